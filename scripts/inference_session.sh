@@ -0,0 +1,65 @@
+#! /bin/bash
+# Runs the inference of all images within one session of the compute servers,
+# s.t. the connection and the base OTs are set up only once.
+
+build_path=${BASE_DIR}/build_debwithrelinfo_gcc
+image_provider_path=${BASE_DIR}/Dataprovider/image_provider/Final_Output_Shares
+fractional_bits=13
+
+debug_0="$build_path/server0/debug_files"
+debug_1="$build_path/server1/debug_files"
+
+if [ ! -d "$debug_0" ]; then
+   echo "$debug_0 does not exist."
+   mkdir $debug_0
+fi
+if [ ! -d "$debug_1" ]; then
+   echo "$debug_1 does not exist."
+   mkdir $debug_1
+fi
+
+image_ids=(1 2 4 5 6 7)
+# number of images evaluated together as one 784xN tensor
+batch_size=${BATCH_SIZE:-${#image_ids[@]}}
+
+$build_path/bin/inference_session --my-id 0 --party 0,::1,7002 --party 1,::1,7000 --fractional-bits $fractional_bits --config-file-model file_config_model0 --image-ids ${image_ids[@]} --batch-size $batch_size --current-path $build_path > $build_path/server0/debug_files/inference_session0.txt &
+pid1=$!
+
+$build_path/bin/inference_session --my-id 1 --party 0,::1,7002 --party 1,::1,7000 --fractional-bits $fractional_bits --config-file-model file_config_model1 --image-ids ${image_ids[@]} --batch-size $batch_size --current-path $build_path > $build_path/server1/debug_files/inference_session1.txt &
+pid2=$!
+
+wait $pid1 $pid2
+echo "Inferencing of all images is done"
+
+for i in "${image_ids[@]}"
+do
+echo
+echo "Argmax of example X$i"
+
+$build_path/bin/output_shares_receiver --my-id 0 --listening-port 1234 --current-path $image_provider_path --index $i > $build_path/server0/debug_files/output_shares_receiver0.txt &
+pid5=$!
+
+$build_path/bin/output_shares_receiver --my-id 1 --listening-port 1235 --current-path $image_provider_path --index $i > $build_path/server1/debug_files/output_shares_receiver1.txt &
+pid6=$!
+echo "Image Provider listening for the inferencing result"
+
+$build_path/bin/argmax --my-id 0 --party 0,::1,7000 --party 1,::1,7001 --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename file_config_input0_X$i --config-input X$i --current-path $build_path > $build_path/server0/debug_files/argmax0_X$i.txt &
+pid1=$!
+
+$build_path/bin/argmax --my-id 1 --party 0,::1,7000 --party 1,::1,7001 --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename file_config_input1_X$i --config-input X$i --current-path $build_path > $build_path/server1/debug_files/argmax1_X$i.txt &
+pid2=$!
+
+wait $pid1 $pid2
+echo "argmax is done"
+
+$build_path/bin/final_output_provider --my-id 0 --connection-port 1234 --config-input X$i --current-path $build_path > $build_path/server0/debug_files/final_output_provider0.txt &
+pid3=$!
+
+$build_path/bin/final_output_provider --my-id 1 --connection-port 1235 --config-input X$i --current-path $build_path > $build_path/server1/debug_files/final_output_provider1.txt &
+pid4=$!
+wait $pid5 $pid3 $pid6 $pid4
+echo "Output shares sent to the Image provider"
+echo "Reconstruction Starts"
+$build_path/bin/Reconstruct --current-path $image_provider_path --index $i
+
+done
@@ -6,6 +6,13 @@
 ./bin/Image_Share_Receiver --my-id 1 --fractional-bits $fractional_bits --file-names $image_config
 --index $i --current-path $build_path
 
+Batch mode: receive the shares of several images in one run and additionally stack them into
+a single 784xN share file (column j holds image j of --batch-indices), which can be passed to
+inference_session via --image-batch-file.
+
+./bin/Image_Share_Receiver --my-id 0 --fractional-bits $fractional_bits --file-names $image_config
+--batch-indices 1 2 4 --batch-output ip_batch --current-path $build_path
+
 ./bin/image_provider_iudx --compute-server0-port 1234 --compute-server1-port 1235 --fractional-bits
 $fractional_bits --NameofImageFile X$i --filepath $image_path
 
@@ -71,6 +78,7 @@ I also modified compute server.cpp to send the extra number to the main function
 #include "compute_server/compute_server.h"
 #include "statistics/analysis.h"
 #include "utility/logger.h"
+#include "utility/tensor_share_file.h"
 
 #include "base/two_party_tensor_backend.h"
 #include "protocols/beavy/tensor.h"
@@ -108,6 +116,8 @@ struct Options {
   std::vector<std::string> filepaths;
   std::string index;
   std::string currentpath;
+  std::vector<std::string> batch_indices;
+  std::string batch_output;
 };
 
 void read_filenames(Options* options) {
@@ -154,6 +164,7 @@ void generate_filepaths(Options* options) {
 
   //../server0/filenameshare_id0 / 1 only for image shares, for actual answer it is only X
   std::cout << "Size of data: " << options->data.size() << "\n";
+  options->filepaths.clear();
   std::string n0 = options->data[0] + options->index;
   fullfilename = dirname1 + n0;
   options->filepaths.push_back(fullfilename);
@@ -181,6 +192,8 @@ void retrieve_shares(int port_number, Options* options) {
   file.close();
 
   std::vector<COMPUTE_SERVER::Shares> input_values_dp0 = p3.first;
+  options->image.Delta.clear();
+  options->image.delta.clear();
 
   // std::ofstream file;
   auto temp = options->filepaths[1];
@@ -228,6 +241,39 @@ void retrieve_shares(int port_number, Options* options) {
     std::cout << "Couldn't open the file\n";
 }
 
+// Receive the images of --batch-indices one after the other and stack their shares
+// column-wise into one (rows x N) share file.
+void retrieve_batch(int port_number, Options* options) {
+  const auto batch_size = options->batch_indices.size();
+  MOTION::TensorShares<std::uint64_t> batch;
+  for (std::size_t j = 0; j < batch_size; ++j) {
+    options->index = options->batch_indices[j];
+    generate_filepaths(options);
+    retrieve_shares(port_number, options);
+    const auto& image = options->image;
+    if (image.col != 1) {
+      throw std::runtime_error("batch mode expects images with a single column");
+    }
+    if (j == 0) {
+      batch.rows_ = image.row;
+      batch.cols_ = batch_size;
+      batch.Delta_.resize(batch.rows_ * batch_size);
+      batch.delta_.resize(batch.rows_ * batch_size);
+    } else if (static_cast<std::size_t>(image.row) != batch.rows_) {
+      throw std::runtime_error("images of a batch need to have the same size");
+    }
+    for (std::size_t r = 0; r < batch.rows_; ++r) {
+      batch.Delta_[r * batch_size + j] = image.Delta[r];
+      batch.delta_[r * batch_size + j] = image.delta[r];
+    }
+  }
+  batch.fractional_bits_ = options->fractional_bits;
+  const std::string path = options->currentpath + "/server" + std::to_string(options->my_id) +
+                           "/Image_shares/" + options->batch_output;
+  MOTION::write_tensor_share_file(path, batch);
+  std::cout << "Stacked " << batch_size << " images into " << path << "\n";
+}
+
 std::optional<Options> parse_program_options(int argc, char* argv[]) {
   Options options;
   boost::program_options::options_description desc("Allowed options");
@@ -244,6 +290,10 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     ("file-names",po::value<std::string>()->required(), "filename")
     ("index",po::value<std::string>()->default_value("0"), "index")
     ("current-path",po::value<std::string>()->required(), "current path build_debwithrelinfo")
+    ("batch-indices", po::value<std::vector<std::string>>()->multitoken(),
+     "receive the images with these indices and stack them into one share file")
+    ("batch-output", po::value<std::string>()->default_value("ip_batch"),
+     "name of the stacked share file in server<my-id>/Image_shares/")
     ("sync-between-setup-and-online", po::bool_switch()->default_value(false),
      "run a synchronization protocol before the online phase starts")
     ("no-run", po::bool_switch()->default_value(false), "just build the circuit, but not execute it")
@@ -279,6 +329,10 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.filenames = vm["file-names"].as<std::string>();
   options.index = vm["index"].as<std::string>();
   options.currentpath = vm["current-path"].as<std::string>();
+  if (vm.count("batch-indices")) {
+    options.batch_indices = vm["batch-indices"].as<std::vector<std::string>>();
+  }
+  options.batch_output = vm["batch-output"].as<std::string>();
   std::cout << "index" << options.index << "\n";
   if (options.my_id > 1) {
     std::cerr << "my-id must be one of 0 and 1\n";
@@ -286,18 +340,6 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   }
 
   read_filenames(&options);
-
-  if (options.my_id == 0) {
-    generate_filepaths(&options);
-  } else if (options.my_id == 1) {
-    generate_filepaths(&options);
-  }
-
-  if (options.my_id == 0) {
-    retrieve_shares(1234, &options);
-  } else {
-    retrieve_shares(1235, &options);
-  }
   return options;
 }
 
@@ -310,8 +352,14 @@ int main(int argc, char* argv[]) {
   try {
     auto logger = std::make_shared<MOTION::Logger>(options->my_id,
                                                    boost::log::trivial::severity_level::trace);
-
-  } catch (std::runtime_error& e) {
+    const int port_number = options->my_id == 0 ? 1234 : 1235;
+    if (!options->batch_indices.empty()) {
+      retrieve_batch(port_number, &*options);
+    } else {
+      generate_filepaths(&*options);
+      retrieve_shares(port_number, &*options);
+    }
+  } catch (std::exception& e) {
     std::cerr << "ERROR OCCURRED: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
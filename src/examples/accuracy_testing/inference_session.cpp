@@ -0,0 +1,641 @@
+/*
+Runs all layers of the model for a list of images inside a single session.
+The connection between the compute servers, the base OTs and the loaded model
+shares are kept alive across the images instead of launching tensor_gt_mul_test
+and tensor_gt_relu for every layer of every image.
+
+The model config file lists the files with the shares of W1, B1, W2, B2, ...,
+one per line (same format as used by tensor_gt_mul_test). For every image i the
+shares are read from server<my-id>/Image_shares/ip<i>. The shares of the output
+of the last layer are written to server<my-id>/outputshare_<my-id>_X<i> and the
+path of this file to file_config_input<my-id>_X<i>, s.t. argmax can be run on it.
+
+With --batch-size N the images are processed in groups of N: their shares are stacked
+column-wise into a 784xN tensor, s.t. every layer runs a single GEMM, truncation and ReLU
+for the whole group. With --image-batch-file the stacked shares written by
+Image_Share_Receiver --batch-indices are read instead; column j then belongs to the j-th
+entry of --image-ids.
+
+Server-0
+./bin/inference_session --my-id 0 --party 0,::1,7002 --party 1,::1,7000 --fractional-bits 13
+--config-file-model file_config_model0 --image-ids 1 2 4 --current-path $build_path
+
+Server-1
+./bin/inference_session --my-id 1 --party 0,::1,7002 --party 1,::1,7000 --fractional-bits 13
+--config-file-model file_config_model1 --image-ids 1 2 4 --current-path $build_path
+
+Batched (both servers)
+./bin/inference_session ... --image-ids 1 2 4 5 6 7 --batch-size 6
+
+With --ring-bits 32 the network is evaluated in the ring Z_{2^32} instead of Z_{2^64}, which
+halves the OTs and garbled ReLU circuits as well as the exchanged shares. The share files then
+need to contain 32-bit shares (see share_file_converter --bit-size 32). The 32-bit ring is only
+correct if all intermediate values fit into it, including the 2 * fractional-bits of a product
+before its truncation, which the caller needs to ensure for the model at hand. The default is the
+64-bit ring.
+
+Precomputed triples (both servers)
+./bin/inference_session ... --image-ids 1 2 4 --generate-triples triples$my_id
+./bin/inference_session ... --image-ids 1 2 4 --triples-file triples$my_id
+
+The first run only computes the triples of the dense layers of the given images and writes them
+to the file; the second run takes them from there instead of computing them with OTs. Each run
+marks the triples it used in the file, so a file serves the same images only once.
+*/
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <regex>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/json/array.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/program_options.hpp>
+
+#include "base/two_party_tensor_backend.h"
+#include "communication/communication_layer.h"
+#include "communication/lz_codec.h"
+#include "communication/tcp_transport.h"
+#include "crypto/multiplication_triple/linalg_triple_provider.h"
+#include "protocols/beavy/tensor.h"
+#include "statistics/analysis.h"
+#include "statistics/run_time_stats.h"
+#include "tensor/tensor.h"
+#include "tensor/tensor_op.h"
+#include "tensor/tensor_op_factory.h"
+#include "utility/logger.h"
+#include "utility/type_traits.hpp"
+#include "utility/tensor_share_file.h"
+
+namespace po = boost::program_options;
+
+template <typename T>
+struct Matrix {
+  std::vector<T> Delta;
+  std::vector<T> delta;
+  std::size_t row;
+  std::size_t col;
+};
+
+// the model shares stay mapped for the whole session and are only copied
+// into the input promises
+template <typename T>
+struct Layer {
+  MOTION::TensorSharesView<T> W;
+  MOTION::TensorSharesView<T> B;
+};
+
+struct Options {
+  std::size_t threads;
+  bool json;
+  bool sync_between_setup_and_online;
+  bool pipelined;
+  std::size_t fractional_bits;
+  std::size_t ring_bits;
+  std::string modelpath;
+  std::vector<std::string> image_ids;
+  std::size_t batch_size;
+  std::string image_batch_file;
+  std::string currentpath;
+  std::string base_ot_cache;
+  std::string generate_triples;
+  std::string triples_file;
+  std::size_t tcp_streams;
+  std::size_t coalescing_window_us;
+  std::vector<MOTION::Communication::MessageType> compressed_message_types;
+  std::size_t my_id;
+  MOTION::Communication::tcp_parties_config tcp_config;
+};
+
+// accepts the binary share format as well as the text format
+template <typename T>
+Matrix<T> read_shares(const std::string& path) {
+  auto shares = MOTION::read_tensor_shares<T>(path);
+  return {std::move(shares.Delta_), std::move(shares.delta_), shares.rows_, shares.cols_};
+}
+
+// the model config contains the paths of W1, B1, W2, B2, ... one per line
+template <typename T>
+std::vector<Layer<T>> read_model(const Options& options) {
+  const std::string config_path = options.currentpath + "/" + options.modelpath;
+  std::ifstream config(config_path);
+  if (!config) {
+    throw std::runtime_error("could not open model config " + config_path);
+  }
+  std::vector<std::string> paths;
+  std::string line;
+  while (std::getline(config, line)) {
+    boost::algorithm::trim(line);
+    if (!line.empty()) {
+      paths.push_back(line);
+    }
+  }
+  if (paths.empty() || paths.size() % 2 != 0) {
+    throw std::runtime_error("model config needs a weight and a bias file for each layer");
+  }
+  std::vector<Layer<T>> layers;
+  for (std::size_t i = 0; i < paths.size(); i += 2) {
+    layers.push_back({MOTION::load_tensor_shares<T>(paths[i]),
+                      MOTION::load_tensor_shares<T>(paths[i + 1])});
+  }
+  return layers;
+}
+
+// Stack column vectors (or batches) side by side into one (rows x sum of cols) matrix.
+template <typename T>
+Matrix<T> stack_columns(const std::vector<Matrix<T>>& columns) {
+  assert(!columns.empty());
+  Matrix<T> stacked;
+  stacked.row = columns.front().row;
+  stacked.col = 0;
+  for (const auto& m : columns) {
+    if (m.row != stacked.row) {
+      throw std::invalid_argument("images of a batch need to have the same number of rows");
+    }
+    stacked.col += m.col;
+  }
+  stacked.Delta.resize(stacked.row * stacked.col);
+  stacked.delta.resize(stacked.row * stacked.col);
+  for (std::size_t r = 0; r < stacked.row; ++r) {
+    std::size_t offset = r * stacked.col;
+    for (const auto& m : columns) {
+      std::copy_n(&m.Delta[r * m.col], m.col, &stacked.Delta[offset]);
+      std::copy_n(&m.delta[r * m.col], m.col, &stacked.delta[offset]);
+      offset += m.col;
+    }
+  }
+  return stacked;
+}
+
+// Extract the columns [first, first + count) of a batch of images.
+template <typename T>
+Matrix<T> slice_columns(const MOTION::TensorSharesView<T>& m, std::size_t first,
+                        std::size_t count) {
+  const auto rows = m.get_rows();
+  const auto cols = m.get_cols();
+  assert(first + count <= cols);
+  Matrix<T> slice;
+  slice.row = rows;
+  slice.col = count;
+  slice.Delta.resize(rows * count);
+  slice.delta.resize(rows * count);
+  for (std::size_t r = 0; r < rows; ++r) {
+    std::copy_n(&m.get_Delta()[r * cols + first], count, &slice.Delta[r * count]);
+    std::copy_n(&m.get_delta()[r * cols + first], count, &slice.delta[r * count]);
+  }
+  return slice;
+}
+
+std::optional<Options> parse_program_options(int argc, char* argv[]) {
+  Options options;
+  boost::program_options::options_description desc("Allowed options");
+  // clang-format off
+  desc.add_options()
+    ("help,h", po::bool_switch()->default_value(false),"produce help message")
+    ("config-file-model", po::value<std::string>()->required(), "config file listing the model shares")
+    ("image-ids", po::value<std::vector<std::string>>()->multitoken()->required(),
+     "ids of the images to run the inference on, e.g., --image-ids 1 2 4")
+    ("batch-size", po::value<std::size_t>()->default_value(1),
+     "number of images evaluated together as one 784xN tensor")
+    ("image-batch-file", po::value<std::string>(),
+     "stacked image shares (one column per entry of --image-ids) to use instead of the single "
+     "image files")
+    ("my-id", po::value<std::size_t>()->required(), "my party id")
+    ("party", po::value<std::vector<std::string>>()->multitoken(),
+     "(party id, IP, port), e.g., --party 1,127.0.0.1,7777")
+    ("threads", po::value<std::size_t>()->default_value(0), "number of threads to use for gate evaluation")
+    ("json", po::bool_switch()->default_value(false), "output data in JSON format")
+    ("fractional-bits", po::value<std::size_t>()->default_value(16),
+     "number of fractional bits for fixed-point arithmetic")
+    ("ring-bits", po::value<std::size_t>()->default_value(64),
+     "bit size of the ring the network is evaluated in (32 or 64)")
+    ("current-path",po::value<std::string>()->required(), "current path build_debwithrelinfo")
+    ("sync-between-setup-and-online", po::bool_switch()->default_value(false),
+     "run a synchronization protocol before the online phase starts")
+    ("pipelined", po::bool_switch()->default_value(false),
+     "start the online phase of each layer as soon as its setup is done")
+    ("base-ot-cache", po::value<std::string>(),
+     "directory in which the base OTs are kept for later runs")
+    ("generate-triples", po::value<std::string>(),
+     "only generate the triples of the dense layers for all given images and write them to "
+     "this file")
+    ("triples-file", po::value<std::string>(),
+     "take the triples of the dense layers from this file written by --generate-triples")
+    ("tcp-streams", po::value<std::size_t>()->default_value(1),
+     "number of TCP connections to the other party, large messages are striped across them")
+    ("coalescing-window-us", po::value<std::size_t>()->default_value(0),
+     "send small gate messages of this many microseconds together (0 to disable)")
+    ("compress", po::value<std::vector<std::string>>()->multitoken(),
+     "types of messages to compress before sending them, e.g., --compress GMWGate BEAVYGate")
+    ;
+  // clang-format on
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  bool help = vm["help"].as<bool>();
+  if (help) {
+    std::cerr << desc << "\n";
+    return std::nullopt;
+  }
+  try {
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << "error:" << e.what() << "\n\n";
+    std::cerr << desc << "\n";
+    return std::nullopt;
+  }
+
+  options.my_id = vm["my-id"].as<std::size_t>();
+  options.threads = vm["threads"].as<std::size_t>();
+  options.json = vm["json"].as<bool>();
+  options.sync_between_setup_and_online = vm["sync-between-setup-and-online"].as<bool>();
+  options.pipelined = vm["pipelined"].as<bool>();
+  options.fractional_bits = vm["fractional-bits"].as<std::size_t>();
+  options.ring_bits = vm["ring-bits"].as<std::size_t>();
+  if (options.ring_bits != 32 && options.ring_bits != 64) {
+    std::cerr << "ring-bits must be one of 32 and 64\n";
+    return std::nullopt;
+  }
+  if (2 * options.fractional_bits >= options.ring_bits) {
+    std::cerr << "fractional-bits are too large for a " << options.ring_bits << "-bit ring\n";
+    return std::nullopt;
+  }
+  options.modelpath = vm["config-file-model"].as<std::string>();
+  options.image_ids = vm["image-ids"].as<std::vector<std::string>>();
+  options.batch_size = vm["batch-size"].as<std::size_t>();
+  if (vm.count("image-batch-file")) {
+    options.image_batch_file = vm["image-batch-file"].as<std::string>();
+  }
+  options.currentpath = vm["current-path"].as<std::string>();
+  if (vm.count("base-ot-cache")) {
+    options.base_ot_cache = vm["base-ot-cache"].as<std::string>();
+  }
+  if (vm.count("generate-triples")) {
+    options.generate_triples = vm["generate-triples"].as<std::string>();
+  }
+  if (vm.count("triples-file")) {
+    options.triples_file = vm["triples-file"].as<std::string>();
+  }
+  if (!options.generate_triples.empty() && !options.triples_file.empty()) {
+    std::cerr << "generate-triples and triples-file cannot be used together\n";
+    return std::nullopt;
+  }
+  options.tcp_streams = vm["tcp-streams"].as<std::size_t>();
+  options.coalescing_window_us = vm["coalescing-window-us"].as<std::size_t>();
+  if (vm.count("compress")) {
+    for (const auto& name : vm["compress"].as<std::vector<std::string>>()) {
+      bool found = false;
+      for (auto type = static_cast<std::size_t>(MOTION::Communication::MessageType::MIN);
+           type <= static_cast<std::size_t>(MOTION::Communication::MessageType::MAX); ++type) {
+        const auto message_type = static_cast<MOTION::Communication::MessageType>(type);
+        if (name == MOTION::Communication::EnumNameMessageType(message_type)) {
+          options.compressed_message_types.push_back(message_type);
+          found = true;
+        }
+      }
+      if (!found) {
+        std::cerr << "unknown message type " << name << " given to --compress\n";
+        return std::nullopt;
+      }
+    }
+  }
+  if (options.tcp_streams == 0) {
+    std::cerr << "tcp-streams must be positive\n";
+    return std::nullopt;
+  }
+  if (options.my_id > 1) {
+    std::cerr << "my-id must be one of 0 and 1\n";
+    return std::nullopt;
+  }
+  if (options.batch_size == 0) {
+    std::cerr << "batch-size must be positive\n";
+    return std::nullopt;
+  }
+
+  const auto parse_party_argument =
+      [](const auto& s) -> std::pair<std::size_t, MOTION::Communication::tcp_connection_config> {
+    const static std::regex party_argument_re("([01]),([^,]+),(\\d{1,5})");
+    std::smatch match;
+    if (!std::regex_match(s, match, party_argument_re)) {
+      throw std::invalid_argument("invalid party argument");
+    }
+    auto id = boost::lexical_cast<std::size_t>(match[1]);
+    auto host = match[2];
+    auto port = boost::lexical_cast<std::uint16_t>(match[3]);
+    return {id, {host, port}};
+  };
+
+  const std::vector<std::string> party_infos = vm["party"].as<std::vector<std::string>>();
+  if (party_infos.size() != 2) {
+    std::cerr << "expecting two --party options\n";
+    return std::nullopt;
+  }
+
+  options.tcp_config.resize(2);
+  const auto [id0, conn_info0] = parse_party_argument(party_infos[0]);
+  const auto [id1, conn_info1] = parse_party_argument(party_infos[1]);
+  if (id0 == id1) {
+    std::cerr << "need party arguments for party 0 and 1\n";
+    return std::nullopt;
+  }
+  options.tcp_config[id0] = conn_info0;
+  options.tcp_config[id1] = conn_info1;
+
+  return options;
+}
+
+std::unique_ptr<MOTION::Communication::CommunicationLayer> setup_communication(
+    const Options& options) {
+  MOTION::Communication::TCPSetupHelper helper(options.my_id, options.tcp_config,
+                                               options.tcp_streams);
+  return std::make_unique<MOTION::Communication::CommunicationLayer>(options.my_id,
+                                                                     helper.setup_connections());
+}
+
+void print_stats(const Options& options,
+                 const MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats,
+                 const MOTION::Statistics::AccumulatedCommunicationStats& comm_stats) {
+  if (options.json) {
+    auto obj = MOTION::Statistics::to_json("inference_session", run_time_stats, comm_stats);
+    obj.emplace("party_id", options.my_id);
+    obj.emplace("images", options.image_ids.size());
+    obj.emplace("batch_size", options.batch_size);
+    obj.emplace("threads", options.threads);
+    obj.emplace("tcp_streams", options.tcp_streams);
+    obj.emplace("coalescing_window_us", options.coalescing_window_us);
+    boost::json::array compressed_message_types;
+    for (auto message_type : options.compressed_message_types) {
+      compressed_message_types.push_back(
+          boost::json::string(MOTION::Communication::EnumNameMessageType(message_type)));
+    }
+    obj.emplace("compressed_message_types", std::move(compressed_message_types));
+    obj.emplace("fractional_bits", options.fractional_bits);
+    obj.emplace("ring_bits", options.ring_bits);
+    obj.emplace("sync_between_setup_and_online", options.sync_between_setup_and_online);
+    obj.emplace("pipelined", options.pipelined);
+    std::cout << obj << "\n";
+  } else {
+    std::cout << MOTION::Statistics::print_stats("inference_session", run_time_stats, comm_stats);
+  }
+}
+
+// Builds the whole network (GEMM + bias, followed by ReLU for all but the last
+// layer) for one image or a batch of images stacked as columns, and returns the
+// tensor holding the output of the last layer.
+template <typename T>
+MOTION::tensor::TensorCP create_network(const Options& options,
+                                        MOTION::TwoPartyTensorBackend& backend,
+                                        const std::vector<Layer<T>>& layers,
+                                        const Matrix<T>& image) {
+  auto& arithmetic_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+  auto& boolean_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::Yao);
+
+  // copies the shares straight from the (possibly mapped) arrays into the promises
+  const auto make_input = [&arithmetic_tof](const auto& dims, std::span<const T> Delta,
+                                            std::span<const T> delta) {
+    auto [promises, tensor] = [&] {
+      if constexpr (std::is_same_v<T, std::uint32_t>) {
+        return arithmetic_tof.make_arithmetic_32_tensor_input_shares(dims);
+      } else {
+        return arithmetic_tof.make_arithmetic_64_tensor_input_shares(dims);
+      }
+    }();
+    promises[0].set_value(std::vector<T>(std::begin(Delta), std::end(Delta)));
+    promises[1].set_value(std::vector<T>(std::begin(delta), std::end(delta)));
+    return tensor;
+  };
+
+  // expects the negated output of the dense layer
+  const auto make_activation = [&](const auto& negated_tensor) {
+    const auto boolean_tensor =
+        boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::Yao, negated_tensor);
+    const auto relu_tensor = boolean_tof.make_tensor_relu_op(boolean_tensor);
+    const auto finBoolean_tensor =
+        boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::ArithmeticBEAVY, relu_tensor);
+    return arithmetic_tof.make_tensor_negate(finBoolean_tensor);
+  };
+
+  std::array<std::size_t, 2> input_shape = {image.row, image.col};
+  MOTION::tensor::TensorCP tensor_X;
+  for (std::size_t layer_i = 0; layer_i < layers.size(); ++layer_i) {
+    const auto& layer = layers[layer_i];
+    const auto num_neurons = layer.W.get_rows();
+    const MOTION::tensor::GemmOp gemm_op = {.input_A_shape_ = {num_neurons, layer.W.get_cols()},
+                                            .input_B_shape_ = input_shape,
+                                            .output_shape_ = {num_neurons, input_shape[1]}};
+    if (!gemm_op.verify()) {
+      throw std::invalid_argument(
+          "shapes of layer " + std::to_string(layer_i + 1) + " do not fit to its input");
+    }
+    if (layer_i == 0) {
+      tensor_X = make_input(gemm_op.get_input_B_tensor_dims(), image.Delta, image.delta);
+    }
+    const auto tensor_W =
+        make_input(gemm_op.get_input_A_tensor_dims(), layer.W.get_Delta(), layer.W.get_delta());
+    // the bias is a column vector, the dense op adds it to every image of the batch
+    const auto tensor_B = make_input(
+        MOTION::tensor::TensorDimensions{
+            .batch_size_ = 1,
+            .num_channels_ = 1,
+            .height_ = layer.B.get_rows(),
+            .width_ = layer.B.get_cols()},
+        layer.B.get_Delta(), layer.B.get_delta());
+
+    // hidden layers produce the negated output the ReLU conversion expects
+    const bool hidden_layer = layer_i + 1 < layers.size();
+    tensor_X = arithmetic_tof.make_tensor_dense_op(gemm_op, tensor_W, tensor_X, tensor_B,
+                                                   options.fractional_bits, hidden_layer);
+    if (hidden_layer) {
+      tensor_X = make_activation(tensor_X);
+    }
+    input_shape = gemm_op.output_shape_;
+  }
+  return tensor_X;
+}
+
+// Writes the shares of column `column` of the last layer in the same format as
+// the share files produced by the per-layer binaries, s.t. argmax can pick them up.
+// argmax works on 64-bit shares: 32-bit shares are shifted into the upper half,
+// which maps x mod 2^32 to x * 2^32 mod 2^64 and keeps the sign bit in place, so
+// the comparisons of argmax give the same result as in the 32-bit ring.
+template <typename T>
+void write_output_shares(const Options& options, const std::string& image_id,
+                         const MOTION::tensor::TensorCP& output, std::size_t column,
+                         std::size_t num_columns) {
+  const auto beavy_output =
+      std::dynamic_pointer_cast<const MOTION::proto::beavy::ArithmeticBEAVYTensor<T>>(output);
+  assert(beavy_output);
+  const auto& public_share = beavy_output->get_public_share();
+  const auto& secret_share = beavy_output->get_secret_share();
+
+  const auto my_id = std::to_string(options.my_id);
+  const std::string share_path =
+      options.currentpath + "/server" + my_id + "/outputshare_" + my_id + "_X" + image_id;
+  assert(public_share.size() % num_columns == 0);
+  const auto num_rows = public_share.size() / num_columns;
+  std::ofstream file(share_path);
+  file << num_rows << " 1\n";
+  constexpr auto shift = 64 - ENCRYPTO::bit_size_v<T>;
+  for (std::size_t i = 0; i < num_rows; ++i) {
+    const auto idx = i * num_columns + column;
+    file << (std::uint64_t(public_share[idx]) << shift) << " "
+         << (std::uint64_t(secret_share[idx]) << shift) << "\n";
+  }
+  file.close();
+
+  std::ofstream file_config(options.currentpath + "/file_config_input" + my_id + "_X" + image_id);
+  file_config << share_path;
+}
+
+// Generates the triples of the dense layers of all batches in advance, s.t. a
+// later session started with --triples-file does not need to compute them.
+template <typename T>
+void generate_triples(const Options& options, MOTION::TwoPartyTensorBackend& backend,
+                      MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats) {
+  const auto layers = read_model<T>(options);
+  MOTION::LinAlgTripleRequirements requirements = {.bit_size_ = ENCRYPTO::bit_size_v<T>};
+  const auto num_images = options.image_ids.size();
+  for (std::size_t first = 0; first < num_images; first += options.batch_size) {
+    const auto count = std::min(options.batch_size, num_images - first);
+    for (const auto& layer : layers) {
+      requirements.gemm_ops_.push_back(
+          {.input_A_shape_ = {layer.W.get_rows(), layer.W.get_cols()},
+           .input_B_shape_ = {layer.W.get_cols(), count},
+           .output_shape_ = {layer.W.get_rows(), count}});
+    }
+  }
+  backend.generate_linalg_triples(requirements, options.generate_triples);
+  std::cout << "Triples of " << num_images << " images written to " << options.generate_triples
+            << "\n";
+  run_time_stats.add(backend.get_run_time_stats());
+}
+
+// Runs the inference of all images with the network evaluated in the ring of T.
+template <typename T>
+void run_inference(const Options& options, MOTION::TwoPartyTensorBackend& backend,
+                   MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats) {
+  const auto layers = read_model<T>(options);
+
+  const std::string image_dir =
+      options.currentpath + "/server" + std::to_string(options.my_id) + "/Image_shares/";
+  std::optional<MOTION::TensorSharesView<T>> image_batch;
+  if (!options.image_batch_file.empty()) {
+    image_batch = MOTION::load_tensor_shares<T>(image_dir + options.image_batch_file);
+    if (image_batch->get_cols() != options.image_ids.size()) {
+      throw std::runtime_error("image batch file does not have one column per image id");
+    }
+  }
+
+  const auto num_images = options.image_ids.size();
+  for (std::size_t first = 0; first < num_images; first += options.batch_size) {
+    const auto count = std::min(options.batch_size, num_images - first);
+    if (first > 0) {
+      backend.reset();
+    }
+    Matrix<T> images;
+    if (image_batch.has_value()) {
+      images = slice_columns(*image_batch, first, count);
+    } else {
+      std::vector<Matrix<T>> columns;
+      for (std::size_t j = 0; j < count; ++j) {
+        columns.push_back(read_shares<T>(image_dir + "ip" + options.image_ids[first + j]));
+      }
+      images = count == 1 ? std::move(columns.front()) : stack_columns(columns);
+    }
+    const auto output = create_network(options, backend, layers, images);
+    if (options.pipelined) {
+      backend.run_pipelined();
+    } else {
+      backend.run();
+    }
+    for (std::size_t j = 0; j < count; ++j) {
+      write_output_shares<T>(options, options.image_ids[first + j], output, j, images.col);
+      std::cout << "Inference of image " << options.image_ids[first + j] << " done\n";
+    }
+    run_time_stats.add(backend.get_run_time_stats());
+  }
+}
+
+int main(int argc, char* argv[]) {
+  auto options = parse_program_options(argc, argv);
+  if (!options.has_value()) {
+    return EXIT_FAILURE;
+  }
+
+  try {
+    auto comm_layer = setup_communication(*options);
+    auto logger = std::make_shared<MOTION::Logger>(options->my_id,
+                                                   boost::log::trivial::severity_level::trace);
+    comm_layer->set_logger(logger);
+    for (auto message_type : options->compressed_message_types) {
+      comm_layer->set_message_codec(message_type, MOTION::Communication::MessageCodec::lz);
+    }
+    MOTION::Statistics::AccumulatedRunTimeStats run_time_stats;
+    MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
+    MOTION::TwoPartyTensorBackend backend(*comm_layer, options->threads,
+                                          options->sync_between_setup_and_online, logger);
+    if (!options->base_ot_cache.empty()) {
+      backend.set_base_ot_cache(options->base_ot_cache);
+    }
+    if (options->coalescing_window_us > 0) {
+      backend.set_message_coalescing(std::chrono::microseconds(options->coalescing_window_us));
+    }
+
+    if (!options->generate_triples.empty()) {
+      if (options->ring_bits == 32) {
+        generate_triples<std::uint32_t>(*options, backend, run_time_stats);
+      } else {
+        generate_triples<std::uint64_t>(*options, backend, run_time_stats);
+      }
+    } else {
+      if (!options->triples_file.empty()) {
+        backend.use_linalg_triples_from_file(options->triples_file);
+      }
+      if (options->ring_bits == 32) {
+        run_inference<std::uint32_t>(*options, backend, run_time_stats);
+      } else {
+        run_inference<std::uint64_t>(*options, backend, run_time_stats);
+      }
+    }
+
+    comm_layer->sync();
+    comm_stats.add(comm_layer->get_transport_statistics());
+    comm_layer->shutdown();
+    print_stats(*options, run_time_stats, comm_stats);
+  } catch (std::runtime_error& e) {
+    std::cerr << "ERROR OCCURRED: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
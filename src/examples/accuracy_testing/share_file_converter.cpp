@@ -0,0 +1,121 @@
+/*
+Converts a share file from the text format ("rows cols" followed by one
+"Delta delta" pair per line) into the binary format of utility/tensor_share_file.h,
+which is memory mapped by tensor_gt_mul_test and inference_session.
+With --bit-size 32 the shares are reduced modulo 2^32, which halves the file for
+networks evaluated in the 32-bit ring (inference_session --ring-bits 32). This is the only way
+to use 64-bit shares in the 32-bit ring, the share files are never reduced implicitly.
+
+./bin/share_file_converter --input server0/Image_shares/ip1 --output server0/Image_shares/ip1.bin
+--fractional-bits 13
+*/
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+
+#include <boost/program_options.hpp>
+
+#include "utility/tensor_share_file.h"
+
+namespace po = boost::program_options;
+
+struct Options {
+  std::string input;
+  std::string output;
+  std::size_t fractional_bits;
+  std::size_t bit_size;
+};
+
+std::optional<Options> parse_program_options(int argc, char* argv[]) {
+  Options options;
+  boost::program_options::options_description desc("Allowed options");
+  // clang-format off
+  desc.add_options()
+    ("help,h", po::bool_switch()->default_value(false),"produce help message")
+    ("input", po::value<std::string>()->required(), "share file in text format")
+    ("output", po::value<std::string>()->required(), "path of the binary share file")
+    ("fractional-bits", po::value<std::size_t>()->default_value(13),
+     "number of fractional bits stored in the header")
+    ("bit-size", po::value<std::size_t>()->default_value(64),
+     "bit size of the shares in the output file (32 or 64)")
+    ;
+  // clang-format on
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  bool help = vm["help"].as<bool>();
+  if (help) {
+    std::cerr << desc << "\n";
+    return std::nullopt;
+  }
+  try {
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << "error:" << e.what() << "\n\n";
+    std::cerr << desc << "\n";
+    return std::nullopt;
+  }
+
+  options.input = vm["input"].as<std::string>();
+  options.output = vm["output"].as<std::string>();
+  options.fractional_bits = vm["fractional-bits"].as<std::size_t>();
+  options.bit_size = vm["bit-size"].as<std::size_t>();
+  if (options.bit_size != 32 && options.bit_size != 64) {
+    std::cerr << "bit-size must be one of 32 and 64\n";
+    return std::nullopt;
+  }
+  return options;
+}
+
+template <typename T>
+void write_shares(const Options& options, MOTION::TensorShares<T>& shares) {
+  shares.fractional_bits_ = options.fractional_bits;
+  MOTION::write_tensor_share_file(options.output, shares);
+  std::cout << "Converted " << shares.rows_ << "x" << shares.cols_ << " shares to "
+            << options.output << " (" << options.bit_size << " bit)\n";
+}
+
+int main(int argc, char* argv[]) {
+  auto options = parse_program_options(argc, argv);
+  if (!options.has_value()) {
+    return EXIT_FAILURE;
+  }
+  try {
+    // the text files contain 64-bit shares, the reduction to 32 bits is explicit
+    auto shares = MOTION::read_tensor_shares<std::uint64_t>(options->input);
+    if (options->bit_size == 32) {
+      auto reduced_shares = MOTION::reduce_tensor_shares<std::uint32_t>(shares);
+      write_shares(*options, reduced_shares);
+    } else {
+      write_shares(*options, shares);
+    }
+  } catch (std::exception& e) {
+    std::cerr << "ERROR OCCURRED: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
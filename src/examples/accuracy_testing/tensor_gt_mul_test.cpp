@@ -68,6 +68,7 @@ Server-1
 #include "tensor/tensor_op.h"
 #include "tensor/tensor_op_factory.h"
 #include "utility/new_fixed_point.h"
+#include "utility/tensor_share_file.h"
 
 namespace po = boost::program_options;
 int j = 0;
@@ -184,87 +185,23 @@ std::string read_filepath(std::ifstream& indata, int count) {
   return str;
 }
 
-void image_shares(Options* options, std::string p) {
-  std::ifstream temps;
-  temps.open(p);
+// the share files are either in the binary format of utility/tensor_share_file.h
+// (memory mapped) or in the text format "rows cols" followed by "Delta delta" lines
+void read_shares(Matrix& matrix, const std::string& p) {
   std::cout << "p:" << p << "\n";
-  if (temps) {
-    std::cout << "File found\n";
-  } else {
-    std::cout << "File not found\n";
-  }
-  assert(temps);
-
-  std::uint64_t rows = read_file(temps);
-  options->image_file.row = rows;
-  std::cout << "r " << rows << " ";
-  std::uint64_t cols = read_file(temps);
-  options->image_file.col = cols;
-  std::cout << "c " << cols << "\n";
-
-  for (int i = 0; i < rows * cols; ++i) {
-    uint64_t m1 = read_file(temps);
-    // std::cout << m1 << " ";
-    options->image_file.Delta.push_back(m1);
-    uint64_t m2 = read_file(temps);
-    // std::cout << m2 << "\n";
-    options->image_file.delta.push_back(m2);
-  }
-  temps.close();
+  auto shares = MOTION::read_tensor_shares<std::uint64_t>(p);
+  matrix.row = shares.rows_;
+  matrix.col = shares.cols_;
+  std::cout << "r " << matrix.row << " c " << matrix.col << "\n";
+  matrix.Delta = std::move(shares.Delta_);
+  matrix.delta = std::move(shares.delta_);
 }
 
-void W_shares(Options* options, std::string p) {
-  std::ifstream indata;
-  indata.open(p);
-  if (std::ifstream(p)) {
-    std::cout << "File found\n";
-  } else {
-    std::cout << "File not found\n";
-  }
-  assert(indata);
-
-  int rows = read_file(indata);
-  options->W_file.row = rows;
-  std::cout << "r " << rows << " ";
-  int cols = read_file(indata);
-  options->W_file.col = cols;
-  std::cout << "c " << cols << "\n";
-
-  for (int i = 0; i < rows * cols; ++i) {
-    uint64_t m1 = read_file(indata);
-    options->W_file.Delta.push_back(m1);
-    uint64_t m2 = read_file(indata);
-    options->W_file.delta.push_back(m2);
-  }
-  indata.close();
-}
+void image_shares(Options* options, std::string p) { read_shares(options->image_file, p); }
 
-void B_shares(Options* options, std::string p) {
-  std::ifstream indata;
-  indata.open(p);
+void W_shares(Options* options, std::string p) { read_shares(options->W_file, p); }
 
-  if (std::ifstream(p)) {
-    std::cout << "File found\n";
-  } else {
-    std::cout << "File not found\n";
-  }
-  assert(indata);
-
-  int rows = read_file(indata);
-  options->B_file.row = rows;
-  std::cout << "r " << rows << " ";
-  int cols = read_file(indata);
-  options->B_file.col = cols;
-  std::cout << "c " << cols << "\n";
-
-  for (int i = 0; i < rows * cols; ++i) {
-    uint64_t m1 = read_file(indata);
-    options->B_file.Delta.push_back(m1);
-    uint64_t m2 = read_file(indata);
-    options->B_file.delta.push_back(m2);
-  }
-  indata.close();
-}
+void B_shares(Options* options, std::string p) { read_shares(options->B_file, p); }
 
 // changes made in this function
 void file_read(Options* options) {
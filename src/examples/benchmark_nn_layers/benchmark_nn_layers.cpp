@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -31,6 +32,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/json/array.hpp>
 #include <boost/json/serialize.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/log/trivial.hpp>
@@ -38,7 +40,9 @@
 
 #include "base/two_party_tensor_backend.h"
 #include "communication/communication_layer.h"
+#include "communication/emulated_transport.h"
 #include "communication/tcp_transport.h"
+#include "crypto/oblivious_transfer/ot_provider.h"
 #include "protocols/beavy/tensor.h"
 #include "protocols/gmw/tensor.h"
 #include "statistics/analysis.h"
@@ -64,6 +68,10 @@ struct Options {
   std::string benchmark;
   std::size_t relu_variant;
   std::size_t relu_size;
+  // empty if the network is not emulated
+  std::vector<MOTION::Communication::NetworkProfile> network_profiles;
+  std::optional<std::string> output_file;
+  ENCRYPTO::ObliviousTransfer::OTExtensionType ot_extension_type;
 };
 
 std::optional<Options> parse_program_options(int argc, char* argv[]) {
@@ -88,6 +96,12 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
      "number of bits per number (32 or 64)")
     ("fractional-bits", po::value<std::size_t>()->default_value(16),
      "number of fractional bits for fixed-point arithmetic")
+    ("network-profile", po::value<std::vector<std::string>>()->multitoken(),
+     "emulate the given network profiles one after another: none, lan, wan, or "
+     "name:latency_ms:bandwidth_mbit:jitter_ms (both parties need the same profiles)")
+    ("output-file", po::value<std::string>(), "write the results of all profiles as JSON array")
+    ("ot-extension", po::value<std::string>()->default_value("iknp"),
+     "OT extension protocol to use: iknp or silent")
     ;
   // clang-format on
 
@@ -117,6 +131,31 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.sync_between_setup_and_online = vm["sync-between-setup-and-online"].as<bool>();
   options.bit_size = vm["bit-size"].as<std::size_t>();
   options.fractional_bits = vm["fractional-bits"].as<std::size_t>();
+  if (vm.count("output-file")) {
+    options.output_file = vm["output-file"].as<std::string>();
+  }
+  {
+    auto ot_extension = vm["ot-extension"].as<std::string>();
+    boost::algorithm::to_lower(ot_extension);
+    if (ot_extension == "iknp") {
+      options.ot_extension_type = ENCRYPTO::ObliviousTransfer::OTExtensionType::IKNP;
+    } else if (ot_extension == "silent") {
+      options.ot_extension_type = ENCRYPTO::ObliviousTransfer::OTExtensionType::Silent;
+    } else {
+      std::cerr << "unknown OT extension: " << ot_extension << "\n";
+      return std::nullopt;
+    }
+  }
+  if (vm.count("network-profile")) {
+    try {
+      for (const auto& profile : vm["network-profile"].as<std::vector<std::string>>()) {
+        options.network_profiles.push_back(MOTION::Communication::NetworkProfile::parse(profile));
+      }
+    } catch (std::invalid_argument& e) {
+      std::cerr << "error: " << e.what() << "\n";
+      return std::nullopt;
+    }
+  }
 
   options.benchmark = vm["benchmark"].as<std::string>();
   boost::algorithm::to_lower(options.benchmark);
@@ -172,11 +211,19 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   return options;
 }
 
-std::unique_ptr<MOTION::Communication::CommunicationLayer> setup_communication(
-    const Options& options) {
+std::pair<std::unique_ptr<MOTION::Communication::CommunicationLayer>,
+          std::vector<MOTION::Communication::EmulatedTransport*>>
+setup_communication(const Options& options) {
   MOTION::Communication::TCPSetupHelper helper(options.my_id, options.tcp_config);
-  return std::make_unique<MOTION::Communication::CommunicationLayer>(options.my_id,
-                                                                     helper.setup_connections());
+  auto transports = helper.setup_connections();
+  std::vector<MOTION::Communication::EmulatedTransport*> emulated_transports;
+  if (!options.network_profiles.empty()) {
+    emulated_transports = MOTION::Communication::emulate_network(
+        transports, options.network_profiles.front(), options.my_id);
+  }
+  return {std::make_unique<MOTION::Communication::CommunicationLayer>(options.my_id,
+                                                                      std::move(transports)),
+          std::move(emulated_transports)};
 }
 
 template <typename T>
@@ -256,25 +303,43 @@ void run_benchmark(const Options& options, MOTION::TwoPartyTensorBackend& backen
   backend.run();
 }
 
-void print_stats(const Options& options,
-                 const MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats,
-                 const MOTION::Statistics::AccumulatedCommunicationStats& comm_stats) {
+boost::json::object to_json(const MOTION::Communication::NetworkProfile& profile) {
+  boost::json::object obj;
+  obj.emplace("name", profile.name);
+  obj.emplace("latency_ms", profile.latency.count() / 1e3);
+  obj.emplace("bandwidth_mbit", profile.bandwidth / 1e6);
+  obj.emplace("jitter_ms", profile.jitter.count() / 1e3);
+  return obj;
+}
+
+// print the results and return them as JSON object
+boost::json::object print_stats(
+    const Options& options, const MOTION::Communication::NetworkProfile* profile,
+    const MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats,
+    const MOTION::Statistics::AccumulatedCommunicationStats& comm_stats) {
+  auto obj = MOTION::Statistics::to_json(options.experiment_name, run_time_stats, comm_stats);
+  obj.emplace("party_id", options.my_id);
+  obj.emplace("threads", options.num_threads);
+  obj.emplace("sync_between_setup_and_online", options.sync_between_setup_and_online);
+  obj.emplace("bit-size", options.bit_size);
+  obj.emplace("benchmark", options.benchmark);
+  if (options.benchmark == "relu") {
+    obj.emplace("relu-variant", options.relu_variant);
+    obj.emplace("relu-size", options.relu_size);
+  }
+  if (profile != nullptr) {
+    obj.emplace("network_profile", to_json(*profile));
+  }
   if (options.json) {
-    auto obj = MOTION::Statistics::to_json(options.experiment_name, run_time_stats, comm_stats);
-    obj.emplace("party_id", options.my_id);
-    obj.emplace("threads", options.num_threads);
-    obj.emplace("sync_between_setup_and_online", options.sync_between_setup_and_online);
-    obj.emplace("bit-size", options.bit_size);
-    obj.emplace("benchmark", options.benchmark);
-    if (options.benchmark == "relu") {
-      obj.emplace("relu-variant", options.relu_variant);
-      obj.emplace("relu-size", options.relu_size);
-    }
     std::cout << obj << "\n";
   } else {
+    if (profile != nullptr) {
+      std::cout << fmt::format("Network profile: {}\n", profile->name);
+    }
     std::cout << MOTION::Statistics::print_stats(options.experiment_name, run_time_stats,
                                                  comm_stats);
   }
+  return obj;
 }
 
 int main(int argc, char* argv[]) {
@@ -284,23 +349,46 @@ int main(int argc, char* argv[]) {
   }
 
   try {
-    auto comm_layer = setup_communication(*options);
+    auto [comm_layer, emulated_transports] = setup_communication(*options);
     auto logger = std::make_shared<MOTION::Logger>(options->my_id,
                                                    boost::log::trivial::severity_level::trace);
     comm_layer->set_logger(logger);
-    MOTION::Statistics::AccumulatedRunTimeStats run_time_stats;
-    MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
-    for (std::size_t i = 0; i < options->num_repetitions; ++i) {
-      MOTION::TwoPartyTensorBackend backend(*comm_layer, options->num_threads,
-                                            options->sync_between_setup_and_online, logger);
-      run_benchmark(*options, backend);
-      comm_layer->sync();
-      comm_stats.add(comm_layer->get_transport_statistics());
-      comm_layer->reset_transport_statistics();
-      run_time_stats.add(backend.get_run_time_stats());
+    boost::json::array results;
+    // run the benchmark once without emulation, or once per network profile
+    const auto num_profiles = std::max(options->network_profiles.size(), std::size_t(1));
+    for (std::size_t profile_i = 0; profile_i < num_profiles; ++profile_i) {
+      const MOTION::Communication::NetworkProfile* profile = nullptr;
+      if (!options->network_profiles.empty()) {
+        profile = &options->network_profiles.at(profile_i);
+        for (auto* transport : emulated_transports) {
+          transport->set_profile(*profile);
+        }
+        // do not measure messages of the previous profile
+        comm_layer->sync();
+        comm_layer->reset_transport_statistics();
+      }
+      MOTION::Statistics::AccumulatedRunTimeStats run_time_stats;
+      MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
+      for (std::size_t i = 0; i < options->num_repetitions; ++i) {
+        MOTION::TwoPartyTensorBackend backend(*comm_layer, options->num_threads,
+                                              options->sync_between_setup_and_online, logger,
+                                              false, options->ot_extension_type);
+        run_benchmark(*options, backend);
+        comm_layer->sync();
+        comm_stats.add(comm_layer->get_transport_statistics());
+        comm_layer->reset_transport_statistics();
+        run_time_stats.add(backend.get_run_time_stats());
+      }
+      results.push_back(print_stats(*options, profile, run_time_stats, comm_stats));
     }
     comm_layer->shutdown();
-    print_stats(*options, run_time_stats, comm_stats);
+    if (options->output_file.has_value()) {
+      std::ofstream output(*options->output_file);
+      if (!output) {
+        throw std::runtime_error(fmt::format("cannot open {}", *options->output_file));
+      }
+      output << results << "\n";
+    }
   } catch (std::runtime_error& e) {
     std::cerr << "ERROR OCCURRED: " << e.what() << "\n";
     return EXIT_FAILURE;
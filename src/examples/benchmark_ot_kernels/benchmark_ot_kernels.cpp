@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// Compares the runtime dispatched kernels of the OT extension.  The first argument of each
+// benchmark is the SIMD level (0: SSE, 1: AVX2, 2: AVX512), levels which are not supported by
+// the CPU are skipped.
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "crypto/aes/aesni_primitives.h"
+#include "crypto/pseudo_random_generator.h"
+#include "utility/bit_matrix.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+#include "utility/cpu_features.h"
+
+namespace {
+
+bool set_level(benchmark::State& state) {
+  const auto level = static_cast<ENCRYPTO::SIMDLevel>(state.range(0));
+  if (level > ENCRYPTO::get_supported_simd_level()) {
+    state.SkipWithError("SIMD level not supported by this CPU");
+    return false;
+  }
+  ENCRYPTO::set_max_simd_level(level);
+  return true;
+}
+
+// number of columns of the OT extension matrix
+void simd_levels_and_sizes(benchmark::internal::Benchmark* b) {
+  for (int level = 0; level <= 2; ++level) {
+    for (int size : {1 << 10, 1 << 16, 1 << 20}) {
+      b->Args({level, size});
+    }
+  }
+}
+
+// number of blocks to hash
+void simd_levels_and_block_counts(benchmark::internal::Benchmark* b) {
+  for (int level = 0; level <= 2; ++level) {
+    for (int size : {1 << 5, 1 << 10, 1 << 15}) {
+      b->Args({level, size});
+    }
+  }
+}
+
+void set_random_key(ENCRYPTO::PRG& prg) {
+  const auto key = ENCRYPTO::block128_t::make_random();
+  prg.SetKey(key.data());
+}
+
+struct TransposeInput {
+  TransposeInput(std::size_t num_columns) : rows_(128) {
+    for (std::size_t i = 0; i < 128; ++i) {
+      rows_[i] = ENCRYPTO::AlignedBitVector::Random(num_columns);
+      ptrs_[i] = rows_[i].GetMutableData().data();
+      const_ptrs_[i] = ptrs_[i];
+    }
+  }
+  std::vector<ENCRYPTO::AlignedBitVector> rows_;
+  std::array<std::byte*, 128> ptrs_;
+  std::array<const std::byte*, 128> const_ptrs_;
+};
+
+}  // namespace
+
+static void BM_transpose_128_rows_inplace(benchmark::State& state) {
+  if (!set_level(state)) return;
+  const std::size_t num_columns = state.range(1);
+  TransposeInput input(num_columns);
+
+  for (auto _ : state) {
+    ENCRYPTO::BitMatrix::Transpose128RowsInplace(input.ptrs_, num_columns);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * 16 * num_columns);
+}
+BENCHMARK(BM_transpose_128_rows_inplace)->Apply(simd_levels_and_sizes);
+
+static void BM_sender_transpose_and_encrypt(benchmark::State& state) {
+  if (!set_level(state)) return;
+  const std::size_t num_columns = state.range(1);
+  TransposeInput input(num_columns);
+  ENCRYPTO::PRG prg;
+  set_random_key(prg);
+  const auto choices = ENCRYPTO::BitVector<>::Random(128);
+  const std::vector<std::size_t> bitlengths(num_columns, 128);
+  std::vector<ENCRYPTO::BitVector<>> y0(num_columns), y1(num_columns);
+
+  for (auto _ : state) {
+    ENCRYPTO::BitMatrix::SenderTransposeAndEncrypt(input.const_ptrs_, y0, y1, choices, prg,
+                                                   num_columns, bitlengths);
+    benchmark::ClobberMemory();
+  }
+  state.counters["ots_per_second"] =
+      benchmark::Counter(state.iterations() * num_columns, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_sender_transpose_and_encrypt)->Apply(simd_levels_and_sizes);
+
+static void BM_receiver_transpose_and_encrypt(benchmark::State& state) {
+  if (!set_level(state)) return;
+  const std::size_t num_columns = state.range(1);
+  TransposeInput input(num_columns);
+  ENCRYPTO::PRG prg;
+  set_random_key(prg);
+  const std::vector<std::size_t> bitlengths(num_columns, 128);
+  std::vector<ENCRYPTO::BitVector<>> out(num_columns);
+
+  for (auto _ : state) {
+    ENCRYPTO::BitMatrix::ReceiverTransposeAndEncrypt(input.const_ptrs_, out, prg, num_columns,
+                                                     bitlengths);
+    benchmark::ClobberMemory();
+  }
+  state.counters["ots_per_second"] =
+      benchmark::Counter(state.iterations() * num_columns, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_receiver_transpose_and_encrypt)->Apply(simd_levels_and_sizes);
+
+// baseline: one MMO^\pi invocation per block
+static void BM_mmo_single(benchmark::State& state) {
+  const std::size_t num_blocks = state.range(0);
+  ENCRYPTO::PRG prg;
+  set_random_key(prg);
+  auto blocks = ENCRYPTO::block128_vector::make_random(num_blocks);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+      prg.MMO(blocks[i].data());
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * 16 * num_blocks);
+}
+BENCHMARK(BM_mmo_single)->RangeMultiplier(1 << 5)->Range(1 << 5, 1 << 15);
+
+static void BM_mmo_batch(benchmark::State& state) {
+  if (!set_level(state)) return;
+  const std::size_t num_blocks = state.range(1);
+  ENCRYPTO::PRG prg;
+  set_random_key(prg);
+  auto blocks = ENCRYPTO::block128_vector::make_random(num_blocks);
+
+  for (auto _ : state) {
+    prg.MMO(blocks.data()->data(), num_blocks);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * 16 * num_blocks);
+}
+BENCHMARK(BM_mmo_batch)->Apply(simd_levels_and_block_counts);
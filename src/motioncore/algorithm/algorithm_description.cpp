@@ -24,9 +24,12 @@
 
 #include "algorithm_description.h"
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <regex>
 #include <sstream>
+#include <stdexcept>
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
@@ -410,5 +413,112 @@ AlgorithmDescription AlgorithmDescription::FromABY(std::ifstream& stream) {
     line_v.clear();
   }
   return algo;
-}  // namespace ENCRYPTO
 }
+
+WireSlotAllocation WireSlotAllocation::FromAlgorithmDescription(
+    const AlgorithmDescription& algo) {
+  constexpr auto unused = std::numeric_limits<std::size_t>::max();
+  const auto n_input_wires =
+      algo.n_input_wires_parent_a_ + algo.n_input_wires_parent_b_.value_or(0);
+  assert(algo.n_gates_ == algo.gates_.size());
+
+  // index of the last gate reading a wire, n_gates_ for the outputs
+  std::vector<std::size_t> last_use(algo.n_wires_, unused);
+  for (std::size_t gate_i = 0; gate_i < algo.n_gates_; ++gate_i) {
+    const auto& op = algo.gates_[gate_i];
+    last_use.at(op.parent_a_) = gate_i;
+    if (op.parent_b_.has_value()) {
+      last_use.at(*op.parent_b_) = gate_i;
+    }
+    if (op.selection_bit_.has_value()) {
+      last_use.at(*op.selection_bit_) = gate_i;
+    }
+  }
+  for (std::size_t wire_i = algo.n_wires_ - algo.n_output_wires_; wire_i < algo.n_wires_;
+       ++wire_i) {
+    last_use[wire_i] = algo.n_gates_;
+  }
+
+  WireSlotAllocation allocation;
+  allocation.wire_slots_.resize(algo.n_wires_, unused);
+  std::vector<std::size_t> free_slots;
+  const auto allocate = [&allocation, &free_slots](auto wire) {
+    if (free_slots.empty()) {
+      allocation.wire_slots_.at(wire) = allocation.n_slots_++;
+    } else {
+      allocation.wire_slots_.at(wire) = free_slots.back();
+      free_slots.pop_back();
+    }
+  };
+  const auto release = [&allocation, &free_slots, &last_use](auto wire, auto gate_i) {
+    if (last_use[wire] == gate_i) {
+      free_slots.push_back(allocation.wire_slots_[wire]);
+      // avoid releasing a wire twice if it is used for both inputs
+      last_use[wire] = unused - 1;
+    }
+  };
+
+  for (std::size_t wire_i = 0; wire_i < n_input_wires; ++wire_i) {
+    allocate(wire_i);
+  }
+  for (std::size_t wire_i = 0; wire_i < n_input_wires; ++wire_i) {
+    if (last_use[wire_i] == unused) {
+      free_slots.push_back(allocation.wire_slots_[wire_i]);
+    }
+  }
+  for (std::size_t gate_i = 0; gate_i < algo.n_gates_; ++gate_i) {
+    const auto& op = algo.gates_[gate_i];
+    allocate(op.output_wire_);
+    release(op.parent_a_, gate_i);
+    if (op.parent_b_.has_value()) {
+      release(*op.parent_b_, gate_i);
+    }
+    if (op.selection_bit_.has_value()) {
+      release(*op.selection_bit_, gate_i);
+    }
+    // outputs which are never read
+    if (last_use[op.output_wire_] == unused) {
+      free_slots.push_back(allocation.wire_slots_[op.output_wire_]);
+    }
+  }
+  return allocation;
+}
+
+CircuitLayers CircuitLayers::FromAlgorithmDescription(const AlgorithmDescription& algo) {
+  assert(algo.n_gates_ == algo.gates_.size());
+  // number of AND gates on the longest path from the inputs to a wire
+  std::vector<std::size_t> depth(algo.n_wires_, 0);
+  CircuitLayers circuit_layers;
+  const auto get_layer = [&circuit_layers](auto layer_i) -> Layer& {
+    if (circuit_layers.layers_.size() <= layer_i) {
+      circuit_layers.layers_.resize(layer_i + 1);
+    }
+    return circuit_layers.layers_[layer_i];
+  };
+  for (std::size_t gate_i = 0; gate_i < algo.n_gates_; ++gate_i) {
+    const auto& op = algo.gates_[gate_i];
+    auto input_depth = depth.at(op.parent_a_);
+    if (op.parent_b_.has_value()) {
+      input_depth = std::max(input_depth, depth.at(*op.parent_b_));
+    }
+    switch (op.type_) {
+      case PrimitiveOperationType::XOR:
+      case PrimitiveOperationType::INV:
+        depth.at(op.output_wire_) = input_depth;
+        get_layer(input_depth).linear_gates_.push_back(gate_i);
+        break;
+      case PrimitiveOperationType::AND:
+        // evaluated at the end of the layer in which its inputs are available
+        depth.at(op.output_wire_) = input_depth + 1;
+        get_layer(input_depth).and_gates_.push_back(gate_i);
+        ++circuit_layers.n_and_gates_;
+        break;
+      default:
+        throw std::invalid_argument(
+            fmt::format("CircuitLayers: unsupported operation {}", ToString(op.type_)));
+    }
+  }
+  return circuit_layers;
+}
+
+}  // namespace ENCRYPTO
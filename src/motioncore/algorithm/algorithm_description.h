@@ -64,4 +64,36 @@ struct AlgorithmDescription {
   std::vector<PrimitiveOperation> gates_;
 };
 
+// Maps the wires of an AlgorithmDescription to a small pool of reusable slots.
+// Two wires share a slot only if their lifetimes do not overlap, where the
+// input wires are alive from the beginning and the output wires (the last
+// n_output_wires_ wires) until the end.  An output of a gate never shares a
+// slot with one of the inputs of the same gate.
+struct WireSlotAllocation {
+  static WireSlotAllocation FromAlgorithmDescription(const AlgorithmDescription&);
+
+  std::size_t n_slots_{0};
+  std::vector<std::size_t> wire_slots_;
+};
+
+// Groups the gates of a Boolean AlgorithmDescription by multiplicative depth.
+// A layer consists of linear gates (XOR, INV), which only depend on the
+// previous layers and on linear gates of the same layer listed before them,
+// followed by AND gates, whose inputs are all computed once the linear gates
+// of the layer are evaluated.  Hence, all AND gates of a layer can be
+// evaluated together with a single round of communication.  Throws if the
+// circuit contains other gates.
+struct CircuitLayers {
+  struct Layer {
+    // indices into AlgorithmDescription::gates_
+    std::vector<std::size_t> linear_gates_;
+    std::vector<std::size_t> and_gates_;
+  };
+
+  static CircuitLayers FromAlgorithmDescription(const AlgorithmDescription&);
+
+  std::size_t n_and_gates_{0};
+  std::vector<Layer> layers_;
+};
+
 }
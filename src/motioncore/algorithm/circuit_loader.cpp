@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <exception>
 #include <filesystem>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <stdexcept>
@@ -390,4 +391,171 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gt_tensor_circuit(std:
   return load_tree_circuit(name, bit_size, num_inputs);
 }
 
+const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_argmax_circuit(std::size_t bit_size,
+                                                                         std::size_t num_inputs,
+                                                                         bool with_max,
+                                                                         bool depth_optimized) {
+  if (num_inputs < 2) {
+    throw std::logic_error("need at least two inputs to compute an argmax");
+  }
+  // the index is output with bit_size bits
+  if (bit_size < 64 && num_inputs > (std::size_t(1) << bit_size)) {
+    throw std::invalid_argument(
+        fmt::format("argmax over {} inputs needs more than {} bits for the index", num_inputs,
+                    bit_size));
+  }
+  const auto name = fmt::format("__circuit_loader_builtin__argmax_{}_bit_{}_inputs_{}_{}", bit_size,
+                                num_inputs, with_max ? "max" : "nomax",
+                                depth_optimized ? "depth" : "size");
+  auto it = algo_cache_.find(name);
+  if (it != std::end(algo_cache_)) {
+    return it->second;
+  }
+  const auto& gt_algo = load_gt_circuit(bit_size, depth_optimized);
+  const auto gt_wire = gt_algo.n_wires_ - 1;
+
+  std::vector<ENCRYPTO::PrimitiveOperation> gates;
+  std::size_t n_wires = bit_size * num_inputs;
+  const auto add_gate = [&gates, &n_wires](ENCRYPTO::PrimitiveOperationType type, std::size_t a,
+                                           std::optional<std::size_t> b = std::nullopt) {
+    gates.push_back(ENCRYPTO::PrimitiveOperation{
+        .type_ = type, .parent_a_ = a, .parent_b_ = b, .output_wire_ = n_wires});
+    return n_wires++;
+  };
+  const auto add_mux = [&add_gate](std::size_t x, std::size_t y, std::size_t choice) {
+    // choice ? x : y
+    const auto t = add_gate(ENCRYPTO::PrimitiveOperationType::XOR, x, y);
+    const auto u = add_gate(ENCRYPTO::PrimitiveOperationType::AND, t, choice);
+    return add_gate(ENCRYPTO::PrimitiveOperationType::XOR, y, u);
+  };
+
+  // A candidate is the winner of a subtree.  The index is relative to the
+  // first leaf of the subtree; its missing high bits are zero.
+  struct Candidate {
+    std::vector<std::size_t> value;
+    std::vector<std::size_t> index;
+  };
+  std::vector<Candidate> candidates(num_inputs);
+  for (std::size_t i = 0; i < num_inputs; ++i) {
+    candidates[i].value.resize(bit_size);
+    std::iota(std::begin(candidates[i].value), std::end(candidates[i].value), i * bit_size);
+  }
+
+  // Combine neighbours level by level, s.t. the left candidate of a pair
+  // always covers a full subtree of 2^level leaves.
+  while (candidates.size() > 1) {
+    const bool last_level = candidates.size() == 2;
+    std::vector<Candidate> next;
+    for (std::size_t i = 0; i + 1 < candidates.size(); i += 2) {
+      const auto& x = candidates[i];
+      const auto& y = candidates[i + 1];
+      assert(x.index.size() >= y.index.size());
+      // embed the comparison circuit, y_wins = y > x, s.t. ties go to x
+      std::vector<std::size_t> wire_map(gt_algo.n_wires_);
+      std::copy(std::begin(y.value), std::end(y.value), std::begin(wire_map));
+      std::copy(std::begin(x.value), std::end(x.value), std::begin(wire_map) + bit_size);
+      for (auto op : gt_algo.gates_) {
+        op.parent_a_ = wire_map.at(op.parent_a_);
+        if (op.parent_b_.has_value()) {
+          *op.parent_b_ = wire_map.at(*op.parent_b_);
+        }
+        wire_map.at(op.output_wire_) = n_wires;
+        op.output_wire_ = n_wires++;
+        gates.push_back(op);
+      }
+      const auto y_wins = wire_map.at(gt_wire);
+
+      Candidate winner;
+      if (!last_level || with_max) {
+        winner.value.resize(bit_size);
+        for (std::size_t bit_j = 0; bit_j < bit_size; ++bit_j) {
+          winner.value[bit_j] = add_mux(y.value[bit_j], x.value[bit_j], y_wins);
+        }
+      }
+      winner.index.resize(x.index.size() + 1);
+      for (std::size_t bit_j = 0; bit_j < x.index.size(); ++bit_j) {
+        if (bit_j < y.index.size()) {
+          winner.index[bit_j] = add_mux(y.index[bit_j], x.index[bit_j], y_wins);
+        } else {
+          // x_j & !y_wins
+          const auto t = add_gate(ENCRYPTO::PrimitiveOperationType::AND, x.index[bit_j], y_wins);
+          winner.index[bit_j] = add_gate(ENCRYPTO::PrimitiveOperationType::XOR, x.index[bit_j], t);
+        }
+      }
+      // y is in the upper half of the subtree
+      winner.index.back() = y_wins;
+      if (last_level) {
+        // outputs must not be read by other gates, use a copy
+        winner.index.back() = add_gate(ENCRYPTO::PrimitiveOperationType::INV,
+                                       add_gate(ENCRYPTO::PrimitiveOperationType::INV, y_wins));
+      }
+      next.push_back(std::move(winner));
+    }
+    if (candidates.size() % 2 == 1) {
+      next.push_back(std::move(candidates.back()));
+    }
+    candidates = std::move(next);
+  }
+  const auto& result = candidates.front();
+
+  // pad the index with zeros
+  std::vector<std::size_t> output_wires(result.index);
+  while (output_wires.size() < bit_size) {
+    output_wires.push_back(add_gate(ENCRYPTO::PrimitiveOperationType::XOR, 0, 0));
+  }
+  if (with_max) {
+    output_wires.insert(std::end(output_wires), std::begin(result.value), std::end(result.value));
+  }
+
+  // renumber the wires s.t. the outputs become the last wires
+  const auto n_input_wires = bit_size * num_inputs;
+  const auto n_output_wires = output_wires.size();
+  std::vector<std::size_t> renumbering(n_wires, n_wires);
+  for (std::size_t i = 0; i < n_output_wires; ++i) {
+    renumbering[output_wires[i]] = n_wires - n_output_wires + i;
+  }
+  for (std::size_t w = 0, next_wire = 0; w < n_wires; ++w) {
+    if (w < n_input_wires || renumbering[w] == n_wires) {
+      renumbering[w] = next_wire++;
+    }
+  }
+  for (auto& op : gates) {
+    op.parent_a_ = renumbering[op.parent_a_];
+    if (op.parent_b_.has_value()) {
+      *op.parent_b_ = renumbering[*op.parent_b_];
+    }
+    op.output_wire_ = renumbering[op.output_wire_];
+  }
+
+  ENCRYPTO::AlgorithmDescription algo{.n_output_wires_ = n_output_wires,
+                                      .n_input_wires_parent_a_ = n_input_wires,
+                                      .n_wires_ = n_wires,
+                                      .n_gates_ = gates.size(),
+                                      .n_input_wires_parent_b_ = std::nullopt,
+                                      .gates_ = std::move(gates)};
+  algo_cache_[name] = std::move(algo);
+  return algo_cache_[name];
+}
+
+const ENCRYPTO::WireSlotAllocation& CircuitLoader::get_wire_slot_allocation(
+    const ENCRYPTO::AlgorithmDescription& algo) {
+  std::scoped_lock lock(slot_allocation_cache_mutex_);
+  auto it = slot_allocation_cache_.find(&algo);
+  if (it != std::end(slot_allocation_cache_)) {
+    return it->second;
+  }
+  return slot_allocation_cache_[&algo] =
+             ENCRYPTO::WireSlotAllocation::FromAlgorithmDescription(algo);
+}
+
+const ENCRYPTO::CircuitLayers& CircuitLoader::get_circuit_layers(
+    const ENCRYPTO::AlgorithmDescription& algo) {
+  std::scoped_lock lock(circuit_layers_cache_mutex_);
+  auto it = circuit_layers_cache_.find(&algo);
+  if (it != std::end(circuit_layers_cache_)) {
+    return it->second;
+  }
+  return circuit_layers_cache_[&algo] = ENCRYPTO::CircuitLayers::FromAlgorithmDescription(algo);
+}
+
 }  // namespace MOTION
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <filesystem>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -57,10 +58,29 @@ class CircuitLoader {
   const ENCRYPTO::AlgorithmDescription& load_gt_tensor_circuit(std::size_t bit_size,
                                                              std::size_t num_inputs,
                                                              bool depth_optimized = false);
+  // Tournament over num_inputs values of bit_size bits each with depth
+  // log(num_inputs) comparisons.  Outputs the position of the first maximum
+  // as a bit_size bit integer, followed by the maximum itself if with_max is set.
+  const ENCRYPTO::AlgorithmDescription& load_argmax_circuit(std::size_t bit_size,
+                                                            std::size_t num_inputs,
+                                                            bool with_max,
+                                                            bool depth_optimized = false);
+
+  // Computed once per circuit and cached, may be called concurrently.  The
+  // circuit needs to be owned by this CircuitLoader.
+  const ENCRYPTO::WireSlotAllocation& get_wire_slot_allocation(
+      const ENCRYPTO::AlgorithmDescription&);
+  const ENCRYPTO::CircuitLayers& get_circuit_layers(const ENCRYPTO::AlgorithmDescription&);
 
  private:
   std::vector<std::filesystem::path> circuit_search_path_;
   std::unordered_map<std::string, ENCRYPTO::AlgorithmDescription> algo_cache_;
+  std::mutex slot_allocation_cache_mutex_;
+  std::unordered_map<const ENCRYPTO::AlgorithmDescription*, ENCRYPTO::WireSlotAllocation>
+      slot_allocation_cache_;
+  std::mutex circuit_layers_cache_mutex_;
+  std::unordered_map<const ENCRYPTO::AlgorithmDescription*, ENCRYPTO::CircuitLayers>
+      circuit_layers_cache_;
 };
 
 }  // namespace MOTION
@@ -26,8 +26,9 @@
 
 namespace MOTION {
 
-GateRegister::GateRegister()
-    : next_gate_id_(0),
+GateRegister::GateRegister(std::size_t first_gate_id)
+    : first_gate_id_(first_gate_id),
+      next_gate_id_(first_gate_id),
       num_gates_with_setup_(0),
       num_gates_with_online_(0),
       num_evaluated_setup_(0),
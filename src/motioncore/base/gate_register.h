@@ -35,20 +35,24 @@ class NewGate;
 
 class GateRegister : public ENCRYPTO::enable_wait_setup, public ENCRYPTO::enable_wait_online {
  public:
-  GateRegister();
+  // the gate ids start at first_gate_id, e.g., to continue the ids of a
+  // previous circuit which used the same randomness generators
+  GateRegister(std::size_t first_gate_id = 0);
   ~GateRegister();
   std::size_t get_next_gate_id() noexcept { return next_gate_id_++; }
   void register_gate(std::unique_ptr<NewGate>&& gate);
   void increment_gate_setup_counter() noexcept;
   void increment_gate_online_counter() noexcept;
 
-  std::size_t get_num_gates() const noexcept { return next_gate_id_; }
+  std::size_t get_num_gates() const noexcept { return next_gate_id_ - first_gate_id_; }
+  std::size_t get_first_free_gate_id() const noexcept { return next_gate_id_; }
   std::size_t get_num_gates_with_setup() const noexcept { return num_gates_with_setup_; }
   std::size_t get_num_gates_with_online() const noexcept { return num_gates_with_online_; }
   std::vector<std::unique_ptr<NewGate>>& get_gates() noexcept { return gates_; }
   const std::vector<std::unique_ptr<NewGate>>& get_gates() const noexcept { return gates_; }
 
  private:
+  std::size_t first_gate_id_;
   std::size_t next_gate_id_;
   std::size_t num_gates_with_setup_;
   std::size_t num_gates_with_online_;
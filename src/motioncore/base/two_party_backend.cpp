@@ -64,7 +64,8 @@ TwoPartyBackend::TwoPartyBackend(Communication::CommunicationLayer& comm_layer,
           std::make_unique<BaseOTProvider>(comm_layer_, &run_time_stats_.back(), logger_)),
       ot_manager_(std::make_unique<ENCRYPTO::ObliviousTransfer::OTProviderManager>(
           comm_layer_, *base_ot_provider_, *motion_base_provider_, &run_time_stats_.back(),
-          logger_)),
+          logger_, ENCRYPTO::ObliviousTransfer::OTExtensionType::IKNP,
+          ENCRYPTO::ObliviousTransfer::default_ot_extension_chunk_size, num_threads)),
       arithmetic_manager_(
           std::make_unique<ArithmeticProviderManager>(comm_layer_, *ot_manager_, logger_)),
       mt_provider_(std::make_unique<MTProviderFromOTs>(my_id_, comm_layer_.get_num_parties(), true,
@@ -126,6 +127,14 @@ void TwoPartyBackend::run_wo_broadcast() {
 
 }
 
+void TwoPartyBackend::run_interleaved() { gate_executor_->evaluate(run_time_stats_.back()); }
+
+void TwoPartyBackend::set_message_coalescing(std::chrono::microseconds window) {
+  beavy_provider_->set_message_coalescing(window);
+  gmw_provider_->set_message_coalescing(window);
+  yao_provider_->set_message_coalescing(window);
+}
+
 std::optional<MPCProtocol> TwoPartyBackend::convert_via(MPCProtocol src_proto,
                                                         MPCProtocol dst_proto) {
   if (src_proto == MPCProtocol::ArithmeticGMW && dst_proto == MPCProtocol::BooleanGMW) {
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 
@@ -79,6 +80,13 @@ class TwoPartyBackend : public CircuitBuilder {
   void run_preprocessing();
   void run();
   void run_wo_broadcast();
+  // Run setup and online phase of each gate as soon as possible instead of
+  // finishing the setup of all gates first.  Both parties need to use the same.
+  void run_interleaved();
+  // Coalesce the small gate messages sent within the given window into one
+  // message per party (see CommMixin::set_message_coalescing).  Needs to be
+  // called before the circuit is evaluated.
+  void set_message_coalescing(std::chrono::microseconds window);
 
   std::optional<MPCProtocol> convert_via(MPCProtocol src_proto, MPCProtocol dst_proto) override;
   GateFactory& get_gate_factory(MPCProtocol proto) override;
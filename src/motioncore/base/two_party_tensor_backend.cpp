@@ -31,6 +31,7 @@
 #include "base/gate_register.h"
 #include "communication/communication_layer.h"
 #include "crypto/arithmetic_provider.h"
+#include "crypto/base_ots/base_ot_cache.h"
 #include "crypto/base_ots/base_ot_provider.h"
 #include "crypto/motion_base_provider.h"
 #include "crypto/multiplication_triple/linalg_triple_provider.h"
@@ -49,57 +50,78 @@
 
 namespace MOTION {
 
-TwoPartyTensorBackend::TwoPartyTensorBackend(Communication::CommunicationLayer& comm_layer,
-                                             std::size_t num_threads,
-                                             bool sync_between_setup_and_online,
-                                             std::shared_ptr<Logger> logger, bool fake_triples)
+TwoPartyTensorBackend::TwoPartyTensorBackend(
+    Communication::CommunicationLayer& comm_layer, std::size_t num_threads,
+    bool sync_between_setup_and_online, std::shared_ptr<Logger> logger, bool fake_triples,
+    ENCRYPTO::ObliviousTransfer::OTExtensionType ot_extension_type)
     : comm_layer_(comm_layer),
       my_id_(comm_layer_.get_my_id()),
       logger_(logger),
-      gate_register_(std::make_unique<GateRegister>()),
-      gate_executor_(std::make_unique<TensorOpExecutor>(
-          *gate_register_, [this] { run_preprocessing(); }, sync_between_setup_and_online,
-          [this] { comm_layer_.sync(); }, num_threads, logger_)),
+      num_threads_(num_threads),
+      sync_between_setup_and_online_(sync_between_setup_and_online),
+      fake_triples_(fake_triples),
+      ot_extension_type_(ot_extension_type),
       circuit_loader_(std::make_unique<CircuitLoader>()),
       run_time_stats_(1),
-      motion_base_provider_(std::make_unique<Crypto::MotionBaseProvider>(comm_layer_, logger_)),
       base_ot_provider_(
-          std::make_unique<BaseOTProvider>(comm_layer_, &run_time_stats_.back(), logger_)),
-      ot_manager_(std::make_unique<ENCRYPTO::ObliviousTransfer::OTProviderManager>(
-          comm_layer_, *base_ot_provider_, *motion_base_provider_, &run_time_stats_.back(),
-          logger_)),
-      arithmetic_manager_(
-          std::make_unique<ArithmeticProviderManager>(comm_layer_, *ot_manager_, logger_)),
-      linalg_triple_provider_(fake_triples ? (std::dynamic_pointer_cast<LinAlgTripleProvider>(
-                                                 std::make_shared<FakeLinAlgTripleProvider>()))
-                                           : (std::dynamic_pointer_cast<LinAlgTripleProvider>(
-                                                 std::make_shared<LinAlgTriplesFromAP>(
-                                                     arithmetic_manager_->get_provider(1 - my_id_),
-                                                     ot_manager_->get_provider(1 - my_id_),
-                                                     run_time_stats_.back(), logger_)))),
-      mt_provider_(std::make_unique<MTProviderFromOTs>(my_id_, comm_layer_.get_num_parties(), true,
-                                                       *arithmetic_manager_, *ot_manager_,
-                                                       run_time_stats_.back(), logger_)),
-      sp_provider_(std::make_unique<SPProviderFromOTs>(ot_manager_->get_providers(), my_id_,
-                                                       run_time_stats_.back(), logger_)),
-      sb_provider_(std::make_unique<TwoPartySBProvider>(
-          comm_layer_, ot_manager_->get_provider(1 - my_id_), run_time_stats_.back(), logger_)),
-      beavy_provider_(std::make_unique<proto::beavy::BEAVYProvider>(
-          comm_layer_, *gate_register_, *circuit_loader_, *motion_base_provider_, *ot_manager_,
-          *arithmetic_manager_, logger_, fake_triples)),
-      gmw_provider_(std::make_unique<proto::gmw::GMWProvider>(
-          comm_layer_, *gate_register_, *circuit_loader_, *motion_base_provider_, *ot_manager_,
-          *arithmetic_manager_, *mt_provider_, *sp_provider_, *sb_provider_, logger_)),
-      yao_provider_(std::make_unique<proto::yao::YaoProvider>(
-          comm_layer_, *gate_register_, *circuit_loader_, *motion_base_provider_,
-          ot_manager_->get_provider(1 - my_id_), logger_)) {
+          std::make_unique<BaseOTProvider>(comm_layer_, &run_time_stats_.back(), logger_)) {
+  // these live as long as the backend, see reset
+  motion_base_provider_ = std::make_unique<Crypto::MotionBaseProvider>(comm_layer_, logger_);
+  ot_manager_ = std::make_unique<ENCRYPTO::ObliviousTransfer::OTProviderManager>(
+      comm_layer_, *base_ot_provider_, *motion_base_provider_, &run_time_stats_.back(), logger_,
+      ot_extension_type_, ENCRYPTO::ObliviousTransfer::default_ot_extension_chunk_size,
+      num_threads_);
+  create_providers();
+  comm_layer_.start();
+}
+
+void TwoPartyTensorBackend::create_providers(std::size_t first_gate_id) {
+  gate_register_ = std::make_unique<GateRegister>(first_gate_id);
+  gate_executor_ = std::make_unique<TensorOpExecutor>(
+      *gate_register_, [this] { run_preprocessing(); }, sync_between_setup_and_online_,
+      [this] { comm_layer_.sync(); }, num_threads_, logger_);
+  arithmetic_manager_ =
+      std::make_unique<ArithmeticProviderManager>(comm_layer_, *ot_manager_, logger_);
+  if (fake_triples_) {
+    linalg_triple_provider_ = std::make_shared<FakeLinAlgTripleProvider>();
+  } else if (linalg_triple_file_.has_value()) {
+    linalg_triple_provider_ =
+        std::make_shared<LinAlgTriplesFromFile>(*linalg_triple_file_, comm_layer_, logger_);
+  } else {
+    linalg_triple_provider_ = std::make_shared<LinAlgTriplesFromAP>(
+        arithmetic_manager_->get_provider(1 - my_id_), ot_manager_->get_provider(1 - my_id_),
+        run_time_stats_.back(), logger_);
+  }
+  mt_provider_ = std::make_unique<MTProviderFromOTs>(my_id_, comm_layer_.get_num_parties(), true,
+                                                     *arithmetic_manager_, *ot_manager_,
+                                                     run_time_stats_.back(), logger_);
+  sp_provider_ = std::make_unique<SPProviderFromOTs>(ot_manager_->get_providers(), my_id_,
+                                                     run_time_stats_.back(), logger_);
+  sb_provider_ = std::make_unique<TwoPartySBProvider>(
+      comm_layer_, ot_manager_->get_provider(1 - my_id_), run_time_stats_.back(), logger_);
+  beavy_provider_ = std::make_unique<proto::beavy::BEAVYProvider>(
+      comm_layer_, *gate_register_, *circuit_loader_, *motion_base_provider_, *ot_manager_,
+      *arithmetic_manager_, logger_, fake_triples_);
+  gmw_provider_ = std::make_unique<proto::gmw::GMWProvider>(
+      comm_layer_, *gate_register_, *circuit_loader_, *motion_base_provider_, *ot_manager_,
+      *arithmetic_manager_, *mt_provider_, *sp_provider_, *sb_provider_, logger_);
+  yao_provider_ = std::make_unique<proto::yao::YaoProvider>(
+      comm_layer_, *gate_register_, *circuit_loader_, *motion_base_provider_,
+      ot_manager_->get_provider(1 - my_id_), logger_);
   gmw_provider_->set_linalg_triple_provider(linalg_triple_provider_);
+  if (linalg_triple_file_.has_value()) {
+    // the BEAVY linear layers take their triples from the file as well
+    beavy_provider_->set_linalg_triple_provider(linalg_triple_provider_);
+  }
+  if (message_coalescing_window_.count() > 0) {
+    set_message_coalescing(message_coalescing_window_);
+  }
+  tensor_op_factories_.clear();
   tensor_op_factories_.emplace(MPCProtocol::ArithmeticBEAVY, *beavy_provider_);
   tensor_op_factories_.emplace(MPCProtocol::BooleanBEAVY, *beavy_provider_);
   tensor_op_factories_.emplace(MPCProtocol::ArithmeticGMW, *gmw_provider_);
   tensor_op_factories_.emplace(MPCProtocol::BooleanGMW, *gmw_provider_);
   tensor_op_factories_.emplace(MPCProtocol::Yao, *yao_provider_);
-  comm_layer_.start();
 }
 
 TwoPartyTensorBackend::~TwoPartyTensorBackend() = default;
@@ -108,7 +130,7 @@ void TwoPartyTensorBackend::run_preprocessing() {
   run_time_stats_.back().record_start<Statistics::RunTimeStats::StatID::preprocessing>();
 
   motion_base_provider_->setup();
-  base_ot_provider_->ComputeBaseOTs();
+  run_base_ots();
   mt_provider_->PreSetup();
   sp_provider_->PreSetup();
   sb_provider_->PreSetup();
@@ -124,10 +146,101 @@ void TwoPartyTensorBackend::run_preprocessing() {
   run_time_stats_.back().record_end<Statistics::RunTimeStats::StatID::preprocessing>();
 }
 
+void TwoPartyTensorBackend::run_base_ots() {
+  if (base_ot_cache_) {
+    // the fixed AES key is jointly chosen at random for every circuit, so it
+    // identifies the session
+    base_ot_provider_->ComputeBaseOTs(*base_ot_cache_, motion_base_provider_->get_aes_fixed_key());
+  } else {
+    base_ot_provider_->ComputeBaseOTs();
+  }
+}
+
 void TwoPartyTensorBackend::run() {
   gate_executor_->evaluate_setup_online(run_time_stats_.back());
 }
 
+void TwoPartyTensorBackend::run_pipelined() { gate_executor_->evaluate(run_time_stats_.back()); }
+
+void TwoPartyTensorBackend::reset() {
+  // all messages belonging to the previous circuit have been delivered after this
+  comm_layer_.sync();
+
+  // the providers deregister their message handlers on destruction, so tear
+  // them down in reverse order of their creation
+  tensor_op_factories_.clear();
+  yao_provider_.reset();
+  gmw_provider_.reset();
+  beavy_provider_.reset();
+  sb_provider_.reset();
+  sp_provider_.reset();
+  mt_provider_.reset();
+  linalg_triple_provider_.reset();
+  arithmetic_manager_.reset();
+  gate_executor_.reset();
+  // the randomness of the MotionBaseProvider is derived from the gate ids, so
+  // they must not be reused with the same seeds
+  const auto first_gate_id = gate_register_->get_first_free_gate_id();
+  gate_register_.reset();
+  // keep the OT extension and the pooled OTs, only the OTs of the previous
+  // circuit are discarded
+  ot_manager_->reset();
+
+  run_time_stats_.back() = Statistics::RunTimeStats();
+  create_providers(first_gate_id);
+
+  // the other party has installed its message handlers for the new circuit
+  comm_layer_.sync();
+}
+
+void TwoPartyTensorBackend::set_ot_pool_size(std::size_t num_ots) {
+  ot_manager_->set_pool_size(num_ots);
+}
+
+void TwoPartyTensorBackend::set_base_ot_cache(const std::filesystem::path& directory) {
+  base_ot_cache_ = std::make_unique<BaseOTCache>(directory);
+}
+
+void TwoPartyTensorBackend::generate_linalg_triples(const LinAlgTripleRequirements& requirements,
+                                                    const std::filesystem::path& path) {
+  LinAlgTriplesFromAP triple_provider(arithmetic_manager_->get_provider(1 - my_id_),
+                                      ot_manager_->get_provider(1 - my_id_),
+                                      run_time_stats_.back(), logger_);
+  triple_provider.register_for_requirements(requirements);
+
+  run_time_stats_.back().record_start<Statistics::RunTimeStats::StatID::preprocessing>();
+  motion_base_provider_->setup();
+  run_base_ots();
+  ot_manager_->run_setup();
+  triple_provider.setup();
+  run_time_stats_.back().record_end<Statistics::RunTimeStats::StatID::preprocessing>();
+
+  // the fixed AES key is jointly chosen at random, so it identifies the batch
+  triple_provider.save_triples(path, motion_base_provider_->get_aes_fixed_key());
+
+  // discard the used OTs and start over with fresh providers
+  const auto run_time_stats = run_time_stats_.back();
+  reset();
+  run_time_stats_.back() = run_time_stats;
+}
+
+void TwoPartyTensorBackend::set_message_coalescing(std::chrono::microseconds window) {
+  message_coalescing_window_ = window;
+  beavy_provider_->set_message_coalescing(window);
+  gmw_provider_->set_message_coalescing(window);
+  yao_provider_->set_message_coalescing(window);
+}
+
+void TwoPartyTensorBackend::use_linalg_triples_from_file(const std::filesystem::path& path) {
+  linalg_triple_file_ = path;
+  // release the previous provider first, it might be registered for the same messages
+  gmw_provider_->set_linalg_triple_provider(nullptr);
+  linalg_triple_provider_.reset();
+  linalg_triple_provider_ = std::make_shared<LinAlgTriplesFromFile>(path, comm_layer_, logger_);
+  gmw_provider_->set_linalg_triple_provider(linalg_triple_provider_);
+  beavy_provider_->set_linalg_triple_provider(linalg_triple_provider_);
+}
+
 tensor::TensorOpFactory& TwoPartyTensorBackend::get_tensor_op_factory(MPCProtocol proto) {
   try {
     return tensor_op_factories_.at(proto);
@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <chrono>
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -30,15 +33,18 @@
 
 namespace ENCRYPTO::ObliviousTransfer {
 class OTProviderManager;
+enum class OTExtensionType : unsigned int;
 }
 
 namespace MOTION {
 
 class ArithmeticProviderManager;
+class BaseOTCache;
 class BaseOTProvider;
 class CircuitLoader;
 class GateRegister;
 class LinAlgTripleProvider;
+struct LinAlgTripleRequirements;
 class Logger;
 class MTProvider;
 class TensorOpExecutor;
@@ -78,11 +84,48 @@ class TwoPartyTensorBackend : public tensor::NetworkBuilder {
  public:
   TwoPartyTensorBackend(Communication::CommunicationLayer&, std::size_t num_threads,
                         bool sync_between_setup_and_online, std::shared_ptr<Logger>,
-                        bool fake_triples = false);
+                        bool fake_triples = false,
+                        // IKNP if not specified
+                        ENCRYPTO::ObliviousTransfer::OTExtensionType ot_extension_type = {});
   virtual ~TwoPartyTensorBackend();
 
   virtual void run_preprocessing();
   void run();
+  // Like run, but the online phase of a gate starts as soon as the setup of
+  // the gates up to it is done, while the setup of the following gates is
+  // still running (see TensorOpExecutor::evaluate).
+  void run_pipelined();
+  // Discard the circuit which has been built and evaluated so far and prepare
+  // the backend for a new one.  The communication layer, the loaded circuits,
+  // the base OTs, the seeds and the OT extension with its pool of OTs are kept,
+  // so a long-running session only pays for them once.  The gate ids continue
+  // after those of the discarded circuit.  Both parties need to call this at
+  // the same point.
+  void reset();
+  // Extend num_ots OTs per direction in addition to the ones needed by the
+  // circuit.  They are kept across reset, s.t. the following circuits take
+  // their OTs from this pool instead of running the OT extension again.  Both
+  // parties need to use the same value.
+  void set_ot_pool_size(std::size_t num_ots);
+  // Keep the base OTs in the given directory and reuse them in later runs.
+  // Each run derives fresh seeds for the OT extension from the stored base
+  // OTs.  Needs to be called before the preprocessing is run.
+  void set_base_ot_cache(const std::filesystem::path& directory);
+  // Generate the linear algebra triples needed by a model in advance and write
+  // them to a file.  This runs the preprocessing for these triples only, so
+  // it is called instead of building a circuit.  Both parties need to call it
+  // at the same point.
+  void generate_linalg_triples(const LinAlgTripleRequirements&, const std::filesystem::path&);
+  // Take the linear algebra triples of all following circuits from a file
+  // written by generate_linalg_triples, i.e., they are not computed in the
+  // preprocessing anymore.  This covers the GMW tensor triples and the setup
+  // of the BEAVY GEMM, Dense and Conv2D gates.  Consumed triples are marked in
+  // the file and never used again.
+  void use_linalg_triples_from_file(const std::filesystem::path&);
+  // Coalesce the small gate messages sent within the given window into one
+  // message per party (see CommMixin::set_message_coalescing).  A zero window
+  // disables it.  Applies to the current and all following circuits.
+  void set_message_coalescing(std::chrono::microseconds window);
 
   tensor::TensorOpFactory& get_tensor_op_factory(MPCProtocol) override;
   std::optional<MPCProtocol> convert_via(MPCProtocol src_proto, MPCProtocol dst_proto) override;
@@ -93,6 +136,10 @@ class TwoPartyTensorBackend : public tensor::NetworkBuilder {
   Communication::CommunicationLayer& comm_layer_;
   std::size_t my_id_;
   std::shared_ptr<Logger> logger_;
+  std::size_t num_threads_;
+  bool sync_between_setup_and_online_;
+  bool fake_triples_;
+  ENCRYPTO::ObliviousTransfer::OTExtensionType ot_extension_type_;
   std::unique_ptr<GateRegister> gate_register_;
   std::unique_ptr<TensorOpExecutor> gate_executor_;
   std::unique_ptr<CircuitLoader> circuit_loader_;
@@ -102,6 +149,9 @@ class TwoPartyTensorBackend : public tensor::NetworkBuilder {
 
   std::unique_ptr<Crypto::MotionBaseProvider> motion_base_provider_;
   std::unique_ptr<BaseOTProvider> base_ot_provider_;
+  std::unique_ptr<BaseOTCache> base_ot_cache_;
+  std::optional<std::filesystem::path> linalg_triple_file_;
+  std::chrono::microseconds message_coalescing_window_{0};
   std::unique_ptr<ENCRYPTO::ObliviousTransfer::OTProviderManager> ot_manager_;
   std::unique_ptr<ArithmeticProviderManager> arithmetic_manager_;
   std::shared_ptr<LinAlgTripleProvider> linalg_triple_provider_;
@@ -112,6 +162,11 @@ class TwoPartyTensorBackend : public tensor::NetworkBuilder {
   std::unique_ptr<proto::beavy::BEAVYProvider> beavy_provider_;
   std::unique_ptr<proto::gmw::GMWProvider> gmw_provider_;
   std::unique_ptr<proto::yao::YaoProvider> yao_provider_;
+
+ private:
+  // create everything which is specific to a single circuit
+  void create_providers(std::size_t first_gate_id = 0);
+  void run_base_ots();
 };
 
 }  // namespace MOTION
@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "buffer_pool.h"
+
+#include <algorithm>
+
+namespace MOTION::Communication {
+
+BufferPool::BufferPool(std::size_t max_retained_bytes, std::size_t max_buffer_size)
+    : max_retained_bytes_(max_retained_bytes), max_buffer_size_(max_buffer_size) {}
+
+std::vector<std::uint8_t> BufferPool::acquire(std::size_t size) {
+  std::vector<std::uint8_t> buffer;
+  {
+    std::scoped_lock lock(mutex_);
+    // take the smallest buffer which is large enough, but not much larger
+    const auto max_capacity = std::max(size, std::size_t(1)) * max_slack_factor;
+    auto it = std::end(free_buffers_);
+    for (auto jt = std::begin(free_buffers_); jt != std::end(free_buffers_); ++jt) {
+      if (jt->capacity() >= size && jt->capacity() <= max_capacity &&
+          (it == std::end(free_buffers_) || jt->capacity() < it->capacity())) {
+        it = jt;
+      }
+    }
+    if (it != std::end(free_buffers_)) {
+      num_retained_bytes_ -= it->capacity();
+      std::swap(*it, free_buffers_.back());
+      buffer = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+      ++num_reuses_;
+    } else {
+      ++num_allocations_;
+    }
+  }
+  buffer.resize(size);
+  return buffer;
+}
+
+void BufferPool::release(std::vector<std::uint8_t>&& buffer) {
+  if (buffer.capacity() == 0 || buffer.capacity() > max_buffer_size_) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  if (num_retained_bytes_ + buffer.capacity() <= max_retained_bytes_) {
+    num_retained_bytes_ += buffer.capacity();
+    free_buffers_.emplace_back(std::move(buffer));
+  }
+}
+
+std::size_t BufferPool::get_num_allocations() const {
+  std::scoped_lock lock(mutex_);
+  return num_allocations_;
+}
+
+std::size_t BufferPool::get_num_reuses() const {
+  std::scoped_lock lock(mutex_);
+  return num_reuses_;
+}
+
+std::size_t BufferPool::get_num_retained_bytes() const {
+  std::scoped_lock lock(mutex_);
+  return num_retained_bytes_;
+}
+
+ReceivedPayload::ReceivedPayload(std::vector<std::uint8_t>&& message, const std::uint8_t* payload,
+                                 std::size_t payload_size, std::shared_ptr<BufferPool> pool)
+    : message_(std::move(message)),
+      payload_(payload),
+      payload_size_(payload_size),
+      pool_(std::move(pool)) {
+  // moving a vector keeps its storage, so payload still points into message_
+}
+
+ReceivedPayload::ReceivedPayload(ReceivedPayload&& other) noexcept
+    : message_(std::move(other.message_)),
+      payload_(other.payload_),
+      payload_size_(other.payload_size_),
+      pool_(std::move(other.pool_)) {
+  other.payload_ = nullptr;
+  other.payload_size_ = 0;
+}
+
+ReceivedPayload::~ReceivedPayload() { release(); }
+
+ReceivedPayload& ReceivedPayload::operator=(ReceivedPayload&& other) noexcept {
+  if (this != &other) {
+    release();
+    message_ = std::move(other.message_);
+    payload_ = other.payload_;
+    payload_size_ = other.payload_size_;
+    pool_ = std::move(other.pool_);
+    other.payload_ = nullptr;
+    other.payload_size_ = 0;
+  }
+  return *this;
+}
+
+void ReceivedPayload::release() noexcept {
+  if (pool_) {
+    pool_->release(std::move(message_));
+    pool_ = nullptr;
+  }
+  message_ = {};
+  payload_ = nullptr;
+  payload_size_ = 0;
+}
+
+}  // namespace MOTION::Communication
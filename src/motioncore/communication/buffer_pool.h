@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MOTION::Communication {
+
+// Pool of receive buffers
+//
+// Transports take the buffers for incoming messages from the pool instead of
+// allocating a fresh vector per message.  Message handlers hand the buffers
+// back once the message has been consumed, s.t. their memory (which is
+// already mapped) can be used for the next message.
+class BufferPool {
+ public:
+  // Keeps idle buffers of at most max_buffer_size bytes each and at most
+  // max_retained_bytes bytes in total.  The default buffer size covers the
+  // share messages of large tensors, e.g., 2^21 64-bit shares.
+  BufferPool(std::size_t max_retained_bytes = std::size_t(1) << 26,
+             std::size_t max_buffer_size = std::size_t(1) << 24);
+
+  // Return a buffer of the given size.  The content of the buffer is unspecified.
+  // A free buffer is only reused if its capacity is at most max_slack_factor
+  // times the size, s.t. small messages do not pin large buffers.
+  std::vector<std::uint8_t> acquire(std::size_t size);
+
+  // Give a buffer back to the pool.
+  void release(std::vector<std::uint8_t>&& buffer);
+
+  std::size_t get_num_allocations() const;
+  std::size_t get_num_reuses() const;
+  // total capacity of the idle buffers
+  std::size_t get_num_retained_bytes() const;
+
+  static constexpr std::size_t max_slack_factor = 2;
+
+ private:
+  const std::size_t max_retained_bytes_;
+  const std::size_t max_buffer_size_;
+  mutable std::mutex mutex_;
+  std::vector<std::vector<std::uint8_t>> free_buffers_;
+  std::size_t num_retained_bytes_ = 0;
+  std::size_t num_allocations_ = 0;
+  std::size_t num_reuses_ = 0;
+};
+
+// Payload of a received message
+//
+// Owns the buffer holding the complete message and points to the payload
+// inside of it, s.t. receivers can read the payload without copying it out of
+// the message.  The buffer is returned to its pool on destruction.
+class ReceivedPayload {
+ public:
+  ReceivedPayload() = default;
+  ReceivedPayload(std::vector<std::uint8_t>&& message, const std::uint8_t* payload,
+                  std::size_t payload_size, std::shared_ptr<BufferPool> pool = nullptr);
+  ReceivedPayload(const ReceivedPayload&) = delete;
+  ReceivedPayload(ReceivedPayload&& other) noexcept;
+  ~ReceivedPayload();
+  ReceivedPayload& operator=(const ReceivedPayload&) = delete;
+  ReceivedPayload& operator=(ReceivedPayload&& other) noexcept;
+
+  const std::uint8_t* data() const noexcept { return payload_; }
+  std::size_t size() const noexcept { return payload_size_; }
+
+  // interpret the payload as an array of T (check is_aligned_for<T>() first)
+  template <typename T>
+  const T* data_as() const noexcept {
+    assert(is_aligned_for<T>());
+    return reinterpret_cast<const T*>(payload_);
+  }
+  // like data_as<T>(), but copy the payload into buffer if it is not aligned for T
+  template <typename T>
+  const T* data_as(std::vector<T>& buffer) const {
+    if (is_aligned_for<T>()) {
+      return data_as<T>();
+    }
+    buffer.resize(size_as<T>());
+    std::memcpy(buffer.data(), payload_, buffer.size() * sizeof(T));
+    return buffer.data();
+  }
+  template <typename T>
+  std::size_t size_as() const noexcept {
+    return payload_size_ / sizeof(T);
+  }
+  // check whether data_as<T>() may be dereferenced
+  template <typename T>
+  bool is_aligned_for() const noexcept {
+    return reinterpret_cast<std::uintptr_t>(payload_) % alignof(T) == 0;
+  }
+
+ private:
+  void release() noexcept;
+
+  std::vector<std::uint8_t> message_;
+  const std::uint8_t* payload_ = nullptr;
+  std::size_t payload_size_ = 0;
+  std::shared_ptr<BufferPool> pool_;
+};
+
+}  // namespace MOTION::Communication
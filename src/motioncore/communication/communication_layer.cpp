@@ -22,17 +22,25 @@
 
 #include "communication_layer.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <functional>
-#include <shared_mutex>
+#include <iterator>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <thread>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include <flatbuffers/flatbuffers.h>
 #include <fmt/format.h>
 
+#include "buffer_pool.h"
+#include "compressed_message.h"
 #include "dummy_transport.h"
 #include "message.h"
 #include "message_handler.h"
@@ -54,6 +62,8 @@ struct CommunicationLayer::CommunicationLayerImpl {
 
   // setup threads and data structures
   void initialize(std::size_t my_id, std::size_t num_parties);
+  // release deregistered handlers once no receive thread dispatches to them
+  void release_handlers(std::vector<std::shared_ptr<MessageHandler>>&& handlers);
   void send_termination_messages();
   void shutdown();
 
@@ -66,17 +76,46 @@ struct CommunicationLayer::CommunicationLayerImpl {
 
   std::vector<std::unique_ptr<Transport>> transports_;
 
+  // buffers for received messages, shared by all transports
+  std::shared_ptr<BufferPool> receive_buffer_pool_;
+
   // message type
   using message_t =
       std::variant<std::vector<std::uint8_t>, std::shared_ptr<const std::vector<std::uint8_t>>,
                    flatbuffers::DetachedBuffer>;
 
+  // compress the message if a codec is set for its type and it gets smaller
+  std::optional<flatbuffers::FlatBufferBuilder> compress_message(std::size_t party_id,
+                                                                 const message_t& message);
+  // replace a CompressedMessage by the message it contains
+  bool decompress_message(std::size_t party_id, std::vector<std::uint8_t>& raw_message);
+
   std::vector<ENCRYPTO::SynchronizedFiberQueue<message_t>> send_queues_;
   std::vector<std::thread> receive_threads_;
   std::vector<std::thread> send_threads_;
 
+  // Handlers indexed by message type which the receive threads look up without
+  // locking.  The dispatch epoch is odd while a receive thread is inside a
+  // handler, so that a handler is only released once no dispatch uses it
+  // anymore.  Handlers deregistered from within a dispatch of this party's
+  // receive thread are kept in deferred_releases_ until the dispatch returns;
+  // only that receive thread accesses the vector.
+  static constexpr std::size_t num_message_types = static_cast<std::size_t>(MessageType::MAX) + 1;
+  struct HandlerTable {
+    std::array<std::atomic<MessageHandler*>, num_message_types> handlers_{};
+    std::atomic<std::uint64_t> dispatch_epoch_ = 0;
+    std::vector<std::shared_ptr<MessageHandler>> deferred_releases_;
+  };
+  std::vector<HandlerTable> handler_tables_;
+
+  // codec for each message type
+  std::array<std::atomic<MessageCodec>, num_message_types> message_codecs_{};
+  // statistics on the compression, the other fields of these stay zero
+  std::vector<TransportStatistics> compression_statistics_;
+
+  // owns the registered handlers, only used when (de)registering handlers
   using MessageHandlerMap = std::unordered_map<MessageType, std::shared_ptr<MessageHandler>>;
-  std::shared_mutex message_handlers_mutex_;
+  std::mutex message_handlers_mutex_;
   std::vector<MessageHandlerMap> message_handlers_;
   std::vector<std::shared_ptr<MessageHandler>> fallback_message_handlers_;
 
@@ -92,7 +131,10 @@ CommunicationLayer::CommunicationLayerImpl::CommunicationLayerImpl(
       num_parties_(transports.size()),
       start_sfuture_(start_promise_.get_future().share()),
       transports_(std::move(transports)),
+      receive_buffer_pool_(std::make_shared<BufferPool>()),
       send_queues_(num_parties_),
+      handler_tables_(num_parties_),
+      compression_statistics_(num_parties_),
       message_handlers_(num_parties_),
       fallback_message_handlers_(num_parties_),
       sync_handler_(std::make_shared<SyncHandler>(my_id_, num_parties_, logger)),
@@ -103,6 +145,7 @@ CommunicationLayer::CommunicationLayerImpl::CommunicationLayerImpl(
       send_threads_.emplace_back();
       continue;
     }
+    transports_.at(party_id)->set_receive_buffer_pool(receive_buffer_pool_);
     receive_threads_.emplace_back([this, party_id] { receive_task(party_id); });
     send_threads_.emplace_back([this, party_id] { send_task(party_id); });
 
@@ -128,7 +171,9 @@ void CommunicationLayer::CommunicationLayerImpl::send_task(std::size_t party_id)
     }
     while (!tmp_queue->empty()) {
       auto& message = tmp_queue->front();
-      if (message.index() == 0) {
+      if (auto compressed = compress_message(party_id, message); compressed.has_value()) {
+        transport.send_message(compressed->GetBufferPointer(), compressed->GetSize());
+      } else if (message.index() == 0) {
         // std::vector<std::uint8_t>
         transport.send_message(std::get<0>(message));
       } else if (message.index() == 1) {
@@ -181,7 +226,7 @@ void CommunicationLayer::CommunicationLayerImpl::send_task(std::size_t party_id)
 
 void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_id) {
   auto& transport = *transports_.at(party_id);
-  auto& handler_map = message_handlers_.at(party_id);
+  auto& handler_table = handler_tables_.at(party_id);
 
   auto my_start_sfuture = start_sfuture_;
   my_start_sfuture.get();
@@ -224,6 +269,13 @@ void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_
     auto message = GetMessage(raw_message.data());
 
     auto message_type = message->message_type();
+    if (message_type == MessageType::CompressedMessage) {
+      if (!decompress_message(party_id, raw_message)) {
+        continue;
+      }
+      message = GetMessage(raw_message.data());
+      message_type = message->message_type();
+    }
     if constexpr (MOTION_DEBUG) {
       if (logger_) {
         logger_->LogDebug(fmt::format("received message of type {} from party {}",
@@ -238,11 +290,18 @@ void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_
       }
       break;
     }
-    std::shared_lock lock(message_handlers_mutex_);
-    auto it = handler_map.find(message_type);
-    if (it != handler_map.end()) {
-      it->second->received_message(party_id, std::move(raw_message));
-    } else {
+    auto type_index = static_cast<std::size_t>(message_type);
+    MessageHandler* handler = nullptr;
+    handler_table.dispatch_epoch_.fetch_add(1);
+    if (type_index < num_message_types) {
+      handler = handler_table.handlers_[type_index].load();
+    }
+    if (handler != nullptr) {
+      handler->received_message(party_id, std::move(raw_message));
+    }
+    handler_table.dispatch_epoch_.fetch_add(1, std::memory_order_release);
+    handler_table.deferred_releases_.clear();
+    if (handler == nullptr) {
       auto fbh = fallback_message_handlers_.at(party_id);
       if (fbh) {
         fbh->received_message(party_id, std::move(raw_message));
@@ -261,6 +320,102 @@ void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_
   }
 }
 
+std::optional<flatbuffers::FlatBufferBuilder>
+CommunicationLayer::CommunicationLayerImpl::compress_message(std::size_t party_id,
+                                                             const message_t& message) {
+  const std::uint8_t* raw_message = nullptr;
+  std::size_t message_size = 0;
+  if (message.index() == 0) {
+    raw_message = std::get<0>(message).data();
+    message_size = std::get<0>(message).size();
+  } else if (message.index() == 1) {
+    raw_message = std::get<1>(message)->data();
+    message_size = std::get<1>(message)->size();
+  } else if (message.index() == 2) {
+    raw_message = std::get<2>(message).data();
+    message_size = std::get<2>(message).size();
+  }
+  // the messages have been built by this party, so they are not verified
+  auto type_index = static_cast<std::size_t>(GetMessage(raw_message)->message_type());
+  if (type_index >= num_message_types) {
+    return std::nullopt;
+  }
+  auto codec = message_codecs_[type_index].load(std::memory_order_relaxed);
+  if (codec == MessageCodec::none) {
+    return std::nullopt;
+  }
+
+  auto& stats = compression_statistics_.at(party_id);
+  const auto start_time = std::chrono::steady_clock::now();
+  auto compressed = BuildCompressedMessage(codec, raw_message, message_size);
+  stats.compression_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start_time)
+                                   .count();
+  if (compressed.has_value()) {
+    stats.num_messages_compressed += 1;
+    stats.num_bytes_before_compression += message_size;
+    stats.num_bytes_after_compression += compressed->GetSize();
+  }
+  return compressed;
+}
+
+bool CommunicationLayer::CommunicationLayerImpl::decompress_message(
+    std::size_t party_id, std::vector<std::uint8_t>& raw_message) {
+  auto& stats = compression_statistics_.at(party_id);
+  const auto start_time = std::chrono::steady_clock::now();
+  auto decompressed_message = receive_buffer_pool_->acquire(0);
+  try {
+    DecompressMessage(*GetMessage(raw_message.data()), decompressed_message);
+  } catch (std::runtime_error& e) {
+    if (logger_) {
+      logger_->LogError(fmt::format("dropping message from party {}: {}", party_id, e.what()));
+    }
+    return false;
+  }
+  stats.decompression_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - start_time)
+                                     .count();
+  flatbuffers::Verifier verifier(decompressed_message.data(), decompressed_message.size());
+  if (!VerifyMessageBuffer(verifier)) {
+    if (logger_) {
+      logger_->LogError(
+          fmt::format("received corrupt message in CompressedMessage from party {}", party_id));
+    }
+    return false;
+  }
+  receive_buffer_pool_->release(std::move(raw_message));
+  raw_message = std::move(decompressed_message);
+  return true;
+}
+
+void CommunicationLayer::CommunicationLayerImpl::release_handlers(
+    std::vector<std::shared_ptr<MessageHandler>>&& handlers) {
+  std::optional<std::size_t> own_party_id;
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    if (receive_threads_.at(party_id).get_id() == std::this_thread::get_id()) {
+      // called from a handler, which must outlive its running dispatch
+      own_party_id = party_id;
+      continue;
+    }
+    const auto& dispatch_epoch = handler_tables_.at(party_id).dispatch_epoch_;
+    auto epoch = dispatch_epoch.load();
+    if (epoch % 2 == 0) {
+      continue;
+    }
+    while (dispatch_epoch.load(std::memory_order_acquire) == epoch) {
+      std::this_thread::yield();
+    }
+  }
+  if (own_party_id.has_value()) {
+    auto& deferred_releases = handler_tables_.at(*own_party_id).deferred_releases_;
+    std::move(std::begin(handlers), std::end(handlers), std::back_inserter(deferred_releases));
+  }
+  handlers.clear();
+}
+
 void CommunicationLayer::CommunicationLayerImpl::shutdown() {
   for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
     if (party_id == my_id_) {
@@ -426,9 +581,13 @@ void CommunicationLayer::register_message_handler(message_handler_f handler_fact
       continue;
     }
     auto& map = impl_->message_handlers_.at(party_id);
+    auto& handler_table = impl_->handler_tables_.at(party_id);
     auto handler = handler_factory(party_id);
     for (auto type : message_types) {
-      map.emplace(type, handler);
+      auto [it, inserted] = map.emplace(type, handler);
+      if (inserted) {
+        handler_table.handlers_.at(static_cast<std::size_t>(type)).store(handler.get());
+      }
       if constexpr (MOTION_DEBUG) {
         if (logger_) {
           logger_->LogDebug(fmt::format("registered handler for messages of type {} from party {}",
@@ -440,14 +599,22 @@ void CommunicationLayer::register_message_handler(message_handler_f handler_fact
 }
 
 void CommunicationLayer::deregister_message_handler(const std::vector<MessageType>& message_types) {
-  std::scoped_lock lock(impl_->message_handlers_mutex_);
+  std::unique_lock lock(impl_->message_handlers_mutex_);
+  std::vector<std::shared_ptr<MessageHandler>> removed_handlers;
   for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
     if (party_id == my_id_) {
       continue;
     }
     auto& map = impl_->message_handlers_.at(party_id);
+    auto& handler_table = impl_->handler_tables_.at(party_id);
     for (auto type : message_types) {
-      map.erase(type);
+      auto it = map.find(type);
+      if (it == map.end()) {
+        continue;
+      }
+      handler_table.handlers_.at(static_cast<std::size_t>(type)).store(nullptr);
+      removed_handlers.push_back(std::move(it->second));
+      map.erase(it);
       if constexpr (MOTION_DEBUG) {
         if (logger_) {
           logger_->LogDebug(
@@ -457,6 +624,12 @@ void CommunicationLayer::deregister_message_handler(const std::vector<MessageTyp
       }
     }
   }
+  // wait without the lock, since a running handler might (de)register handlers itself
+  lock.unlock();
+  if (!removed_handlers.empty()) {
+    // the receive threads might still be using the removed handlers
+    impl_->release_handlers(std::move(removed_handlers));
+  }
 }
 
 MessageHandler& CommunicationLayer::get_message_handler(std::size_t party_id,
@@ -508,6 +681,10 @@ void CommunicationLayer::shutdown() {
   is_shutdown_ = true;
 }
 
+std::shared_ptr<BufferPool> CommunicationLayer::get_receive_buffer_pool() const noexcept {
+  return impl_->receive_buffer_pool_;
+}
+
 std::vector<TransportStatistics> CommunicationLayer::get_transport_statistics() const noexcept {
   std::vector<TransportStatistics> stats;
   stats.reserve(num_parties_);
@@ -515,7 +692,13 @@ std::vector<TransportStatistics> CommunicationLayer::get_transport_statistics()
     if (party_id == my_id_) {
       continue;
     }
-    stats.emplace_back(impl_->transports_.at(party_id)->get_stats());
+    auto& party_stats = stats.emplace_back(impl_->transports_.at(party_id)->get_stats());
+    const auto& compression_stats = impl_->compression_statistics_.at(party_id);
+    party_stats.num_messages_compressed = compression_stats.num_messages_compressed;
+    party_stats.num_bytes_before_compression = compression_stats.num_bytes_before_compression;
+    party_stats.num_bytes_after_compression = compression_stats.num_bytes_after_compression;
+    party_stats.compression_time_ns = compression_stats.compression_time_ns;
+    party_stats.decompression_time_ns = compression_stats.decompression_time_ns;
   }
   return stats;
 }
@@ -526,9 +709,15 @@ void CommunicationLayer::reset_transport_statistics() noexcept {
       continue;
     }
     impl_->transports_.at(party_id)->reset_stats();
+    impl_->compression_statistics_.at(party_id) = TransportStatistics();
   }
 }
 
+void CommunicationLayer::set_message_codec(MessageType message_type, MessageCodec codec) {
+  impl_->message_codecs_.at(static_cast<std::size_t>(message_type))
+      .store(codec, std::memory_order_relaxed);
+}
+
 void CommunicationLayer::set_logger(std::shared_ptr<Logger> logger) {
   if (is_started_) {
     throw std::logic_error(
@@ -561,7 +750,7 @@ std::vector<std::unique_ptr<CommunicationLayer>> make_dummy_communication_layers
 }
 
 std::vector<std::unique_ptr<CommunicationLayer>> make_local_tcp_communication_layers(
-    std::size_t num_parties, bool ipv6) {
+    std::size_t num_parties, bool ipv6, std::size_t num_streams) {
   const auto localhost = ipv6 ? "::1" : "127.0.0.1";
   tcp_parties_config config;
   config.reserve(num_parties);
@@ -570,8 +759,8 @@ std::vector<std::unique_ptr<CommunicationLayer>> make_local_tcp_communication_la
   }
   std::vector<std::future<std::vector<std::unique_ptr<Transport>>>> futs;
   for (std::size_t party_id = 0; party_id < num_parties; ++party_id) {
-    futs.emplace_back(std::async(std::launch::async, [party_id, &config] {
-      TCPSetupHelper helper(party_id, config);
+    futs.emplace_back(std::async(std::launch::async, [party_id, num_streams, &config] {
+      TCPSetupHelper helper(party_id, config, num_streams);
       return helper.setup_connections();
     }));
   }
@@ -37,8 +37,10 @@ class Logger;
 
 namespace Communication {
 
+class BufferPool;
 class MessageHandler;
 struct TransportStatistics;
+enum class MessageCodec : std::uint8_t;
 
 // Central interface for all communication related functionality
 //
@@ -74,7 +76,8 @@ class CommunicationLayer {
   using message_handler_f = std::function<std::shared_ptr<MessageHandler>(std::size_t party_id)>;
   // Register message handlers for given types
   void register_message_handler(message_handler_f, const std::vector<MessageType>& message_types);
-  // Deregister any message handler registered for the given types
+  // Deregister any message handler registered for the given types.  Returns once no other
+  // receive thread dispatches to them; a handler may deregister itself while it is dispatching.
   void deregister_message_handler(const std::vector<MessageType>& message_types);
   // Return the message handler registered for the given type.
   // Throws if no handler was registered for this type.
@@ -87,6 +90,16 @@ class CommunicationLayer {
   // shutdown the communication layer
   void shutdown();
 
+  // Pool the buffers of received messages are taken from.  Message handlers
+  // can return buffers to it after they are done with a message.
+  std::shared_ptr<BufferPool> get_receive_buffer_pool() const noexcept;
+
+  // Compress the messages of the given type with the given codec before they
+  // are sent, e.g., MessageCodec::lz for structured data when bandwidth is
+  // scarce.  Messages which do not get smaller are sent as they are.  The
+  // receiving side decompresses any compressed message, whatever its codecs.
+  void set_message_codec(MessageType, MessageCodec);
+
   std::vector<TransportStatistics> get_transport_statistics() const noexcept;
   void reset_transport_statistics() noexcept;
 
@@ -107,9 +120,10 @@ class CommunicationLayer {
 std::vector<std::unique_ptr<CommunicationLayer>> make_dummy_communication_layers(
     std::size_t num_parties);
 
-// Create a set of communication layers connected by local TCP connections
+// Create a set of communication layers connected by local TCP connections,
+// using num_streams connections between each pair of parties
 std::vector<std::unique_ptr<CommunicationLayer>> make_local_tcp_communication_layers(
-    std::size_t num_parties, bool ipv6 = true);
+    std::size_t num_parties, bool ipv6 = true, std::size_t num_streams = 1);
 
 }  // namespace Communication
 }  // namespace MOTION
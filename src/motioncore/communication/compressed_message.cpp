@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "compressed_message.h"
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "fbs_headers/compressed_message_generated.h"
+#include "fbs_headers/message_generated.h"
+#include "message.h"
+
+namespace MOTION::Communication {
+
+std::optional<flatbuffers::FlatBufferBuilder> BuildCompressedMessage(MessageCodec codec,
+                                                                     const std::uint8_t* message,
+                                                                     std::size_t size) {
+  if (codec != MessageCodec::lz) {
+    return std::nullopt;
+  }
+  const auto compressed = lz_compress(message, size);
+  // the compressed message needs to save at least the additional framing
+  if (compressed.size() + 64 >= size) {
+    return std::nullopt;
+  }
+  flatbuffers::FlatBufferBuilder builder(compressed.size() + 64);
+  auto data = builder.CreateVector(compressed);
+  auto root = CreateCompressedMessage(builder, static_cast<std::uint8_t>(codec), size, data);
+  FinishCompressedMessageBuffer(builder, root);
+  return BuildMessage(MessageType::CompressedMessage, builder.GetBufferPointer(),
+                      builder.GetSize());
+}
+
+void DecompressMessage(const Message& message, std::vector<std::uint8_t>& output) {
+  const auto* payload = message.payload();
+  if (payload == nullptr) {
+    throw std::runtime_error("received CompressedMessage without payload");
+  }
+  {
+    flatbuffers::Verifier verifier(payload->data(), payload->size());
+    if (!VerifyCompressedMessageBuffer(verifier)) {
+      throw std::runtime_error("received malformed CompressedMessage");
+    }
+  }
+  const auto* compressed_message = GetCompressedMessage(payload->data());
+  const auto* data = compressed_message->data();
+  if (data == nullptr) {
+    throw std::runtime_error("received CompressedMessage without data");
+  }
+  const auto codec = static_cast<MessageCodec>(compressed_message->codec());
+  if (codec != MessageCodec::lz) {
+    throw std::runtime_error(fmt::format("received CompressedMessage with unknown codec {}",
+                                         compressed_message->codec()));
+  }
+  // every compressed byte expands to at most 255 bytes
+  const auto uncompressed_size = compressed_message->uncompressed_size();
+  if (uncompressed_size / 255 > data->size()) {
+    throw std::runtime_error("received CompressedMessage with invalid size");
+  }
+  output.resize(uncompressed_size);
+  lz_decompress(data->data(), data->size(), output.data(), output.size());
+}
+
+}  // namespace MOTION::Communication
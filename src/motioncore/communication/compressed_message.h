@@ -0,0 +1,50 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <flatbuffers/flatbuffers.h>
+
+#include "lz_codec.h"
+
+namespace MOTION::Communication {
+
+struct Message;
+
+// Compress a serialized Message with the given codec and wrap it into a
+// Message of type CompressedMessage.  Returns std::nullopt if this does not
+// make the message smaller.
+std::optional<flatbuffers::FlatBufferBuilder> BuildCompressedMessage(MessageCodec codec,
+                                                                     const std::uint8_t* message,
+                                                                     std::size_t size);
+
+// Decompress a Message of type CompressedMessage into output, which is resized
+// to the size of the original message.  Throws std::runtime_error if the
+// message is malformed.
+void DecompressMessage(const Message& message, std::vector<std::uint8_t>& output);
+
+}  // namespace MOTION::Communication
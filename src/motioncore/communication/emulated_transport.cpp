@@ -0,0 +1,217 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "emulated_transport.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace MOTION::Communication {
+
+NetworkProfile NetworkProfile::from_name(const std::string& name) {
+  using namespace std::chrono_literals;
+  if (name == "none") {
+    return {name, 0us, 0, 0us};
+  } else if (name == "lan") {
+    // 1 Gbit/s, 0.5 ms round trip time
+    return {name, 250us, 1'000'000'000, 0us};
+  } else if (name == "wan") {
+    // 100 Mbit/s, 100 ms round trip time
+    return {name, 50'000us, 100'000'000, 1'000us};
+  }
+  throw std::invalid_argument(fmt::format("unknown network profile: {}", name));
+}
+
+NetworkProfile NetworkProfile::parse(const std::string& description) {
+  std::vector<std::string> parts;
+  std::size_t begin = 0;
+  while (true) {
+    auto end = description.find(':', begin);
+    parts.push_back(description.substr(begin, end - begin));
+    if (end == std::string::npos) {
+      break;
+    }
+    begin = end + 1;
+  }
+  if (parts.size() == 1) {
+    return from_name(description);
+  }
+  if (parts.size() != 4 || parts.at(0).empty()) {
+    throw std::invalid_argument(fmt::format(
+        "invalid network profile '{}', expected name:latency_ms:bandwidth_mbit:jitter_ms",
+        description));
+  }
+  const auto to_us = [](double ms) {
+    return std::chrono::microseconds(static_cast<std::int64_t>(ms * 1000));
+  };
+  try {
+    const auto latency_ms = std::stod(parts.at(1));
+    const auto bandwidth_mbit = std::stod(parts.at(2));
+    const auto jitter_ms = std::stod(parts.at(3));
+    if (latency_ms < 0 || bandwidth_mbit < 0 || jitter_ms < 0) {
+      throw std::invalid_argument("negative value");
+    }
+    return {parts.at(0), to_us(latency_ms), static_cast<std::uint64_t>(bandwidth_mbit * 1e6),
+            to_us(jitter_ms)};
+  } catch (const std::exception& e) {
+    throw std::invalid_argument(
+        fmt::format("invalid network profile '{}': {}", description, e.what()));
+  }
+}
+
+EmulatedTransport::EmulatedTransport(std::unique_ptr<Transport> transport,
+                                     const NetworkProfile& profile, std::uint64_t seed)
+    : transport_(std::move(transport)),
+      profile_(profile),
+      jitter_rng_(seed),
+      link_free_time_(clock_type::now()),
+      last_delivery_time_(link_free_time_),
+      delivery_thread_([this] { delivery_loop(); }) {}
+
+EmulatedTransport::~EmulatedTransport() {
+  if (delivery_thread_.joinable()) {
+    shutdown_send();
+  }
+}
+
+void EmulatedTransport::send_message(std::vector<std::uint8_t>&& message) {
+  const auto message_size = message.size();
+  {
+    std::scoped_lock lock(mutex_);
+    if (send_closed_) {
+      throw std::logic_error("EmulatedTransport: send_message after shutdown_send");
+    }
+    const auto now = clock_type::now();
+    const auto start_time = std::max(now, link_free_time_);
+    link_free_time_ = start_time;
+    if (profile_.bandwidth != 0) {
+      link_free_time_ += std::chrono::nanoseconds(
+          static_cast<std::int64_t>(8e9 * message_size / profile_.bandwidth));
+    }
+    auto delivery_time = link_free_time_ + profile_.latency;
+    if (profile_.jitter.count() > 0) {
+      std::uniform_int_distribution<std::int64_t> dist(0, profile_.jitter.count());
+      delivery_time += std::chrono::microseconds(dist(jitter_rng_));
+    }
+    // keep the order of the messages
+    delivery_time = std::max(delivery_time, last_delivery_time_);
+    last_delivery_time_ = delivery_time;
+    pending_messages_.push_back({delivery_time, std::move(message)});
+  }
+  cv_.notify_one();
+  statistics_.num_messages_sent += 1;
+  statistics_.num_bytes_sent += message_size;
+}
+
+void EmulatedTransport::send_message(const std::vector<std::uint8_t>& message) {
+  send_message(std::vector<std::uint8_t>(message));
+}
+
+void EmulatedTransport::send_message(const std::uint8_t* message, std::size_t size) {
+  send_message(std::vector<std::uint8_t>(message, message + size));
+}
+
+void EmulatedTransport::delivery_loop() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return !pending_messages_.empty() || send_closed_; });
+    if (pending_messages_.empty()) {
+      // closed and everything is delivered
+      return;
+    }
+    const auto delivery_time = pending_messages_.front().delivery_time;
+    if (clock_type::now() < delivery_time) {
+      cv_.wait_until(lock, delivery_time);
+      continue;
+    }
+    auto message = std::move(pending_messages_.front().message);
+    pending_messages_.pop_front();
+    lock.unlock();
+    transport_->send_message(std::move(message));
+    lock.lock();
+  }
+}
+
+bool EmulatedTransport::available() const { return transport_->available(); }
+
+std::optional<std::vector<std::uint8_t>> EmulatedTransport::receive_message() {
+  // the CommunicationLayer sets the pool on this transport
+  if (!receive_buffer_pool_forwarded_ && receive_buffer_pool_) {
+    transport_->set_receive_buffer_pool(receive_buffer_pool_);
+    receive_buffer_pool_forwarded_ = true;
+  }
+  auto message_opt = transport_->receive_message();
+  if (message_opt.has_value()) {
+    statistics_.num_messages_received += 1;
+    statistics_.num_bytes_received += message_opt->size();
+  }
+  return message_opt;
+}
+
+void EmulatedTransport::shutdown_send() {
+  {
+    std::scoped_lock lock(mutex_);
+    send_closed_ = true;
+  }
+  cv_.notify_one();
+  // deliver all pending messages before the underlying transport is closed
+  if (delivery_thread_.joinable()) {
+    delivery_thread_.join();
+    transport_->shutdown_send();
+  }
+}
+
+void EmulatedTransport::shutdown() {
+  shutdown_send();
+  transport_->shutdown();
+}
+
+void EmulatedTransport::set_profile(const NetworkProfile& profile) {
+  std::scoped_lock lock(mutex_);
+  profile_ = profile;
+}
+
+NetworkProfile EmulatedTransport::get_profile() const {
+  std::scoped_lock lock(mutex_);
+  return profile_;
+}
+
+std::vector<EmulatedTransport*> emulate_network(std::vector<std::unique_ptr<Transport>>& transports,
+                                                const NetworkProfile& profile,
+                                                std::uint64_t seed) {
+  std::vector<EmulatedTransport*> emulated_transports;
+  for (std::size_t i = 0; i < transports.size(); ++i) {
+    if (transports.at(i) == nullptr) {
+      continue;
+    }
+    auto emulated_transport =
+        std::make_unique<EmulatedTransport>(std::move(transports.at(i)), profile, seed + i);
+    emulated_transports.push_back(emulated_transport.get());
+    transports.at(i) = std::move(emulated_transport);
+  }
+  return emulated_transports;
+}
+
+}  // namespace MOTION::Communication
@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "transport.h"
+
+namespace MOTION::Communication {
+
+// Characteristics of an emulated network link
+struct NetworkProfile {
+  std::string name;
+  // one-way delay added to every message
+  std::chrono::microseconds latency{0};
+  // link capacity in bits per second, 0 means unlimited
+  std::uint64_t bandwidth = 0;
+  // maximal additional delay, drawn uniformly for every message
+  std::chrono::microseconds jitter{0};
+
+  // predefined profiles: "none", "lan", "wan"
+  static NetworkProfile from_name(const std::string& name);
+  // either a predefined name or "name:latency_ms:bandwidth_mbit:jitter_ms"
+  static NetworkProfile parse(const std::string& description);
+};
+
+// Transport that delays the messages of another transport
+//
+// Outgoing messages are put on an emulated link: each message occupies the
+// link for size / bandwidth and arrives latency + jitter after it was
+// completely put on the link.  A delivery thread hands the message to the
+// underlying transport at this point in time.  Messages are never reordered,
+// i.e., jitter only delays a message up to the arrival of its successor.
+// Since both parties delay their outgoing messages, a connection between two
+// EmulatedTransports behaves like a symmetric link with the given profile.
+class EmulatedTransport : public Transport {
+ public:
+  EmulatedTransport(std::unique_ptr<Transport> transport, const NetworkProfile& profile,
+                    std::uint64_t seed = 0);
+  ~EmulatedTransport();
+
+  void send_message(std::vector<std::uint8_t>&& message) override;
+  void send_message(const std::vector<std::uint8_t>& message) override;
+  void send_message(const std::uint8_t* message, std::size_t size) override;
+
+  bool available() const override;
+  std::optional<std::vector<std::uint8_t>> receive_message() override;
+  void shutdown_send() override;
+  void shutdown() override;
+
+  // change the profile for all messages sent from now on
+  void set_profile(const NetworkProfile& profile);
+  NetworkProfile get_profile() const;
+
+ private:
+  using clock_type = std::chrono::steady_clock;
+  struct PendingMessage {
+    clock_type::time_point delivery_time;
+    std::vector<std::uint8_t> message;
+  };
+
+  void delivery_loop();
+
+  std::unique_ptr<Transport> transport_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<PendingMessage> pending_messages_;
+  NetworkProfile profile_;
+  std::mt19937_64 jitter_rng_;
+  // point in time at which the emulated link is free again
+  clock_type::time_point link_free_time_;
+  clock_type::time_point last_delivery_time_;
+  bool send_closed_ = false;
+  bool receive_buffer_pool_forwarded_ = false;
+  std::thread delivery_thread_;
+};
+
+// Wrap all transports of a party into EmulatedTransports with the given
+// profile.  Entries which are nullptr (i.e., the own party) are kept.  The
+// returned pointers allow to change the profile later on.
+std::vector<EmulatedTransport*> emulate_network(std::vector<std::unique_ptr<Transport>>& transports,
+                                                const NetworkProfile& profile,
+                                                std::uint64_t seed = 0);
+
+}  // namespace MOTION::Communication
@@ -0,0 +1,183 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "lz_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+// The compressed data is a sequence of blocks, each consisting of
+//  - a token byte with the number of literals in the upper and the match
+//    length minus min_match in the lower four bits (15 meaning that further
+//    length bytes follow, each 255 meaning that yet another one follows),
+//  - the additional literal length bytes and the literals,
+//  - the 2 byte offset of the match (little endian) and the additional match
+//    length bytes.
+// The last block ends after its literals and has no match.
+
+namespace {
+
+constexpr std::size_t min_match = 4;
+constexpr std::size_t max_offset = 0xffff;
+constexpr std::size_t hash_bits = 14;
+// after this many positions without a match, the search starts to skip bytes
+constexpr std::size_t skip_trigger_bits = 6;
+
+std::uint32_t read_u32(const std::uint8_t* ptr) {
+  std::uint32_t value;
+  std::memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+std::size_t hash(std::uint32_t value) { return (value * 2654435761u) >> (32 - hash_bits); }
+
+void write_length(std::vector<std::uint8_t>& output, std::size_t length) {
+  for (; length >= 255; length -= 255) {
+    output.push_back(255);
+  }
+  output.push_back(static_cast<std::uint8_t>(length));
+}
+
+void write_block(std::vector<std::uint8_t>& output, const std::uint8_t* literals,
+                 std::size_t num_literals, std::size_t offset, std::size_t match_length) {
+  const auto extra_match_length = match_length - min_match;
+  const auto token = static_cast<std::uint8_t>((std::min<std::size_t>(num_literals, 15) << 4) |
+                                               std::min<std::size_t>(extra_match_length, 15));
+  output.push_back(token);
+  if (num_literals >= 15) {
+    write_length(output, num_literals - 15);
+  }
+  output.insert(output.end(), literals, literals + num_literals);
+  output.push_back(static_cast<std::uint8_t>(offset));
+  output.push_back(static_cast<std::uint8_t>(offset >> 8));
+  if (extra_match_length >= 15) {
+    write_length(output, extra_match_length - 15);
+  }
+}
+
+void write_last_block(std::vector<std::uint8_t>& output, const std::uint8_t* literals,
+                      std::size_t num_literals) {
+  output.push_back(static_cast<std::uint8_t>(std::min<std::size_t>(num_literals, 15) << 4));
+  if (num_literals >= 15) {
+    write_length(output, num_literals - 15);
+  }
+  output.insert(output.end(), literals, literals + num_literals);
+}
+
+}  // namespace
+
+namespace MOTION::Communication {
+
+std::vector<std::uint8_t> lz_compress(const std::uint8_t* data, std::size_t size) {
+  std::vector<std::uint8_t> output;
+  output.reserve(size + size / 255 + 16);
+
+  // positions (+ 1) of the last occurrence of each hashed 4 byte sequence
+  std::vector<std::uint32_t> table(std::size_t(1) << hash_bits, 0);
+  std::size_t anchor = 0;
+  std::size_t pos = 0;
+  std::size_t skip_counter = std::size_t(1) << skip_trigger_bits;
+  while (pos + min_match <= size) {
+    const auto sequence = read_u32(data + pos);
+    auto& entry = table[hash(sequence)];
+    const std::size_t candidate = entry;
+    entry = static_cast<std::uint32_t>(pos + 1);
+    if (candidate == 0 || pos + 1 - candidate > max_offset ||
+        read_u32(data + candidate - 1) != sequence) {
+      pos += skip_counter++ >> skip_trigger_bits;
+      continue;
+    }
+    const auto match = candidate - 1;
+    auto match_length = min_match;
+    while (pos + match_length < size && data[match + match_length] == data[pos + match_length]) {
+      ++match_length;
+    }
+    write_block(output, data + anchor, pos - anchor, pos - match, match_length);
+    pos += match_length;
+    anchor = pos;
+    skip_counter = std::size_t(1) << skip_trigger_bits;
+  }
+  write_last_block(output, data + anchor, size - anchor);
+  return output;
+}
+
+void lz_decompress(const std::uint8_t* data, std::size_t size, std::uint8_t* output,
+                   std::size_t uncompressed_size) {
+  const auto malformed = [] { return std::runtime_error("malformed lz compressed data"); };
+  std::size_t in = 0;
+  std::size_t out = 0;
+  const auto read_length = [&](std::size_t length) {
+    if (length < 15) {
+      return length;
+    }
+    std::uint8_t byte;
+    do {
+      if (in == size) {
+        throw malformed();
+      }
+      byte = data[in++];
+      length += byte;
+    } while (byte == 255);
+    return length;
+  };
+
+  while (true) {
+    if (in == size) {
+      throw malformed();
+    }
+    const auto token = data[in++];
+    const auto num_literals = read_length(token >> 4);
+    if (num_literals > size - in || num_literals > uncompressed_size - out) {
+      throw malformed();
+    }
+    std::copy_n(data + in, num_literals, output + out);
+    in += num_literals;
+    out += num_literals;
+    if (in == size) {
+      // last block
+      break;
+    }
+    if (size - in < 2) {
+      throw malformed();
+    }
+    const std::size_t offset = data[in] | (std::size_t(data[in + 1]) << 8);
+    in += 2;
+    const auto match_length = read_length(token & 0xf) + min_match;
+    if (offset == 0 || offset > out || match_length > uncompressed_size - out) {
+      throw malformed();
+    }
+    // the match may overlap with its own output, so copy byte by byte
+    for (std::size_t i = 0; i < match_length; ++i, ++out) {
+      output[out] = output[out - offset];
+    }
+  }
+  if (out != uncompressed_size) {
+    throw std::runtime_error(fmt::format(
+        "lz compressed data has size {} while expecting {}", out, uncompressed_size));
+  }
+}
+
+}  // namespace MOTION::Communication
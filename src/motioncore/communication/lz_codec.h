@@ -0,0 +1,49 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MOTION::Communication {
+
+// Codecs the CommunicationLayer can compress messages with
+enum class MessageCodec : std::uint8_t {
+  none = 0,
+  // byte-oriented LZ77 codec in the style of LZ4: fast, and effective on
+  // structured data such as small integers or repeated values, but useless
+  // for pseudo-random data like masked shares or garbled tables
+  lz = 1,
+};
+
+// Compress size bytes of data.  The result may be larger than the input.
+std::vector<std::uint8_t> lz_compress(const std::uint8_t* data, std::size_t size);
+
+// Decompress the output of lz_compress into a buffer of exactly
+// uncompressed_size bytes.  Throws std::runtime_error on malformed input.
+void lz_decompress(const std::uint8_t* data, std::size_t size, std::uint8_t* output,
+                   std::size_t uncompressed_size);
+
+}  // namespace MOTION::Communication
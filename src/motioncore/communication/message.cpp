@@ -40,8 +40,16 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type, const uint8_t *payload,
                                                    std::size_t size) {
   assert(payload);
-  std::vector<std::uint8_t> buffer(payload, payload + size);
-  return BuildMessage(message_type, &buffer);
+  // write the payload directly into the builder instead of copying it into a
+  // temporary vector first
+  flatbuffers::FlatBufferBuilder builder(size + 36);
+  // align the payload to 16 bytes, s.t. receivers can read (nested) gate
+  // messages and the blocks therein in place
+  builder.ForceVectorAlignment(size, sizeof(uint8_t), 16);
+  auto payload_vector = builder.CreateVector(payload, size);
+  auto root = CreateMessage(builder, message_type, payload_vector);
+  FinishMessageBuffer(builder, root);
+  return builder;
 }
 
 using namespace std::string_literals;
@@ -76,6 +84,16 @@ std::string to_string(MessageType message_type) {
       return "MessageType::SharedBitsMask"s;
     case MessageType::SharedBitsReconstruct:
       return "MessageType::SharedBitsReconstruct"s;
+    case MessageType::BaseOTCacheCheck:
+      return "MessageType::BaseOTCacheCheck"s;
+    case MessageType::CompressedMessage:
+      return "MessageType::CompressedMessage"s;
+    case MessageType::OTExtensionSilentSender:
+      return "MessageType::OTExtensionSilentSender"s;
+    case MessageType::LinAlgTripleFileCheck:
+      return "MessageType::LinAlgTripleFileCheck"s;
+    case MessageType::OTExtensionSenderChunkAck:
+      return "MessageType::OTExtensionSenderChunkAck"s;
     default:
       return "Unknown MessageType => update to_string function"s;
   }
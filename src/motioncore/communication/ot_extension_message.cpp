@@ -63,4 +63,25 @@ flatbuffers::FlatBufferBuilder BuildOTExtensionMessageReceiverCorrections(const
                       builder.GetSize());
 }
 
+flatbuffers::FlatBufferBuilder BuildOTExtensionMessageSilentSender(const std::byte *buffer,
+                                                                   const std::size_t size,
+                                                                   const std::size_t i) {
+  flatbuffers::FlatBufferBuilder builder(size + 32);
+  std::vector<std::uint8_t> v_buffer(reinterpret_cast<const std::uint8_t *>(buffer),
+                                     reinterpret_cast<const std::uint8_t *>(buffer) + size);
+  auto root = CreateOTExtensionMessageDirect(builder, i, &v_buffer);
+  FinishOTExtensionMessageBuffer(builder, root);
+  return BuildMessage(MessageType::OTExtensionSilentSender, builder.GetBufferPointer(),
+                      builder.GetSize());
+}
+
+flatbuffers::FlatBufferBuilder BuildOTExtensionMessageSenderChunkAck(const std::size_t i) {
+  flatbuffers::FlatBufferBuilder builder(32);
+  std::vector<std::uint8_t> v_buffer;
+  auto root = CreateOTExtensionMessageDirect(builder, i, &v_buffer);
+  FinishOTExtensionMessageBuffer(builder, root);
+  return BuildMessage(MessageType::OTExtensionSenderChunkAck, builder.GetBufferPointer(),
+                      builder.GetSize());
+}
+
 }  // namespace MOTION::Communication
@@ -39,4 +39,12 @@ flatbuffers::FlatBufferBuilder BuildOTExtensionMessageReceiverMasks(const std::b
 flatbuffers::FlatBufferBuilder BuildOTExtensionMessageReceiverCorrections(const std::byte *buffer,
                                                                           const std::size_t size,
                                                                           const std::size_t i);
+
+flatbuffers::FlatBufferBuilder BuildOTExtensionMessageSilentSender(const std::byte *buffer,
+                                                                   const std::size_t size,
+                                                                   const std::size_t i);
+
+// acknowledges the masks of the i-th chunk of the bit matrix, s.t. the receiver
+// may send those of a further chunk
+flatbuffers::FlatBufferBuilder BuildOTExtensionMessageSenderChunkAck(const std::size_t i);
 }  // namespace MOTION::Communication
@@ -23,7 +23,11 @@
 #include "tcp_transport.h"
 
 #include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <future>
+#include <map>
+#include <mutex>
 #include <thread>
 #include <shared_mutex>
 
@@ -36,6 +40,9 @@
 #include <boost/system/error_code.hpp>
 #include <fmt/format.h>
 
+#include "utility/synchronized_queue.h"
+#include "utility/thread.h"
+
 using boost::asio::ip::tcp;
 
 namespace MOTION::Communication {
@@ -50,6 +57,61 @@ struct TCPTransportImpl {
   std::shared_mutex socket_mutex_;
 };
 
+// header in front of every chunk sent by a MultiStreamTCPTransport
+struct ChunkHeader {
+  std::uint64_t sequence_number_;
+  std::uint32_t message_size_;
+  std::uint32_t offset_;
+  std::uint32_t chunk_size_;
+  std::uint32_t reserved_;
+};
+static_assert(sizeof(ChunkHeader) == 24);
+
+struct MultiStreamTCPTransportImpl {
+  MultiStreamTCPTransportImpl(std::shared_ptr<boost::asio::io_context> io_context,
+                              std::vector<tcp::socket>&& sockets)
+      : io_context_(io_context), sockets_(std::move(sockets)), send_queues_(sockets_.size()) {}
+
+  // chunk waiting to be written; small messages are copied into data_, large
+  // ones are written from the caller's buffer which waits for the promise
+  struct SendJob {
+    ChunkHeader header_;
+    std::vector<std::uint8_t> data_;
+    const std::uint8_t* data_ptr_;
+    std::optional<std::promise<void>> written_;
+  };
+
+  // message whose chunks are received
+  struct PartialMessage {
+    std::vector<std::uint8_t> buffer_;
+    std::size_t missing_bytes_;
+  };
+
+  std::shared_ptr<boost::asio::io_context> io_context_;
+  std::vector<tcp::socket> sockets_;
+
+  std::vector<ENCRYPTO::SynchronizedQueue<SendJob>> send_queues_;
+  std::vector<std::thread> write_threads_;
+  std::uint64_t next_send_sequence_number_ = 0;
+  std::size_t next_stream_ = 0;
+  std::mutex send_error_mutex_;
+  std::string send_error_;
+
+  std::once_flag start_receiving_flag_;
+  std::vector<std::thread> read_threads_;
+  std::mutex receive_mutex_;
+  std::condition_variable receive_cv_;
+  std::map<std::uint64_t, PartialMessage> partial_messages_;
+  std::uint64_t next_receive_sequence_number_ = 0;
+  std::size_t num_closed_streams_ = 0;
+  std::string receive_error_;
+
+  bool next_message_complete() const {
+    auto it = partial_messages_.find(next_receive_sequence_number_);
+    return it != partial_messages_.end() && it->second.missing_bytes_ == 0;
+  }
+};
+
 }  // namespace detail
 
 TCPTransport::TCPTransport(std::unique_ptr<detail::TCPTransportImpl> impl)
@@ -140,7 +202,7 @@ std::optional<std::vector<std::uint8_t>> TCPTransport::receive_message() {
                                          ec.message(), ec.value()));
   }
   std::uint32_t message_size = u8tou32(message_size_buffer);
-  std::vector<std::uint8_t> message_buffer(message_size);
+  auto message_buffer = allocate_receive_buffer(message_size);
   boost::asio::read(impl_->socket_, boost::asio::buffer(message_buffer),
                     boost::asio::transfer_exactly(message_buffer.size()), ec);
   if (ec) {
@@ -152,26 +214,296 @@ std::optional<std::vector<std::uint8_t>> TCPTransport::receive_message() {
   return message_buffer;
 }
 
+MultiStreamTCPTransport::MultiStreamTCPTransport(
+    std::unique_ptr<detail::MultiStreamTCPTransportImpl> impl)
+    : impl_(std::move(impl)) {
+  for (std::size_t stream_id = 0; stream_id < impl_->sockets_.size(); ++stream_id) {
+    impl_->write_threads_.emplace_back([this, stream_id] { write_task(stream_id); });
+    ENCRYPTO::thread_set_name(impl_->write_threads_.back(), fmt::format("tcp-write-{}", stream_id));
+  }
+}
+
+MultiStreamTCPTransport::~MultiStreamTCPTransport() { shutdown(); }
+
+std::size_t MultiStreamTCPTransport::get_num_streams() const noexcept {
+  return impl_->sockets_.size();
+}
+
+void MultiStreamTCPTransport::write_task(std::size_t stream_id) {
+  auto& socket = impl_->sockets_.at(stream_id);
+  auto& queue = impl_->send_queues_.at(stream_id);
+  while (auto job = queue.dequeue()) {
+    const auto* data = job->data_ptr_ != nullptr ? job->data_ptr_ : job->data_.data();
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(&job->header_, sizeof(job->header_)),
+        boost::asio::buffer(data, job->header_.chunk_size_)};
+    boost::system::error_code ec;
+    boost::asio::write(socket, buffers, boost::asio::transfer_all(), ec);
+    if (ec) {
+      auto error = fmt::format("Error while writing to socket {}: {}", stream_id, ec.message());
+      if (job->written_.has_value()) {
+        job->written_->set_exception(std::make_exception_ptr(std::runtime_error(error)));
+      } else {
+        std::scoped_lock lock(impl_->send_error_mutex_);
+        impl_->send_error_ = std::move(error);
+      }
+      continue;
+    }
+    if (job->written_.has_value()) {
+      job->written_->set_value();
+    }
+  }
+}
+
+void MultiStreamTCPTransport::send_message(std::vector<std::uint8_t>&& message) {
+  send_message(message.data(), message.size());
+}
+
+void MultiStreamTCPTransport::send_message(const std::vector<std::uint8_t>& message) {
+  send_message(message.data(), message.size());
+}
+
+void MultiStreamTCPTransport::send_message(const std::uint8_t* message, std::size_t size) {
+  if (size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                         std::numeric_limits<std::uint32_t>::max(), size));
+  }
+  {
+    std::scoped_lock lock(impl_->send_error_mutex_);
+    if (!impl_->send_error_.empty()) {
+      throw std::runtime_error(impl_->send_error_);
+    }
+  }
+  const auto num_streams = impl_->sockets_.size();
+  const auto sequence_number = impl_->next_send_sequence_number_++;
+  detail::ChunkHeader header = {.sequence_number_ = sequence_number,
+                                .message_size_ = static_cast<std::uint32_t>(size),
+                                .offset_ = 0,
+                                .chunk_size_ = static_cast<std::uint32_t>(size),
+                                .reserved_ = 0};
+
+  if (size < stripe_threshold) {
+    // copy the message, s.t. the caller does not need to wait for the write
+    impl_->send_queues_.at(impl_->next_stream_)
+        .enqueue({header, std::vector<std::uint8_t>(message, message + size), nullptr,
+                  std::nullopt});
+    impl_->next_stream_ = (impl_->next_stream_ + 1) % num_streams;
+    statistics_.num_bytes_sent += size + sizeof(header);
+    statistics_.num_messages_sent += 1;
+    return;
+  }
+
+  // write one chunk to every connection and wait until all of them are sent
+  const auto chunk_size = (size + num_streams - 1) / num_streams;
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_streams);
+  for (std::size_t offset = 0; offset < size; offset += chunk_size) {
+    header.offset_ = static_cast<std::uint32_t>(offset);
+    header.chunk_size_ = static_cast<std::uint32_t>(std::min(chunk_size, size - offset));
+    std::promise<void> written;
+    futures.emplace_back(written.get_future());
+    impl_->send_queues_.at(impl_->next_stream_)
+        .enqueue({header, {}, message + offset, std::move(written)});
+    impl_->next_stream_ = (impl_->next_stream_ + 1) % num_streams;
+    statistics_.num_bytes_sent += sizeof(header);
+  }
+  // wait for all chunks before reporting an error, s.t. the buffer is not used anymore
+  std::exception_ptr error;
+  for (auto& f : futures) {
+    try {
+      f.get();
+    } catch (std::runtime_error&) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  statistics_.num_bytes_sent += size;
+  statistics_.num_messages_sent += 1;
+}
+
+void MultiStreamTCPTransport::start_receiving() {
+  std::call_once(impl_->start_receiving_flag_, [this] {
+    for (std::size_t stream_id = 0; stream_id < impl_->sockets_.size(); ++stream_id) {
+      impl_->read_threads_.emplace_back([this, stream_id] { read_task(stream_id); });
+      ENCRYPTO::thread_set_name(impl_->read_threads_.back(),
+                                fmt::format("tcp-read-{}", stream_id));
+    }
+  });
+}
+
+void MultiStreamTCPTransport::read_task(std::size_t stream_id) {
+  auto& socket = impl_->sockets_.at(stream_id);
+  const auto fail = [this](std::string error) {
+    std::scoped_lock lock(impl_->receive_mutex_);
+    if (impl_->receive_error_.empty()) {
+      impl_->receive_error_ = std::move(error);
+    }
+  };
+  while (true) {
+    detail::ChunkHeader header;
+    boost::system::error_code ec;
+    boost::asio::read(socket, boost::asio::buffer(&header, sizeof(header)),
+                      boost::asio::transfer_exactly(sizeof(header)), ec);
+    if (ec) {
+      if (ec.value() != boost::asio::error::misc_errors::eof) {
+        fail(fmt::format("Error while reading chunk header from socket {}: {} ({})", stream_id,
+                         ec.message(), ec.value()));
+      }
+      break;
+    }
+    if (std::size_t(header.offset_) + header.chunk_size_ > header.message_size_) {
+      fail(fmt::format("received chunk exceeding its message on socket {}", stream_id));
+      break;
+    }
+
+    std::uint8_t* chunk_data;
+    {
+      std::scoped_lock lock(impl_->receive_mutex_);
+      if (header.sequence_number_ < impl_->next_receive_sequence_number_) {
+        impl_->receive_error_ =
+            fmt::format("received chunk of completed message on socket {}", stream_id);
+        break;
+      }
+      auto [it, inserted] = impl_->partial_messages_.try_emplace(header.sequence_number_);
+      auto& partial_message = it->second;
+      if (inserted) {
+        partial_message.buffer_ = allocate_receive_buffer(header.message_size_);
+        partial_message.missing_bytes_ = header.message_size_;
+      } else if (partial_message.buffer_.size() != header.message_size_) {
+        impl_->receive_error_ =
+            fmt::format("received chunks of different sizes on socket {}", stream_id);
+        break;
+      }
+      chunk_data = partial_message.buffer_.data() + header.offset_;
+    }
+
+    // the chunks of a message cover disjoint parts of the buffer
+    boost::asio::read(socket, boost::asio::buffer(chunk_data, header.chunk_size_),
+                      boost::asio::transfer_exactly(header.chunk_size_), ec);
+    if (ec) {
+      fail(fmt::format("Error while reading chunk from socket {}: {} ({})", stream_id,
+                       ec.message(), ec.value()));
+      break;
+    }
+
+    bool complete;
+    {
+      std::scoped_lock lock(impl_->receive_mutex_);
+      auto& partial_message = impl_->partial_messages_.at(header.sequence_number_);
+      partial_message.missing_bytes_ -= header.chunk_size_;
+      complete = partial_message.missing_bytes_ == 0 &&
+                 header.sequence_number_ == impl_->next_receive_sequence_number_;
+    }
+    if (complete) {
+      impl_->receive_cv_.notify_all();
+    }
+  }
+  {
+    std::scoped_lock lock(impl_->receive_mutex_);
+    ++impl_->num_closed_streams_;
+  }
+  impl_->receive_cv_.notify_all();
+}
+
+bool MultiStreamTCPTransport::available() const {
+  const_cast<MultiStreamTCPTransport*>(this)->start_receiving();
+  std::scoped_lock lock(impl_->receive_mutex_);
+  return impl_->next_message_complete();
+}
+
+std::optional<std::vector<std::uint8_t>> MultiStreamTCPTransport::receive_message() {
+  start_receiving();
+  std::unique_lock lock(impl_->receive_mutex_);
+  impl_->receive_cv_.wait(lock, [this] {
+    return impl_->next_message_complete() || !impl_->receive_error_.empty() ||
+           impl_->num_closed_streams_ == impl_->sockets_.size();
+  });
+  if (!impl_->next_message_complete()) {
+    if (!impl_->receive_error_.empty()) {
+      throw std::runtime_error(impl_->receive_error_);
+    }
+    // all connections have been closed
+    return std::nullopt;
+  }
+  auto node = impl_->partial_messages_.extract(impl_->next_receive_sequence_number_);
+  ++impl_->next_receive_sequence_number_;
+  auto message = std::move(node.mapped().buffer_);
+  statistics_.num_bytes_received +=
+      message.size() + sizeof(detail::ChunkHeader) *
+                           (message.size() < stripe_threshold ? 1 : impl_->sockets_.size());
+  statistics_.num_messages_received += 1;
+  return message;
+}
+
+void MultiStreamTCPTransport::shutdown_send() {
+  for (auto& queue : impl_->send_queues_) {
+    queue.close();
+  }
+  for (auto& thread : impl_->write_threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  for (auto& socket : impl_->sockets_) {
+    boost::system::error_code ec;
+    socket.shutdown(tcp::socket::shutdown_send, ec);
+  }
+}
+
+void MultiStreamTCPTransport::shutdown() {
+  for (auto& queue : impl_->send_queues_) {
+    queue.close();
+  }
+  for (auto& thread : impl_->write_threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  for (auto& socket : impl_->sockets_) {
+    boost::system::error_code ec;
+    socket.shutdown(tcp::socket::shutdown_both, ec);
+  }
+  for (auto& thread : impl_->read_threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  for (auto& socket : impl_->sockets_) {
+    boost::system::error_code ec;
+    socket.close(ec);
+  }
+}
+
 using namespace std::chrono_literals;
 
 struct TCPSetupHelper::TCPSetupImpl {
-  [[nodiscard]] std::map<std::size_t, tcp::socket> accept_task();
-  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::string host,
-                                         std::uint16_t port);
+  [[nodiscard]] std::map<std::size_t, std::vector<tcp::socket>> accept_task();
+  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::size_t stream_id,
+                                         std::string host, std::uint16_t port);
+
+  // the connecting party sends this after its id to identify the connection
+  std::uint64_t make_stream_word(std::size_t stream_id) const {
+    return (static_cast<std::uint64_t>(num_streams_) << 32) | stream_id;
+  }
 
   std::size_t my_id_;
   std::size_t num_parties_;
+  std::size_t num_streams_;
   int num_connect_retries_ = 10;
   decltype(1s) retry_delay_ = 3s;
   boost::asio::ip::address bind_address_;
   std::uint16_t bind_port_;
   std::shared_ptr<boost::asio::io_context> io_context_;
-  std::map<std::size_t, tcp::socket> sockets_;
+  std::map<std::size_t, std::vector<tcp::socket>> sockets_;
 };
 
-TCPSetupHelper::TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config)
+TCPSetupHelper::TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config,
+                               std::size_t num_streams)
     : my_id_(my_id),
       num_parties_(parties_config.size()),
+      num_streams_(num_streams),
       parties_config_(parties_config),
       impl_(std::make_unique<TCPSetupImpl>()) {
   // check arguments
@@ -181,10 +513,15 @@ TCPSetupHelper::TCPSetupHelper(std::size_t my_id, const tcp_parties_config& part
   if (my_id_ >= num_parties_) {
     throw std::invalid_argument("specified invalid party id: my_id >= parties_config.size()");
   }
+  if (num_streams_ == 0 || num_streams_ > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::invalid_argument(
+        fmt::format("specified invalid number of streams: {}", num_streams_));
+  }
   boost::system::error_code ec;
   auto my_config = parties_config_[my_id_];
   impl_->my_id_ = my_id_;
   impl_->num_parties_ = num_parties_;
+  impl_->num_streams_ = num_streams_;
   impl_->bind_port_ = std::get<1>(my_config);
   impl_->bind_address_ = boost::asio::ip::make_address(std::get<0>(my_config), ec);
   if (ec) {
@@ -201,24 +538,31 @@ std::vector<std::unique_ptr<Transport>> TCPSetupHelper::setup_connections() {
   std::vector<std::future<tcp::socket>> futs;
   for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
     auto party_config = parties_config_.at(party_id);
-    futs.emplace_back(std::async(std::launch::async, [this, party_id, party_config] {
-      return impl_->connect_task(party_id, std::get<0>(party_config), std::get<1>(party_config));
-    }));
+    for (std::size_t stream_id = 0; stream_id < num_streams_; ++stream_id) {
+      futs.emplace_back(std::async(std::launch::async, [this, party_id, stream_id, party_config] {
+        return impl_->connect_task(party_id, stream_id, std::get<0>(party_config),
+                                   std::get<1>(party_config));
+      }));
+    }
   }
   try {
     impl_->sockets_ = accept_fut.get();
     for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
-      impl_->sockets_.emplace(party_id, futs.at(party_id).get());
+      auto& sockets = impl_->sockets_[party_id];
+      for (std::size_t stream_id = 0; stream_id < num_streams_; ++stream_id) {
+        sockets.emplace_back(futs.at(party_id * num_streams_ + stream_id).get());
+      }
     }
   } catch (std::runtime_error& e) {
     // an error happened => close all other sockets
     std::for_each(std::begin(impl_->sockets_), std::end(impl_->sockets_), [](auto& it) {
-      auto& socket = it.second;
-      if (socket.is_open()) {
-        boost::system::error_code ec;
-        socket.shutdown(tcp::socket::shutdown_type::shutdown_both, ec);
-        socket.close(ec);
-        // socket is closed even if error occures
+      for (auto& socket : it.second) {
+        if (socket.is_open()) {
+          boost::system::error_code ec;
+          socket.shutdown(tcp::socket::shutdown_type::shutdown_both, ec);
+          socket.close(ec);
+          // socket is closed even if error occures
+        }
       }
     });
     throw;
@@ -226,20 +570,26 @@ std::vector<std::unique_ptr<Transport>> TCPSetupHelper::setup_connections() {
 
   std::vector<std::unique_ptr<Transport>> result(num_parties_);
   std::for_each(std::begin(impl_->sockets_), std::end(impl_->sockets_), [this, &result](auto& it) {
-    auto transport_impl =
-        std::make_unique<detail::TCPTransportImpl>(impl_->io_context_, std::move(it.second));
-    result.at(it.first) = std::make_unique<TCPTransport>(std::move(transport_impl));
+    if (num_streams_ == 1) {
+      auto transport_impl = std::make_unique<detail::TCPTransportImpl>(
+          impl_->io_context_, std::move(it.second.front()));
+      result.at(it.first) = std::make_unique<TCPTransport>(std::move(transport_impl));
+    } else {
+      auto transport_impl = std::make_unique<detail::MultiStreamTCPTransportImpl>(
+          impl_->io_context_, std::move(it.second));
+      result.at(it.first) = std::make_unique<MultiStreamTCPTransport>(std::move(transport_impl));
+    }
   });
   return result;
 }
 
-std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
+std::map<std::size_t, std::vector<tcp::socket>> TCPSetupHelper::TCPSetupImpl::accept_task() {
   if (my_id_ == num_parties_ - 1) {
     return {};
   }
-  std::map<std::size_t, tcp::socket> sockets;
+  std::map<std::size_t, std::vector<std::optional<tcp::socket>>> accepted_sockets;
   std::size_t num_accepted = 0;
-  std::size_t expected_connections = num_parties_ - my_id_ - 1;
+  std::size_t expected_connections = (num_parties_ - my_id_ - 1) * num_streams_;
   boost::system::error_code ec;
   tcp::acceptor acceptor(*io_context_, tcp::endpoint(bind_address_, bind_port_),
                          /* reuse_addr = */ true);
@@ -270,8 +620,26 @@ std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
       socket.close();
       continue;
     }
-    // check if we are already connected to this party
-    if (auto it = sockets.find(static_cast<std::size_t>(other_id)); it != sockets.end()) {
+    // receive the index of this connection and the number of connections
+    std::size_t stream_id;
+    {
+      std::uint64_t stream_word;
+      boost::asio::read(socket, boost::asio::mutable_buffer(&stream_word, sizeof(stream_word)),
+                        ec);
+      if (ec) {
+        socket.close();
+        continue;
+      }
+      if ((stream_word >> 32) != num_streams_) {
+        throw std::runtime_error(fmt::format("party {} uses {} connections, expected {}\n",
+                                             other_id, stream_word >> 32, num_streams_));
+      }
+      stream_id = static_cast<std::size_t>(stream_word & 0xffffffff);
+    }
+    // check if we are already connected to this party with this stream
+    auto& party_sockets = accepted_sockets[other_id];
+    party_sockets.resize(num_streams_);
+    if (stream_id >= num_streams_ || party_sockets.at(stream_id).has_value()) {
       socket.close();
       continue;
     }
@@ -285,13 +653,21 @@ std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
       }
     }
     // success
-    sockets.emplace(std::make_pair(other_id, std::move(socket)));
+    party_sockets.at(stream_id).emplace(std::move(socket));
     ++num_accepted;
   }
+  std::map<std::size_t, std::vector<tcp::socket>> sockets;
+  for (auto& [other_id, party_sockets] : accepted_sockets) {
+    auto& result = sockets[other_id];
+    for (auto& socket : party_sockets) {
+      result.emplace_back(std::move(*socket));
+    }
+  }
   return sockets;
 }
 
-tcp::socket TCPSetupHelper::TCPSetupImpl::connect_task(std::size_t other_id, std::string host,
+tcp::socket TCPSetupHelper::TCPSetupImpl::connect_task(std::size_t other_id,
+                                                       std::size_t stream_id, std::string host,
                                                        std::uint16_t port) {
   boost::system::error_code ec;
   tcp::socket socket(*io_context_);
@@ -308,10 +684,11 @@ tcp::socket TCPSetupHelper::TCPSetupImpl::connect_task(std::size_t other_id, std
       continue;
     }
 
-    // send my id to the peer
+    // send my id and the index of this connection to the peer
     {
-      std::uint64_t own_id = static_cast<std::uint64_t>(my_id_);
-      boost::asio::write(socket, boost::asio::const_buffer(&own_id, sizeof(own_id)), ec);
+      std::array<std::uint64_t, 2> own_id = {static_cast<std::uint64_t>(my_id_),
+                                             make_stream_word(stream_id)};
+      boost::asio::write(socket, boost::asio::const_buffer(own_id.data(), sizeof(own_id)), ec);
       if (ec) {
         socket.close();
         continue;
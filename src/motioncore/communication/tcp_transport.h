@@ -33,6 +33,7 @@ namespace MOTION::Communication {
 
 namespace detail {
 struct TCPTransportImpl;
+struct MultiStreamTCPTransportImpl;
 }
 
 class TCPTransport : public Transport {
@@ -57,6 +58,45 @@ class TCPTransport : public Transport {
   std::unique_ptr<detail::TCPTransportImpl> impl_;
 };
 
+// Transport over several TCP connections to the same party
+//
+// A single TCP flow cannot saturate fast links, and large messages would block
+// all following ones.  Every message is therefore sent as one or more chunks,
+// each prefixed by (sequence number, message size, offset, chunk size).
+// Messages of at least stripe_threshold bytes are split into one chunk per
+// connection which are written concurrently, smaller messages are distributed
+// over the connections in round robin.  The receiving side reassembles the
+// chunks and returns the messages in the order in which they were sent.
+class MultiStreamTCPTransport : public Transport {
+ public:
+  static constexpr std::size_t stripe_threshold = std::size_t(1) << 18;
+
+  MultiStreamTCPTransport(std::unique_ptr<detail::MultiStreamTCPTransportImpl> impl);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~MultiStreamTCPTransport();
+
+  void send_message(std::vector<std::uint8_t>&& message) override;
+  void send_message(const std::vector<std::uint8_t>& message) override;
+  void send_message(const std::uint8_t* message, std::size_t size) override;
+
+  bool available() const override;
+  std::optional<std::vector<std::uint8_t>> receive_message() override;
+  void shutdown_send() override;
+  void shutdown() override;
+
+  std::size_t get_num_streams() const noexcept;
+
+ private:
+  // start the threads reading from the connections, done lazily s.t. the
+  // receive buffer pool is set before the first message is received
+  void start_receiving();
+  void read_task(std::size_t stream_id);
+  void write_task(std::size_t stream_id);
+
+  std::unique_ptr<detail::MultiStreamTCPTransportImpl> impl_;
+};
+
 using tcp_connection_config = std::pair<std::string, std::uint16_t>;
 using tcp_parties_config = std::vector<tcp_connection_config>;
 
@@ -65,9 +105,14 @@ using tcp_parties_config = std::vector<tcp_connection_config>;
 // for all parties, connections are created as follows: This party tries to
 // connect to all parties with smaller IDs, and it accepts connections from the
 // parties with larger IDs.
+//
+// With num_streams > 1, num_streams connections are opened to every party and
+// combined into a MultiStreamTCPTransport.  All parties need to use the same
+// number of streams.
 class TCPSetupHelper {
  public:
-  TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config);
+  TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config,
+                 std::size_t num_streams = 1);
 
   // Destructor needs to be defined in implementation due to pimpl
   ~TCPSetupHelper();
@@ -81,6 +126,7 @@ class TCPSetupHelper {
 
   std::size_t my_id_;
   std::size_t num_parties_;
+  std::size_t num_streams_;
   bool connections_open = false;
   const tcp_parties_config parties_config_;
   std::unique_ptr<TCPSetupImpl> impl_;
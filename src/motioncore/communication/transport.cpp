@@ -22,6 +22,8 @@
 
 #include "transport.h"
 
+#include "buffer_pool.h"
+
 namespace MOTION::Communication {
 
 const TransportStatistics& Transport::get_stats() const { return statistics_; }
@@ -33,4 +35,15 @@ void Transport::reset_stats() {
   statistics_.num_bytes_received = 0;
 }
 
+void Transport::set_receive_buffer_pool(std::shared_ptr<BufferPool> pool) {
+  receive_buffer_pool_ = std::move(pool);
+}
+
+std::vector<std::uint8_t> Transport::allocate_receive_buffer(std::size_t size) {
+  if (receive_buffer_pool_) {
+    return receive_buffer_pool_->acquire(size);
+  }
+  return std::vector<std::uint8_t>(size);
+}
+
 }  // namespace MOTION::Communication
@@ -23,17 +23,26 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <vector>
 
 namespace MOTION::Communication {
 
+class BufferPool;
+
 struct TransportStatistics {
   std::size_t num_messages_sent = 0;
   std::size_t num_messages_received = 0;
   std::size_t num_bytes_sent = 0;
   std::size_t num_bytes_received = 0;
+  // messages compressed by the CommunicationLayer before they were sent
+  std::size_t num_messages_compressed = 0;
+  std::size_t num_bytes_before_compression = 0;
+  std::size_t num_bytes_after_compression = 0;
+  std::size_t compression_time_ns = 0;
+  std::size_t decompression_time_ns = 0;
 };
 
 // underlying transport between two parties
@@ -67,8 +76,15 @@ class Transport {
   const TransportStatistics& get_stats() const;
   void reset_stats();
 
+  // take the buffers for received messages from the given pool
+  void set_receive_buffer_pool(std::shared_ptr<BufferPool> pool);
+
  protected:
+  // allocate a buffer for a received message of the given size
+  std::vector<std::uint8_t> allocate_receive_buffer(std::size_t size);
+
   TransportStatistics statistics_;
+  std::shared_ptr<BufferPool> receive_buffer_pool_;
 };
 
 }  // namespace MOTION::Communication
@@ -298,6 +298,106 @@ void aesni_mmo_single(const void* round_keys_in, void* input) {
   _mm_storeu_si128(input_ptr, wb_1);
 }
 
+void aesni_mmo_batch(const void* round_keys_in, void* input, std::size_t num_blocks) {
+  constexpr std::size_t width = 8;
+  auto input_ptr = reinterpret_cast<__m128i*>(input);
+  auto round_keys =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_in, aes_block_size));
+
+  std::size_t i = 0;
+  for (; i + width <= num_blocks; i += width) {
+    __m128i x[width];
+    __m128i wb[width];
+    for (std::size_t j = 0; j < width; ++j) {
+      x[j] = _mm_loadu_si128(input_ptr + i + j);
+      wb[j] = _mm_xor_si128(x[j], round_keys[0]);
+    }
+    // the independent AES instructions of each round can be executed in parallel
+    for (std::size_t r = 1; r < aes_num_round_keys_128 - 1; ++r) {
+      for (std::size_t j = 0; j < width; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[r]);
+    }
+    for (std::size_t j = 0; j < width; ++j) {
+      wb[j] = _mm_aesenclast_si128(wb[j], round_keys[10]);
+      _mm_storeu_si128(input_ptr + i + j, _mm_xor_si128(wb[j], x[j]));
+    }
+  }
+  for (; i < num_blocks; ++i) {
+    aesni_mmo_single(round_keys_in, input_ptr + i);
+  }
+}
+
+__attribute__((target("avx2,vaes"))) void vaes_mmo_batch_256(const void* round_keys_in,
+                                                               void* input,
+                                                               std::size_t num_blocks) {
+  // four registers of two blocks each
+  constexpr std::size_t width = 4;
+  auto input_ptr = reinterpret_cast<__m256i*>(input);
+  auto round_keys =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_in, aes_block_size));
+  __m256i round_keys_256[aes_num_round_keys_128];
+  for (std::size_t r = 0; r < aes_num_round_keys_128; ++r) {
+    round_keys_256[r] = _mm256_broadcastsi128_si256(round_keys[r]);
+  }
+
+  std::size_t i = 0;
+  for (; 2 * (i + width) <= num_blocks; i += width) {
+    __m256i x[width];
+    __m256i wb[width];
+    for (std::size_t j = 0; j < width; ++j) {
+      x[j] = _mm256_loadu_si256(input_ptr + i + j);
+      wb[j] = _mm256_xor_si256(x[j], round_keys_256[0]);
+    }
+    for (std::size_t r = 1; r < aes_num_round_keys_128 - 1; ++r) {
+      for (std::size_t j = 0; j < width; ++j) {
+        wb[j] = _mm256_aesenc_epi128(wb[j], round_keys_256[r]);
+      }
+    }
+    for (std::size_t j = 0; j < width; ++j) {
+      wb[j] = _mm256_aesenclast_epi128(wb[j], round_keys_256[10]);
+      _mm256_storeu_si256(input_ptr + i + j, _mm256_xor_si256(wb[j], x[j]));
+    }
+  }
+  // avoid the penalty for mixing with the legacy SSE instructions of the remainder
+  _mm256_zeroupper();
+  aesni_mmo_batch(round_keys_in, input_ptr + i, num_blocks - 2 * i);
+}
+
+__attribute__((target("avx512f,vaes"))) void vaes_mmo_batch_512(const void* round_keys_in,
+                                                                  void* input,
+                                                                  std::size_t num_blocks) {
+  // four registers of four blocks each
+  constexpr std::size_t width = 4;
+  auto input_ptr = reinterpret_cast<__m512i*>(input);
+  auto round_keys =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_in, aes_block_size));
+  __m512i round_keys_512[aes_num_round_keys_128];
+  for (std::size_t r = 0; r < aes_num_round_keys_128; ++r) {
+    round_keys_512[r] = _mm512_broadcast_i32x4(round_keys[r]);
+  }
+
+  std::size_t i = 0;
+  for (; 4 * (i + width) <= num_blocks; i += width) {
+    __m512i x[width];
+    __m512i wb[width];
+    for (std::size_t j = 0; j < width; ++j) {
+      x[j] = _mm512_loadu_si512(input_ptr + i + j);
+      wb[j] = _mm512_xor_si512(x[j], round_keys_512[0]);
+    }
+    for (std::size_t r = 1; r < aes_num_round_keys_128 - 1; ++r) {
+      for (std::size_t j = 0; j < width; ++j) {
+        wb[j] = _mm512_aesenc_epi128(wb[j], round_keys_512[r]);
+      }
+    }
+    for (std::size_t j = 0; j < width; ++j) {
+      wb[j] = _mm512_aesenclast_epi128(wb[j], round_keys_512[10]);
+      _mm512_storeu_si512(input_ptr + i + j, _mm512_xor_si512(wb[j], x[j]));
+    }
+  }
+  // avoid the penalty for mixing with the legacy SSE instructions of the remainder
+  _mm256_zeroupper();
+  aesni_mmo_batch(round_keys_in, input_ptr + i, num_blocks - 4 * i);
+}
+
 static __m128i aesni_mix_keys(__m128i key_a, __m128i key_b) {
   const __m128i modulus = _mm_set_epi32(0, 0, 0, 0x87);
   const __m128i msb_mask = _mm_set_epi32(0x80000000, 0, 0, 0);
@@ -66,6 +66,19 @@ void aesni_tmmo_batch_4(const void* round_keys, void* input, __uint128_t tweak);
 // * round_keys are 16B aligned
 void aesni_mmo_single(const void* round_keys, void* input);
 
+// Compute MMO^\pi on num_blocks blocks inplace with eight AES evaluations interleaved to hide
+// the latency of the AES instructions.
+//
+// * round_keys are 16B aligned
+void aesni_mmo_batch(const void* round_keys, void* input, std::size_t num_blocks);
+
+// Same as aesni_mmo_batch, but with VAES on 256 bit and 512 bit registers.
+//
+// * require VAES and AVX2 or AVX-512F, respectively, which need to be checked at runtime
+// * round_keys are 16B aligned
+void vaes_mmo_batch_256(const void* round_keys, void* input, std::size_t num_blocks);
+void vaes_mmo_batch_512(const void* round_keys, void* input, std::size_t num_blocks);
+
 // Compute the dual-key cipher A2/D1 by Bellare et al.
 // (https://eprint.iacr.org/2013/426).
 //
@@ -225,6 +225,55 @@ void IntegerMultiplicationSender<T>::compute_outputs() {
   }
 }
 
+template <typename T>
+void IntegerMultiplicationSender<T>::set_inputs_repeated(const T* inputs,
+                                                         std::size_t num_repetitions) {
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<T>;
+  if (num_repetitions == 0 || batch_size_ % num_repetitions != 0) {
+    throw std::invalid_argument("batch size is not a multiple of the number of repetitions");
+  }
+  const auto num_inputs = batch_size_ / num_repetitions;
+
+  // shifted copies of the inputs, computed once for all repetitions
+  std::vector<T> shifted_inputs(num_inputs * bit_size * vector_size_);
+  for (std::size_t input_i = 0; input_i < num_inputs; ++input_i) {
+    for (std::size_t bit_j = 0; bit_j < bit_size; ++bit_j) {
+      auto* dst = &shifted_inputs[(input_i * bit_size + bit_j) * vector_size_];
+      const auto* src = &inputs[input_i * vector_size_];
+      for (std::size_t vector_enty_k = 0; vector_enty_k < vector_size_; ++vector_enty_k) {
+        dst[vector_enty_k] = src[vector_enty_k] << bit_j;
+      }
+    }
+  }
+  // the OT sender keeps only this single copy of the correlations
+  ot_sender_->SetRepeatedCorrelations(std::move(shifted_inputs), num_repetitions);
+  ot_sender_->SendMessages();
+}
+
+template <typename T>
+void IntegerMultiplicationSender<T>::compute_summed_outputs(std::size_t num_summands) {
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<T>;
+  if (num_summands == 0 || batch_size_ % num_summands != 0) {
+    throw std::invalid_argument("batch size is not a multiple of the number of summands");
+  }
+  ot_sender_->ComputeOutputs();
+  auto ot_outputs = ot_sender_->GetOutputs();
+  assert(ot_outputs.size() == batch_size_ * vector_size_ * bit_size);
+  // the outputs of the OTs belonging to one output vector are consecutive
+  const auto group_size = num_summands * bit_size;
+  const auto num_outputs = batch_size_ / num_summands;
+  outputs_.assign(num_outputs * vector_size_, 0);
+  for (std::size_t output_i = 0; output_i < num_outputs; ++output_i) {
+    auto* dst = &outputs_[output_i * vector_size_];
+    for (std::size_t ot_j = 0; ot_j < group_size; ++ot_j) {
+      const auto* src = &ot_outputs[(output_i * group_size + ot_j) * vector_size_];
+      for (std::size_t vector_enty_k = 0; vector_enty_k < vector_size_; ++vector_enty_k) {
+        dst[vector_enty_k] -= src[vector_enty_k];
+      }
+    }
+  }
+}
+
 template <typename T>
 std::vector<T> IntegerMultiplicationSender<T>::get_outputs() {
   // TODO: check output is ready
@@ -295,6 +344,29 @@ void IntegerMultiplicationReceiver<T>::compute_outputs() {
   }
 }
 
+template <typename T>
+void IntegerMultiplicationReceiver<T>::compute_summed_outputs(std::size_t num_summands) {
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<T>;
+  if (num_summands == 0 || batch_size_ % num_summands != 0) {
+    throw std::invalid_argument("batch size is not a multiple of the number of summands");
+  }
+  ot_receiver_->ComputeOutputs();
+  auto ot_outputs = ot_receiver_->GetOutputs();
+  assert(ot_outputs.size() == batch_size_ * vector_size_ * bit_size);
+  const auto group_size = num_summands * bit_size;
+  const auto num_outputs = batch_size_ / num_summands;
+  outputs_.assign(num_outputs * vector_size_, 0);
+  for (std::size_t output_i = 0; output_i < num_outputs; ++output_i) {
+    auto* dst = &outputs_[output_i * vector_size_];
+    for (std::size_t ot_j = 0; ot_j < group_size; ++ot_j) {
+      const auto* src = &ot_outputs[(output_i * group_size + ot_j) * vector_size_];
+      for (std::size_t vector_enty_k = 0; vector_enty_k < vector_size_; ++vector_enty_k) {
+        dst[vector_enty_k] += src[vector_enty_k];
+      }
+    }
+  }
+}
+
 template <typename T>
 std::vector<T> IntegerMultiplicationReceiver<T>::get_outputs() {
   // TODO: check output is ready
@@ -307,14 +379,46 @@ void IntegerMultiplicationReceiver<T>::clear() noexcept {
   outputs_ = {};
 }
 
+namespace {
+
+// The products of the matrix multiplication are computed with one vector OT per bit of an entry
+// of the choice-side matrix, correlated with a whole row of the other matrix.  Computing
+// A * B (l x m times m x n) directly needs l * m * bit_size OTs with vectors of length n,
+// computing it as (B^T * A^T)^T needs m * n * bit_size OTs with vectors of length l.  Both
+// parties pick the orientation with fewer OTs from the public dimensions.
+bool use_transposed_matrix_multiplication(std::size_t l, std::size_t, std::size_t n) {
+  return n < l;
+}
+
+// transpose a (rows x cols) matrix given in row-major order
+template <typename T>
+std::vector<T> transpose_matrix(const T* matrix, std::size_t rows, std::size_t cols) {
+  std::vector<T> result(rows * cols);
+  for (std::size_t row_i = 0; row_i < rows; ++row_i) {
+    for (std::size_t col_j = 0; col_j < cols; ++col_j) {
+      result[col_j * rows + row_i] = matrix[row_i * cols + col_j];
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
 // ---------- MatrixMultiplicationRHS ----------
 
 template <typename T>
 MatrixMultiplicationRHS<T>::MatrixMultiplicationRHS(std::size_t l, std::size_t m, std::size_t n,
                                                     ArithmeticProvider& arith_provider)
     : dims_({l, m, n}),
-      mult_sender_(arith_provider.register_integer_multiplication_send<T>(l * m, n)),
-      is_output_ready_(false) {}
+      transposed_(use_transposed_matrix_multiplication(l, m, n)),
+      is_output_ready_(false) {
+  if (transposed_) {
+    // the columns of the RHS are the choices, the LHS provides the correlations
+    mult_receiver_ = arith_provider.register_integer_multiplication_receive<T>(n * m, l);
+  } else {
+    mult_sender_ = arith_provider.register_integer_multiplication_send<T>(l * m, n);
+  }
+}
 
 template <typename T>
 MatrixMultiplicationRHS<T>::~MatrixMultiplicationRHS() = default;
@@ -334,25 +438,27 @@ void MatrixMultiplicationRHS<T>::set_input(const std::vector<T>& inputs) {
 
 template <typename T>
 void MatrixMultiplicationRHS<T>::set_input(const T* inputs) {
-  const auto input_size = dims_[1] * dims_[2];
-  std::vector<T> mult_inputs(dims_[0] * input_size);
-  for (std::size_t i = 0; i < dims_[0]; ++i) {
-    std::copy_n(inputs, input_size, std::begin(mult_inputs) + i * input_size);
+  if (transposed_) {
+    mult_receiver_->set_inputs(transpose_matrix(inputs, dims_[1], dims_[2]));
+  } else {
+    // row k of the RHS is the correlation for entry (i, k) of the LHS for every row i
+    mult_sender_->set_inputs_repeated(inputs, dims_[0]);
   }
-  mult_sender_->set_inputs(std::move(mult_inputs));
 }
 
 template <typename T>
 void MatrixMultiplicationRHS<T>::compute_output() {
-  mult_sender_->compute_outputs();
-  auto mult_output = mult_sender_->get_outputs();
-  output_.resize(dims_[0] * dims_[2]);
-  using TensorType2 = Eigen::Tensor<T, 2, Eigen::RowMajor>;
-  using TensorType3 = Eigen::Tensor<T, 3, Eigen::RowMajor>;
-  Eigen::TensorMap<TensorType3> input_tensor(mult_output.data(), dims_[0], dims_[1], dims_[2]);
-  Eigen::TensorMap<TensorType2> output_tensor(output_.data(), dims_[0], dims_[2]);
-  Eigen::array<Eigen::Index, 1> reduction_dimensions = {1};
-  output_tensor = input_tensor.sum(reduction_dimensions);
+  // reduce over the inner dimension while collecting the OT outputs
+  if (transposed_) {
+    mult_receiver_->compute_summed_outputs(dims_[1]);
+    const auto output_transposed = mult_receiver_->get_outputs();
+    assert(output_transposed.size() == dims_[2] * dims_[0]);
+    output_ = transpose_matrix(output_transposed.data(), dims_[2], dims_[0]);
+  } else {
+    mult_sender_->compute_summed_outputs(dims_[1]);
+    output_ = mult_sender_->get_outputs();
+  }
+  assert(output_.size() == dims_[0] * dims_[2]);
   is_output_ready_ = true;
 }
 
@@ -364,7 +470,11 @@ std::vector<T> MatrixMultiplicationRHS<T>::get_output() {
 
 template <typename T>
 void MatrixMultiplicationRHS<T>::clear() noexcept {
-  mult_sender_->clear();
+  if (transposed_) {
+    mult_receiver_->clear();
+  } else {
+    mult_sender_->clear();
+  }
   output_ = {};
   is_output_ready_ = false;
 }
@@ -375,8 +485,15 @@ template <typename T>
 MatrixMultiplicationLHS<T>::MatrixMultiplicationLHS(std::size_t l, std::size_t m, std::size_t n,
                                                     ArithmeticProvider& arith_provider)
     : dims_({l, m, n}),
-      mult_receiver_(arith_provider.register_integer_multiplication_receive<T>(l * m, n)),
-      is_output_ready_(false) {}
+      transposed_(use_transposed_matrix_multiplication(l, m, n)),
+      is_output_ready_(false) {
+  if (transposed_) {
+    // the columns of the LHS are the correlations for the choices of the RHS
+    mult_sender_ = arith_provider.register_integer_multiplication_send<T>(n * m, l);
+  } else {
+    mult_receiver_ = arith_provider.register_integer_multiplication_receive<T>(l * m, n);
+  }
+}
 
 template <typename T>
 MatrixMultiplicationLHS<T>::~MatrixMultiplicationLHS() = default;
@@ -386,7 +503,11 @@ void MatrixMultiplicationLHS<T>::set_input(std::vector<T>&& inputs) {
   if (inputs.size() != dims_[0] * dims_[1]) {
     throw std::invalid_argument("input has unexpected size");
   }
-  mult_receiver_->set_inputs(std::move(inputs));
+  if (transposed_) {
+    set_input(inputs.data());
+  } else {
+    mult_receiver_->set_inputs(std::move(inputs));
+  }
 }
 
 template <typename T>
@@ -399,22 +520,28 @@ void MatrixMultiplicationLHS<T>::set_input(const std::vector<T>& inputs) {
 
 template <typename T>
 void MatrixMultiplicationLHS<T>::set_input(const T* inputs) {
-  std::vector<T> mult_inputs(inputs, inputs + dims_[0] * dims_[1]);
-  mult_receiver_->set_inputs(std::move(mult_inputs));
+  if (transposed_) {
+    // column k of the LHS is the correlation for entry (j, k) of the transposed RHS for every j
+    const auto inputs_transposed = transpose_matrix(inputs, dims_[0], dims_[1]);
+    mult_sender_->set_inputs_repeated(inputs_transposed.data(), dims_[2]);
+  } else {
+    std::vector<T> mult_inputs(inputs, inputs + dims_[0] * dims_[1]);
+    mult_receiver_->set_inputs(std::move(mult_inputs));
+  }
 }
 
 template <typename T>
 void MatrixMultiplicationLHS<T>::compute_output() {
-  mult_receiver_->compute_outputs();
-  auto mult_output = mult_receiver_->get_outputs();
-  assert(mult_output.size() == dims_[0] * dims_[1] * dims_[2]);
-  output_.resize(dims_[0] * dims_[2]);
-  using TensorType2 = Eigen::Tensor<T, 2, Eigen::RowMajor>;
-  using TensorType3 = Eigen::Tensor<T, 3, Eigen::RowMajor>;
-  Eigen::TensorMap<TensorType3> input_tensor(mult_output.data(), dims_[0], dims_[1], dims_[2]);
-  Eigen::TensorMap<TensorType2> output_tensor(output_.data(), dims_[0], dims_[2]);
-  Eigen::array<Eigen::Index, 1> reduction_dimensions = {1};
-  output_tensor = input_tensor.sum(reduction_dimensions);
+  if (transposed_) {
+    mult_sender_->compute_summed_outputs(dims_[1]);
+    const auto output_transposed = mult_sender_->get_outputs();
+    assert(output_transposed.size() == dims_[2] * dims_[0]);
+    output_ = transpose_matrix(output_transposed.data(), dims_[2], dims_[0]);
+  } else {
+    mult_receiver_->compute_summed_outputs(dims_[1]);
+    output_ = mult_receiver_->get_outputs();
+  }
+  assert(output_.size() == dims_[0] * dims_[2]);
   is_output_ready_ = true;
 }
 
@@ -426,7 +553,11 @@ std::vector<T> MatrixMultiplicationLHS<T>::get_output() {
 
 template <typename T>
 void MatrixMultiplicationLHS<T>::clear() noexcept {
-  mult_receiver_->clear();
+  if (transposed_) {
+    mult_sender_->clear();
+  } else {
+    mult_receiver_->clear();
+  }
   output_ = {};
   is_output_ready_ = false;
 }
@@ -100,7 +100,13 @@ class IntegerMultiplicationSender {
   void set_inputs(std::vector<T>&& inputs);
   void set_inputs(const std::vector<T>& inputs);
   void set_inputs(const T* inputs);
+  // set the inputs to num_repetitions copies of the batch_size / num_repetitions
+  // vectors at inputs without materializing the copies
+  void set_inputs_repeated(const T* inputs, std::size_t num_repetitions);
   void compute_outputs();
+  // sum the products of each group of num_summands consecutive inputs, i.e.,
+  // produce batch_size / num_summands output vectors
+  void compute_summed_outputs(std::size_t num_summands);
   std::vector<T> get_outputs();
   void clear() noexcept;
 
@@ -122,6 +128,8 @@ class IntegerMultiplicationReceiver {
   void set_inputs(const std::vector<T>& inputs);
   void set_inputs(const T* inputs);
   void compute_outputs();
+  // see IntegerMultiplicationSender::compute_summed_outputs
+  void compute_summed_outputs(std::size_t num_summands);
   std::vector<T> get_outputs();
   void clear() noexcept;
 
@@ -134,6 +142,12 @@ class IntegerMultiplicationReceiver {
   std::shared_ptr<Logger> logger_;
 };
 
+// Shares of the product of an l x m matrix A held by the LHS side and an m x n
+// matrix B held by the RHS side (Gilboa-style products from ACOTs).  This
+// needs min(l, n) * m * bit_size OTs whose correlations have max(l, n)
+// elements, i.e., the communication is l * m * n * bit_size elements as for
+// any OT-based product.  A generator whose communication scales with
+// l * m + m * n (e.g., from vector OLE) is not implemented.
 template <typename T>
 class MatrixMultiplicationRHS {
  public:
@@ -149,8 +163,12 @@ class MatrixMultiplicationRHS {
  private:
   using is_enabled_ = ENCRYPTO::is_unsigned_int_t<T>;
   std::array<std::size_t, 3> dims_;
+  // compute the product as (B^T * A^T)^T with this side as OT receiver, which needs fewer OTs
+  // if n < l
+  bool transposed_;
   std::vector<T> output_;
   std::unique_ptr<IntegerMultiplicationSender<T>> mult_sender_;
+  std::unique_ptr<IntegerMultiplicationReceiver<T>> mult_receiver_;
   bool is_output_ready_;
 };
 
@@ -169,7 +187,10 @@ class MatrixMultiplicationLHS {
  private:
   using is_enabled_ = ENCRYPTO::is_unsigned_int_t<T>;
   std::array<std::size_t, 3> dims_;
+  // see MatrixMultiplicationRHS, this side is the OT sender if transposed
+  bool transposed_;
   std::vector<T> output_;
+  std::unique_ptr<IntegerMultiplicationSender<T>> mult_sender_;
   std::unique_ptr<IntegerMultiplicationReceiver<T>> mult_receiver_;
   std::shared_ptr<Logger> logger_;
   bool is_output_ready_;
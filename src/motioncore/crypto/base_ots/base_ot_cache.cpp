@@ -0,0 +1,232 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "base_ot_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "crypto/blake2b.h"
+#include "utility/constants.h"
+
+namespace MOTION {
+
+namespace {
+
+constexpr std::array<char, 8> cache_magic = {'M', 'O', 'T', 'N', 'B', 'O', 'T', 'C'};
+constexpr std::uint32_t cache_version = 1;
+constexpr std::size_t msgs_size = kappa * 16;
+constexpr std::size_t cache_file_size =
+    cache_magic.size() + sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t) + 16 + kappa / 8 +
+    3 * msgs_size;
+
+template <typename T>
+void append(std::vector<std::uint8_t>& buffer, const T& value) {
+  const auto* ptr = reinterpret_cast<const std::uint8_t*>(&value);
+  buffer.insert(std::end(buffer), ptr, ptr + sizeof(T));
+}
+
+void append(std::vector<std::uint8_t>& buffer, const base_ot_msgs_t& msgs) {
+  for (const auto& m : msgs) {
+    append(buffer, m);
+  }
+}
+
+template <typename T>
+const std::uint8_t* extract(const std::uint8_t* ptr, T& value) {
+  std::memcpy(&value, ptr, sizeof(T));
+  return ptr + sizeof(T);
+}
+
+const std::uint8_t* extract(const std::uint8_t* ptr, base_ot_msgs_t& msgs) {
+  for (auto& m : msgs) {
+    ptr = extract(ptr, m);
+  }
+  return ptr;
+}
+
+// m <- H("MOTION base OT" || m || session_id || i)
+void derive_messages(base_ot_msgs_t& msgs, const std::vector<std::uint8_t>& session_id,
+                     Blake2bCtx& ctx) {
+  static constexpr char label[] = "MOTION base OT";
+  std::vector<std::uint8_t> input(sizeof(label) + 16 + session_id.size() + sizeof(std::uint64_t));
+  std::copy_n(label, sizeof(label), std::begin(input));
+  std::copy(std::begin(session_id), std::end(session_id), std::begin(input) + sizeof(label) + 16);
+  std::uint8_t digest[EVP_MAX_MD_SIZE];
+  for (std::uint64_t i = 0; i < msgs.size(); ++i) {
+    std::memcpy(input.data() + sizeof(label), msgs[i].data(), 16);
+    std::memcpy(input.data() + input.size() - sizeof(i), &i, sizeof(i));
+    Blake2b(input.data(), digest, input.size(), ctx);
+    std::memcpy(msgs[i].data(), digest, 16);
+  }
+}
+
+}  // namespace
+
+BaseOTCache::BaseOTCache(std::filesystem::path directory) : directory_(std::move(directory)) {}
+
+std::filesystem::path BaseOTCache::get_path(std::size_t my_id, std::size_t other_id) const {
+  return directory_ / fmt::format("base_ots_{}_{}.bin", my_id, other_id);
+}
+
+std::optional<BaseOTCacheEntry> BaseOTCache::load(std::size_t my_id, std::size_t other_id) const {
+  namespace fs = std::filesystem;
+  const auto path = get_path(my_id, other_id);
+  std::error_code ec;
+  const auto status = fs::status(path, ec);
+  if (ec || !fs::is_regular_file(status)) {
+    return std::nullopt;
+  }
+  if ((status.permissions() & (fs::perms::group_all | fs::perms::others_all)) != fs::perms::none) {
+    throw std::runtime_error(fmt::format(
+        "BaseOTCache: {} is accessible by other users, refusing to use it", path.string()));
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<std::uint8_t> buffer(std::istreambuf_iterator<char>(file), {});
+  if (!file || buffer.size() != cache_file_size ||
+      !std::equal(std::begin(cache_magic), std::end(cache_magic), std::begin(buffer))) {
+    throw std::runtime_error(
+        fmt::format("BaseOTCache: {} is not a valid cache file", path.string()));
+  }
+
+  const auto* ptr = buffer.data() + cache_magic.size();
+  std::uint32_t version;
+  std::uint64_t stored_my_id, stored_other_id;
+  ptr = extract(ptr, version);
+  ptr = extract(ptr, stored_my_id);
+  ptr = extract(ptr, stored_other_id);
+  if (version != cache_version) {
+    throw std::runtime_error(fmt::format("BaseOTCache: {} has unsupported version {}",
+                                         path.string(), version));
+  }
+  if (stored_my_id != my_id || stored_other_id != other_id) {
+    throw std::runtime_error(
+        fmt::format("BaseOTCache: {} belongs to party pair ({}, {}) instead of ({}, {})",
+                    path.string(), stored_my_id, stored_other_id, my_id, other_id));
+  }
+
+  BaseOTCacheEntry entry;
+  ptr = extract(ptr, entry.cache_id_);
+  entry.receiver_msgs_.c_ = ENCRYPTO::BitVector<>(ptr, kappa);
+  ptr += kappa / 8;
+  ptr = extract(ptr, entry.receiver_msgs_.messages_c_);
+  ptr = extract(ptr, entry.sender_msgs_.messages_0_);
+  ptr = extract(ptr, entry.sender_msgs_.messages_1_);
+  assert(ptr == buffer.data() + buffer.size());
+  return entry;
+}
+
+void BaseOTCache::store(std::size_t my_id, std::size_t other_id,
+                        const BaseOTCacheEntry& entry) const {
+  if (entry.receiver_msgs_.c_.GetSize() != kappa) {
+    throw std::invalid_argument(
+        fmt::format("BaseOTCache: expected {} choice bits, got {}", kappa,
+                    entry.receiver_msgs_.c_.GetSize()));
+  }
+
+  std::vector<std::uint8_t> buffer;
+  buffer.reserve(cache_file_size);
+  buffer.insert(std::end(buffer), std::begin(cache_magic), std::end(cache_magic));
+  append(buffer, cache_version);
+  append(buffer, std::uint64_t(my_id));
+  append(buffer, std::uint64_t(other_id));
+  append(buffer, entry.cache_id_);
+  const auto& choice_bits = entry.receiver_msgs_.c_.GetData();
+  const auto* choice_ptr = reinterpret_cast<const std::uint8_t*>(choice_bits.data());
+  buffer.insert(std::end(buffer), choice_ptr, choice_ptr + kappa / 8);
+  append(buffer, entry.receiver_msgs_.messages_c_);
+  append(buffer, entry.sender_msgs_.messages_0_);
+  append(buffer, entry.sender_msgs_.messages_1_);
+  assert(buffer.size() == cache_file_size);
+
+  std::filesystem::create_directories(directory_);
+  // write to a temporary file which is created with restricted permissions and
+  // move it into place afterwards, s.t. readers never see a partial entry
+  const auto path = get_path(my_id, other_id);
+  auto tmp_path = path;
+  tmp_path += fmt::format(".tmp{}", ::getpid());
+  const int fd =
+      ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format("BaseOTCache: could not create {}: {}",
+                                         tmp_path.string(), std::strerror(errno)));
+  }
+  std::size_t written = 0;
+  while (written < buffer.size()) {
+    const auto ret = ::write(fd, buffer.data() + written, buffer.size() - written);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      const auto error = errno;
+      ::close(fd);
+      ::unlink(tmp_path.c_str());
+      throw std::runtime_error(fmt::format("BaseOTCache: could not write {}: {}",
+                                           tmp_path.string(), std::strerror(error)));
+    }
+    written += ret;
+  }
+  if (::fsync(fd) != 0 || ::close(fd) != 0) {
+    ::unlink(tmp_path.c_str());
+    throw std::runtime_error(fmt::format("BaseOTCache: could not write {}: {}",
+                                         tmp_path.string(), std::strerror(errno)));
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
+void BaseOTCache::remove(std::size_t my_id, std::size_t other_id) const {
+  std::filesystem::remove(get_path(my_id, other_id));
+}
+
+void derive_session_base_ots(ReceiverMsgs& receiver_msgs, SenderMsgs& sender_msgs,
+                             const std::vector<std::uint8_t>& session_id) {
+  auto ctx = NewBlakeCtx();
+  derive_messages(receiver_msgs.messages_c_, session_id, ctx);
+  derive_messages(sender_msgs.messages_0_, session_id, ctx);
+  derive_messages(sender_msgs.messages_1_, session_id, ctx);
+}
+
+std::array<std::byte, 16> make_base_ot_cache_id(const std::vector<std::uint8_t>& session_id) {
+  static constexpr char label[] = "MOTION base OT cache id";
+  std::vector<std::uint8_t> input(std::begin(label), std::end(label));
+  input.insert(std::end(input), std::begin(session_id), std::end(session_id));
+  std::uint8_t digest[EVP_MAX_MD_SIZE];
+  Blake2b(input.data(), digest, input.size());
+  std::array<std::byte, 16> cache_id;
+  std::memcpy(cache_id.data(), digest, cache_id.size());
+  return cache_id;
+}
+
+}  // namespace MOTION
@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "base_ot_provider.h"
+
+namespace MOTION {
+
+// Base OTs of one party pair as they are stored in a BaseOTCache.  The cache
+// id is the same on both sides and is used to check that the two parties hold
+// matching entries.
+struct BaseOTCacheEntry {
+  std::array<std::byte, 16> cache_id_;
+  ReceiverMsgs receiver_msgs_;
+  SenderMsgs sender_msgs_;
+};
+
+// Stores the base OTs between two parties on disk, s.t. they need to be
+// computed only once.  The directory contains one file per party pair which is
+// only accessible by its owner.  Entries are never used directly, but
+// rerandomized with derive_session_base_ots for each session.
+class BaseOTCache {
+ public:
+  explicit BaseOTCache(std::filesystem::path directory);
+
+  // returns std::nullopt if there is no entry for this party pair
+  std::optional<BaseOTCacheEntry> load(std::size_t my_id, std::size_t other_id) const;
+  void store(std::size_t my_id, std::size_t other_id, const BaseOTCacheEntry&) const;
+  void remove(std::size_t my_id, std::size_t other_id) const;
+
+  std::filesystem::path get_path(std::size_t my_id, std::size_t other_id) const;
+  const std::filesystem::path& get_directory() const noexcept { return directory_; }
+
+ private:
+  std::filesystem::path directory_;
+};
+
+// Derive the base OTs of a session from cached ones: every message m_i is
+// replaced by H(m_i || session_id || i) on both sides, the choice bits stay the
+// same.  Different session ids yield independent seeds for the OT extension.
+void derive_session_base_ots(ReceiverMsgs&, SenderMsgs&,
+                             const std::vector<std::uint8_t>& session_id);
+
+// Compute the cache id of an entry created in the session with the given id.
+std::array<std::byte, 16> make_base_ot_cache_id(const std::vector<std::uint8_t>& session_id);
+
+}  // namespace MOTION
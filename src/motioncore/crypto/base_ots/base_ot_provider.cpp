@@ -22,12 +22,17 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstring>
+#include <optional>
+
 #include "base/configuration.h"
 #include "base/register.h"
+#include "base_ot_cache.h"
 #include "base_ot_provider.h"
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/base_ot_generated.h"
 #include "communication/fbs_headers/message_generated.h"
+#include "communication/message.h"
 #include "communication/message_handler.h"
 #include "crypto/base_ots/ot_hl17.h"
 #include "data_storage/base_ot_data.h"
@@ -37,13 +42,17 @@
 
 namespace MOTION {
 
-// Handler for messages of type BaseROTMessageSender, BaseROTMessageReceiver
+// Handler for messages of type BaseROTMessageSender, BaseROTMessageReceiver, BaseOTCacheCheck
 class BaseOTMessageHandler : public Communication::MessageHandler {
  public:
   // Create a handler object for a given party
   BaseOTMessageHandler(std::size_t party_id, std::shared_ptr<Logger> logger,
-                       BaseOTsData &base_ots_data)
-      : party_id_(party_id), logger_(logger), base_ots_data_(base_ots_data) {}
+                       BaseOTsData &base_ots_data,
+                       ENCRYPTO::ReusablePromise<std::vector<std::uint8_t>> &cache_check_promise)
+      : party_id_(party_id),
+        logger_(logger),
+        base_ots_data_(base_ots_data),
+        cache_check_promise_(cache_check_promise) {}
 
   // Method which is called on received messages.
   void received_message(std::size_t, std::vector<std::uint8_t> &&message) override;
@@ -54,11 +63,17 @@ class BaseOTMessageHandler : public Communication::MessageHandler {
   std::size_t party_id_;
   std::shared_ptr<Logger> logger_;
   BaseOTsData &base_ots_data_;
+  ENCRYPTO::ReusablePromise<std::vector<std::uint8_t>> &cache_check_promise_;
 };
 
 void BaseOTMessageHandler::received_message(std::size_t, std::vector<std::uint8_t> &&raw_message) {
   assert(!raw_message.empty());
   auto message = Communication::GetMessage(raw_message.data());
+  if (message->message_type() == Communication::MessageType::BaseOTCacheCheck) {
+    auto payload = message->payload();
+    cache_check_promise_.set_value(std::vector<std::uint8_t>(payload->begin(), payload->end()));
+    return;
+  }
   auto base_ot_message = Communication::GetBaseROTMessage(message->payload()->data());
   auto base_ot_id = base_ot_message->base_ot_id();
   if (message->message_type() == Communication::MessageType::BaseROTMessageReceiver) {
@@ -81,21 +96,28 @@ BaseOTProvider::BaseOTProvider(Communication::CommunicationLayer &communication_
       num_parties_(communication_layer.get_num_parties()),
       my_id_(communication_layer.get_my_id()),
       data_(num_parties_),
+      cache_check_promises_(num_parties_),
       stats_(stats),
       logger_(logger),
       finished_(false) {
+  std::transform(std::begin(cache_check_promises_), std::end(cache_check_promises_),
+                 std::back_inserter(cache_check_futures_),
+                 [](auto &promise) { return promise.get_future(); });
   communication_layer_.register_message_handler(
       [this, &logger](auto party_id) {
-        return std::make_shared<BaseOTMessageHandler>(party_id, logger, data_.at(party_id));
+        return std::make_shared<BaseOTMessageHandler>(party_id, logger, data_.at(party_id),
+                                                      cache_check_promises_.at(party_id));
       },
       {Communication::MessageType::BaseROTMessageSender,
-       Communication::MessageType::BaseROTMessageReceiver});
+       Communication::MessageType::BaseROTMessageReceiver,
+       Communication::MessageType::BaseOTCacheCheck});
 }
 
 BaseOTProvider::~BaseOTProvider() {
   communication_layer_.deregister_message_handler(
       {Communication::MessageType::BaseROTMessageSender,
-       Communication::MessageType::BaseROTMessageReceiver});
+       Communication::MessageType::BaseROTMessageReceiver,
+       Communication::MessageType::BaseOTCacheCheck});
 }
 
 void BaseOTProvider::ComputeBaseOTs() {
@@ -176,6 +198,87 @@ void BaseOTProvider::ComputeBaseOTs() {
   }
 }
 
+void BaseOTProvider::ComputeBaseOTs(const BaseOTCache &cache,
+                                    const std::vector<std::uint8_t> &session_id) {
+  // tell every party which cache entry we have, s.t. the cache is only used if
+  // both sides hold the same one
+  std::vector<std::optional<BaseOTCacheEntry>> entries(num_parties_);
+  std::vector<bool> cache_checked(num_parties_, false);
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    const auto &base_ots_data = data_.at(party_id);
+    if (party_id == my_id_ || (base_ots_data.GetReceiverData().is_ready_ &&
+                               base_ots_data.GetSenderData().is_ready_)) {
+      continue;
+    }
+    try {
+      entries.at(party_id) = cache.load(my_id_, party_id);
+    } catch (std::runtime_error &e) {
+      // an unusable entry is replaced by fresh base OTs below
+      if (logger_) {
+        logger_->LogError(e.what());
+      }
+    }
+    std::vector<std::uint8_t> cache_id;
+    if (entries.at(party_id).has_value()) {
+      const auto &stored_id = entries.at(party_id)->cache_id_;
+      const auto *ptr = reinterpret_cast<const std::uint8_t *>(stored_id.data());
+      cache_id.assign(ptr, ptr + stored_id.size());
+    }
+    communication_layer_.send_message(
+        party_id, Communication::BuildMessage(Communication::MessageType::BaseOTCacheCheck,
+                                              &cache_id));
+    cache_checked.at(party_id) = true;
+  }
+
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (!cache_checked.at(party_id)) {
+      continue;
+    }
+    const auto their_cache_id = cache_check_futures_.at(party_id).get();
+    auto &entry = entries.at(party_id);
+    if (!entry.has_value()) {
+      continue;
+    }
+    if (their_cache_id.size() != entry->cache_id_.size() ||
+        std::memcmp(their_cache_id.data(), entry->cache_id_.data(), their_cache_id.size()) != 0) {
+      if constexpr (MOTION_DEBUG) {
+        if (logger_) {
+          logger_->LogDebug(
+              fmt::format("No matching base OT cache entry for Party#{}, recomputing", party_id));
+        }
+      }
+      entry.reset();
+      continue;
+    }
+    derive_session_base_ots(entry->receiver_msgs_, entry->sender_msgs_, session_id);
+    ImportBaseOTs(party_id, entry->receiver_msgs_);
+    ImportBaseOTs(party_id, entry->sender_msgs_);
+    if constexpr (MOTION_DEBUG) {
+      if (logger_) {
+        logger_->LogDebug(fmt::format("Reusing cached base OTs for Party#{}", party_id));
+      }
+    }
+  }
+
+  // compute the remaining base OTs and add them to the cache
+  ComputeBaseOTs();
+  const auto cache_id = make_base_ot_cache_id(session_id);
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (!cache_checked.at(party_id) || entries.at(party_id).has_value()) {
+      continue;
+    }
+    auto [receiver_msgs, sender_msgs] = ExportBaseOTs(party_id);
+    try {
+      cache.store(my_id_, party_id, {cache_id, std::move(receiver_msgs), std::move(sender_msgs)});
+    } catch (std::exception &e) {
+      // the base OTs are still usable for this session
+      if (logger_) {
+        logger_->LogError(e.what());
+      }
+    }
+  }
+}
+
 void BaseOTProvider::ImportBaseOTs(std::size_t party_id, const ReceiverMsgs &msgs) {
   auto &rcv_data = data_.at(party_id).GetReceiverData();
   if (rcv_data.is_ready_)
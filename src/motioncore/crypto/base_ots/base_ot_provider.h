@@ -26,11 +26,13 @@
 
 #include <array>
 #include <cstddef>
+#include <vector>
 
 #include "data_storage/base_ot_data.h"
 #include "utility/bit_vector.h"
 #include "utility/constants.h"
 #include "utility/enable_wait.h"
+#include "utility/reusable_future.h"
 
 namespace MOTION {
 
@@ -42,6 +44,7 @@ namespace Statistics {
 struct RunTimeStats;
 }
 
+class BaseOTCache;
 class Configuration;
 class Logger;
 class Register;
@@ -64,6 +67,11 @@ class BaseOTProvider : public ENCRYPTO::enable_wait_setup {
                  std::shared_ptr<Logger>);
   ~BaseOTProvider();
   void ComputeBaseOTs();
+  // Like ComputeBaseOTs, but reuse the base OTs stored in the cache for every
+  // party which holds a matching entry.  These are rerandomized with the
+  // session id, which needs to be the same on both sides and fresh for each
+  // session.  Base OTs which had to be computed are stored in the cache.
+  void ComputeBaseOTs(const BaseOTCache&, const std::vector<std::uint8_t>& session_id);
   void ImportBaseOTs(std::size_t party_id, const ReceiverMsgs& msgs);
   void ImportBaseOTs(std::size_t party_id, const SenderMsgs& msgs);
   std::pair<ReceiverMsgs, SenderMsgs> ExportBaseOTs(std::size_t party_id);
@@ -75,6 +83,8 @@ class BaseOTProvider : public ENCRYPTO::enable_wait_setup {
   std::size_t num_parties_;
   std::size_t my_id_;
   std::vector<BaseOTsData> data_;
+  std::vector<ENCRYPTO::ReusablePromise<std::vector<std::uint8_t>>> cache_check_promises_;
+  std::vector<ENCRYPTO::ReusableFuture<std::vector<std::uint8_t>>> cache_check_futures_;
   Statistics::RunTimeStats* stats_;
   std::shared_ptr<Logger> logger_;
   bool finished_;
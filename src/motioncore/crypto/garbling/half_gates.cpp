@@ -23,7 +23,9 @@
 #include "half_gates.h"
 
 #include <parallel/algorithm>
+#include <algorithm>
 #include <numeric>
+#include <stdexcept>
 
 #include "algorithm/algorithm_description.h"
 #include "crypto/aes/aesni_primitives.h"
@@ -108,36 +110,48 @@ void HalfGateGarbler::batch_garble_and_omp(ENCRYPTO::block128_t* key_cs,
   }
 }
 
-void HalfGateGarbler::garble_circuit(
-    ENCRYPTO::block128_vector& output_keys, ENCRYPTO::block128_vector& garbled_tables,
-    std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
-    const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
-    const ENCRYPTO::AlgorithmDescription& algo, bool parallel) const {
+std::size_t get_num_and_gates(const ENCRYPTO::AlgorithmDescription& algo) {
+  return std::count_if(std::begin(algo.gates_), std::end(algo.gates_), [](const auto& op) {
+    return op.type_ == ENCRYPTO::PrimitiveOperationType::AND;
+  });
+}
+
+template <typename GetTables, typename TablesDone>
+void HalfGateGarbler::garble_circuit_impl(ENCRYPTO::block128_vector& output_keys,
+                                          std::size_t start_index,
+                                          const ENCRYPTO::block128_vector& input_keys_a,
+                                          const ENCRYPTO::block128_vector& input_keys_b,
+                                          std::size_t num_simd,
+                                          const ENCRYPTO::AlgorithmDescription& algo,
+                                          bool parallel,
+                                          const ENCRYPTO::WireSlotAllocation* slot_allocation,
+                                          GetTables&& get_tables,
+                                          TablesDone&& tables_done) const {
   assert(input_keys_a.size() == algo.n_input_wires_parent_a_ * num_simd);
   assert((!algo.n_input_wires_parent_b_.has_value()) ||
          (input_keys_b.size() == *algo.n_input_wires_parent_b_ * num_simd));
   output_keys.resize(algo.n_output_wires_ * num_simd);
-  std::size_t num_and_gates = std::transform_reduce(
-      std::begin(algo.gates_), std::end(algo.gates_), 0, std::plus{}, [](const auto& op) {
-        if (op.type_ == ENCRYPTO::PrimitiveOperationType::AND) {
-          return 1;
-        } else {
-          return 0;
-        }
-      });
-  garbled_tables.resize(2 * num_and_gates * num_simd);
-  ENCRYPTO::block128_vector wire_keys(algo.n_wires_ * num_simd);
-  auto it = std::copy_n(input_keys_a.data(), input_keys_a.size(), wire_keys.data());
+  const auto slot = [slot_allocation](std::size_t wire) {
+    return slot_allocation ? slot_allocation->wire_slots_[wire] : wire;
+  };
+  ENCRYPTO::block128_vector wire_keys(
+      (slot_allocation ? slot_allocation->n_slots_ : algo.n_wires_) * num_simd);
+  for (std::size_t wire_i = 0; wire_i < algo.n_input_wires_parent_a_; ++wire_i) {
+    std::copy_n(&input_keys_a[wire_i * num_simd], num_simd, &wire_keys[slot(wire_i) * num_simd]);
+  }
   if (algo.n_input_wires_parent_b_.has_value()) {
-    std::copy_n(input_keys_b.data(), input_keys_b.size(), it);
+    for (std::size_t wire_i = 0; wire_i < *algo.n_input_wires_parent_b_; ++wire_i) {
+      std::copy_n(&input_keys_b[wire_i * num_simd], num_simd,
+                  &wire_keys[slot(algo.n_input_wires_parent_a_ + wire_i) * num_simd]);
+    }
   }
   assert(algo.n_gates_ == algo.gates_.size());
   for (std::size_t op_i = 0, and_j = 0; op_i < algo.n_gates_; ++op_i) {
     const auto& op = algo.gates_[op_i];
-    const auto* gate_input_keys_a = &wire_keys[op.parent_a_ * num_simd];
-    auto* gate_output_keys = &wire_keys[op.output_wire_ * num_simd];
+    const auto* gate_input_keys_a = &wire_keys[slot(op.parent_a_) * num_simd];
+    auto* gate_output_keys = &wire_keys[slot(op.output_wire_) * num_simd];
     if (op.parent_b_.has_value()) {
-      const auto* gate_input_keys_b = &wire_keys[*op.parent_b_ * num_simd];
+      const auto* gate_input_keys_b = &wire_keys[slot(*op.parent_b_) * num_simd];
       if (op.type_ == ENCRYPTO::PrimitiveOperationType::XOR) {
         if (parallel) {
           __gnu_parallel::transform(gate_input_keys_a, gate_input_keys_a + num_simd,
@@ -149,12 +163,13 @@ void HalfGateGarbler::garble_circuit(
         }
       } else if (op.type_ == ENCRYPTO::PrimitiveOperationType::AND) {
         if (parallel) {
-          batch_garble_and_omp(gate_output_keys, &garbled_tables[and_j * 2 * num_simd], start_index,
+          batch_garble_and_omp(gate_output_keys, get_tables(and_j), start_index,
                                gate_input_keys_a, gate_input_keys_b, num_simd);
         } else {
-          batch_garble_and(gate_output_keys, &garbled_tables[and_j * 2 * num_simd], start_index,
-                           gate_input_keys_a, gate_input_keys_b, num_simd);
+          batch_garble_and(gate_output_keys, get_tables(and_j), start_index, gate_input_keys_a,
+                           gate_input_keys_b, num_simd);
         }
+        tables_done(and_j);
         ++and_j;
         start_index += num_simd;
       } else {
@@ -175,8 +190,54 @@ void HalfGateGarbler::garble_circuit(
       }
     }
   }
-  std::copy_n(wire_keys.data() + (algo.n_wires_ - algo.n_output_wires_) * num_simd,
-              algo.n_output_wires_ * num_simd, output_keys.data());
+  const auto first_output_wire = algo.n_wires_ - algo.n_output_wires_;
+  for (std::size_t wire_i = 0; wire_i < algo.n_output_wires_; ++wire_i) {
+    std::copy_n(&wire_keys[slot(first_output_wire + wire_i) * num_simd], num_simd,
+                &output_keys[wire_i * num_simd]);
+  }
+}
+
+void HalfGateGarbler::garble_circuit(
+    ENCRYPTO::block128_vector& output_keys, ENCRYPTO::block128_vector& garbled_tables,
+    std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
+    const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
+    const ENCRYPTO::AlgorithmDescription& algo, bool parallel,
+    const ENCRYPTO::WireSlotAllocation* slot_allocation) const {
+  garbled_tables.resize(2 * get_num_and_gates(algo) * num_simd);
+  garble_circuit_impl(
+      output_keys, start_index, input_keys_a, input_keys_b, num_simd, algo, parallel,
+      slot_allocation,
+      [&garbled_tables, num_simd](auto and_j) { return &garbled_tables[and_j * 2 * num_simd]; },
+      [](auto) {});
+}
+
+void HalfGateGarbler::garble_circuit_streaming(
+    ENCRYPTO::block128_vector& output_keys, std::size_t start_index,
+    const ENCRYPTO::block128_vector& input_keys_a, const ENCRYPTO::block128_vector& input_keys_b,
+    std::size_t num_simd, const ENCRYPTO::AlgorithmDescription& algo,
+    std::size_t num_and_gates_per_chunk, const garbled_tables_sink_t& sink, bool parallel,
+    const ENCRYPTO::WireSlotAllocation* slot_allocation) const {
+  assert(num_and_gates_per_chunk > 0);
+  const auto num_and_gates = get_num_and_gates(algo);
+  // only a single chunk is kept in memory, it is moved into the sink when it is complete
+  ENCRYPTO::block128_vector chunk;
+  garble_circuit_impl(
+      output_keys, start_index, input_keys_a, input_keys_b, num_simd, algo, parallel,
+      slot_allocation,
+      [&](auto and_j) {
+        const auto chunk_offset = and_j % num_and_gates_per_chunk;
+        if (chunk_offset == 0) {
+          const auto chunk_size = std::min(num_and_gates_per_chunk, num_and_gates - and_j);
+          chunk.resize(2 * chunk_size * num_simd);
+        }
+        return &chunk[chunk_offset * 2 * num_simd];
+      },
+      [&](auto and_j) {
+        if ((and_j + 1) % num_and_gates_per_chunk == 0 || and_j + 1 == num_and_gates) {
+          sink(and_j / num_and_gates_per_chunk, std::move(chunk));
+          chunk = {};
+        }
+      });
 }
 
 HalfGateEvaluator::HalfGateEvaluator(const HalfGatePublicData& public_data)
@@ -239,27 +300,41 @@ void HalfGateEvaluator::batch_evaluate_and_omp(ENCRYPTO::block128_t* key_cs,
   }
 }
 
-void HalfGateEvaluator::evaluate_circuit(
-    ENCRYPTO::block128_vector& output_keys, const ENCRYPTO::block128_vector& garbled_tables,
-    std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
-    const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
-    const ENCRYPTO::AlgorithmDescription& algo, bool parallel) const {
+template <typename GetTables>
+void HalfGateEvaluator::evaluate_circuit_impl(ENCRYPTO::block128_vector& output_keys,
+                                              std::size_t start_index,
+                                              const ENCRYPTO::block128_vector& input_keys_a,
+                                              const ENCRYPTO::block128_vector& input_keys_b,
+                                              std::size_t num_simd,
+                                              const ENCRYPTO::AlgorithmDescription& algo,
+                                              bool parallel,
+                                              const ENCRYPTO::WireSlotAllocation* slot_allocation,
+                                              GetTables&& get_tables) const {
   assert(input_keys_a.size() == algo.n_input_wires_parent_a_ * num_simd);
   assert((!algo.n_input_wires_parent_b_.has_value()) ||
          (input_keys_b.size() == *algo.n_input_wires_parent_b_ * num_simd));
   output_keys.resize(algo.n_output_wires_ * num_simd);
-  ENCRYPTO::block128_vector wire_keys(algo.n_wires_ * num_simd);
-  auto it = std::copy_n(input_keys_a.data(), input_keys_a.size(), wire_keys.data());
+  const auto slot = [slot_allocation](std::size_t wire) {
+    return slot_allocation ? slot_allocation->wire_slots_[wire] : wire;
+  };
+  ENCRYPTO::block128_vector wire_keys(
+      (slot_allocation ? slot_allocation->n_slots_ : algo.n_wires_) * num_simd);
+  for (std::size_t wire_i = 0; wire_i < algo.n_input_wires_parent_a_; ++wire_i) {
+    std::copy_n(&input_keys_a[wire_i * num_simd], num_simd, &wire_keys[slot(wire_i) * num_simd]);
+  }
   if (algo.n_input_wires_parent_b_.has_value()) {
-    std::copy_n(input_keys_b.data(), input_keys_b.size(), it);
+    for (std::size_t wire_i = 0; wire_i < *algo.n_input_wires_parent_b_; ++wire_i) {
+      std::copy_n(&input_keys_b[wire_i * num_simd], num_simd,
+                  &wire_keys[slot(algo.n_input_wires_parent_a_ + wire_i) * num_simd]);
+    }
   }
   assert(algo.n_gates_ == algo.gates_.size());
   for (std::size_t op_i = 0, and_j = 0; op_i < algo.n_gates_; ++op_i) {
     const auto& op = algo.gates_[op_i];
-    const ENCRYPTO::block128_t* gate_input_keys_a = &wire_keys[op.parent_a_ * num_simd];
-    auto* gate_output_keys = &wire_keys[op.output_wire_ * num_simd];
+    const ENCRYPTO::block128_t* gate_input_keys_a = &wire_keys[slot(op.parent_a_) * num_simd];
+    auto* gate_output_keys = &wire_keys[slot(op.output_wire_) * num_simd];
     if (op.parent_b_.has_value()) {
-      const auto* gate_input_keys_b = &wire_keys[*op.parent_b_ * num_simd];
+      const auto* gate_input_keys_b = &wire_keys[slot(*op.parent_b_) * num_simd];
       if (op.type_ == ENCRYPTO::PrimitiveOperationType::XOR) {
         if (parallel) {
           __gnu_parallel::transform(gate_input_keys_a, gate_input_keys_a + num_simd,
@@ -271,11 +346,11 @@ void HalfGateEvaluator::evaluate_circuit(
         }
       } else if (op.type_ == ENCRYPTO::PrimitiveOperationType::AND) {
         if (parallel) {
-          batch_evaluate_and_omp(gate_output_keys, &garbled_tables[and_j * 2 * num_simd],
-                                 start_index, gate_input_keys_a, gate_input_keys_b, num_simd);
+          batch_evaluate_and_omp(gate_output_keys, get_tables(and_j), start_index,
+                                 gate_input_keys_a, gate_input_keys_b, num_simd);
         } else {
-          batch_evaluate_and(gate_output_keys, &garbled_tables[and_j * 2 * num_simd], start_index,
-                             gate_input_keys_a, gate_input_keys_b, num_simd);
+          batch_evaluate_and(gate_output_keys, get_tables(and_j), start_index, gate_input_keys_a,
+                             gate_input_keys_b, num_simd);
         }
         ++and_j;
         start_index += num_simd;
@@ -290,8 +365,55 @@ void HalfGateEvaluator::evaluate_circuit(
       }
     }
   }
-  std::copy_n(wire_keys.data() + (algo.n_wires_ - algo.n_output_wires_) * num_simd,
-              algo.n_output_wires_ * num_simd, output_keys.data());
+  const auto first_output_wire = algo.n_wires_ - algo.n_output_wires_;
+  for (std::size_t wire_i = 0; wire_i < algo.n_output_wires_; ++wire_i) {
+    std::copy_n(&wire_keys[slot(first_output_wire + wire_i) * num_simd], num_simd,
+                &output_keys[wire_i * num_simd]);
+  }
+}
+
+void HalfGateEvaluator::evaluate_circuit(
+    ENCRYPTO::block128_vector& output_keys, const ENCRYPTO::block128_vector& garbled_tables,
+    std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
+    const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
+    const ENCRYPTO::AlgorithmDescription& algo, bool parallel,
+    const ENCRYPTO::WireSlotAllocation* slot_allocation) const {
+  evaluate_circuit(output_keys, garbled_tables.data(), start_index, input_keys_a, input_keys_b,
+                   num_simd, algo, parallel, slot_allocation);
+}
+
+void HalfGateEvaluator::evaluate_circuit(
+    ENCRYPTO::block128_vector& output_keys, const ENCRYPTO::block128_t* garbled_tables,
+    std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
+    const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
+    const ENCRYPTO::AlgorithmDescription& algo, bool parallel,
+    const ENCRYPTO::WireSlotAllocation* slot_allocation) const {
+  evaluate_circuit_impl(
+      output_keys, start_index, input_keys_a, input_keys_b, num_simd, algo, parallel,
+      slot_allocation,
+      [garbled_tables, num_simd](auto and_j) { return garbled_tables + and_j * 2 * num_simd; });
+}
+
+void HalfGateEvaluator::evaluate_circuit_streaming(
+    ENCRYPTO::block128_vector& output_keys, std::size_t start_index,
+    const ENCRYPTO::block128_vector& input_keys_a, const ENCRYPTO::block128_vector& input_keys_b,
+    std::size_t num_simd, const ENCRYPTO::AlgorithmDescription& algo,
+    std::size_t num_and_gates_per_chunk, const garbled_tables_source_t& source, bool parallel,
+    const ENCRYPTO::WireSlotAllocation* slot_allocation) const {
+  assert(num_and_gates_per_chunk > 0);
+  const auto num_and_gates = get_num_and_gates(algo);
+  const ENCRYPTO::block128_t* chunk = nullptr;
+  evaluate_circuit_impl(output_keys, start_index, input_keys_a, input_keys_b, num_simd, algo,
+                        parallel, slot_allocation, [&](auto and_j) -> const ENCRYPTO::block128_t* {
+                          const auto chunk_offset = and_j % num_and_gates_per_chunk;
+                          if (chunk_offset == 0) {
+                            const auto chunk_size =
+                                std::min(num_and_gates_per_chunk, num_and_gates - and_j);
+                            chunk = source(and_j / num_and_gates_per_chunk,
+                                           2 * chunk_size * num_simd);
+                          }
+                          return chunk + chunk_offset * 2 * num_simd;
+                        });
 }
 
 }  // namespace MOTION::Crypto::garbling
@@ -22,11 +22,14 @@
 
 #pragma once
 
+#include <functional>
+
 #include "crypto/aes/aesni_primitives.h"
 #include "utility/block.h"
 
 namespace ENCRYPTO {
 struct AlgorithmDescription;
+struct WireSlotAllocation;
 }
 
 namespace MOTION::Crypto::garbling {
@@ -39,6 +42,21 @@ struct HalfGatePublicData {
 using half_gate_t = std::array<ENCRYPTO::block128_t, 2>;
 constexpr std::size_t half_gate_block_size = 2;
 
+// Streaming garbled tables: the tables of a circuit are split into chunks of
+// num_and_gates_per_chunk AND gates (each 2 * num_simd blocks).  The garbler
+// hands every chunk to the sink as soon as it is complete, the evaluator pulls
+// chunk i from the source right before evaluating its first AND gate.  The
+// source returns a pointer to the num_blocks blocks of the chunk, which needs
+// to stay valid until the source is called for the next chunk.
+//
+// If a WireSlotAllocation is given, the keys are stored per slot instead of per
+// wire, i.e., only n_slots_ * num_simd keys are kept in memory.
+using garbled_tables_sink_t = std::function<void(std::size_t chunk_i, ENCRYPTO::block128_vector&&)>;
+using garbled_tables_source_t =
+    std::function<const ENCRYPTO::block128_t*(std::size_t chunk_i, std::size_t num_blocks)>;
+
+std::size_t get_num_and_gates(const ENCRYPTO::AlgorithmDescription&);
+
 class HalfGateGarbler {
  public:
   HalfGateGarbler();
@@ -59,9 +77,24 @@ class HalfGateGarbler {
   void garble_circuit(ENCRYPTO::block128_vector& key_c, ENCRYPTO::block128_vector& garbled_tables,
                       std::size_t index, const ENCRYPTO::block128_vector& key_a,
                       const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
-                      const ENCRYPTO::AlgorithmDescription&, bool parallel = false) const;
+                      const ENCRYPTO::AlgorithmDescription&, bool parallel = false,
+                      const ENCRYPTO::WireSlotAllocation* = nullptr) const;
+  void garble_circuit_streaming(ENCRYPTO::block128_vector& key_c, std::size_t index,
+                                const ENCRYPTO::block128_vector& key_a,
+                                const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
+                                const ENCRYPTO::AlgorithmDescription&,
+                                std::size_t num_and_gates_per_chunk, const garbled_tables_sink_t&,
+                                bool parallel = false,
+                                const ENCRYPTO::WireSlotAllocation* = nullptr) const;
 
  private:
+  template <typename GetTables, typename TablesDone>
+  void garble_circuit_impl(ENCRYPTO::block128_vector& key_c, std::size_t index,
+                           const ENCRYPTO::block128_vector& key_a,
+                           const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
+                           const ENCRYPTO::AlgorithmDescription&, bool parallel,
+                           const ENCRYPTO::WireSlotAllocation*, GetTables&&, TablesDone&&) const;
+
   ENCRYPTO::block128_t offset_;
   ENCRYPTO::block128_t hash_key_;
   alignas(aes_block_size) std::array<std::byte, aes_round_keys_size_128> round_keys_;
@@ -89,9 +122,32 @@ class HalfGateEvaluator {
                         const ENCRYPTO::block128_vector& garbled_tables, std::size_t index,
                         const ENCRYPTO::block128_vector& key_a,
                         const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
-                        const ENCRYPTO::AlgorithmDescription&, bool parallel = false) const;
+                        const ENCRYPTO::AlgorithmDescription&, bool parallel = false,
+                        const ENCRYPTO::WireSlotAllocation* = nullptr) const;
+  // garbled_tables points to the 2 * num_simd * get_num_and_gates(algo) blocks
+  // of the tables, e.g., inside of a received message
+  void evaluate_circuit(ENCRYPTO::block128_vector& key_c,
+                        const ENCRYPTO::block128_t* garbled_tables, std::size_t index,
+                        const ENCRYPTO::block128_vector& key_a,
+                        const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
+                        const ENCRYPTO::AlgorithmDescription&, bool parallel = false,
+                        const ENCRYPTO::WireSlotAllocation* = nullptr) const;
+  void evaluate_circuit_streaming(ENCRYPTO::block128_vector& key_c, std::size_t index,
+                                  const ENCRYPTO::block128_vector& key_a,
+                                  const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
+                                  const ENCRYPTO::AlgorithmDescription&,
+                                  std::size_t num_and_gates_per_chunk,
+                                  const garbled_tables_source_t&, bool parallel = false,
+                                  const ENCRYPTO::WireSlotAllocation* = nullptr) const;
 
  private:
+  template <typename GetTables>
+  void evaluate_circuit_impl(ENCRYPTO::block128_vector& key_c, std::size_t index,
+                             const ENCRYPTO::block128_vector& key_a,
+                             const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
+                             const ENCRYPTO::AlgorithmDescription&, bool parallel,
+                             const ENCRYPTO::WireSlotAllocation*, GetTables&&) const;
+
   ENCRYPTO::block128_t hash_key_;
   alignas(aes_block_size) std::array<std::byte, aes_round_keys_size_128> round_keys_;
 };
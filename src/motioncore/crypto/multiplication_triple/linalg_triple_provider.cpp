@@ -23,13 +23,26 @@
 #include "linalg_triple_provider.h"
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <stdexcept>
 #include <type_traits>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <fmt/format.h>
 
+#include "communication/communication_layer.h"
+#include "communication/fbs_headers/message_generated.h"
+#include "communication/message.h"
+#include "communication/message_handler.h"
 #include "crypto/arithmetic_provider.h"
+#include "crypto/blake2b.h"
 #include "crypto/oblivious_transfer/ot_flavors.h"
 #include "crypto/oblivious_transfer/ot_provider.h"
 #include "statistics/run_time_stats.h"
@@ -41,6 +54,133 @@
 
 namespace MOTION {
 
+namespace {
+
+// layout of the files written by LinAlgTripleProvider::write_triples: a header
+// consisting of the batch id and the number of setups which have taken triples
+// from the file, followed by one section per operation.  A section consists of
+// the kind, the bit size, the operation, the number of triples, the number of
+// triples which have been consumed and the triples themselves.  The counters
+// are updated in place (see LinAlgTriplesFromFile::setup).
+constexpr std::array<char, 8> triple_file_magic = {'M', 'O', 'T', 'N', 'L', 'A', 'T', 'R'};
+constexpr std::uint32_t triple_file_version = 2;
+constexpr std::streamoff triple_file_num_setups_pos =
+    triple_file_magic.size() + sizeof(std::uint32_t) + sizeof(LinAlgTripleProvider::BatchId);
+
+enum class TripleKind : std::uint8_t { gemm = 0, conv2d = 1, relu = 2 };
+
+// the batch id is derived from a session id which both parties share, s.t.
+// their files can be matched up
+LinAlgTripleProvider::BatchId make_triple_batch_id(const std::vector<std::uint8_t>& session_id) {
+  static constexpr char label[] = "MOTION linalg triple batch id";
+  std::vector<std::uint8_t> input(std::begin(label), std::end(label));
+  input.insert(std::end(input), std::begin(session_id), std::end(session_id));
+  std::uint8_t digest[EVP_MAX_MD_SIZE];
+  Blake2b(input.data(), digest, input.size());
+  LinAlgTripleProvider::BatchId batch_id;
+  std::copy_n(digest, batch_id.size(), batch_id.data());
+  return batch_id;
+}
+
+// overwrite a counter of the file at the given position
+void write_counter(int fd, std::streamoff pos, std::uint64_t value,
+                   const std::filesystem::path& path) {
+  if (::pwrite(fd, &value, sizeof(value), pos) != sizeof(value)) {
+    throw std::runtime_error(
+        fmt::format("could not update triple file {}: {}", path.string(), std::strerror(errno)));
+  }
+}
+
+template <typename V>
+void write_value(std::ostream& os, const V& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(V));
+}
+
+template <typename V>
+V read_value(std::istream& is) {
+  V value;
+  is.read(reinterpret_cast<char*>(&value), sizeof(V));
+  return value;
+}
+
+template <std::size_t N>
+void write_shape(std::ostream& os, const std::array<std::size_t, N>& shape) {
+  for (auto x : shape) {
+    write_value(os, std::uint64_t(x));
+  }
+}
+
+template <std::size_t N>
+void read_shape(std::istream& is, std::array<std::size_t, N>& shape) {
+  for (auto& x : shape) {
+    x = read_value<std::uint64_t>(is);
+  }
+}
+
+void write_op(std::ostream& os, const tensor::GemmOp& gemm_op) {
+  write_shape(os, gemm_op.input_A_shape_);
+  write_shape(os, gemm_op.input_B_shape_);
+  write_shape(os, gemm_op.output_shape_);
+  write_value(os, gemm_op.alpha_);
+  write_value(os, gemm_op.beta_);
+  write_value(os, std::uint8_t(gemm_op.transA_));
+  write_value(os, std::uint8_t(gemm_op.transB_));
+}
+
+void read_op(std::istream& is, tensor::GemmOp& gemm_op) {
+  read_shape(is, gemm_op.input_A_shape_);
+  read_shape(is, gemm_op.input_B_shape_);
+  read_shape(is, gemm_op.output_shape_);
+  gemm_op.alpha_ = read_value<float>(is);
+  gemm_op.beta_ = read_value<float>(is);
+  gemm_op.transA_ = read_value<std::uint8_t>(is);
+  gemm_op.transB_ = read_value<std::uint8_t>(is);
+}
+
+void write_op(std::ostream& os, const tensor::Conv2DOp& conv_op) {
+  write_shape(os, conv_op.kernel_shape_);
+  write_shape(os, conv_op.input_shape_);
+  write_shape(os, conv_op.output_shape_);
+  write_shape(os, conv_op.dilations_);
+  write_shape(os, conv_op.pads_);
+  write_shape(os, conv_op.strides_);
+}
+
+void read_op(std::istream& is, tensor::Conv2DOp& conv_op) {
+  read_shape(is, conv_op.kernel_shape_);
+  read_shape(is, conv_op.input_shape_);
+  read_shape(is, conv_op.output_shape_);
+  read_shape(is, conv_op.dilations_);
+  read_shape(is, conv_op.pads_);
+  read_shape(is, conv_op.strides_);
+}
+
+template <typename T>
+void write_vector(std::ostream& os, const std::vector<T>& vec) {
+  os.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(T));
+}
+
+template <typename T>
+std::vector<T> read_vector(std::istream& is, std::size_t size) {
+  std::vector<T> vec(size);
+  is.read(reinterpret_cast<char*>(vec.data()), size * sizeof(T));
+  return vec;
+}
+
+void write_bits(std::ostream& os, const ENCRYPTO::BitVector<>& bits) {
+  const auto& data = bits.GetData();
+  os.write(reinterpret_cast<const char*>(data.data()),
+           Helpers::Convert::BitsToBytes(bits.GetSize()));
+}
+
+ENCRYPTO::BitVector<> read_bits(std::istream& is, std::size_t num_bits) {
+  std::vector<std::byte> data(Helpers::Convert::BitsToBytes(num_bits));
+  is.read(reinterpret_cast<char*>(data.data()), data.size());
+  return ENCRYPTO::BitVector<>(std::move(data), num_bits);
+}
+
+}  // namespace
+
 template <typename T>
 std::size_t LinAlgTripleProvider::register_for_gemm_triple(const tensor::GemmOp& gemm_op) {
   assert(gemm_op.verify());
@@ -225,6 +365,124 @@ LinAlgTripleProvider::BooleanTriple LinAlgTripleProvider::get_relu_triple(std::s
   }
 }
 
+void LinAlgTripleProvider::register_for_requirements(
+    const LinAlgTripleRequirements& requirements) {
+  const auto register_triples = [this, &requirements](auto dummy_arg) {
+    using T = decltype(dummy_arg);
+    for (std::size_t run_i = 0; run_i < requirements.num_runs_; ++run_i) {
+      for (const auto& gemm_op : requirements.gemm_ops_) {
+        register_for_gemm_triple<T>(gemm_op);
+      }
+      for (const auto& conv_op : requirements.conv2d_ops_) {
+        register_for_conv2d_triple<T>(conv_op);
+      }
+      for (const auto num_triples : requirements.relu_sizes_) {
+        register_for_relu_triple(num_triples, requirements.bit_size_);
+      }
+    }
+  };
+
+  switch (requirements.bit_size_) {
+    case 8:
+      return register_triples(std::uint8_t{});
+    case 16:
+      return register_triples(std::uint16_t{});
+    case 32:
+      return register_triples(std::uint32_t{});
+    case 64:
+      return register_triples(std::uint64_t{});
+    case 128:
+      return register_triples(__uint128_t{});
+    default:
+      throw std::logic_error("invalid bit size");
+  }
+}
+
+void LinAlgTripleProvider::save_triples(const std::filesystem::path& path,
+                                        const std::vector<std::uint8_t>& session_id) {
+  wait_setup();
+  write_triples(path, make_triple_batch_id(session_id));
+}
+
+void LinAlgTripleProvider::write_triples(const std::filesystem::path& path,
+                                         const BatchId& batch_id) const {
+  // the triples are secret, so create the file s.t. only its owner can read it,
+  // and replace the old file only after the new one is complete
+  auto tmp_path = path;
+  tmp_path += ".tmp";
+  const int fd =
+      ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format("could not create triple file {}: {}", tmp_path.string(),
+                                         std::strerror(errno)));
+  }
+  ::close(fd);
+  std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+  file.write(triple_file_magic.data(), triple_file_magic.size());
+  write_value(file, triple_file_version);
+  file.write(reinterpret_cast<const char*>(batch_id.data()), batch_id.size());
+  // number of setups
+  write_value(file, std::uint64_t(0));
+
+  const auto write_linalg_triples = [&file](TripleKind kind, const auto& triple_map) {
+    for (const auto& [op, triple_vec] : triple_map) {
+      if (triple_vec.empty()) {
+        continue;
+      }
+      using T = typename decltype(triple_vec.front().a_)::value_type;
+      write_value(file, kind);
+      write_value(file, std::uint64_t(ENCRYPTO::bit_size_v<T>));
+      write_op(file, op);
+      write_value(file, std::uint64_t(triple_vec.size()));
+      // number of consumed triples
+      write_value(file, std::uint64_t(0));
+      for (const auto& triple : triple_vec) {
+        write_vector(file, triple.a_);
+        write_vector(file, triple.b_);
+        write_vector(file, triple.c_);
+      }
+    }
+  };
+
+  write_linalg_triples(TripleKind::gemm, gemm_triples_8_);
+  write_linalg_triples(TripleKind::gemm, gemm_triples_16_);
+  write_linalg_triples(TripleKind::gemm, gemm_triples_32_);
+  write_linalg_triples(TripleKind::gemm, gemm_triples_64_);
+  write_linalg_triples(TripleKind::gemm, gemm_triples_128_);
+
+  write_linalg_triples(TripleKind::conv2d, conv2d_triples_8_);
+  write_linalg_triples(TripleKind::conv2d, conv2d_triples_16_);
+  write_linalg_triples(TripleKind::conv2d, conv2d_triples_32_);
+  write_linalg_triples(TripleKind::conv2d, conv2d_triples_64_);
+  write_linalg_triples(TripleKind::conv2d, conv2d_triples_128_);
+
+  for (const auto& [key, triple_vec] : relu_triples_) {
+    if (triple_vec.empty()) {
+      continue;
+    }
+    const auto [num_triples, bit_size] = key;
+    write_value(file, TripleKind::relu);
+    write_value(file, std::uint64_t(bit_size));
+    write_value(file, std::uint64_t(num_triples));
+    write_value(file, std::uint64_t(triple_vec.size()));
+    write_value(file, std::uint64_t(0));
+    for (const auto& triple : triple_vec) {
+      write_bits(file, triple.a_);
+      std::for_each(std::begin(triple.b_), std::end(triple.b_),
+                    [&file](const auto& bv) { write_bits(file, bv); });
+      std::for_each(std::begin(triple.c_), std::end(triple.c_),
+                    [&file](const auto& bv) { write_bits(file, bv); });
+    }
+  }
+
+  file.close();
+  if (!file) {
+    std::filesystem::remove(tmp_path);
+    throw std::runtime_error(fmt::format("could not write triple file {}", tmp_path.string()));
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
 // ---------- LinAlgTriplesFromAP ----------
 
 LinAlgTriplesFromAP::LinAlgTriplesFromAP(ArithmeticProvider& arith_provider,
@@ -494,6 +752,270 @@ void LinAlgTriplesFromAP::registration_hook_boolean(std::size_t num_triples, std
   it->second.emplace_back(std::move(pair));
 }
 
+// ---------- LinAlgTriplesFromFile ----------
+
+namespace {
+
+// Handler for messages of type LinAlgTripleFileCheck
+class LinAlgTripleFileCheckHandler : public Communication::MessageHandler {
+ public:
+  LinAlgTripleFileCheckHandler(ENCRYPTO::ReusablePromise<std::vector<std::uint8_t>>& promise)
+      : promise_(promise) {}
+  void received_message(std::size_t, std::vector<std::uint8_t>&& raw_message) override {
+    assert(!raw_message.empty());
+    auto message = Communication::GetMessage(raw_message.data());
+    auto payload = message->payload();
+    promise_.set_value(std::vector<std::uint8_t>(payload->begin(), payload->end()));
+  }
+
+ private:
+  ENCRYPTO::ReusablePromise<std::vector<std::uint8_t>>& promise_;
+};
+
+}  // namespace
+
+LinAlgTriplesFromFile::LinAlgTriplesFromFile(std::filesystem::path path,
+                                             Communication::CommunicationLayer& communication_layer,
+                                             std::shared_ptr<Logger> logger)
+    : path_(std::move(path)),
+      communication_layer_(communication_layer),
+      logger_(logger),
+      check_future_(check_promise_.get_future()) {
+  read_index();
+  communication_layer_.register_message_handler(
+      [this](auto) { return std::make_shared<LinAlgTripleFileCheckHandler>(check_promise_); },
+      {Communication::MessageType::LinAlgTripleFileCheck});
+}
+
+LinAlgTriplesFromFile::~LinAlgTriplesFromFile() {
+  communication_layer_.deregister_message_handler(
+      {Communication::MessageType::LinAlgTripleFileCheck});
+}
+
+void LinAlgTriplesFromFile::read_index() {
+  std::ifstream file(path_, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(fmt::format("could not open triple file {}", path_.string()));
+  }
+  const auto file_size = std::filesystem::file_size(path_);
+  std::array<char, triple_file_magic.size()> magic;
+  file.read(magic.data(), magic.size());
+  const auto version = read_value<std::uint32_t>(file);
+  file.read(reinterpret_cast<char*>(batch_id_.data()), batch_id_.size());
+  num_setups_ = read_value<std::uint64_t>(file);
+  if (!file || magic != triple_file_magic || version != triple_file_version) {
+    throw std::runtime_error(fmt::format("{} is not a valid triple file", path_.string()));
+  }
+
+  // only the section headers are read here, the triples are read in setup
+  while (file.peek() != std::ifstream::traits_type::eof()) {
+    auto& section = sections_.emplace_back();
+    section.kind_ = read_value<std::uint8_t>(file);
+    section.bit_size_ = read_value<std::uint64_t>(file);
+    bool valid = false;
+    if (section.kind_ == static_cast<std::uint8_t>(TripleKind::gemm)) {
+      read_op(file, section.gemm_op_);
+      valid = section.gemm_op_.verify();
+      section.triple_size_ = (section.gemm_op_.compute_input_A_size() +
+                              section.gemm_op_.compute_input_B_size() +
+                              section.gemm_op_.compute_output_size()) *
+                             (section.bit_size_ / 8);
+    } else if (section.kind_ == static_cast<std::uint8_t>(TripleKind::conv2d)) {
+      read_op(file, section.conv_op_);
+      valid = section.conv_op_.verify();
+      section.triple_size_ = (section.conv_op_.compute_input_size() +
+                              section.conv_op_.compute_kernel_size() +
+                              section.conv_op_.compute_output_size()) *
+                             (section.bit_size_ / 8);
+    } else if (section.kind_ == static_cast<std::uint8_t>(TripleKind::relu)) {
+      section.num_relu_triples_ = read_value<std::uint64_t>(file);
+      valid = section.bit_size_ >= 2 && section.bit_size_ <= 128;
+      section.triple_size_ = Helpers::Convert::BitsToBytes(section.num_relu_triples_) *
+                             (2 * section.bit_size_ - 1);
+    }
+    if (section.kind_ != static_cast<std::uint8_t>(TripleKind::relu)) {
+      valid = valid && (section.bit_size_ == 8 || section.bit_size_ == 16 ||
+                        section.bit_size_ == 32 || section.bit_size_ == 64 ||
+                        section.bit_size_ == 128);
+    }
+    section.count_ = read_value<std::uint64_t>(file);
+    section.consumed_pos_ = file.tellg();
+    section.consumed_ = read_value<std::uint64_t>(file);
+    section.data_pos_ = file.tellg();
+    if (!file || !valid || section.triple_size_ == 0 || section.consumed_ > section.count_ ||
+        section.count_ > (file_size - section.data_pos_) / section.triple_size_) {
+      throw std::runtime_error(fmt::format("triple file {} is corrupted", path_.string()));
+    }
+    file.seekg(section.data_pos_ + std::streamoff(section.count_ * section.triple_size_));
+  }
+}
+
+void LinAlgTriplesFromFile::setup() {
+  if constexpr (MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("LinAlgTriplesFromFile::setup start");
+    }
+  }
+
+  // Both parties need to take their triples from the same positions of files
+  // which belong to the same batch.  This holds if they agree on the batch id
+  // and on the number of setups which have been served from their files.
+  {
+    std::vector<std::uint8_t> state(std::begin(batch_id_), std::end(batch_id_));
+    const auto* num_setups_ptr = reinterpret_cast<const std::uint8_t*>(&num_setups_);
+    state.insert(std::end(state), num_setups_ptr, num_setups_ptr + sizeof(num_setups_));
+    communication_layer_.send_message(
+        1 - communication_layer_.get_my_id(),
+        Communication::BuildMessage(Communication::MessageType::LinAlgTripleFileCheck, &state));
+    const auto their_state = check_future_.get();
+    if (their_state.size() != state.size() ||
+        !std::equal(std::begin(state), std::begin(state) + batch_id_.size(),
+                    std::begin(their_state))) {
+      throw std::runtime_error(fmt::format(
+          "triple file {} does not belong to the same batch as the one of the other party",
+          path_.string()));
+    }
+    if (!std::equal(std::begin(state), std::end(state), std::begin(their_state))) {
+      throw std::runtime_error(fmt::format(
+          "triple file {} is out of sync with the one of the other party", path_.string()));
+    }
+  }
+
+  std::ifstream file(path_, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(fmt::format("could not open triple file {}", path_.string()));
+  }
+  // sections whose consumed counter needs to be written back
+  std::vector<Section*> used_sections;
+
+  // find the section of an operation and reserve count triples from it
+  const auto take = [this, &file, &used_sections](const char* name, auto kind,
+                                                   std::size_t bit_size, std::size_t count,
+                                                   auto matches) {
+    auto it = std::find_if(std::begin(sections_), std::end(sections_), [&](const auto& section) {
+      return section.kind_ == static_cast<std::uint8_t>(kind) && section.bit_size_ == bit_size &&
+             matches(section);
+    });
+    const auto available = it == std::end(sections_) ? 0 : it->count_ - it->consumed_;
+    if (available < count) {
+      throw std::runtime_error(
+          fmt::format("not enough precomputed {} triples: {} required, {} available", name, count,
+                      available));
+    }
+    file.seekg(it->data_pos_ + std::streamoff(it->consumed_ * it->triple_size_));
+    it->consumed_ += count;
+    used_sections.push_back(&*it);
+  };
+
+  const auto read_linalg_triples = [&file](auto& triple_vec, std::size_t count,
+                                           std::size_t size_a, std::size_t size_b,
+                                           std::size_t size_c) {
+    using T = typename decltype(triple_vec.front().a_)::value_type;
+    triple_vec.resize(count);
+    for (auto& triple : triple_vec) {
+      triple.a_ = read_vector<T>(file, size_a);
+      triple.b_ = read_vector<T>(file, size_b);
+      triple.c_ = read_vector<T>(file, size_c);
+    }
+  };
+
+  const auto take_gemm_triples = [&](const auto& count_map, auto& triple_map) {
+    for (const auto& [gemm_op, count] : count_map) {
+      auto& triple_vec = triple_map.at(gemm_op);
+      using T = typename decltype(triple_vec.front().a_)::value_type;
+      take("gemm", TripleKind::gemm, ENCRYPTO::bit_size_v<T>, count,
+           [&gemm_op](const auto& section) { return section.gemm_op_ == gemm_op; });
+      read_linalg_triples(triple_vec, count, gemm_op.compute_input_A_size(),
+                          gemm_op.compute_input_B_size(), gemm_op.compute_output_size());
+    }
+  };
+
+  const auto take_conv2d_triples = [&](const auto& count_map, auto& triple_map) {
+    for (const auto& [conv_op, count] : count_map) {
+      auto& triple_vec = triple_map.at(conv_op);
+      using T = typename decltype(triple_vec.front().a_)::value_type;
+      take("conv2d", TripleKind::conv2d, ENCRYPTO::bit_size_v<T>, count,
+           [&conv_op](const auto& section) { return section.conv_op_ == conv_op; });
+      read_linalg_triples(triple_vec, count, conv_op.compute_input_size(),
+                          conv_op.compute_kernel_size(), conv_op.compute_output_size());
+    }
+  };
+
+  take_gemm_triples(gemm_counts_8_, gemm_triples_8_);
+  take_gemm_triples(gemm_counts_16_, gemm_triples_16_);
+  take_gemm_triples(gemm_counts_32_, gemm_triples_32_);
+  take_gemm_triples(gemm_counts_64_, gemm_triples_64_);
+  take_gemm_triples(gemm_counts_128_, gemm_triples_128_);
+
+  take_conv2d_triples(conv2d_counts_8_, conv2d_triples_8_);
+  take_conv2d_triples(conv2d_counts_16_, conv2d_triples_16_);
+  take_conv2d_triples(conv2d_counts_32_, conv2d_triples_32_);
+  take_conv2d_triples(conv2d_counts_64_, conv2d_triples_64_);
+  take_conv2d_triples(conv2d_counts_128_, conv2d_triples_128_);
+
+  for (const auto& [key, count] : relu_counts_) {
+    const auto [num_triples, bit_size] = key;
+    take("relu", TripleKind::relu, bit_size, count,
+         [num_triples = num_triples](const auto& section) {
+           return section.num_relu_triples_ == num_triples;
+         });
+    auto& triple_vec = relu_triples_.at(key);
+    triple_vec.resize(count);
+    for (auto& triple : triple_vec) {
+      triple.a_ = read_bits(file, num_triples);
+      triple.b_.resize(bit_size - 1);
+      std::generate(std::begin(triple.b_), std::end(triple.b_),
+                    [&file, num_triples = num_triples] { return read_bits(file, num_triples); });
+      triple.c_.resize(bit_size - 1);
+      std::generate(std::begin(triple.c_), std::end(triple.c_),
+                    [&file, num_triples = num_triples] { return read_bits(file, num_triples); });
+    }
+  }
+  if (!file) {
+    throw std::runtime_error(fmt::format("could not read triple file {}", path_.string()));
+  }
+
+  // Mark the triples as consumed before handing them out, s.t. they are never
+  // used twice.  Only the counters are written, the file is not rewritten.
+  {
+    const int fd = ::open(path_.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::runtime_error(fmt::format("could not open triple file {}: {}", path_.string(),
+                                           std::strerror(errno)));
+    }
+    try {
+      for (const auto* section : used_sections) {
+        write_counter(fd, section->consumed_pos_, section->consumed_, path_);
+      }
+      ++num_setups_;
+      write_counter(fd, triple_file_num_setups_pos, num_setups_, path_);
+      if (::fsync(fd) != 0) {
+        throw std::runtime_error(fmt::format("could not sync triple file {}: {}",
+                                             path_.string(), std::strerror(errno)));
+      }
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+  }
+
+  set_setup_ready();
+
+  if constexpr (MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug(fmt::format("LinAlgTriplesFromFile::setup end ({} setups served)",
+                                    num_setups_));
+    }
+  }
+}
+
+void LinAlgTriplesFromFile::registration_hook(const tensor::GemmOp&, std::size_t) {}
+
+void LinAlgTriplesFromFile::registration_hook(const tensor::Conv2DOp&, std::size_t) {}
+
+void LinAlgTriplesFromFile::registration_hook_boolean(std::size_t, std::size_t) {}
+
 // ---------- FakeLinAlgTripleProvider ----------
 
 void FakeLinAlgTripleProvider::setup() {
@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <filesystem>
+#include <ios>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -32,6 +35,7 @@
 #include "utility/bit_vector.h"
 #include "utility/enable_wait.h"
 #include "utility/hash.h"
+#include "utility/reusable_future.h"
 #include "utility/type_traits.hpp"
 
 namespace ENCRYPTO::ObliviousTransfer {
@@ -42,6 +46,10 @@ class ROTSender;
 
 namespace MOTION {
 
+namespace Communication {
+class CommunicationLayer;
+}
+
 namespace Statistics {
 struct RunTimeStats;
 }
@@ -57,6 +65,17 @@ template <typename T>
 class MatrixMultiplicationRHS;
 class Logger;
 
+// Shape of a model whose triples are generated in advance, i.e., the GEMMs and
+// convolutions of its layers and the sizes of its ReLU layers.
+struct LinAlgTripleRequirements {
+  std::size_t bit_size_ = 64;
+  std::vector<tensor::GemmOp> gemm_ops_;
+  std::vector<tensor::Conv2DOp> conv2d_ops_;
+  std::vector<std::size_t> relu_sizes_;
+  // number of evaluations of the model
+  std::size_t num_runs_ = 1;
+};
+
 class LinAlgTripleProvider : public ENCRYPTO::enable_wait_setup {
  public:
   virtual ~LinAlgTripleProvider() = default;
@@ -90,9 +109,23 @@ class LinAlgTripleProvider : public ENCRYPTO::enable_wait_setup {
   [[nodiscard]] BooleanTriple get_relu_triple(std::size_t num_triples, std::size_t bit_size,
                                               std::size_t index);
 
+  // register all triples needed by a model
+  void register_for_requirements(const LinAlgTripleRequirements&);
+
+  // Write the triples generated in setup to a file which can be used with
+  // LinAlgTriplesFromFile.  Needs to be called before any triple is retrieved.
+  // Both parties need to pass the same session id, which identifies the batch
+  // of triples, s.t. LinAlgTriplesFromFile only uses matching files together.
+  void save_triples(const std::filesystem::path&, const std::vector<std::uint8_t>& session_id);
+
+  using BatchId = std::array<std::uint8_t, 16>;
+
   virtual void setup() = 0;
 
  protected:
+  // Write the triples to a file which is only accessible by its owner.
+  void write_triples(const std::filesystem::path&, const BatchId&) const;
+
   virtual void registration_hook(const tensor::GemmOp&, std::size_t bit_size) = 0;
   virtual void registration_hook(const tensor::Conv2DOp&, std::size_t bit_size) = 0;
   virtual void registration_hook_boolean(std::size_t num_triples, std::size_t bit_size) = 0;
@@ -172,6 +205,53 @@ class LinAlgTriplesFromAP : public LinAlgTripleProvider {
       relu_handles_;
 };
 
+// Provider of triples which have been generated in advance and written to a
+// file with LinAlgTripleProvider::save_triples.  Each setup reads only the
+// triples registered for the circuit and marks them as consumed by advancing
+// counters in the file, s.t. they are never used twice.  The parties check in
+// setup that their files belong to the same batch and are at the same position.
+class LinAlgTriplesFromFile : public LinAlgTripleProvider {
+ public:
+  LinAlgTriplesFromFile(std::filesystem::path, Communication::CommunicationLayer&,
+                        std::shared_ptr<Logger>);
+  ~LinAlgTriplesFromFile();
+
+  void setup() override;
+
+ protected:
+  void registration_hook(const tensor::GemmOp&, std::size_t bit_size) override;
+  void registration_hook(const tensor::Conv2DOp&, std::size_t bit_size) override;
+  void registration_hook_boolean(std::size_t num_triples, std::size_t bit_size) override;
+
+ private:
+  // the triples of one operation in the file
+  struct Section {
+    std::uint8_t kind_;
+    std::size_t bit_size_;
+    tensor::GemmOp gemm_op_;
+    tensor::Conv2DOp conv_op_;
+    std::size_t num_relu_triples_ = 0;
+    std::size_t count_;
+    std::size_t consumed_;
+    // position of the consumed counter and of the first triple
+    std::streamoff consumed_pos_;
+    std::streamoff data_pos_;
+    // size of a single triple in bytes
+    std::size_t triple_size_;
+  };
+
+  void read_index();
+
+  std::filesystem::path path_;
+  Communication::CommunicationLayer& communication_layer_;
+  std::shared_ptr<Logger> logger_;
+  BatchId batch_id_;
+  std::uint64_t num_setups_;
+  std::vector<Section> sections_;
+  ENCRYPTO::ReusablePromise<std::vector<std::uint8_t>> check_promise_;
+  ENCRYPTO::ReusableFuture<std::vector<std::uint8_t>> check_future_;
+};
+
 // Generator of fake triples which just consists of random data.
 class FakeLinAlgTripleProvider : public LinAlgTripleProvider {
  public:
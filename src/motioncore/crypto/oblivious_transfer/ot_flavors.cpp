@@ -41,14 +41,10 @@ BasicOTSender::BasicOTSender(std::size_t ot_id, std::size_t num_ots, std::size_t
         return data_.received_correction_offsets_.find(ot_id_) !=
                data_.received_correction_offsets_.end();
       }));
-  data_.y0_.resize(data_.y0_.size() + num_ots);
-  data_.y1_.resize(data_.y1_.size() + num_ots);
-  data_.bitlengths_.resize(data_.bitlengths_.size() + num_ots, bitlen);
-  data_.corrections_.Resize(data_.corrections_.GetSize() + num_ots);
-  data_.num_ots_in_batch_.emplace(ot_id, num_ots);
+  data_.Reserve(ot_id, num_ots, bitlen);
 }
 
-void BasicOTSender::WaitSetup() const { data_.setup_finished_cond_->Wait(); }
+void BasicOTSender::WaitSetup() const { data_.WaitForOTs(ot_id_, num_ots_); }
 
 // ---------- BasicOTReceiver ----------
 
@@ -57,12 +53,10 @@ BasicOTReceiver::BasicOTReceiver(std::size_t ot_id, std::size_t num_ots, std::si
                                  const std::function<void(flatbuffers::FlatBufferBuilder &&)> &Send,
                                  MOTION::OTExtensionReceiverData &data)
     : OTVector(ot_id, num_ots, bitlen, p, Send), data_(data) {
-  data_.outputs_.resize(ot_id + num_ots);
-  data_.bitlengths_.resize(ot_id + num_ots, bitlen);
-  data_.num_ots_in_batch_.emplace(ot_id, num_ots);
+  data_.Reserve(ot_id, num_ots, bitlen);
 }
 
-void BasicOTReceiver::WaitSetup() const { data_.setup_finished_cond_->Wait(); }
+void BasicOTReceiver::WaitSetup() const { data_.WaitForOTs(ot_id_, num_ots_); }
 
 void BasicOTReceiver::SendCorrections() {
   if (choices_.Empty()) {
@@ -342,9 +336,12 @@ void ACOTSender<T>::ComputeOutputs() {
 
 template <typename T>
 void ACOTSender<T>::SendMessages() const {
-  auto buffer = correlations_;
+  // the correlations may be a single copy that is repeated for all OTs
+  const auto num_distinct_ots = num_ots_ / num_correlation_repetitions_;
+  std::vector<T> buffer(num_ots_ * vector_size_);
   if (vector_size_ == 1) {
     for (std::size_t ot_i = 0; ot_i < num_ots_; ++ot_i) {
+      buffer[ot_i] = correlations_[ot_i % num_distinct_ots];
       buffer[ot_i] += *reinterpret_cast<const T *>(data_.y0_.at(ot_id_ + ot_i).GetData().data());
       buffer[ot_i] += *reinterpret_cast<const T *>(data_.y1_.at(ot_id_ + ot_i).GetData().data());
     }
@@ -352,9 +349,10 @@ void ACOTSender<T>::SendMessages() const {
     for (std::size_t ot_i = 0; ot_i < num_ots_; ++ot_i) {
       auto y0_p = reinterpret_cast<const T *>(data_.y0_.at(ot_id_ + ot_i).GetData().data());
       auto y1_p = reinterpret_cast<const T *>(data_.y1_.at(ot_id_ + ot_i).GetData().data());
+      auto c_p = &correlations_[(ot_i % num_distinct_ots) * vector_size_];
       auto b_p = &buffer[ot_i * vector_size_];
       for (std::size_t j = 0; j < vector_size_; ++j) {
-        b_p[j] += y0_p[j] + y1_p[j];
+        b_p[j] = c_p[j] + y0_p[j] + y1_p[j];
       }
     }
   }
@@ -232,13 +232,24 @@ class ACOTSender : public BasicOTSender {
   void SetCorrelations(std::vector<T> &&correlations) {
     assert(correlations.size() == num_ots_ * vector_size_);
     correlations_ = std::move(correlations);
+    num_correlation_repetitions_ = 1;
   }
   void SetCorrelations(const std::vector<T> &correlations) {
     assert(correlations.size() == num_ots_ * vector_size_);
     correlations_ = correlations;
+    num_correlation_repetitions_ = 1;
   }
 
-  // get the correlations for the OTs in this batch
+  // set the correlations for the OTs in this batch to num_repetitions copies of
+  // the given correlations without materializing the copies
+  void SetRepeatedCorrelations(std::vector<T> &&correlations, std::size_t num_repetitions) {
+    assert(num_repetitions > 0);
+    assert(correlations.size() * num_repetitions == num_ots_ * vector_size_);
+    correlations_ = std::move(correlations);
+    num_correlation_repetitions_ = num_repetitions;
+  }
+
+  // get the correlations for the OTs in this batch (only one copy if they are repeated)
   const std::vector<T> &GetCorrelations() const { return correlations_; }
 
   // compute the sender's outputs
@@ -256,6 +267,7 @@ class ACOTSender : public BasicOTSender {
   // clear stored data s.t. this handle can be used again
   void clear() noexcept {
     correlations_ = {};
+    num_correlation_repetitions_ = 1;
     outputs_ = {};
     outputs_computed_ = false;
   }
@@ -267,6 +279,9 @@ class ACOTSender : public BasicOTSender {
   // the correlation vector
   std::vector<T> correlations_;
 
+  // how often correlations_ is repeated to cover all OTs
+  std::size_t num_correlation_repetitions_ = 1;
+
   // the "0 output" for the sender (the "1 output" can be computed by applying the correlation)
   std::vector<T> outputs_;
 
@@ -24,6 +24,10 @@
 
 #include "ot_provider.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/ot_extension_generated.h"
 #include "communication/message_handler.h"
@@ -34,6 +38,7 @@
 #include "data_storage/base_ot_data.h"
 #include "data_storage/ot_extension_data.h"
 #include "ot_flavors.h"
+#include "silent_ot.h"
 #include "statistics/run_time_stats.h"
 #include "utility/bit_matrix.h"
 #include "utility/config.h"
@@ -140,14 +145,124 @@ template std::unique_ptr<ACOTReceiver<__uint128_t>> OTProvider::RegisterReceiveA
   return receiver_provider_.RegisterROT(num_ots, vector_size, random_choice, Send_);
 }
 
+namespace {
+
+// expand the rows of a chunk of the sender's bit matrix from the base OTs and
+// xor the receiver's masks to the rows for which our base OT choice is 1
+// (the rows are processed by num_threads threads in parallel)
+std::vector<AlignedBitVector> ComputeSenderRows(const MOTION::BaseOTsReceiverData &base_ots_rcv,
+                                                MOTION::OTExtensionSenderData &ot_ext_snd,
+                                                std::size_t chunk_i, std::size_t block_offset,
+                                                std::size_t num_columns, std::size_t num_threads) {
+  constexpr std::size_t kappa = 128;
+  assert(num_columns % kappa == 0);
+
+  // XXX: note that rows/columns are swapped compared to the ALSZ paper
+  std::vector<AlignedBitVector> v(kappa);
+#pragma omp parallel for num_threads(num_threads)
+  for (std::size_t i = 0; i < kappa; ++i) {
+    PRG prg_var_key;
+    // use the key we got from the base OTs as seed
+    prg_var_key.SetKey(base_ots_rcv.messages_c_.at(i).data());
+    // skip the parts of the output stream used by previous setups and chunks
+    prg_var_key.SetOffset(block_offset);
+    v[i] = AlignedBitVector(prg_var_key.Encrypt(num_columns / 8), num_columns);
+  }
+
+  // wait for all masks of this chunk (they may arrive in any order)
+  ot_ext_snd.u_conds_.at(chunk_i)->Wait();
+  auto &u = ot_ext_snd.u_.at(chunk_i);
+#pragma omp parallel for num_threads(num_threads)
+  for (std::size_t i = 0; i < kappa; ++i) {
+    if (base_ots_rcv.c_.Get(i)) {
+      v[i] ^= u[i];
+    }
+  }
+  // delete the allocated memory
+  u = {};
+  return v;
+}
+
+// expand the rows of a chunk of the receiver's bit matrix T from the base OTs
+// and send the masks u_i = T_i ^ choices ^ PRG(s_{i,1}) to the sender
+// (the rows are processed by num_threads threads in parallel)
+std::vector<AlignedBitVector> ComputeReceiverRows(
+    const MOTION::BaseOTsSenderData &base_ots_snd,
+    const std::function<void(flatbuffers::FlatBufferBuilder &&)> &Send,
+    const AlignedBitVector &choices, std::size_t chunk_i, std::size_t block_offset,
+    std::size_t num_columns, std::size_t num_threads) {
+  constexpr std::size_t kappa = 128;
+  assert(num_columns % kappa == 0);
+  assert(choices.GetSize() == num_columns);
+
+  std::vector<AlignedBitVector> v(kappa);
+#pragma omp parallel for num_threads(num_threads)
+  for (std::size_t i = 0; i < kappa; ++i) {
+    PRG prg_var_key;
+    // T_i = PRG(s_{i,0})
+    prg_var_key.SetKey(base_ots_snd.messages_0_.at(i).data());
+    prg_var_key.SetOffset(block_offset);
+    v[i] = AlignedBitVector(prg_var_key.Encrypt(num_columns / 8), num_columns);
+    auto u = v[i];
+    u ^= choices;
+    prg_var_key.SetKey(base_ots_snd.messages_1_.at(i).data());
+    prg_var_key.SetOffset(block_offset);
+    u ^= AlignedBitVector(prg_var_key.Encrypt(num_columns / 8), num_columns);
+
+    // send this row, the masks are numbered consecutively over the chunks
+    Send(MOTION::Communication::BuildOTExtensionMessageReceiverMasks(
+        u.GetData().data(), u.GetData().size(), chunk_i * kappa + i));
+  }
+  return v;
+}
+
+// number of columns of the blocks of a chunk which are transposed and hashed
+// in parallel, a multiple of 128
+std::size_t GetColumnBlockSize(std::size_t num_columns, std::size_t num_threads) {
+  constexpr std::size_t kappa = 128;
+  const auto num_kappa_blocks = num_columns / kappa;
+  return std::max((num_kappa_blocks + num_threads - 1) / num_threads, std::size_t(1)) * kappa;
+}
+
+// the random choices of the newly extended OTs follow those of the pooled OTs
+void AppendRandomChoices(MOTION::OTExtensionReceiverData &ot_ext_rcv, std::size_t num_pooled,
+                         const AlignedBitVector &random_choices) {
+  if (!ot_ext_rcv.random_choices_) {
+    ot_ext_rcv.random_choices_ = std::make_unique<AlignedBitVector>();
+  }
+  ot_ext_rcv.random_choices_->Resize(num_pooled);
+  ot_ext_rcv.random_choices_->Append(random_choices);
+}
+
+// mark the setup of the sender or receiver side as done
+template <typename OTExtensionDataT>
+void FinishSetup(OTExtensionDataT &ot_ext_data) {
+  {
+    std::scoped_lock lock(ot_ext_data.setup_finished_cond_->GetMutex());
+    ot_ext_data.setup_finished_ = true;
+  }
+  ot_ext_data.setup_finished_cond_->NotifyAll();
+}
+
+}  // namespace
+
 OTProviderFromOTExtension::OTProviderFromOTExtension(
     std::function<void(flatbuffers::FlatBufferBuilder &&)> Send, MOTION::OTExtensionData &data,
-    const MOTION::BaseOTsData &base_ot_data,
+    MOTION::BaseOTsData &base_ot_data,
     MOTION::Crypto::MotionBaseProvider &motion_base_provider, std::size_t party_id,
-    std::shared_ptr<MOTION::Logger> logger)
+    std::shared_ptr<MOTION::Logger> logger, std::size_t chunk_size, std::size_t num_threads)
     : OTProvider(Send, data, party_id, logger),
       base_ot_data_(base_ot_data),
-      motion_base_provider_(motion_base_provider) {
+      motion_base_provider_(motion_base_provider),
+      chunk_size_(chunk_size),
+      // hardware_concurrency() returns 0 if the number of threads is unknown
+      num_threads_(num_threads == 0
+                       ? std::max<std::size_t>(1, std::thread::hardware_concurrency())
+                       : num_threads) {
+  if (chunk_size_ % 128 != 0) {
+    throw std::invalid_argument(
+        fmt::format("OT extension chunk size must be a multiple of 128, got {}", chunk_size_));
+  }
   auto &ot_ext_rcv = data_.GetReceiverData();
   ot_ext_rcv.real_choices_ = std::make_unique<BitVector<>>();
 }
@@ -163,267 +278,517 @@ void OTProviderFromOTExtension::SendSetup() {
   constexpr std::size_t kappa = 128;
 
   // storage for sender and base OT receiver data
-  const auto &base_ots_rcv = base_ot_data_.GetReceiverData();
+  auto &base_ots_rcv = base_ot_data_.GetReceiverData();
   auto &ot_ext_snd = data_.GetSenderData();
 
-  // number of OTs after extension
-  // == width of the bit matrix
-  const std::size_t bit_size = sender_provider_.GetNumOTs();
-  if (bit_size == 0) {
+  // the OTs which are left from a previous setup are taken from the pool
+  const std::size_t num_ots = sender_provider_.GetNumOTs();
+  const std::size_t num_pooled = ot_ext_snd.num_finished_ots_;
+  if (num_ots <= num_pooled) {
     if constexpr (MOTION::MOTION_DEBUG) {
       if (logger_) {
-        logger_->LogDebug("OTProviderFromOTExtension::SendSetup() return, nothing to do");
+        logger_->LogDebug(fmt::format(
+            "OTProviderFromOTExtension::SendSetup() return, {} OTs taken from the pool", num_ots));
       }
     }
-    return;  // no OTs needed
+    FinishSetup(ot_ext_snd);
+    return;
   }
-  ot_ext_snd.bit_size_ = bit_size;
 
-  // XXX: index variable?
-  std::size_t i;
+  // width of the bit matrix, the OTs which are not needed now are pooled
+  const std::size_t bit_size = num_ots - num_pooled + pool_size_;
+  // bit size rounded to blocks
+  const auto bit_size_padded = (bit_size + kappa - 1) / kappa * kappa;
+  const auto chunk_size = chunk_size_ == 0 ? bit_size_padded : chunk_size_;
+  const auto num_chunks = (bit_size_padded + chunk_size - 1) / chunk_size;
 
-  // bit size of the matrix rounded to bytes
-  // XXX: maybe round to blocks?
-  const std::size_t byte_size = MOTION::Helpers::Convert::BitsToBytes(bit_size);
+  // make space for all outputs, s.t. the vectors are not resized while the
+  // outputs of the finished chunks are already in use
+  ot_ext_snd.y0_.resize(num_pooled + bit_size_padded);
+  ot_ext_snd.y1_.resize(num_pooled + bit_size_padded);
+  // the unregistered OTs are hashed to 128 bit and converted when they are used
+  ot_ext_snd.bitlengths_.resize(num_pooled + bit_size_padded, kappa);
 
-  // bit size rounded to blocks
-  const auto bit_size_padded = bit_size + kappa - (bit_size % kappa);
+  // accept the receiver's masks
+  ot_ext_snd.PrepareMasks(bit_size, num_chunks);
 
-  // vector containing the matrix rows
-  // XXX: note that rows/columns are swapped compared to the ALSZ paper
-  std::vector<AlignedBitVector> v(kappa);
+  motion_base_provider_.setup();
+  const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
 
-  // PRG which is used to expand the keys we got from the base OTs
-  PRG prgs_var_key;
-  //// fill the rows of the matrix
-  for (i = 0; i < kappa; ++i) {
-    // use the key we got from the base OTs as seed
-    prgs_var_key.SetKey(base_ots_rcv.messages_c_.at(i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prgs_var_key.SetOffset(base_ots_rcv.consumed_offset_);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prgs_var_key.Encrypt(byte_size));
-    v[i] = AlignedBitVector(std::move(row), bit_size_padded);
+  // the base OTs might have been used previously
+  const std::size_t block_offset = base_ots_rcv.consumed_offset_;
+  for (std::size_t chunk_i = 0; chunk_i < num_chunks; ++chunk_i) {
+    const auto column_offset = chunk_i * chunk_size;
+    const auto num_columns = std::min(chunk_size, bit_size_padded - column_offset);
+
+    const auto v = ComputeSenderRows(base_ots_rcv, ot_ext_snd, chunk_i,
+                                     block_offset + column_offset / kappa, num_columns,
+                                     num_threads_);
+    // the receiver may send the masks of a further chunk
+    Send_(MOTION::Communication::BuildOTExtensionMessageSenderChunkAck(chunk_i));
+
+    // transpose the bit matrix and hash its columns into the outputs, the
+    // column blocks are independent of each other
+    const auto column_block_size = GetColumnBlockSize(num_columns, num_threads_);
+    const auto num_column_blocks = (num_columns + column_block_size - 1) / column_block_size;
+#pragma omp parallel for num_threads(num_threads_)
+    for (std::size_t block_i = 0; block_i < num_column_blocks; ++block_i) {
+      const auto block_begin = block_i * column_block_size;
+      const auto block_columns = std::min(column_block_size, num_columns - block_begin);
+      std::array<const std::byte *, kappa> ptrs;
+      for (std::size_t i = 0; i < kappa; ++i) {
+        ptrs[i] = v[i].GetData().data() + block_begin / 8;
+      }
+      PRG prg_fixed_key;
+      prg_fixed_key.SetKey(fixed_key_aes_key.data());
+      BitMatrix::SenderTransposeAndEncrypt(ptrs, ot_ext_snd.y0_, ot_ext_snd.y1_, base_ots_rcv.c_,
+                                           prg_fixed_key, block_columns, ot_ext_snd.bitlengths_,
+                                           num_pooled + column_offset + block_begin);
+    }
+
+    // the OTs of this chunk can be used now
+    {
+      std::scoped_lock lock(ot_ext_snd.setup_finished_cond_->GetMutex());
+      ot_ext_snd.num_finished_ots_ = num_pooled + column_offset + num_columns;
+    }
+    ot_ext_snd.setup_finished_cond_->NotifyAll();
   }
   ot_ext_snd.consumed_offset_base_ots_ += bit_size_padded / kappa;
+  base_ots_rcv.consumed_offset_ += bit_size_padded / kappa;
+  // masks of a later setup must not be stored before it is prepared
+  ot_ext_snd.bit_size_ = 0;
+  ++num_extensions_;
 
-  // receive the vectors u one by one from the receiver
-  // and xor them to the expanded keys if the corresponding selection bit is 1
-  // transmitted one by one to prevent waiting for finishing all messages to start sending
-  // the vectors can be transmitted in the wrong order
+  // we are done with the setup for the sender side
+  FinishSetup(ot_ext_snd);
 
-  for (auto it = ot_ext_snd.u_futures_.begin(); it < ot_ext_snd.u_futures_.end(); ++it) {
-    const std::size_t u_id{it->get()};
-    if (base_ots_rcv.c_[u_id]) {
-      const auto &u = ot_ext_snd.u_[u_id];
-      ENCRYPTO::BitSpan bs(v[u_id].GetMutableData().data(), bit_size, true);
-      bs ^= u;
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromOTExtension::SendSetup() end");
     }
   }
+}
 
-  // delete the allocated memory
-  ot_ext_snd.u_ = {};
+void OTProviderFromOTExtension::ReceiveSetup() {
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() start");
+    }
+  }
 
-  // array with pointers to each row of the matrix
-  std::array<const std::byte *, kappa> ptrs;
-  for (i = 0u; i < ptrs.size(); ++i) {
-    ptrs[i] = v[i].GetData().data();
+  // security parameter and number of base OTs
+  constexpr std::size_t kappa = 128;
+  // storage for receiver and base OT sender data
+  auto &base_ots_snd = base_ot_data_.GetSenderData();
+  auto &ot_ext_rcv = data_.GetReceiverData();
+
+  // the OTs which are left from a previous setup are taken from the pool
+  const std::size_t num_ots = receiver_provider_.GetNumOTs();
+  const std::size_t num_pooled = ot_ext_rcv.num_finished_ots_;
+  if (num_ots <= num_pooled) {
+    if constexpr (MOTION::MOTION_DEBUG) {
+      if (logger_) {
+        logger_->LogDebug(fmt::format(
+            "OTProviderFromOTExtension::ReceiveSetup() return, {} OTs taken from the pool",
+            num_ots));
+      }
+    }
+    FinishSetup(ot_ext_rcv);
+    return;
   }
 
-  // pad the vector of bitlength with zeros
-  ot_ext_snd.bitlengths_.resize(bit_size_padded, 0);
+  // width of the bit matrix, the OTs which are not needed now are pooled
+  const std::size_t bit_size = num_ots - num_pooled + pool_size_;
+  // rounded up to a multiple of the security parameter
+  const auto bit_size_padded = (bit_size + kappa - 1) / kappa * kappa;
+  const auto chunk_size = chunk_size_ == 0 ? bit_size_padded : chunk_size_;
+  const auto num_chunks = (bit_size_padded + chunk_size - 1) / chunk_size;
+
+  // make random choices (this is precomputation, real inputs are not known yet)
+  const auto random_choices = AlignedBitVector::Random(bit_size_padded);
+  AppendRandomChoices(ot_ext_rcv, num_pooled, random_choices);
+
+  // make space for all outputs, s.t. the vector is not resized while the
+  // outputs of the finished chunks are already in use
+  ot_ext_rcv.outputs_.resize(num_pooled + bit_size_padded);
+  // the unregistered OTs are hashed to 128 bit and converted when they are used
+  ot_ext_rcv.bitlengths_.resize(num_pooled + bit_size_padded, kappa);
 
   motion_base_provider_.setup();
   const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
 
-  // for each (extended) OT i
-  PRG prg_fixed_key;
-  prg_fixed_key.SetKey(fixed_key_aes_key.data());
+  // the base OTs might have been used previously
+  const std::size_t block_offset = base_ots_snd.consumed_offset_;
+  for (std::size_t chunk_i = 0; chunk_i < num_chunks; ++chunk_i) {
+    const auto column_offset = chunk_i * chunk_size;
+    const auto num_columns = std::min(chunk_size, bit_size_padded - column_offset);
 
-  // transpose the bit matrix
-  // XXX: figure out how the result looks like
-  BitMatrix::SenderTransposeAndEncrypt(ptrs, ot_ext_snd.y0_, ot_ext_snd.y1_, base_ots_rcv.c_,
-                                       prg_fixed_key, bit_size_padded, ot_ext_snd.bitlengths_);
-  /*
-    for (i = 0; i < ot_ext_snd.bitlengths_.size(); ++i) {
-      // here we want to store the sender's outputs
-      // XXX: why are the y0_, y1_ vectors resized every time new ots are registered?
-      auto &out0 = ot_ext_snd.y0_[i];
-      auto &out1 = ot_ext_snd.y1_[i];
-
-      // bit length of the OT
-      const auto bitlen = ot_ext_snd.bitlengths_[i];
-
-      // in which of the above "rows" can we find the block
-      const auto row_i = i % kappa;
-      // where in the "row" do we have to look for the block
-      const auto blk_offset = ((kappa / 8) * (i / kappa));
-      auto V_row = reinterpret_cast<std::byte *>(
-          __builtin_assume_aligned(ptrs.at(row_i) + blk_offset, MOTION::MOTION_ALIGNMENT));
-
-      // compute the sender outputs
-      if (bitlen <= kappa) {
-        // the bit length is smaller than 128 bit
-        out0 = BitVector<>(prg_fixed_key.FixedKeyAES(V_row, i), bitlen);
-
-        auto out1_in = base_ots_rcv.c_ ^ BitSpan(V_row, kappa, true);
-        out1 = BitVector<>(prg_fixed_key.FixedKeyAES(out1_in.GetData().data(), i), bitlen);
-      } else {
-        // string OT with bit length > 128 bit
-        // -> do seed compression and send later only 128 bit seeds
-        auto seed0 = prg_fixed_key.FixedKeyAES(V_row, i);
-        prgs_var_key.SetKey(seed0.data());
-        out0 =
-            BitVector<>(prgs_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)),
-    bitlen);
-
-        auto out1_in = base_ots_rcv.c_ ^ BitSpan(V_row, kappa, true);
-        auto seed1 = prg_fixed_key.FixedKeyAES(out1_in.GetData().data(), i);
-        prgs_var_key.SetKey(seed1.data());
-        out1 =
-            BitVector<>(prgs_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)),
-    bitlen);
+    // wait until the sender has processed all but the last chunks in flight,
+    // s.t. it does not need to buffer the masks of the whole matrix
+    {
+      const auto num_sent_chunks = ot_ext_rcv.num_sent_chunks_;
+      ot_ext_rcv.acked_chunks_cond_->Wait([&ot_ext_rcv, num_sent_chunks] {
+        return ot_ext_rcv.num_acked_chunks_ + max_ot_extension_chunks_in_flight > num_sent_chunks;
+      });
+    }
+    ++ot_ext_rcv.num_sent_chunks_;
+    const auto choices = random_choices.Subset(column_offset, column_offset + num_columns);
+    const auto v = ComputeReceiverRows(base_ots_snd, Send_, choices, chunk_i,
+                                       block_offset + column_offset / kappa, num_columns,
+                                       num_threads_);
+
+    // transpose matrix T and hash its columns into the outputs, the column
+    // blocks are independent of each other
+    const auto column_block_size = GetColumnBlockSize(num_columns, num_threads_);
+    const auto num_column_blocks = (num_columns + column_block_size - 1) / column_block_size;
+#pragma omp parallel for num_threads(num_threads_)
+    for (std::size_t block_i = 0; block_i < num_column_blocks; ++block_i) {
+      const auto block_begin = block_i * column_block_size;
+      const auto block_columns = std::min(column_block_size, num_columns - block_begin);
+      std::array<const std::byte *, kappa> ptrs;
+      for (std::size_t i = 0; i < kappa; ++i) {
+        ptrs[i] = v[i].GetData().data() + block_begin / 8;
       }
-    }*/
+      PRG prg_fixed_key;
+      prg_fixed_key.SetKey(fixed_key_aes_key.data());
+      BitMatrix::ReceiverTransposeAndEncrypt(ptrs, ot_ext_rcv.outputs_, prg_fixed_key,
+                                             block_columns, ot_ext_rcv.bitlengths_,
+                                             num_pooled + column_offset + block_begin);
+    }
 
-  // we are done with the setup for the sender side
-  {
-    std::scoped_lock(ot_ext_snd.setup_finished_cond_->GetMutex());
-    ot_ext_snd.setup_finished_ = true;
+    // the OTs of this chunk can be used now
+    {
+      std::scoped_lock lock(ot_ext_rcv.setup_finished_cond_->GetMutex());
+      ot_ext_rcv.num_finished_ots_ = num_pooled + column_offset + num_columns;
+    }
+    ot_ext_rcv.setup_finished_cond_->NotifyAll();
   }
-  ot_ext_snd.setup_finished_cond_->NotifyAll();
+  ot_ext_rcv.consumed_offset_base_ots_ += bit_size_padded / kappa;
+  base_ots_snd.consumed_offset_ += bit_size_padded / kappa;
+  ++num_extensions_;
+
+  FinishSetup(ot_ext_rcv);
 
   if constexpr (MOTION::MOTION_DEBUG) {
     if (logger_) {
-      logger_->LogDebug("OTProviderFromOTExtension::SendSetup() end");
+      logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() end");
     }
   }
 }
 
-void OTProviderFromOTExtension::ReceiveSetup() {
+OTProviderFromSilentOT::OTProviderFromSilentOT(
+    std::function<void(flatbuffers::FlatBufferBuilder &&)> Send, MOTION::OTExtensionData &data,
+    MOTION::BaseOTsData &base_ot_data, MOTION::Crypto::MotionBaseProvider &motion_base_provider,
+    std::size_t party_id, std::shared_ptr<MOTION::Logger> logger)
+    : OTProvider(Send, data, party_id, logger),
+      base_ot_data_(base_ot_data),
+      motion_base_provider_(motion_base_provider) {
+  auto &ot_ext_rcv = data_.GetReceiverData();
+  ot_ext_rcv.real_choices_ = std::make_unique<BitVector<>>();
+}
+
+namespace {
+
+// the IKNP extension of the base COTs works on whole 128 x 128 blocks
+std::size_t GetNumBootstrapCOTs(const LPNParameters &parameters) {
+  constexpr std::size_t kappa = 128;
+  return (parameters.get_num_base_cots() + kappa - 1) / kappa * kappa;
+}
+
+// hash a COT to an OT output of bitlen bits as in BitMatrix::SenderTransposeAndEncrypt
+BitVector<> HashCOT(PRG &prg_fixed_key, PRG &prg_var_key, block128_t block, std::size_t bitlen) {
+  prg_fixed_key.MMO(block.data());
+  if (bitlen <= 128) {
+    return BitVector<>(block.data(), bitlen);
+  }
+  // string OT with bit length > 128 bit -> use the hash as seed
+  prg_var_key.SetKey(block.data());
+  return BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+}
+
+// tweak of the hash which encrypts the GGM tree sums with base COT cot_i
+uint128_t GetSPCOTTweak(std::size_t instance, std::size_t cot_i) {
+  return (uint128_t(instance) << 64) | cot_i;
+}
+
+}  // namespace
+
+ENCRYPTO::block128_vector OTProviderFromSilentOT::ExtendBaseCOTsSender(std::size_t num_cots) {
+  constexpr std::size_t kappa = 128;
+  assert(num_cots % kappa == 0);
+
+  auto &base_ots_rcv = base_ot_data_.GetReceiverData();
+  auto &ot_ext_snd = data_.GetSenderData();
+
+  // the base COTs are extended in a single chunk
+  ot_ext_snd.PrepareMasks(num_cots, 1);
+  const auto v =
+      ComputeSenderRows(base_ots_rcv, ot_ext_snd, 0, base_ots_rcv.consumed_offset_,
+                        num_cots, 1);
+  ot_ext_snd.consumed_offset_base_ots_ += num_cots / kappa;
+  base_ots_rcv.consumed_offset_ += num_cots / kappa;
+  // masks of a later setup must not be stored before it is prepared
+  ot_ext_snd.bit_size_ = 0;
+
+  std::array<const std::byte *, kappa> ptrs;
+  for (std::size_t i = 0; i < kappa; ++i) {
+    ptrs[i] = v[i].GetData().data();
+  }
+  return transpose_to_blocks(ptrs, num_cots);
+}
+
+std::pair<AlignedBitVector, ENCRYPTO::block128_vector>
+OTProviderFromSilentOT::ExtendBaseCOTsReceiver(std::size_t num_cots) {
+  constexpr std::size_t kappa = 128;
+  assert(num_cots % kappa == 0);
+
+  auto &base_ots_snd = base_ot_data_.GetSenderData();
+  auto &ot_ext_rcv = data_.GetReceiverData();
+
+  auto choices = AlignedBitVector::Random(num_cots);
+  const auto v =
+      ComputeReceiverRows(base_ots_snd, Send_, choices, 0, base_ots_snd.consumed_offset_,
+                          num_cots, 1);
+  ot_ext_rcv.consumed_offset_base_ots_ += num_cots / kappa;
+  base_ots_snd.consumed_offset_ += num_cots / kappa;
+
+  std::array<const std::byte *, kappa> ptrs;
+  for (std::size_t i = 0; i < kappa; ++i) {
+    ptrs[i] = v[i].GetData().data();
+  }
+  return {std::move(choices), transpose_to_blocks(ptrs, num_cots)};
+}
+
+void OTProviderFromSilentOT::SendSetup() {
   if constexpr (MOTION::MOTION_DEBUG) {
     if (logger_) {
-      logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() start");
+      logger_->LogDebug("OTProviderFromSilentOT::SendSetup() start");
     }
   }
 
-  // some index variables
-  std::size_t i = 0, j = 0;
-  // security parameter and number of base OTs
-  constexpr std::size_t kappa = 128;
-  // number of OTs and width of the bit matrix
-  const std::size_t bit_size = receiver_provider_.GetNumOTs();
-  if (bit_size == 0) {
+  auto &ot_ext_snd = data_.GetSenderData();
+
+  // the OTs which are left from a previous setup are taken from the pool
+  const std::size_t num_pooled = ot_ext_snd.num_finished_ots_;
+  if (sender_provider_.GetNumOTs() <= num_pooled) {
     if constexpr (MOTION::MOTION_DEBUG) {
       if (logger_) {
-        logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() return, nothing to do");
+        logger_->LogDebug("OTProviderFromSilentOT::SendSetup() return, OTs taken from the pool");
       }
     }
-    return;  // nothing to do
-  }
-
-  // rounded up to a multiple of the security parameter
-  const auto bit_size_padded = bit_size + kappa - (bit_size % kappa);
-
-  // convert to bytes
-  const std::size_t byte_size = MOTION::Helpers::Convert::BitsToBytes(bit_size);
-  // XXX: if byte_size is 0 then bit_size was also zero (or an overflow happened
-  if (byte_size == 0) {
+    FinishSetup(ot_ext_snd);
     return;
   }
-  // storage for receiver and base OT sender data
-  const auto &base_ots_snd = base_ot_data_.GetSenderData();
-  auto &ot_ext_rcv = data_.GetReceiverData();
-
-  // make random choices (this is precomputation, real inputs are not known yet)
-  ot_ext_rcv.random_choices_ =
-      std::make_unique<AlignedBitVector>(AlignedBitVector::Random(bit_size));
+  // the OTs which are not needed now are pooled
+  const std::size_t num_ots = sender_provider_.GetNumOTs() - num_pooled + pool_size_;
+  ot_ext_snd.y0_.resize(num_pooled + num_ots);
+  ot_ext_snd.y1_.resize(num_pooled + num_ots);
+  ot_ext_snd.bitlengths_.resize(num_pooled + num_ots, 128);
 
-  // create matrix with kappa rows
-  std::vector<AlignedBitVector> v(kappa);
+  motion_base_provider_.setup();
+  const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
+  PRG prg_fixed_key, prg_var_key;
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
 
-  // PRG we use with the fixed-key AES function
+  // our base OT choices are the global correlation Delta of all COTs
+  const auto delta =
+      block128_t::make_from_memory(base_ot_data_.GetReceiverData().c_.GetData().data());
+
+  const auto schedule = make_silent_ot_schedule(num_ots);
+  auto base_cots = ExtendBaseCOTsSender(GetNumBootstrapCOTs(schedule.front()));
+
+  std::size_t output_offset = num_pooled;
+  for (std::size_t instance = 0; instance < schedule.size(); ++instance) {
+    const auto &parameters = schedule.at(instance);
+    const auto depth = parameters.log_bin_size_;
+    const auto bin_size = parameters.get_bin_size();
+    const auto tree_message_size = 2 * depth + 1;
+
+    // single-point COTs, i.e., the leaves of one GGM tree per bin
+    ENCRYPTO::block128_vector cots(parameters.n_);
+    ENCRYPTO::block128_vector message(parameters.t_ * tree_message_size);
+    std::vector<block128_t> level_sums(2 * depth);
+    for (std::size_t tree = 0; tree < parameters.t_; ++tree) {
+      auto leaves = cots.data() + tree * bin_size;
+      ggm_tree_expand(prg_fixed_key, block128_t::make_random(), depth, leaves, level_sums.data());
+      auto tree_message = message.data() + tree * tree_message_size;
+      // the receiver can decrypt the sum on one side of each level with its base COT
+      for (std::size_t level = 0; level < depth; ++level) {
+        const auto cot_i = parameters.k_ + tree * depth + level;
+        const auto tweak = GetSPCOTTweak(instance, cot_i);
+        const auto base_cot_1 = base_cots[cot_i] ^ delta;
+        prg_fixed_key.FixedKeyAES(base_cots[cot_i].data(), tweak, tree_message[2 * level].data());
+        prg_fixed_key.FixedKeyAES(base_cot_1.data(), tweak, tree_message[2 * level + 1].data());
+        tree_message[2 * level] ^= level_sums[2 * level];
+        tree_message[2 * level + 1] ^= level_sums[2 * level + 1];
+      }
+      // allows the receiver to compute the missing leaf xor Delta
+      auto &leaf_correction = tree_message[2 * depth];
+      leaf_correction = delta;
+      for (std::size_t j = 0; j < bin_size; ++j) {
+        leaf_correction ^= leaves[j];
+      }
+    }
+    Send_(MOTION::Communication::BuildOTExtensionMessageSilentSender(
+        reinterpret_cast<const std::byte *>(message.data()), message.byte_size(), instance));
+
+    LPNEncoder(parameters, fixed_key_aes_key.data()).encode(cots.data(), base_cots.data());
+
+    // the first COTs are the base COTs of the next instance
+    const std::size_t num_reserved =
+        instance + 1 < schedule.size() ? schedule.at(instance + 1).get_num_base_cots() : 0;
+    const auto num_outputs =
+        std::min(parameters.n_ - num_reserved, num_pooled + num_ots - output_offset);
+    for (std::size_t i = 0; i < num_outputs; ++i) {
+      const auto &cot = cots[num_reserved + i];
+      const auto bitlen = ot_ext_snd.bitlengths_.at(output_offset + i);
+      ot_ext_snd.y0_.at(output_offset + i) = HashCOT(prg_fixed_key, prg_var_key, cot, bitlen);
+      ot_ext_snd.y1_.at(output_offset + i) =
+          HashCOT(prg_fixed_key, prg_var_key, cot ^ delta, bitlen);
+    }
+    output_offset += num_outputs;
+    cots.resize(num_reserved);
+    base_cots = std::move(cots);
+  }
+  {
+    std::scoped_lock lock(ot_ext_snd.setup_finished_cond_->GetMutex());
+    ot_ext_snd.num_finished_ots_ = output_offset;
+  }
+  ++num_extensions_;
 
-  // PRG which is used to expand the keys we got from the base OTs
-  PRG prg_fixed_key, prg_var_key;
-  // fill the rows of the matrix
-  for (i = 0; i < kappa; ++i) {
-    // generate rows of the matrix using the corresponding 0 key
-    // T[j] = PRG(s_{j,0})
-    prg_var_key.SetKey(base_ots_snd.messages_0_.at(i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prg_var_key.SetOffset(base_ots_snd.consumed_offset_);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prg_var_key.Encrypt(byte_size));
-    v.at(i) = AlignedBitVector(std::move(row), bit_size);
-    // take a copy of the row and XOR it with our choices
-    auto u = v.at(i);
-    // u_j = T[j] XOR r
-    u ^= *ot_ext_rcv.random_choices_;
-
-    // now mask the result with random stream expanded from the 1 key
-    // u_j = u_j XOR PRG(s_{j,1})
-    prg_var_key.SetKey(base_ots_snd.messages_1_.at(i).data());
-    prg_var_key.SetOffset(base_ots_snd.consumed_offset_);
-    u ^= AlignedBitVector(prg_var_key.Encrypt(byte_size), bit_size);
+  // we are done with the setup for the sender side
+  FinishSetup(ot_ext_snd);
 
-    // send this row
-    Send_(MOTION::Communication::BuildOTExtensionMessageReceiverMasks(u.GetData().data(),
-                                                                      u.GetData().size(), i));
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug(fmt::format(
+          "OTProviderFromSilentOT::SendSetup() end, {} OTs from {} LPN instances", num_ots,
+          schedule.size()));
+    }
   }
-  ot_ext_rcv.consumed_offset_base_ots_ += bit_size_padded / kappa;
+}
 
-  // transpose matrix T
-  if (bit_size_padded != bit_size) {
-    for (i = 0u; i < v.size(); ++i) {
-      v.at(i).Resize(bit_size_padded, true);
+void OTProviderFromSilentOT::ReceiveSetup() {
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromSilentOT::ReceiveSetup() start");
     }
   }
 
-  std::array<const std::byte *, kappa> ptrs;
-  for (j = 0; j < ptrs.size(); ++j) {
-    ptrs.at(j) = v.at(j).GetMutableData().data();
+  auto &ot_ext_rcv = data_.GetReceiverData();
+
+  // the OTs which are left from a previous setup are taken from the pool
+  const std::size_t num_pooled = ot_ext_rcv.num_finished_ots_;
+  if (receiver_provider_.GetNumOTs() <= num_pooled) {
+    if constexpr (MOTION::MOTION_DEBUG) {
+      if (logger_) {
+        logger_->LogDebug(
+            "OTProviderFromSilentOT::ReceiveSetup() return, OTs taken from the pool");
+      }
+    }
+    FinishSetup(ot_ext_rcv);
+    return;
   }
+  // the OTs which are not needed now are pooled
+  const std::size_t num_ots = receiver_provider_.GetNumOTs() - num_pooled + pool_size_;
+  ot_ext_rcv.outputs_.resize(num_pooled + num_ots);
+  ot_ext_rcv.bitlengths_.resize(num_pooled + num_ots, 128);
+  const auto schedule = make_silent_ot_schedule(num_ots);
 
-  // pad the vector of bitlength with zeros
-  ot_ext_rcv.bitlengths_.resize(bit_size_padded, 0);
+  // the sender's messages may arrive as soon as it has received our masks
+  ot_ext_rcv.silent_messages_.assign(schedule.size(), {});
+  ot_ext_rcv.silent_messages_conds_.clear();
+  for (std::size_t instance = 0; instance < schedule.size(); ++instance) {
+    ot_ext_rcv.silent_messages_conds_.emplace_back(
+        std::make_unique<FiberCondition>([&ot_ext_rcv, instance] {
+          return !ot_ext_rcv.silent_messages_.at(instance).empty();
+        }));
+  }
 
   motion_base_provider_.setup();
   const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
+  PRG prg_fixed_key, prg_var_key;
   prg_fixed_key.SetKey(fixed_key_aes_key.data());
-  BitMatrix::ReceiverTransposeAndEncrypt(ptrs, ot_ext_rcv.outputs_, prg_fixed_key, bit_size_padded,
-                                         ot_ext_rcv.bitlengths_);
-  /*BitMatrix::TransposeUsingBitSlicing(ptrs, bit_size_padded);
-  for (i = 0; i < ot_ext_rcv.outputs_.size(); ++i) {
-    const auto row_i = i % kappa;
-    const auto blk_offset = ((kappa / 8) * (i / kappa));
-    const auto T_row = ptrs.at(row_i) + blk_offset;
-    auto &out = ot_ext_rcv.outputs_.at(i);
-
-    std::unique_lock lock(ot_ext_rcv.bitlengths_mutex_);
-    const std::size_t bitlen = ot_ext_rcv.bitlengths_.at(i);
-    lock.unlock();
 
-    if (bitlen <= kappa) {
-      out = BitVector<>(prg_fixed_key.FixedKeyAES(T_row, i), bitlen);
-    } else {
-      auto seed = prg_fixed_key.FixedKeyAES(T_row, i);
-      prg_var_key.SetKey(seed.data());
-      out = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+  AppendRandomChoices(ot_ext_rcv, num_pooled, AlignedBitVector(num_ots));
+  auto [base_choices, base_cots] = ExtendBaseCOTsReceiver(GetNumBootstrapCOTs(schedule.front()));
+
+  std::size_t output_offset = num_pooled;
+  for (std::size_t instance = 0; instance < schedule.size(); ++instance) {
+    const auto &parameters = schedule.at(instance);
+    const auto depth = parameters.log_bin_size_;
+    const auto bin_size = parameters.get_bin_size();
+    const auto tree_message_size = 2 * depth + 1;
+
+    ot_ext_rcv.silent_messages_conds_.at(instance)->Wait();
+    const auto &raw_message = ot_ext_rcv.silent_messages_.at(instance);
+    if (raw_message.size() != parameters.t_ * tree_message_size * block128_t::size()) {
+      throw std::runtime_error(
+          fmt::format("OTProviderFromSilentOT: received {} B for LPN instance {}, expected {} B",
+                      raw_message.size(), instance,
+                      parameters.t_ * tree_message_size * block128_t::size()));
+    }
+    const ENCRYPTO::block128_vector message(parameters.t_ * tree_message_size,
+                                            raw_message.data());
+
+    // punctured single-point COTs: the noisy position of each bin is chosen by
+    // our random choices of the base COTs used for the GGM tree
+    ENCRYPTO::block128_vector cots(parameters.n_);
+    AlignedBitVector choices(parameters.n_);
+    std::vector<block128_t> level_sums(depth);
+    for (std::size_t tree = 0; tree < parameters.t_; ++tree) {
+      auto tree_message = message.data() + tree * tree_message_size;
+      std::size_t alpha = 0;
+      for (std::size_t level = 0; level < depth; ++level) {
+        const auto cot_i = parameters.k_ + tree * depth + level;
+        const bool choice = base_choices.Get(cot_i);
+        // the path to alpha continues on the side which we cannot decrypt
+        alpha = (alpha << 1) | std::size_t(!choice);
+        prg_fixed_key.FixedKeyAES(base_cots[cot_i].data(), GetSPCOTTweak(instance, cot_i),
+                                  level_sums[level].data());
+        level_sums[level] ^= tree_message[2 * level + choice];
+      }
+      auto leaves = cots.data() + tree * bin_size;
+      ggm_tree_puncture(prg_fixed_key, depth, alpha, level_sums.data(), leaves);
+      auto leaf = tree_message[2 * depth];
+      for (std::size_t j = 0; j < bin_size; ++j) {
+        leaf ^= leaves[j];
+      }
+      leaves[alpha] = leaf;
+      choices.Set(true, tree * bin_size + alpha);
     }
-  }*/
 
+    LPNEncoder(parameters, fixed_key_aes_key.data())
+        .encode(cots.data(), choices, base_cots.data(), base_choices);
+
+    // the first COTs are the base COTs of the next instance
+    const std::size_t num_reserved =
+        instance + 1 < schedule.size() ? schedule.at(instance + 1).get_num_base_cots() : 0;
+    const auto num_outputs =
+        std::min(parameters.n_ - num_reserved, num_pooled + num_ots - output_offset);
+    for (std::size_t i = 0; i < num_outputs; ++i) {
+      const auto bitlen = ot_ext_rcv.bitlengths_.at(output_offset + i);
+      ot_ext_rcv.outputs_.at(output_offset + i) =
+          HashCOT(prg_fixed_key, prg_var_key, cots[num_reserved + i], bitlen);
+    }
+    ot_ext_rcv.random_choices_->Copy(output_offset, output_offset + num_outputs,
+                                     choices.Subset(num_reserved, num_reserved + num_outputs));
+    output_offset += num_outputs;
+    base_choices = choices.Subset(0, num_reserved);
+    cots.resize(num_reserved);
+    base_cots = std::move(cots);
+  }
   {
-    std::scoped_lock(ot_ext_rcv.setup_finished_cond_->GetMutex());
-    ot_ext_rcv.setup_finished_ = true;
+    std::scoped_lock lock(ot_ext_rcv.setup_finished_cond_->GetMutex());
+    ot_ext_rcv.num_finished_ots_ = output_offset;
   }
-  ot_ext_rcv.setup_finished_cond_->NotifyAll();
+  ++num_extensions_;
+
+  FinishSetup(ot_ext_rcv);
 
   if constexpr (MOTION::MOTION_DEBUG) {
     if (logger_) {
-      logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() end");
+      logger_->LogDebug("OTProviderFromSilentOT::ReceiveSetup() end");
     }
   }
 }
@@ -448,7 +813,7 @@ const std::vector<BitVector<>> &OTVectorSender::GetOutputs() {
   return outputs_;
 }
 
-void OTVectorSender::WaitSetup() { data_.setup_finished_cond_->Wait(); }
+void OTVectorSender::WaitSetup() { data_.WaitForOTs(ot_id_, num_ots_); }
 
 OTVectorSender::OTVectorSender(const std::size_t ot_id, const std::size_t num_ots,
                                const std::size_t bitlen, const OTProtocol p,
@@ -460,14 +825,7 @@ OTVectorSender::OTVectorSender(const std::size_t ot_id, const std::size_t num_ot
 
 void OTVectorSender::Reserve(const std::size_t id, const std::size_t num_ots,
                              const std::size_t bitlen) {
-  data_.y0_.resize(data_.y0_.size() + num_ots);
-  data_.y1_.resize(data_.y1_.size() + num_ots);
-  data_.bitlengths_.resize(data_.bitlengths_.size() + num_ots);
-  data_.corrections_.Resize(data_.corrections_.GetSize() + num_ots);
-  for (auto i = 0ull; i < num_ots; ++i) {
-    data_.bitlengths_.at(data_.bitlengths_.size() - 1 - i) = bitlen;
-  }
-  data_.num_ots_in_batch_.emplace(id, num_ots);
+  data_.Reserve(id, num_ots, bitlen);
 }
 
 GOTVectorSender::GOTVectorSender(const std::size_t ot_id, const std::size_t num_ots,
@@ -708,7 +1066,7 @@ void ROTVectorSender::SendMessages() {
   throw std::runtime_error("Inputs in ROT are available locally and thus do not need to be sent");
 }
 
-void OTVectorReceiver::WaitSetup() { data_.setup_finished_cond_->Wait(); }
+void OTVectorReceiver::WaitSetup() { data_.WaitForOTs(ot_id_, num_ots_); }
 
 OTVectorReceiver::OTVectorReceiver(const std::size_t ot_id, const std::size_t num_ots,
                                    const std::size_t bitlen, const OTProtocol p,
@@ -720,12 +1078,7 @@ OTVectorReceiver::OTVectorReceiver(const std::size_t ot_id, const std::size_t nu
 
 void OTVectorReceiver::Reserve(const std::size_t id, const std::size_t num_ots,
                                const std::size_t bitlen) {
-  data_.outputs_.resize(id + num_ots);
-  data_.bitlengths_.resize(id + num_ots);
-  for (auto i = 0ull; i < num_ots; ++i) {
-    data_.bitlengths_.at(id + i) = bitlen;
-  }
-  data_.num_ots_in_batch_.emplace(id, num_ots);
+  data_.Reserve(id, num_ots, bitlen);
 }
 
 GOTVectorReceiver::GOTVectorReceiver(
@@ -1068,6 +1421,7 @@ std::unique_ptr<ROTSender> OTProviderSender::RegisterROT(
 
 void OTProviderSender::Clear() {
   {
+    // the finished OTs are kept, a following setup only extends the missing ones
     std::scoped_lock lock(data_.setup_finished_cond_->GetMutex());
     data_.setup_finished_ = false;
   }
@@ -1075,17 +1429,13 @@ void OTProviderSender::Clear() {
     std::scoped_lock lock(data_.corrections_mutex_);
     data_.received_correction_offsets_.clear();
   }
-  {
-    std::scoped_lock lock(data_.u_mutex_);
-    data_.num_received_u_ = 0;
-  }
 }
 
 void OTProviderSender::Reset() {
   Clear();
+  sender_data_.clear();
+  data_.DiscardOTs(total_ots_count_);
   total_ots_count_ = 0;
-  // TODO
-  // - clear promise map
 }
 
 std::shared_ptr<OTVectorReceiver> &OTProviderReceiver::GetOTs(std::size_t offset) {
@@ -1297,9 +1647,9 @@ void OTProviderReceiver::Clear() {
 }
 void OTProviderReceiver::Reset() {
   Clear();
+  receiver_data_.clear();
+  data_.DiscardOTs(total_ots_count_);
   total_ots_count_ = 0;
-  // TODO
-  // - clear promise map
 }
 
 class OTExtensionMessageHandler : public MOTION::Communication::MessageHandler {
@@ -1334,6 +1684,16 @@ void OTExtensionMessageHandler::received_message(std::size_t,
       data_.MessageReceived(ot_data, ot_data_size, MOTION::OTExtensionDataType::snd_messages, index_i);
       break;
     }
+    case MOTION::Communication::MessageType::OTExtensionSilentSender: {
+      data_.MessageReceived(ot_data, ot_data_size,
+                            MOTION::OTExtensionDataType::silent_snd_messages, index_i);
+      break;
+    }
+    case MOTION::Communication::MessageType::OTExtensionSenderChunkAck: {
+      data_.MessageReceived(ot_data, ot_data_size, MOTION::OTExtensionDataType::snd_chunk_acks,
+                            index_i);
+      break;
+    }
     default: {
       assert(false);
       break;
@@ -1342,10 +1702,13 @@ void OTExtensionMessageHandler::received_message(std::size_t,
 }
 
 OTProviderManager::OTProviderManager(MOTION::Communication::CommunicationLayer &communication_layer,
-                                     const MOTION::BaseOTProvider &base_ot_provider,
+                                     MOTION::BaseOTProvider &base_ot_provider,
                                      MOTION::Crypto::MotionBaseProvider &motion_base_provider,
                                      MOTION::Statistics::RunTimeStats *stats,
-                                     std::shared_ptr<MOTION::Logger> logger)
+                                     std::shared_ptr<MOTION::Logger> logger,
+                                     OTExtensionType ot_extension_type,
+                                     std::size_t ot_extension_chunk_size,
+                                     std::size_t num_threads)
     : communication_layer_(communication_layer),
       base_ot_provider_(base_ot_provider),
       motion_base_provider_(motion_base_provider),
@@ -1363,9 +1726,15 @@ OTProviderManager::OTProviderManager(MOTION::Communication::CommunicationLayer &
       communication_layer_.send_message(party_id, std::move(message_builder));
     };
     data_.at(party_id) = std::make_unique<MOTION::OTExtensionData>();
-    providers_.at(party_id) = std::make_unique<OTProviderFromOTExtension>(
-        send_func, *data_.at(party_id), base_ot_provider.get_base_ots_data(party_id),
-        motion_base_provider, party_id, logger);
+    if (ot_extension_type == OTExtensionType::Silent) {
+      providers_.at(party_id) = std::make_unique<OTProviderFromSilentOT>(
+          send_func, *data_.at(party_id), base_ot_provider.get_base_ots_data(party_id),
+          motion_base_provider, party_id, logger);
+    } else {
+      providers_.at(party_id) = std::make_unique<OTProviderFromOTExtension>(
+          send_func, *data_.at(party_id), base_ot_provider.get_base_ots_data(party_id),
+          motion_base_provider, party_id, logger, ot_extension_chunk_size, num_threads);
+    }
   }
 
   communication_layer_.register_message_handler(
@@ -1374,14 +1743,18 @@ OTProviderManager::OTProviderManager(MOTION::Communication::CommunicationLayer &
       },
       {MOTION::Communication::MessageType::OTExtensionReceiverMasks,
        MOTION::Communication::MessageType::OTExtensionReceiverCorrections,
-       MOTION::Communication::MessageType::OTExtensionSender});
+       MOTION::Communication::MessageType::OTExtensionSender,
+       MOTION::Communication::MessageType::OTExtensionSilentSender,
+       MOTION::Communication::MessageType::OTExtensionSenderChunkAck});
 }
 
 OTProviderManager::~OTProviderManager() {
   communication_layer_.deregister_message_handler(
       {MOTION::Communication::MessageType::OTExtensionReceiverMasks,
        MOTION::Communication::MessageType::OTExtensionReceiverCorrections,
-       MOTION::Communication::MessageType::OTExtensionSender});
+       MOTION::Communication::MessageType::OTExtensionSender,
+       MOTION::Communication::MessageType::OTExtensionSilentSender,
+       MOTION::Communication::MessageType::OTExtensionSenderChunkAck});
 }
 
 void OTProviderManager::run_setup() {
@@ -1434,4 +1807,28 @@ void OTProviderManager::clear() {
   reset_setup_ready();
 }
 
+void OTProviderManager::reset() {
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderManager::reset()");
+    }
+  }
+  for (auto party_i = 0ull; party_i < communication_layer_.get_num_parties(); ++party_i) {
+    if (party_i == communication_layer_.get_my_id()) {
+      continue;
+    }
+    providers_.at(party_i)->Reset();
+  }
+  reset_setup_ready();
+}
+
+void OTProviderManager::set_pool_size(std::size_t num_ots) {
+  for (auto party_i = 0ull; party_i < communication_layer_.get_num_parties(); ++party_i) {
+    if (party_i == communication_layer_.get_my_id()) {
+      continue;
+    }
+    providers_.at(party_i)->SetPoolSize(num_ots);
+  }
+}
+
 }  // namespace ENCRYPTO::ObliviousTransfer
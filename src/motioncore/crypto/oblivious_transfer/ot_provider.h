@@ -28,6 +28,7 @@
 #include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include <flatbuffers/flatbuffers.h>
 
@@ -59,6 +60,8 @@ struct RunTimeStats;
 
 namespace ENCRYPTO {
 
+struct block128_vector;
+
 namespace ObliviousTransfer {
 
 enum OTProtocol : uint {
@@ -296,8 +299,10 @@ class OTProviderSender {
 
   auto GetNumOTs() const { return total_ots_count_; }
 
+  // prepare for another setup, further OTs continue the numbering
   void Clear();
 
+  // discard the registered OTs, only the pooled OTs are kept and renumbered
   void Reset();
 
  private:
@@ -346,6 +351,7 @@ class OTProviderReceiver {
 
   std::size_t GetNumOTs() const { return total_ots_count_; }
 
+  // see OTProviderSender
   void Clear();
   void Reset();
 
@@ -443,6 +449,15 @@ class OTProvider {
     sender_provider_.Reset();
   }
 
+  // Extend num_ots OTs in addition to the registered ones in each setup.  These
+  // are kept in a pool across Reset, so the OTs of the following circuits can
+  // be taken from it without running the OT extension again.  Needs to be the
+  // same on both sides.
+  void SetPoolSize(std::size_t num_ots) { pool_size_ = num_ots; }
+
+  // number of times the OT extension protocol has been run as sender or receiver
+  std::size_t GetNumExtensions() const { return num_extensions_; }
+
  protected:
   OTProvider(std::function<void(flatbuffers::FlatBufferBuilder&&)> Send,
              MOTION::OTExtensionData& data, std::size_t party_id,
@@ -453,6 +468,8 @@ class OTProvider {
   OTProviderReceiver receiver_provider_;
   OTProviderSender sender_provider_;
   std::shared_ptr<MOTION::Logger> logger_;
+  std::size_t pool_size_{0};
+  std::atomic<std::size_t> num_extensions_{0};
 };
 
 class OTProviderFromFile : public OTProvider {
@@ -463,6 +480,22 @@ class OTProviderFromBaseOTs : public OTProvider {
   // TODO
 };
 
+// number of OTs which are extended at once by OTProviderFromOTExtension
+constexpr std::size_t default_ot_extension_chunk_size = std::size_t(1) << 20;
+// number of chunks whose masks the receiver may send before the sender has
+// acknowledged them, i.e., the sender buffers at most 2 * 128 * chunk_size bits
+// of masks (32 MiB with the default chunk size)
+constexpr std::size_t max_ot_extension_chunks_in_flight = 2;
+
+// IKNP OT extension.  The bit matrix is processed in chunks of chunk_size
+// columns, i.e., only 128 x chunk_size bits of it are kept in memory at a time,
+// and the OTs of a chunk can be used as soon as the chunk is finished.  A
+// chunk_size of 0 extends all OTs at once.  Within a chunk, the rows are
+// expanded and the column blocks are transposed and hashed by num_threads
+// threads (0: one per hardware thread).  The sender acknowledges each chunk
+// once it has processed its masks, and the receiver sends the masks of a chunk
+// only if fewer than max_ot_extension_chunks_in_flight previous chunks are
+// unacknowledged.
 class OTProviderFromOTExtension final : public OTProvider {
  public:
   void SendSetup() final;
@@ -470,12 +503,48 @@ class OTProviderFromOTExtension final : public OTProvider {
   void ReceiveSetup() final;
 
   OTProviderFromOTExtension(std::function<void(flatbuffers::FlatBufferBuilder&&)> Send,
-                            MOTION::OTExtensionData& data, const MOTION::BaseOTsData& base_ot_data,
+                            MOTION::OTExtensionData& data, MOTION::BaseOTsData& base_ot_data,
                             MOTION::Crypto::MotionBaseProvider&, std::size_t party_id,
-                            std::shared_ptr<MOTION::Logger> logger);
+                            std::shared_ptr<MOTION::Logger> logger,
+                            std::size_t chunk_size = default_ot_extension_chunk_size,
+                            std::size_t num_threads = 1);
 
  private:
-  const MOTION::BaseOTsData& base_ot_data_;
+  // the consumed offsets of the base OTs are advanced after each extension, s.t.
+  // the base OTs can be reused for further setups without repeating PRG outputs
+  MOTION::BaseOTsData& base_ot_data_;
+  MOTION::Crypto::MotionBaseProvider& motion_base_provider_;
+  // multiple of 128
+  std::size_t chunk_size_;
+  std::size_t num_threads_;
+};
+
+// OT extension with communication sublinear in the number of OTs, based on
+// the LPN assumption (silent OT, see Ferret: https://eprint.iacr.org/2020/924).
+// The base COTs of the first LPN instance are extended from the base OTs with
+// IKNP, those of the following instances are taken from the outputs of their
+// predecessor.  The outputs are hashed in the same way as in
+// OTProviderFromOTExtension, so all OT flavors work on top of it.
+class OTProviderFromSilentOT final : public OTProvider {
+ public:
+  void SendSetup() final;
+
+  void ReceiveSetup() final;
+
+  OTProviderFromSilentOT(std::function<void(flatbuffers::FlatBufferBuilder&&)> Send,
+                         MOTION::OTExtensionData& data, MOTION::BaseOTsData& base_ot_data,
+                         MOTION::Crypto::MotionBaseProvider&, std::size_t party_id,
+                         std::shared_ptr<MOTION::Logger> logger);
+
+ private:
+  // IKNP extension of num_cots (a multiple of 128) COTs without the final hashing
+  // returns the sender's blocks q_i
+  ENCRYPTO::block128_vector ExtendBaseCOTsSender(std::size_t num_cots);
+  // returns the receiver's random choices b_i and blocks t_i = q_i ^ b_i * Delta
+  std::pair<AlignedBitVector, ENCRYPTO::block128_vector> ExtendBaseCOTsReceiver(
+      std::size_t num_cots);
+
+  MOTION::BaseOTsData& base_ot_data_;
   MOTION::Crypto::MotionBaseProvider& motion_base_provider_;
 };
 
@@ -487,11 +556,20 @@ class OTProviderFromMultipleThirdParties : public OTProvider {
   // TODO
 };
 
+// which protocol generates the OTs from the base OTs
+enum class OTExtensionType : unsigned int {
+  IKNP,   // OTProviderFromOTExtension
+  Silent  // OTProviderFromSilentOT
+};
+
 class OTProviderManager : public enable_wait_setup {
  public:
-  OTProviderManager(MOTION::Communication::CommunicationLayer&, const MOTION::BaseOTProvider&,
+  OTProviderManager(MOTION::Communication::CommunicationLayer&, MOTION::BaseOTProvider&,
                     MOTION::Crypto::MotionBaseProvider&, MOTION::Statistics::RunTimeStats*,
-                    std::shared_ptr<MOTION::Logger>);
+                    std::shared_ptr<MOTION::Logger>,
+                    OTExtensionType ot_extension_type = OTExtensionType::IKNP,
+                    std::size_t ot_extension_chunk_size = default_ot_extension_chunk_size,
+                    std::size_t num_threads = 1);
   ~OTProviderManager();
 
   std::vector<std::unique_ptr<OTProvider>>& get_providers() { return providers_; }
@@ -501,9 +579,15 @@ class OTProviderManager : public enable_wait_setup {
   // reset all data structures for a new round of OTs
   void clear();
 
+  // discard the OTs of the current circuit, the pooled OTs are kept for the next one
+  void reset();
+
+  // see OTProvider::SetPoolSize
+  void set_pool_size(std::size_t num_ots);
+
  private:
   MOTION::Communication::CommunicationLayer& communication_layer_;
-  const MOTION::BaseOTProvider& base_ot_provider_;
+  MOTION::BaseOTProvider& base_ot_provider_;
   MOTION::Crypto::MotionBaseProvider& motion_base_provider_;
   MOTION::Statistics::RunTimeStats* stats_;
   std::shared_ptr<MOTION::Logger> logger_;
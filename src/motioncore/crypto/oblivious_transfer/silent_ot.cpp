@@ -0,0 +1,186 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "silent_ot.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "utility/bit_matrix.h"
+
+namespace ENCRYPTO::ObliviousTransfer {
+
+std::vector<LPNParameters> make_silent_ot_schedule(std::size_t num_cots) {
+  std::vector<LPNParameters> schedule;
+  while (num_cots > lpn_parameters_small.n_) {
+    schedule.push_back(lpn_parameters_large);
+    // a small successor covers the rest
+    const auto num_outputs_small_successor =
+        lpn_parameters_large.n_ - lpn_parameters_small.get_num_base_cots();
+    if (num_cots <= num_outputs_small_successor) {
+      return schedule;
+    }
+    if (num_cots - num_outputs_small_successor <= lpn_parameters_small.n_) {
+      schedule.push_back(lpn_parameters_small);
+      return schedule;
+    }
+    // otherwise we keep the base COTs of a large successor
+    num_cots -= lpn_parameters_large.n_ - lpn_parameters_large.get_num_base_cots();
+  }
+  if (num_cots > 0) {
+    schedule.push_back(lpn_parameters_small);
+  }
+  return schedule;
+}
+
+block128_vector transpose_to_blocks(const std::array<const std::byte*, 128>& rows,
+                                    std::size_t num_columns) {
+  assert(num_columns % 8 == 0);
+  block128_vector output(num_columns);
+  // whole 128 x 128 blocks are transposed with the best kernel of the CPU
+  const auto num_block_columns = num_columns / 128 * 128;
+  for (std::size_t c = 0; c < num_block_columns; c += 128) {
+    BitMatrix::Transpose128x128Block(rows.data(), c, output[c].data());
+  }
+  alignas(16) std::array<std::byte, 16> column_bytes;
+  for (std::size_t c = num_block_columns; c < num_columns; c += 8) {
+    for (std::size_t r = 0; r < 128; r += 16) {
+      // byte k of vec contains the bits of the columns c, ..., c + 7 in row r + k
+      for (std::size_t k = 0; k < 16; ++k) {
+        column_bytes[k] = rows[r + k][c / 8];
+      }
+      auto vec = _mm_load_si128(reinterpret_cast<const __m128i*>(column_bytes.data()));
+      // the most significant bits belong to column c + 7
+      for (std::size_t i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
+        *reinterpret_cast<std::uint16_t*>(output[c + i - 1].data() + r / 8) =
+            _mm_movemask_epi8(vec);
+      }
+    }
+  }
+  return output;
+}
+
+namespace {
+
+// length-doubling PRG G(x) = (MMO(x), MMO(x ^ 1)) from fixed-key AES
+void expand_node(PRG& prg_fixed_key, block128_t parent, block128_t& left, block128_t& right) {
+  left = parent;
+  right = parent;
+  right.data()[0] ^= std::byte(0x01);
+  prg_fixed_key.MMO(left.data());
+  prg_fixed_key.MMO(right.data());
+}
+
+}  // namespace
+
+void ggm_tree_expand(PRG& prg_fixed_key, const block128_t& seed, std::size_t depth,
+                     block128_t* leaves, block128_t* level_sums) {
+  leaves[0] = seed;
+  for (std::size_t level = 0; level < depth; ++level) {
+    auto& sum_left = level_sums[2 * level];
+    auto& sum_right = level_sums[2 * level + 1];
+    sum_left = block128_t::make_zero();
+    sum_right = block128_t::make_zero();
+    // expand backwards s.t. no node is overwritten before it is expanded
+    for (std::size_t j = std::size_t(1) << level; j-- > 0;) {
+      expand_node(prg_fixed_key, leaves[j], leaves[2 * j], leaves[2 * j + 1]);
+      sum_left ^= leaves[2 * j];
+      sum_right ^= leaves[2 * j + 1];
+    }
+  }
+}
+
+void ggm_tree_puncture(PRG& prg_fixed_key, std::size_t depth, std::size_t alpha,
+                       const block128_t* level_sums, block128_t* leaves) {
+  leaves[0] = block128_t::make_zero();
+  for (std::size_t level = 0; level < depth; ++level) {
+    // unknown node on this level and the direction of the path to alpha
+    const std::size_t path = alpha >> (depth - level);
+    const std::size_t direction = (alpha >> (depth - level - 1)) & 1;
+    auto sibling = level_sums[level];
+    for (std::size_t j = std::size_t(1) << level; j-- > 0;) {
+      if (j == path) {
+        leaves[2 * j] = block128_t::make_zero();
+        leaves[2 * j + 1] = block128_t::make_zero();
+        continue;
+      }
+      expand_node(prg_fixed_key, leaves[j], leaves[2 * j], leaves[2 * j + 1]);
+      sibling ^= leaves[2 * j + 1 - direction];
+    }
+    leaves[2 * path + 1 - direction] = sibling;
+  }
+}
+
+LPNEncoder::LPNEncoder(const LPNParameters& parameters, const std::uint8_t* key)
+    : parameters_(parameters), indices_(chunk_size * lpn_num_nonzeros) {
+  prg_.SetKey(key);
+}
+
+void LPNEncoder::compute_indices(std::size_t row_offset) {
+  // chunk i is generated from the AES blocks starting at i * chunk_size * 40 / 16
+  prg_.SetOffset(row_offset * lpn_num_nonzeros * sizeof(std::uint32_t) / 16);
+  const auto random = prg_.Encrypt(indices_.size() * sizeof(std::uint32_t));
+  std::memcpy(indices_.data(), random.data(), indices_.size() * sizeof(std::uint32_t));
+  for (auto& index : indices_) {
+    index %= parameters_.k_;
+  }
+}
+
+void LPNEncoder::encode(block128_t* outputs, const block128_t* secret) {
+  for (std::size_t row_offset = 0; row_offset < parameters_.n_; row_offset += chunk_size) {
+    compute_indices(row_offset);
+    const auto num_rows = std::min(chunk_size, parameters_.n_ - row_offset);
+    for (std::size_t i = 0; i < num_rows; ++i) {
+      auto& output = outputs[row_offset + i];
+      for (std::size_t j = 0; j < lpn_num_nonzeros; ++j) {
+        output ^= secret[indices_[i * lpn_num_nonzeros + j]];
+      }
+    }
+  }
+}
+
+void LPNEncoder::encode(block128_t* outputs, AlignedBitVector& output_bits,
+                        const block128_t* secret, const AlignedBitVector& secret_bits) {
+  auto output_bytes = output_bits.GetMutableData().data();
+  for (std::size_t row_offset = 0; row_offset < parameters_.n_; row_offset += chunk_size) {
+    compute_indices(row_offset);
+    const auto num_rows = std::min(chunk_size, parameters_.n_ - row_offset);
+    for (std::size_t i = 0; i < num_rows; ++i) {
+      auto& output = outputs[row_offset + i];
+      bool parity = false;
+      for (std::size_t j = 0; j < lpn_num_nonzeros; ++j) {
+        const auto index = indices_[i * lpn_num_nonzeros + j];
+        output ^= secret[index];
+        parity ^= secret_bits.Get(index);
+      }
+      if (parity) {
+        const auto row = row_offset + i;
+        output_bytes[row / 8] ^= SET_BIT_MASK[row % 8];
+      }
+    }
+  }
+}
+
+}  // namespace ENCRYPTO::ObliviousTransfer
@@ -0,0 +1,104 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "crypto/pseudo_random_generator.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+
+namespace ENCRYPTO::ObliviousTransfer {
+
+// Parameters of an LPN instance with regular noise as used by Ferret
+// (https://eprint.iacr.org/2020/924).  One instance turns k + t * log_bin_size
+// correlated OTs (COTs) into n COTs: The noise vector has exactly one nonzero
+// entry in each of the t bins of 2^log_bin_size entries, which is obtained by
+// a single-point COT from a GGM tree, and the secret of length k is expanded
+// with a sparse public matrix.
+struct LPNParameters {
+  std::size_t n_;
+  std::size_t k_;
+  std::size_t t_;
+  std::size_t log_bin_size_;
+
+  std::size_t get_bin_size() const { return std::size_t(1) << log_bin_size_; }
+  std::size_t get_num_base_cots() const { return k_ + t_ * log_bin_size_; }
+};
+
+// number of nonzero entries in each row of the LPN matrix
+constexpr std::size_t lpn_num_nonzeros = 10;
+
+// parameter sets of Ferret for 128 bit computational security
+constexpr LPNParameters lpn_parameters_large{10'608'640, 589'760, 1'295, 13};
+constexpr LPNParameters lpn_parameters_small{649'728, 36'288, 1'269, 9};
+
+// Sequence of LPN instances which produces at least num_cots COTs.  The base
+// COTs of every instance except the first one are taken from the outputs of
+// its predecessor.
+std::vector<LPNParameters> make_silent_ot_schedule(std::size_t num_cots);
+
+// Transpose a bit matrix with 128 rows of num_columns bits each (a multiple of
+// 8), s.t. the i-th block of the result contains the i-th column.
+block128_vector transpose_to_blocks(const std::array<const std::byte*, 128>& rows,
+                                    std::size_t num_columns);
+
+// Expand a GGM tree of the given depth from a seed into its 2^depth leaves.
+// The xor of all left (right) children on level l + 1 is written to
+// level_sums[2 * l] (level_sums[2 * l + 1]).
+void ggm_tree_expand(PRG& prg_fixed_key, const block128_t& seed, std::size_t depth,
+                     block128_t* leaves, block128_t* level_sums);
+
+// Reconstruct all leaves of a GGM tree except the one at position alpha.  For
+// each level l + 1, level_sums[l] contains the xor of the children which lie
+// on the other side than the path to alpha.  The leaf at alpha is set to zero.
+void ggm_tree_puncture(PRG& prg_fixed_key, std::size_t depth, std::size_t alpha,
+                       const block128_t* level_sums, block128_t* leaves);
+
+// Multiplication with the public LPN matrix, i.e., xor to each of the n
+// outputs lpn_num_nonzeros pseudorandomly chosen entries of the secret.
+class LPNEncoder {
+ public:
+  // the matrix is derived from the given AES key, i.e., both parties need to
+  // use the same key
+  LPNEncoder(const LPNParameters&, const std::uint8_t* key);
+
+  void encode(block128_t* outputs, const block128_t* secret);
+
+  void encode(block128_t* outputs, AlignedBitVector& output_bits, const block128_t* secret,
+              const AlignedBitVector& secret_bits);
+
+ private:
+  // compute the indices of the rows [row_offset, row_offset + chunk_size)
+  void compute_indices(std::size_t row_offset);
+
+  static constexpr std::size_t chunk_size = 4096;
+  LPNParameters parameters_;
+  PRG prg_;
+  std::vector<std::uint32_t> indices_;
+};
+
+}  // namespace ENCRYPTO::ObliviousTransfer
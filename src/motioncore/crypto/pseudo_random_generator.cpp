@@ -26,6 +26,7 @@
 #include <cstdint>
 
 #include "aes/aesni_primitives.h"
+#include "utility/cpu_features.h"
 
 namespace ENCRYPTO {
 
@@ -136,4 +137,24 @@ void PRG::FixedKeyAES(const std::byte *input, const uint128_t tweak, std::byte *
 
 void PRG::MMO(std::byte *input) { aesni_mmo_single(round_keys_.data(), input); }
 
+void PRG::MMO(std::byte *input, std::size_t num_blocks) {
+  const bool vaes = get_cpu_features().vaes_;
+  switch (get_simd_level()) {
+    case SIMDLevel::AVX512:
+      if (vaes) {
+        vaes_mmo_batch_512(round_keys_.data(), input, num_blocks);
+        return;
+      }
+      [[fallthrough]];
+    case SIMDLevel::AVX2:
+      if (vaes) {
+        vaes_mmo_batch_256(round_keys_.data(), input, num_blocks);
+        return;
+      }
+      [[fallthrough]];
+    case SIMDLevel::SSE:
+      aesni_mmo_batch(round_keys_.data(), input, num_blocks);
+  }
+}
+
 }  // namespace ENCRYPTO
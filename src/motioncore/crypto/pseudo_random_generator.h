@@ -65,6 +65,9 @@ class PRG {
   std::vector<std::byte> FixedKeyAES(const std::byte *x, const uint128_t i);
   void MMO(std::byte *input);
 
+  // MMO^\pi on num_blocks consecutive blocks inplace, uses the best AES kernel of the CPU
+  void MMO(std::byte *input, std::size_t num_blocks);
+
 
   // Implementation of TMMO^\pi
   // of https://eprint.iacr.org/2019/074
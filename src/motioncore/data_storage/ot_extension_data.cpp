@@ -24,24 +24,155 @@
 
 #include "ot_extension_data.h"
 
+#include <algorithm>
 #include <thread>
 
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/keys.hpp>
+
+#include "crypto/pseudo_random_generator.h"
 #include "utility/block.h"
 #include "utility/condition.h"
 #include "utility/fiber_condition.h"
+#include "utility/helpers.h"
 
 namespace MOTION {
 
+namespace {
+
+// the OTs in the pool are hashed to 128 bit, shorten or expand such an output
+// to bitlen bits in the same way as BitMatrix::SenderTransposeAndEncrypt
+void ConvertPooledOutput(ENCRYPTO::BitVector<> &output, std::size_t bitlen) {
+  constexpr std::size_t kappa = 128;
+  assert(output.GetSize() == kappa);
+  if (bitlen == kappa) {
+    return;
+  } else if (bitlen < kappa) {
+    output = ENCRYPTO::BitVector<>(output.GetData().data(), bitlen);
+  } else {
+    ENCRYPTO::PRG prg_var_key;
+    prg_var_key.SetKey(output.GetData().data());
+    output = ENCRYPTO::BitVector<>(
+        prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+  }
+}
+
+// remove the first num_ots elements of v
+template <typename T>
+void EraseFront(std::vector<T> &v, std::size_t num_ots) {
+  v.erase(v.begin(), v.begin() + std::min(num_ots, v.size()));
+}
+
+}  // namespace
+
 OTExtensionReceiverData::OTExtensionReceiverData() {
   setup_finished_cond_ =
       std::make_unique<ENCRYPTO::FiberCondition>([this]() { return setup_finished_.load(); });
+  acked_chunks_cond_ = std::make_unique<ENCRYPTO::FiberCondition>(
+      [this]() { return num_acked_chunks_ == num_sent_chunks_; });
+}
+
+void OTExtensionReceiverData::WaitForOTs(std::size_t ot_id, std::size_t num_ots) const {
+  setup_finished_cond_->Wait(
+      [this, end = ot_id + num_ots] { return setup_finished_ || num_finished_ots_ >= end; });
+}
+
+void OTExtensionReceiverData::Reserve(std::size_t ot_id, std::size_t num_ots,
+                                      std::size_t bitlen) {
+  const auto end = ot_id + num_ots;
+  if (outputs_.size() < end) {
+    outputs_.resize(end);
+  }
+  if (bitlengths_.size() < end) {
+    bitlengths_.resize(end);
+  }
+  for (auto i = ot_id; i < end; ++i) {
+    bitlengths_.at(i) = bitlen;
+    if (i < num_finished_ots_) {
+      ConvertPooledOutput(outputs_.at(i), bitlen);
+    }
+  }
+  num_ots_in_batch_.emplace(ot_id, num_ots);
+}
+
+void OTExtensionReceiverData::DiscardOTs(std::size_t num_ots) {
+  EraseFront(outputs_, num_ots);
+  EraseFront(bitlengths_, num_ots);
+  if (random_choices_) {
+    const auto size = random_choices_->GetSize();
+    *random_choices_ = random_choices_->Subset(std::min(num_ots, size), size);
+  }
+  real_choices_ = std::make_unique<ENCRYPTO::BitVector<>>();
+  num_finished_ots_ = num_finished_ots_ > num_ots ? num_finished_ots_ - num_ots : 0;
+
+  received_outputs_.clear();
+  output_conds_.clear();
+  num_messages_.clear();
+  xor_correlation_.clear();
+  real_choices_cond_.clear();
+  msg_type_.clear();
+  message_promises_bit_.clear();
+  message_promises_block128_.clear();
+  boost::hana::for_each(boost::hana::keys(message_promises_int_),
+                        [this](auto key) { message_promises_int_[key].clear(); });
+  set_real_choices_.clear();
+  num_ots_in_batch_.clear();
 }
 
 OTExtensionSenderData::OTExtensionSenderData() {
   setup_finished_cond_ =
       std::make_unique<ENCRYPTO::FiberCondition>([this]() { return setup_finished_.load(); });
+}
+
+void OTExtensionSenderData::PrepareMasks(std::size_t bit_size, std::size_t num_chunks) {
+  u_.assign(num_chunks, {});
+  num_received_u_.assign(num_chunks, 0);
+  u_conds_.clear();
+  for (std::size_t chunk_i = 0; chunk_i < num_chunks; ++chunk_i) {
+    u_conds_.emplace_back(std::make_unique<ENCRYPTO::FiberCondition>(
+        [this, chunk_i] { return num_received_u_.at(chunk_i) == u_.at(chunk_i).size(); }));
+  }
+  bit_size_ = bit_size;
+}
 
-  for (std::size_t i = 0; i < u_promises_.size(); ++i) u_futures_[i] = u_promises_[i].get_future();
+void OTExtensionSenderData::WaitForOTs(std::size_t ot_id, std::size_t num_ots) const {
+  setup_finished_cond_->Wait(
+      [this, end = ot_id + num_ots] { return setup_finished_ || num_finished_ots_ >= end; });
+}
+
+void OTExtensionSenderData::Reserve(std::size_t ot_id, std::size_t num_ots,
+                                    std::size_t bitlen) {
+  const auto end = ot_id + num_ots;
+  if (y0_.size() < end) {
+    y0_.resize(end);
+    y1_.resize(end);
+  }
+  if (bitlengths_.size() < end) {
+    bitlengths_.resize(end);
+  }
+  if (corrections_.GetSize() < end) {
+    corrections_.Resize(end);
+  }
+  for (auto i = ot_id; i < end; ++i) {
+    bitlengths_.at(i) = bitlen;
+    if (i < num_finished_ots_) {
+      ConvertPooledOutput(y0_.at(i), bitlen);
+      ConvertPooledOutput(y1_.at(i), bitlen);
+    }
+  }
+  num_ots_in_batch_.emplace(ot_id, num_ots);
+}
+
+void OTExtensionSenderData::DiscardOTs(std::size_t num_ots) {
+  EraseFront(y0_, num_ots);
+  EraseFront(y1_, num_ots);
+  EraseFront(bitlengths_, num_ots);
+  corrections_ = ENCRYPTO::BitVector<>();
+  num_finished_ots_ = num_finished_ots_ > num_ots ? num_finished_ots_ - num_ots : 0;
+
+  num_ots_in_batch_.clear();
+  received_correction_offsets_.clear();
+  received_correction_offsets_cond_.clear();
 }
 
 void OTExtensionData::MessageReceived(const std::uint8_t *message,
@@ -49,16 +180,19 @@ void OTExtensionData::MessageReceived(const std::uint8_t *message,
                                       const OTExtensionDataType type, const std::size_t i) {
   switch (type) {
     case OTExtensionDataType::rcv_masks: {
+      // wait until the sender has allocated the storage for the masks
+      while (sender_data_.bit_size_ == 0) std::this_thread::yield();
+      // the masks are numbered consecutively over the chunks of the matrix
+      const auto chunk_i = i / 128;
+      const auto row_i = i % 128;
+      auto &cond = sender_data_.u_conds_.at(chunk_i);
       {
-        while (sender_data_.bit_size_ == 0) std::this_thread::yield();
-        std::scoped_lock lock(sender_data_.u_mutex_);
-        sender_data_.u_[i] = ENCRYPTO::AlignedBitVector(message, sender_data_.bit_size_);
-        sender_data_.u_promises_[sender_data_.num_received_u_].set_value(i);
-
-        // set to 0 after Clear()
-        sender_data_.num_received_u_++;
+        std::scoped_lock lock(cond->GetMutex());
+        sender_data_.u_.at(chunk_i).at(row_i) =
+            ENCRYPTO::AlignedBitVector(message, 8 * message_size);
+        ++sender_data_.num_received_u_.at(chunk_i);
       }
-
+      cond->NotifyAll();
       break;
     }
     case OTExtensionDataType::rcv_corrections: {
@@ -77,16 +211,16 @@ void OTExtensionData::MessageReceived(const std::uint8_t *message,
     }
     case OTExtensionDataType::snd_messages: {
       {
-        receiver_data_.setup_finished_cond_->Wait();
+        const auto bs_it = receiver_data_.num_ots_in_batch_.find(i);
+        assert(bs_it != receiver_data_.num_ots_in_batch_.end());
+        const auto batch_size = bs_it->second;
+
+        receiver_data_.WaitForOTs(i, batch_size);
 
         std::unique_lock lock(receiver_data_.bitlengths_mutex_);
         const auto bitlen = receiver_data_.bitlengths_.at(i);
         lock.unlock();
 
-        const auto bs_it = receiver_data_.num_ots_in_batch_.find(i);
-        assert(bs_it != receiver_data_.num_ots_in_batch_.end());
-        const auto batch_size = bs_it->second;
-
         auto msg_type = receiver_data_.msg_type_.find(i);
         if (msg_type != receiver_data_.msg_type_.end()) {
           switch (msg_type->second) {
@@ -261,6 +395,25 @@ void OTExtensionData::MessageReceived(const std::uint8_t *message,
       }
       break;
     }
+    case OTExtensionDataType::silent_snd_messages: {
+      assert(i < receiver_data_.silent_messages_.size());
+      auto &cond = receiver_data_.silent_messages_conds_.at(i);
+      {
+        std::scoped_lock lock(cond->GetMutex());
+        receiver_data_.silent_messages_.at(i).assign(message, message + message_size);
+      }
+      cond->NotifyAll();
+      break;
+    }
+    case OTExtensionDataType::snd_chunk_acks: {
+      auto &cond = receiver_data_.acked_chunks_cond_;
+      {
+        std::scoped_lock lock(cond->GetMutex());
+        ++receiver_data_.num_acked_chunks_;
+      }
+      cond->NotifyAll();
+      break;
+    }
     default: {
       throw std::runtime_error(fmt::format(
           "DataStorage::OTExtensionDataType: unknown data type {}; data_type must be <{}", type,
@@ -50,7 +50,9 @@ enum OTExtensionDataType : uint {
   rcv_masks = 0,
   rcv_corrections = 1,
   snd_messages = 2,
-  OTExtension_invalid_data_type = 3
+  silent_snd_messages = 3,
+  snd_chunk_acks = 4,
+  OTExtension_invalid_data_type = 5
 };
 
 enum class OTMsgType {
@@ -75,6 +77,19 @@ struct OTExtensionReceiverData {
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<std::vector<T>> RegisterForIntSenderMessage(
       std::size_t ot_id, std::size_t size);
 
+  // wait until the outputs of the OTs ot_id, ..., ot_id + num_ots - 1 are computed
+  // (if the OT extension is done in chunks, this may be before the setup is finished)
+  void WaitForOTs(std::size_t ot_id, std::size_t num_ots) const;
+
+  // make space for the outputs of the OTs ot_id, ..., ot_id + num_ots - 1 with
+  // bitlen bits each; outputs which are already computed (i.e., which are left
+  // in the pool by a previous setup) are converted to the bit length
+  void Reserve(std::size_t ot_id, std::size_t num_ots, std::size_t bitlen);
+
+  // discard the first num_ots OTs and the state of their batches, s.t. the
+  // pooled OTs are renumbered starting from 0
+  void DiscardOTs(std::size_t num_ots);
+
   // matrix of the OT extension scheme
   // XXX: can't we delete this after setup?
   std::shared_ptr<ENCRYPTO::BitMatrix> T_;
@@ -135,9 +150,25 @@ struct OTExtensionReceiverData {
   // how many ots are in each batch?
   std::unordered_map<std::size_t, std::size_t> num_ots_in_batch_;
 
+  // number of chunks of the bit matrix whose masks were sent and whose masks
+  // were acknowledged by the sender, counted over all setups (the latter is
+  // modified under the mutex of acked_chunks_cond_)
+  std::size_t num_sent_chunks_ = 0;
+  std::size_t num_acked_chunks_ = 0;
+  std::unique_ptr<ENCRYPTO::FiberCondition> acked_chunks_cond_;
+
+  // messages of the silent OT extension, one per LPN instance
+  // (both vectors are sized by the receiver before it sends its masks)
+  std::vector<std::vector<std::uint8_t>> silent_messages_;
+  std::vector<std::unique_ptr<ENCRYPTO::FiberCondition>> silent_messages_conds_;
+
   // flag and condition variable: is setup is done?
   std::unique_ptr<ENCRYPTO::FiberCondition> setup_finished_cond_;
   std::atomic<bool> setup_finished_{false};
+  // number of OTs whose outputs are computed, the chunks are finished in order
+  // (modified under the mutex of setup_finished_cond_); OTs beyond the
+  // registered ones are kept as a pool for the following setups
+  std::atomic<std::size_t> num_finished_ots_{0};
 
   std::atomic<std::size_t> consumed_offset_base_ots_{0};
   // XXX: unused
@@ -148,16 +179,30 @@ struct OTExtensionSenderData {
   OTExtensionSenderData();
   ~OTExtensionSenderData() = default;
 
-  // width of the bit matrix
-  std::atomic<std::size_t> bit_size_{0};
+  // allocate the storage for the masks of num_chunks chunks of the bit matrix and
+  // start accepting the masks of a matrix with bit_size columns
+  void PrepareMasks(std::size_t bit_size, std::size_t num_chunks);
+
+  // see OTExtensionReceiverData::WaitForOTs
+  void WaitForOTs(std::size_t ot_id, std::size_t num_ots) const;
+
+  // see OTExtensionReceiverData::Reserve
+  void Reserve(std::size_t ot_id, std::size_t num_ots, std::size_t bitlen);
 
-  /// receiver's mask that are needed to construct matrix @param V_
-  std::array<ENCRYPTO::AlignedBitVector, 128> u_;
+  // see OTExtensionReceiverData::DiscardOTs
+  void DiscardOTs(std::size_t num_ots);
+
+  // width of the bit matrix (0 while no masks are accepted)
+  std::atomic<std::size_t> bit_size_{0};
 
-  std::array<ENCRYPTO::ReusableFiberPromise<std::size_t>, 128> u_promises_;
-  std::array<ENCRYPTO::ReusableFiberFuture<std::size_t>, 128> u_futures_;
-  std::mutex u_mutex_;
-  std::size_t num_received_u_{0};
+  /// receiver's masks that are needed to construct matrix @param V_, 128 per
+  /// chunk of the matrix; the masks of a chunk are freed once it is processed,
+  /// and the receiver keeps at most max_ot_extension_chunks_in_flight chunks of
+  /// masks unprocessed (see OTProviderFromOTExtension)
+  std::vector<std::array<ENCRYPTO::AlignedBitVector, 128>> u_;
+  // number of received masks per chunk (modified under the mutex of the chunk's condition)
+  std::vector<std::size_t> num_received_u_;
+  std::vector<std::unique_ptr<ENCRYPTO::FiberCondition>> u_conds_;
   // matrix of the OT extension scheme
   // XXX: can't we delete this after setup?
   std::shared_ptr<ENCRYPTO::BitMatrix> V_;
@@ -183,6 +228,8 @@ struct OTExtensionSenderData {
   // flag and condition variable: is setup is done?
   std::unique_ptr<ENCRYPTO::FiberCondition> setup_finished_cond_;
   std::atomic<bool> setup_finished_{false};
+  // see OTExtensionReceiverData::num_finished_ots_
+  std::atomic<std::size_t> num_finished_ots_{0};
 
   std::atomic<std::size_t> consumed_offset_base_ots_{0};
   // XXX: unused
@@ -24,7 +24,10 @@
 
 #include <boost/fiber/future/async.hpp>
 #include <boost/fiber/policy.hpp>
+#include <algorithm>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 
 #include "base/gate_register.h"
 #include "gate/new_gate.h"
@@ -79,21 +82,19 @@ void NewGateExecutor::evaluate_setup_online_multi_threaded(Statistics::RunTimeSt
   }
 
   // create a pool to execute fibers
-  ENCRYPTO::FiberThreadPool fpool(num_threads_, 2 * register_.get_num_gates());
+  ENCRYPTO::FiberThreadPool fpool(num_threads_, max_gates_in_flight_);
 
   // ------------------------------ setup phase ------------------------------
   stats.record_start<Statistics::RunTimeStats::StatID::gates_setup>();
 
   if (register_.get_num_gates_with_setup()) {
     // evaluate the setup phase of all the gates
-    for (auto& gate : register_.get_gates()) {
-      if (gate->need_setup()) {
-        fpool.post([&] {
-          gate->evaluate_setup();
+    dispatch_gates(
+        fpool, [](const auto& gate) { return gate.need_setup(); },
+        [this](auto& gate) {
+          gate.evaluate_setup();
           register_.increment_gate_setup_counter();
         });
-      }
-    }
     register_.wait_setup();
   }
 
@@ -112,15 +113,12 @@ void NewGateExecutor::evaluate_setup_online_multi_threaded(Statistics::RunTimeSt
 
   if (register_.get_num_gates_with_online()) {
     // evaluate the online phase of all the gates
-    for (auto& gate : register_.get_gates()) {
-      if (gate->need_online()) {
-        fpool.post([&] {
-          // std::cout << gate << std::endl;
-          gate->evaluate_online();
+    dispatch_gates(
+        fpool, [](const auto& gate) { return gate.need_online(); },
+        [this](auto& gate) {
+          gate.evaluate_online();
           register_.increment_gate_online_counter();
         });
-      }
-    }
     register_.wait_online();
   }
 
@@ -147,21 +145,19 @@ void NewGateExecutor::evaluate_setup_online_wo_broadcast_multi_threaded(Statisti
   }
 
   // create a pool to execute fibers
-  ENCRYPTO::FiberThreadPool fpool(num_threads_, 2 * register_.get_num_gates());
+  ENCRYPTO::FiberThreadPool fpool(num_threads_, max_gates_in_flight_);
 
   // ------------------------------ setup phase ------------------------------
   stats.record_start<Statistics::RunTimeStats::StatID::gates_setup>();
 
   if (register_.get_num_gates_with_setup()) {
     // evaluate the setup phase of all the gates
-    for (auto& gate : register_.get_gates()) {
-      if (gate->need_setup()) {
-        fpool.post([&] {
-          gate->evaluate_setup_wo_broadcast();
+    dispatch_gates(
+        fpool, [](const auto& gate) { return gate.need_setup(); },
+        [this](auto& gate) {
+          gate.evaluate_setup_wo_broadcast();
           register_.increment_gate_setup_counter();
         });
-      }
-    }
     register_.wait_setup();
   }
 
@@ -180,14 +176,12 @@ void NewGateExecutor::evaluate_setup_online_wo_broadcast_multi_threaded(Statisti
 
   if (register_.get_num_gates_with_online()) {
     // evaluate the online phase of all the gates
-    for (auto& gate : register_.get_gates()) {
-      if (gate->need_online()) {
-        fpool.post([&] {
-          gate->evaluate_online_wo_output();
+    dispatch_gates(
+        fpool, [](const auto& gate) { return gate.need_online(); },
+        [this](auto& gate) {
+          gate.evaluate_online_wo_output();
           register_.increment_gate_online_counter();
         });
-      }
-    }
     register_.wait_online();
   }
 
@@ -273,8 +267,76 @@ void NewGateExecutor::evaluate_setup_online_single_threaded(Statistics::RunTimeS
   cleanup_fut.get();
 }
 
-void NewGateExecutor::evaluate(Statistics::RunTimeStats&) {
-  throw std::logic_error("not implemented");
+void NewGateExecutor::evaluate(Statistics::RunTimeStats& stats) {
+  stats.record_start<Statistics::RunTimeStats::StatID::evaluate>();
+  preprocessing_fctn_();
+
+  if (logger_) {
+    logger_->LogInfo("Start evaluating the circuit gates (online as soon as possible)");
+  }
+
+  ENCRYPTO::FiberThreadPool fpool(num_threads_, max_gates_in_flight_);
+
+  // the online phase of a gate only waits for its own setup and the online
+  // phase of its inputs, so independent parts of the circuit can be in
+  // different phases
+  dispatch_gates(
+      fpool, [](const auto& gate) { return gate.need_setup() || gate.need_online(); },
+      [this](auto& gate) {
+        if (gate.need_setup()) {
+          gate.evaluate_setup();
+          register_.increment_gate_setup_counter();
+        }
+        if (gate.need_online()) {
+          gate.evaluate_online();
+          register_.increment_gate_online_counter();
+        }
+      });
+  if (register_.get_num_gates_with_setup()) {
+    register_.wait_setup();
+  }
+  if (register_.get_num_gates_with_online()) {
+    register_.wait_online();
+  }
+
+  if (logger_) {
+    logger_->LogInfo("Finished evaluating the circuit gates");
+  }
+
+  fpool.join();
+
+  stats.record_end<Statistics::RunTimeStats::StatID::evaluate>();
+}
+
+void NewGateExecutor::dispatch_gates(ENCRYPTO::FiberThreadPool& fpool,
+                                     const std::function<bool(const NewGate&)>& need,
+                                     const std::function<void(NewGate&)>& f) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t num_in_flight = 0;
+  const auto max_in_flight = std::max(std::size_t{1}, max_gates_in_flight_);
+
+  for (auto& gate : register_.get_gates()) {
+    if (!need(*gate)) {
+      continue;
+    }
+    {
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [&] { return num_in_flight < max_in_flight; });
+      ++num_in_flight;
+    }
+    fpool.post([&, gate_ptr = gate.get()] {
+      f(*gate_ptr);
+      // notify under the lock, since the dispatcher may return right afterwards
+      std::scoped_lock lock(mutex);
+      --num_in_flight;
+      cv.notify_one();
+    });
+  }
+
+  // the state above lives on this stack, so wait until all tasks are done
+  std::unique_lock lock(mutex);
+  cv.wait(lock, [&] { return num_in_flight == 0; });
 }
 
 }  // namespace MOTION
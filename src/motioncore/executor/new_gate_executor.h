@@ -24,11 +24,17 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
+
+namespace ENCRYPTO {
+class FiberThreadPool;
+}
 
 namespace MOTION {
 
 class Logger;
 class GateRegister;
+class NewGate;
 
 namespace Statistics {
 struct RunTimeStats;
@@ -50,7 +56,20 @@ class NewGateExecutor {
   // Run setup and online phase of each gate as soon as possible.
   void evaluate(Statistics::RunTimeStats& stats);
 
+  // Limit the number of gates which are evaluated concurrently by the thread
+  // pool, and hence the number of fibers and their stacks.
+  void set_max_gates_in_flight(std::size_t max_gates_in_flight) noexcept {
+    max_gates_in_flight_ = max_gates_in_flight;
+  }
+
  private:
+  // Run f on all gates for which need returns true in the order of their ids.
+  // A gate is registered after the gates computing its inputs, so the ids are a
+  // topological order of the circuit and the gates in flight can always make
+  // progress.  At most max_gates_in_flight_ gates are dispatched at a time.
+  void dispatch_gates(ENCRYPTO::FiberThreadPool&, const std::function<bool(const NewGate&)>& need,
+                      const std::function<void(NewGate&)>& f);
+
   void evaluate_setup_online_multi_threaded(Statistics::RunTimeStats& stats);
   void evaluate_setup_online_single_threaded(Statistics::RunTimeStats& stats);
   void evaluate_setup_online_wo_broadcast_multi_threaded(Statistics::RunTimeStats& stats);
@@ -60,6 +79,7 @@ class NewGateExecutor {
   std::function<void()> sync_fctn_;
   std::size_t num_threads_;
   bool sync_between_setup_and_online_ = false;
+  std::size_t max_gates_in_flight_ = 1024;
   std::shared_ptr<Logger> logger_;
 };
 
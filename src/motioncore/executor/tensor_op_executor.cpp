@@ -25,7 +25,10 @@
 #include <fmt/format.h>
 #include <omp.h>
 #include <algorithm>
+#include <condition_variable>
+#include <future>
 #include <iostream>
+#include <mutex>
 
 #include "base/gate_register.h"
 #include "executor/execution_context.h"
@@ -36,6 +39,21 @@
 
 namespace MOTION {
 
+namespace {
+
+// prepare an entry for the timings of each gate
+std::vector<Statistics::RunTimeStats::GateStats>& init_gate_stats(
+    Statistics::RunTimeStats& stats, const std::vector<std::unique_ptr<NewGate>>& gates) {
+  stats.gate_stats_.clear();
+  stats.gate_stats_.reserve(gates.size());
+  for (const auto& gate : gates) {
+    stats.gate_stats_.push_back({gate->get_gate_id(), {}, {}});
+  }
+  return stats.gate_stats_;
+}
+
+}  // namespace
+
 TensorOpExecutor::TensorOpExecutor(GateRegister& reg, std::function<void(void)> preprocessing_fctn,
                                    bool sync_between_setup_and_online,
                                    std::function<void(void)> sync_fctn, std::size_t num_threads,
@@ -80,11 +98,16 @@ void TensorOpExecutor::evaluate_setup_online(Statistics::RunTimeStats& stats) {
   // ------------------------------ setup phase ------------------------------
   stats.record_start<Statistics::RunTimeStats::StatID::gates_setup>();
 
+  auto& gates = register_.get_gates();
+  auto& gate_stats = init_gate_stats(stats, gates);
+
   if (register_.get_num_gates_with_setup()) {
     // evaluate the setup phase of all the gates
-    for (auto& gate : register_.get_gates()) {
-      if (gate->need_setup()) {
-        gate->evaluate_setup_with_context(exec_ctx);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+      if (gates[i]->need_setup()) {
+        gate_stats[i].setup_.first = stats.get_time();
+        gates[i]->evaluate_setup_with_context(exec_ctx);
+        gate_stats[i].setup_.second = stats.get_time();
         register_.increment_gate_setup_counter();
       }
     }
@@ -106,9 +129,11 @@ void TensorOpExecutor::evaluate_setup_online(Statistics::RunTimeStats& stats) {
 
   if (register_.get_num_gates_with_online()) {
     // evaluate the online phase of all the gates
-    for (auto& gate : register_.get_gates()) {
-      if (gate->need_online()) {
-        gate->evaluate_online_with_context(exec_ctx);
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+      if (gates[i]->need_online()) {
+        gate_stats[i].online_.first = stats.get_time();
+        gates[i]->evaluate_online_with_context(exec_ctx);
+        gate_stats[i].online_.second = stats.get_time();
         register_.increment_gate_online_counter();
       }
     }
@@ -128,7 +153,122 @@ void TensorOpExecutor::evaluate_setup_online(Statistics::RunTimeStats& stats) {
 }
 
 void TensorOpExecutor::evaluate(Statistics::RunTimeStats& stats) {
-  throw std::logic_error("not implemented");
+  if (num_threads_ > 0) {
+    if (logger_) {
+      logger_->LogInfo(fmt::format("Set OpenMP threads to {}", num_threads_));
+    }
+    omp_set_num_threads(num_threads_);
+  }
+
+  ExecutionContext exec_ctx{.num_threads_ = num_threads_,
+                            .fpool_ = std::make_unique<ENCRYPTO::FiberThreadPool>(
+                                std::max(std::size_t{2}, num_threads_))};
+
+  stats.record_start<Statistics::RunTimeStats::StatID::evaluate>();
+
+  preprocessing_fctn_();
+
+  if (logger_) {
+    logger_->LogInfo(
+        "Start evaluating the circuit gates pipelined (online as soon as the setup is finished)");
+  }
+
+  auto& gates = register_.get_gates();
+  auto& gate_stats = init_gate_stats(stats, gates);
+
+  // number of gates at the front of the gate list whose setup has finished
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t num_gates_set_up = 0;
+  bool setup_failed = false;
+  // set if the online phase failed, so that the setup stops after its current gate
+  bool online_failed = false;
+
+  // Both phases are evaluated in the order of the gate ids, and their
+  // messages are queued per party as before, so the send threads still pass
+  // everything sent in the meantime on together (or the CommMixin coalesces
+  // it, if enabled).
+  stats.record_start<Statistics::RunTimeStats::StatID::gates_setup>();
+  auto setup_future = std::async(std::launch::async, [&] {
+    if (num_threads_ > 0) {
+      omp_set_num_threads(num_threads_);
+    }
+    try {
+      for (std::size_t i = 0; i < gates.size(); ++i) {
+        {
+          std::scoped_lock lock(mutex);
+          if (online_failed) {
+            return;
+          }
+        }
+        if (gates[i]->need_setup()) {
+          gate_stats[i].setup_.first = stats.get_time();
+          gates[i]->evaluate_setup_with_context(exec_ctx);
+          gate_stats[i].setup_.second = stats.get_time();
+          register_.increment_gate_setup_counter();
+        }
+        {
+          std::scoped_lock lock(mutex);
+          num_gates_set_up = i + 1;
+        }
+        cv.notify_one();
+      }
+    } catch (...) {
+      {
+        std::scoped_lock lock(mutex);
+        setup_failed = true;
+      }
+      cv.notify_one();
+      throw;
+    }
+    stats.record_end<Statistics::RunTimeStats::StatID::gates_setup>();
+  });
+
+  stats.record_start<Statistics::RunTimeStats::StatID::gates_online>();
+  try {
+    for (std::size_t i = 0; i < gates.size(); ++i) {
+      if (!gates[i]->need_online()) {
+        continue;
+      }
+      {
+        // the online phase of a gate may use the setup of all its predecessors
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&] { return num_gates_set_up > i || setup_failed; });
+        if (setup_failed) {
+          break;
+        }
+      }
+      gate_stats[i].online_.first = stats.get_time();
+      gates[i]->evaluate_online_with_context(exec_ctx);
+      gate_stats[i].online_.second = stats.get_time();
+      register_.increment_gate_online_counter();
+    }
+  } catch (...) {
+    {
+      std::scoped_lock lock(mutex);
+      online_failed = true;
+    }
+    // join the setup before its state goes out of scope; an exception of the
+    // setup phase is superseded by the one of the online phase
+    setup_future.wait();
+    throw;
+  }
+  // rethrows an exception of the setup phase
+  setup_future.get();
+  if (register_.get_num_gates_with_setup()) {
+    register_.wait_setup();
+  }
+  if (register_.get_num_gates_with_online()) {
+    register_.wait_online();
+  }
+  stats.record_end<Statistics::RunTimeStats::StatID::gates_online>();
+
+  if (logger_) {
+    logger_->LogInfo("Finished with the pipelined evaluation of the circuit gates");
+  }
+
+  stats.record_end<Statistics::RunTimeStats::StatID::evaluate>();
+  exec_ctx.fpool_->join();
 }
 
 }  // namespace MOTION
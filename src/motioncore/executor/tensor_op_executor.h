@@ -46,7 +46,12 @@ class TensorOpExecutor {
   // Run the setup phases first for all gates before starting with the online
   // phases.
   void evaluate_setup_online(Statistics::RunTimeStats& stats);
-  // Run setup and online phase of each gate as soon as possible.
+  // Run the setup phases of all gates and, concurrently, the online phase of
+  // each gate as soon as the setup phases up to this gate are finished.  Thus,
+  // the online phase of the first layers of a network overlaps with the setup
+  // of the following ones.  sync_between_setup_and_online is ignored.  If the
+  // online phase throws, the setup stops after its current gate and is joined
+  // before the exception is passed on.
   void evaluate(Statistics::RunTimeStats& stats);
 
  private:
@@ -22,9 +22,12 @@
 
 #include "beavy_provider.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <unordered_map>
 
+#include "algorithm/circuit_loader.h"
 #include "base/gate_register.h"
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/gmw_message_generated.h"
@@ -415,6 +418,23 @@ std::pair<NewGateP, WireVector> BEAVYProvider::construct_binary_gate(
   }
 }
 
+std::pair<NewGateP, WireVector> BEAVYProvider::construct_circuit_gate(
+    const ENCRYPTO::AlgorithmDescription& algo, const WireVector& in) {
+  const auto& circuit_layers = circuit_loader_.get_circuit_layers(algo);
+  auto gate_id = gate_register_.get_next_gate_id();
+  auto gate = std::make_unique<BooleanBEAVYCircuitGate>(gate_id, *this, algo, circuit_layers,
+                                                         cast_wires(in));
+  auto output = gate->get_output_wires();
+  return {std::move(gate), cast_wires(std::move(output))};
+}
+
+WireVector BEAVYProvider::make_circuit_gate(const ENCRYPTO::AlgorithmDescription& algo,
+                                            const WireVector& in) {
+  auto [gate, output] = construct_circuit_gate(algo, in);
+  gate_register_.register_gate(std::move(gate));
+  return output;
+}
+
 std::vector<std::shared_ptr<NewWire>> BEAVYProvider::make_binary_gate(
     ENCRYPTO::PrimitiveOperationType op, const std::vector<std::shared_ptr<NewWire>>& in_a,
     const std::vector<std::shared_ptr<NewWire>>& in_b) {
@@ -1119,6 +1139,114 @@ tensor::TensorCP BEAVYProvider::make_tensor_gemm_op(const tensor::GemmOp& gemm_o
   return output;
 }
 
+tensor::TensorCP BEAVYProvider::make_tensor_gemm_op(const tensor::GemmOp& gemm_op,
+                                                    const std::vector<std::uint64_t>& input_A,
+                                                    const tensor::TensorCP input_B,
+                                                    std::size_t fractional_bits) {
+  if (!gemm_op.verify()) {
+    throw std::invalid_argument("invalid GemmOp");
+  }
+  if (input_A.size() != gemm_op.compute_input_A_size()) {
+    throw std::invalid_argument("invalid input_A size");
+  }
+  if (input_B->get_dimensions() != gemm_op.get_input_B_tensor_dims()) {
+    throw std::invalid_argument("invalid input_B dimensions");
+  }
+  auto bit_size = input_B->get_bit_size();
+  std::unique_ptr<NewGate> gate;
+  auto gate_id = gate_register_.get_next_gate_id();
+  tensor::TensorCP output;
+  const auto make_op = [this, &input_A, gemm_op, input_B, fractional_bits, gate_id,
+                        &output](auto dummy_arg) {
+    using T = decltype(dummy_arg);
+    if constexpr (ENCRYPTO::bit_size_v<T> < 64) {
+      // the values are reduced modulo 2^bit_size, which is only lossless if they are given as
+      // unsigned or sign-extended values of that bit size
+      constexpr auto bit_size = ENCRYPTO::bit_size_v<T>;
+      const auto fits = [](std::uint64_t v) {
+        const auto upper_bits = v >> (bit_size - 1);
+        return upper_bits <= 1 || upper_bits == (std::uint64_t(-1) >> (bit_size - 1));
+      };
+      const auto it = std::find_if_not(std::begin(input_A), std::end(input_A), fits);
+      if (it != std::end(input_A)) {
+        throw std::invalid_argument(
+            fmt::format("public matrix entry {} at index {} does not fit into {} bits", *it,
+                        std::distance(std::begin(input_A), it), bit_size));
+      }
+    }
+    auto tensor_op = std::make_unique<ArithmeticBEAVYTensorPublicGemm<T>>(
+        gate_id, *this, gemm_op, std::vector<T>(std::begin(input_A), std::end(input_A)),
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<T>>(input_B), fractional_bits);
+    output = tensor_op->get_output_tensor();
+    return tensor_op;
+  };
+  switch (bit_size) {
+    case 32:
+      gate = make_op(std::uint32_t{});
+      break;
+    case 64:
+      gate = make_op(std::uint64_t{});
+      break;
+    default:
+      throw std::logic_error(fmt::format("unexpected bit size {}", bit_size));
+  }
+  gate_register_.register_gate(std::move(gate));
+  return output;
+}
+
+tensor::TensorCP BEAVYProvider::make_tensor_dense_op(const tensor::GemmOp& gemm_op,
+                                                     const tensor::TensorCP input_A,
+                                                     const tensor::TensorCP input_B,
+                                                     const tensor::TensorCP bias,
+                                                     std::size_t fractional_bits,
+                                                     bool negate_output) {
+  if (!gemm_op.verify()) {
+    throw std::invalid_argument("invalid GemmOp");
+  }
+  if (input_A->get_dimensions() != gemm_op.get_input_A_tensor_dims()) {
+    throw std::invalid_argument("invalid input_A dimensions");
+  }
+  if (input_B->get_dimensions() != gemm_op.get_input_B_tensor_dims()) {
+    throw std::invalid_argument("invalid input_B dimensions");
+  }
+  const auto& bias_dims = bias->get_dimensions();
+  const tensor::TensorDimensions bias_column_dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = gemm_op.output_shape_[0], .width_ = 1};
+  if (bias_dims != gemm_op.get_output_tensor_dims() && bias_dims != bias_column_dims) {
+    throw std::invalid_argument("invalid bias dimensions");
+  }
+  auto bit_size = input_A->get_bit_size();
+  if (bit_size != input_B->get_bit_size() || bit_size != bias->get_bit_size()) {
+    throw std::invalid_argument("bit size mismatch");
+  }
+  std::unique_ptr<NewGate> gate;
+  auto gate_id = gate_register_.get_next_gate_id();
+  tensor::TensorCP output;
+  const auto make_op = [this, input_A, gemm_op, input_B, bias, fractional_bits, negate_output,
+                        gate_id, &output](auto dummy_arg) {
+    using T = decltype(dummy_arg);
+    auto tensor_op = std::make_unique<ArithmeticBEAVYTensorDense<T>>(
+        gate_id, *this, gemm_op, std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<T>>(input_A),
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<T>>(input_B),
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<T>>(bias), fractional_bits,
+        negate_output);
+    output = tensor_op->get_output_tensor();
+    return tensor_op;
+  };
+  switch (bit_size) {
+    case 32:
+      gate = make_op(std::uint32_t{});
+      break;
+    case 64:
+      gate = make_op(std::uint64_t{});
+      break;
+    default:
+      throw std::logic_error(fmt::format("unexpected bit size {}", bit_size));
+  }
+  gate_register_.register_gate(std::move(gate));
+  return output;
+}
+
 tensor::TensorCP BEAVYProvider::make_tensor_sqr_op(const tensor::TensorCP input,
                                                    std::size_t fractional_bits) {
   auto bit_size = input->get_bit_size();
@@ -1237,6 +1365,19 @@ tensor::TensorCP BEAVYProvider::make_tensor_maxpool_op(const tensor::MaxPoolOp&
   return output;
 }
 
+std::pair<tensor::TensorCP, tensor::TensorCP> BEAVYProvider::make_tensor_argmax_op(
+    const tensor::ArgMaxOp& argmax_op, const tensor::TensorCP in, bool with_max) {
+  const auto input_tensor = std::dynamic_pointer_cast<const BooleanBEAVYTensor>(in);
+  assert(input_tensor != nullptr);
+  auto gate_id = gate_register_.get_next_gate_id();
+  auto tensor_op = std::make_unique<BooleanBEAVYTensorArgMax>(gate_id, *this, argmax_op,
+                                                              input_tensor, with_max);
+  std::pair<tensor::TensorCP, tensor::TensorCP> output = {tensor_op->get_index_tensor(),
+                                                          tensor_op->get_max_tensor()};
+  gate_register_.register_gate(std::move(tensor_op));
+  return output;
+}
+
 // Functions defined to perform constant operations (addnl)
 tensor::TensorCP BEAVYProvider::make_tensor_negate(const tensor::TensorCP in) {
   auto bit_size = in->get_bit_size();
@@ -33,6 +33,10 @@
 #include "utility/enable_wait.h"
 #include "utility/type_traits.hpp"
 
+namespace ENCRYPTO {
+struct AlgorithmDescription;
+}
+
 namespace ENCRYPTO::ObliviousTransfer {
 class OTProviderManager;
 }
@@ -41,6 +45,7 @@ namespace MOTION {
 
 class CircuitLoader;
 class ArithmeticProviderManager;
+class LinAlgTripleProvider;
 class GateRegister;
 class Logger;
 class NewGate;
@@ -103,6 +108,16 @@ class BEAVYProvider : public GateFactory,
 
   bool get_fake_setup() const noexcept { return fake_setup_; }
 
+  // Take the setup of the linear tensor operations (GEMM, Dense, Conv2D) from
+  // precomputed Beaver triples instead of computing it with OTs.
+  void set_linalg_triple_provider(std::shared_ptr<LinAlgTripleProvider> ltp) noexcept {
+    linalg_triple_provider_ = ltp;
+  }
+  // nullptr if the setup is computed with OTs
+  LinAlgTripleProvider* get_linalg_triple_provider() noexcept {
+    return linalg_triple_provider_.get();
+  }
+
   // Implementation of GateFactors interface
 
   // Boolean inputs
@@ -176,6 +191,12 @@ class BEAVYProvider : public GateFactory,
   std::pair<NewGateP, WireVector> construct_binary_gate(ENCRYPTO::PrimitiveOperationType op,
                                                         const WireVector&, const WireVector&);
 
+  // Boolean circuit evaluated as a single gate with one round per AND layer,
+  // the circuit needs to be owned by the CircuitLoader
+  std::pair<NewGateP, WireVector> construct_circuit_gate(const ENCRYPTO::AlgorithmDescription&,
+                                                         const WireVector&);
+  WireVector make_circuit_gate(const ENCRYPTO::AlgorithmDescription&, const WireVector&);
+
   // conversions
   WireVector convert(MPCProtocol dst_protocol, const WireVector&) override;
 
@@ -216,6 +237,16 @@ class BEAVYProvider : public GateFactory,
                                        const tensor::TensorCP input_A,
                                        const tensor::TensorCP input_B,
                                        std::size_t fractional_bits = 0) override;
+  tensor::TensorCP make_tensor_gemm_op(const tensor::GemmOp& gemm_op,
+                                       const std::vector<std::uint64_t>& input_A,
+                                       const tensor::TensorCP input_B,
+                                       std::size_t fractional_bits = 0) override;
+  tensor::TensorCP make_tensor_dense_op(const tensor::GemmOp& gemm_op,
+                                        const tensor::TensorCP input_A,
+                                        const tensor::TensorCP input_B,
+                                        const tensor::TensorCP bias,
+                                        std::size_t fractional_bits = 0,
+                                        bool negate_output = false) override;
   tensor::TensorCP make_tensor_sqr_op(const tensor::TensorCP input,
                                       std::size_t fractional_bits = 0) override;
   tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP) override;
@@ -224,6 +255,8 @@ class BEAVYProvider : public GateFactory,
   tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP, const tensor::TensorCP) override;
   tensor::TensorCP make_tensor_maxpool_op(const tensor::MaxPoolOp&,
                                           const tensor::TensorCP) override;
+  std::pair<tensor::TensorCP, tensor::TensorCP> make_tensor_argmax_op(
+      const tensor::ArgMaxOp&, const tensor::TensorCP, bool with_max = false) override;
   tensor::TensorCP make_tensor_avgpool_op(const tensor::AveragePoolOp&, const tensor::TensorCP,
                                           std::size_t fractional_bits = 0) override;
   //Functions defined to perform constant operations (addnl)
@@ -334,6 +367,7 @@ class BEAVYProvider : public GateFactory,
   std::size_t next_input_id_;
   std::shared_ptr<Logger> logger_;
   bool fake_setup_;
+  std::shared_ptr<LinAlgTripleProvider> linalg_triple_provider_;
 };
 
 }  // namespace proto::beavy
@@ -28,6 +28,7 @@
 #include <functional>
 #include <stdexcept>
 
+#include "algorithm/algorithm_description.h"
 #include "base/gate_factory.h"
 #include "beavy_provider.h"
 #include "crypto/arithmetic_provider.h"
@@ -625,6 +626,214 @@ void BooleanBEAVYANDGate::evaluate_online() {
   }
 }
 
+BooleanBEAVYCircuitGate::BooleanBEAVYCircuitGate(std::size_t gate_id,
+                                                 BEAVYProvider& beavy_provider,
+                                                 const ENCRYPTO::AlgorithmDescription& algo,
+                                                 const ENCRYPTO::CircuitLayers& circuit_layers,
+                                                 BooleanBEAVYWireVector&& in)
+    : NewGate(gate_id),
+      beavy_provider_(beavy_provider),
+      algo_(algo),
+      circuit_layers_(circuit_layers),
+      num_simd_(in.at(0)->get_num_simd()),
+      inputs_(std::move(in)),
+      ot_sender_(nullptr),
+      ot_receiver_(nullptr) {
+  const auto n_input_wires =
+      algo_.n_input_wires_parent_a_ + algo_.n_input_wires_parent_b_.value_or(0);
+  if (inputs_.size() != n_input_wires) {
+    throw std::invalid_argument(
+        fmt::format("BooleanBEAVYCircuitGate: circuit expects {} input wires, but {} are provided",
+                    n_input_wires, inputs_.size()));
+  }
+  outputs_.reserve(algo_.n_output_wires_);
+  std::generate_n(std::back_inserter(outputs_), algo_.n_output_wires_,
+                  [this] { return std::make_shared<BooleanBEAVYWire>(num_simd_); });
+  auto my_id = beavy_provider_.get_my_id();
+  const auto num_layers = circuit_layers_.layers_.size();
+  share_futures_.resize(num_layers);
+  for (std::size_t layer_i = 0; layer_i < num_layers; ++layer_i) {
+    const auto num_and_gates = circuit_layers_.layers_[layer_i].and_gates_.size();
+    if (num_and_gates > 0) {
+      share_futures_[layer_i] = beavy_provider_.register_for_bits_message(
+          1 - my_id, gate_id_, num_and_gates * num_simd_, layer_i);
+    }
+  }
+  const auto num_bits = circuit_layers_.n_and_gates_ * num_simd_;
+  if (num_bits > 0) {
+    auto& otp = beavy_provider_.get_ot_manager().get_provider(1 - my_id);
+    ot_sender_ = otp.RegisterSendXCOTBit(num_bits);
+    ot_receiver_ = otp.RegisterReceiveXCOTBit(num_bits);
+  }
+}
+
+BooleanBEAVYCircuitGate::~BooleanBEAVYCircuitGate() = default;
+
+void BooleanBEAVYCircuitGate::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYCircuitGate::evaluate_setup start", gate_id_));
+    }
+  }
+
+  secret_shares_.resize(algo_.n_wires_);
+  for (std::size_t wire_i = 0; wire_i < inputs_.size(); ++wire_i) {
+    const auto& wire = inputs_[wire_i];
+    wire->wait_setup();
+    secret_shares_[wire_i] = wire->get_secret_share();
+  }
+
+  // the secret shares do not depend on the layers
+  const auto is_my_job = beavy_provider_.is_my_job(gate_id_);
+  for (const auto& op : algo_.gates_) {
+    switch (op.type_) {
+      case ENCRYPTO::PrimitiveOperationType::XOR:
+        secret_shares_[op.output_wire_] =
+            secret_shares_[op.parent_a_] ^ secret_shares_[*op.parent_b_];
+        break;
+      case ENCRYPTO::PrimitiveOperationType::INV:
+        secret_shares_[op.output_wire_] =
+            is_my_job ? ~secret_shares_[op.parent_a_] : secret_shares_[op.parent_a_];
+        break;
+      case ENCRYPTO::PrimitiveOperationType::AND:
+        secret_shares_[op.output_wire_] = ENCRYPTO::BitVector<>::Random(num_simd_);
+        break;
+      default:
+        throw std::logic_error("BooleanBEAVYCircuitGate: unexpected operation");
+    }
+  }
+
+  const auto first_output_wire = algo_.n_wires_ - algo_.n_output_wires_;
+  for (std::size_t wire_i = 0; wire_i < outputs_.size(); ++wire_i) {
+    auto& wire_o = outputs_[wire_i];
+    wire_o->get_secret_share() = secret_shares_[first_output_wire + wire_i];
+    wire_o->set_setup_ready();
+  }
+
+  // compute the shares of delta_a * delta_b for all AND gates at once
+  const auto num_bits = circuit_layers_.n_and_gates_ * num_simd_;
+  if (num_bits > 0) {
+    const auto num_bytes = Helpers::Convert::BitsToBytes(num_bits);
+    ENCRYPTO::BitVector<> delta_a_share;
+    ENCRYPTO::BitVector<> delta_b_share;
+    delta_a_share.Reserve(num_bytes);
+    delta_b_share.Reserve(num_bytes);
+    Delta_y_share_.Reserve(num_bytes);
+    for (const auto& layer : circuit_layers_.layers_) {
+      for (auto gate_i : layer.and_gates_) {
+        const auto& op = algo_.gates_[gate_i];
+        delta_a_share.Append(secret_shares_[op.parent_a_]);
+        delta_b_share.Append(secret_shares_[*op.parent_b_]);
+        Delta_y_share_.Append(secret_shares_[op.output_wire_]);
+      }
+    }
+    auto delta_ab_share = delta_a_share & delta_b_share;
+    ot_receiver_->SetChoices(std::move(delta_a_share));
+    ot_receiver_->SendCorrections();
+    ot_sender_->SetCorrelations(std::move(delta_b_share));
+    ot_sender_->SendMessages();
+    ot_receiver_->ComputeOutputs();
+    ot_sender_->ComputeOutputs();
+    delta_ab_share ^= ot_sender_->GetOutputs();
+    delta_ab_share ^= ot_receiver_->GetOutputs();
+    Delta_y_share_ ^= delta_ab_share;
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYCircuitGate::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYCircuitGate::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYCircuitGate::evaluate_online start", gate_id_));
+    }
+  }
+
+  // public shares of all wires of the circuit
+  std::vector<ENCRYPTO::BitVector<>> public_shares(algo_.n_wires_);
+  for (std::size_t wire_i = 0; wire_i < inputs_.size(); ++wire_i) {
+    const auto& wire = inputs_[wire_i];
+    wire->wait_online();
+    public_shares[wire_i] = wire->get_public_share();
+  }
+
+  const auto is_my_job = beavy_provider_.is_my_job(gate_id_);
+  std::size_t and_offset = 0;
+  for (std::size_t layer_i = 0; layer_i < circuit_layers_.layers_.size(); ++layer_i) {
+    const auto& layer = circuit_layers_.layers_[layer_i];
+    for (auto gate_i : layer.linear_gates_) {
+      const auto& op = algo_.gates_[gate_i];
+      if (op.type_ == ENCRYPTO::PrimitiveOperationType::XOR) {
+        public_shares[op.output_wire_] = public_shares[op.parent_a_] ^ public_shares[*op.parent_b_];
+      } else {
+        // INV only changes the secret share
+        public_shares[op.output_wire_] = public_shares[op.parent_a_];
+      }
+    }
+    if (layer.and_gates_.empty()) {
+      continue;
+    }
+
+    // evaluate all AND gates of this layer at once
+    const auto num_bits = layer.and_gates_.size() * num_simd_;
+    const auto num_bytes = Helpers::Convert::BitsToBytes(num_bits);
+    ENCRYPTO::BitVector<> Delta_a;
+    ENCRYPTO::BitVector<> Delta_b;
+    ENCRYPTO::BitVector<> delta_a_share;
+    ENCRYPTO::BitVector<> delta_b_share;
+    Delta_a.Reserve(num_bytes);
+    Delta_b.Reserve(num_bytes);
+    delta_a_share.Reserve(num_bytes);
+    delta_b_share.Reserve(num_bytes);
+    for (auto gate_i : layer.and_gates_) {
+      const auto& op = algo_.gates_[gate_i];
+      Delta_a.Append(public_shares[op.parent_a_]);
+      Delta_b.Append(public_shares[*op.parent_b_]);
+      delta_a_share.Append(secret_shares_[op.parent_a_]);
+      delta_b_share.Append(secret_shares_[*op.parent_b_]);
+    }
+    auto Delta_y_share = Delta_y_share_.Subset(and_offset, and_offset + num_bits);
+    and_offset += num_bits;
+    Delta_y_share ^= (Delta_a & delta_b_share);
+    Delta_y_share ^= (Delta_b & delta_a_share);
+    if (is_my_job) {
+      Delta_y_share ^= (Delta_a & Delta_b);
+    }
+    beavy_provider_.broadcast_bits_message(gate_id_, Delta_y_share, layer_i);
+    Delta_y_share ^= share_futures_[layer_i].get();
+    for (std::size_t and_i = 0; and_i < layer.and_gates_.size(); ++and_i) {
+      const auto& op = algo_.gates_[layer.and_gates_[and_i]];
+      public_shares[op.output_wire_] =
+          Delta_y_share.Subset(and_i * num_simd_, (and_i + 1) * num_simd_);
+    }
+  }
+
+  const auto first_output_wire = algo_.n_wires_ - algo_.n_output_wires_;
+  for (std::size_t wire_i = 0; wire_i < outputs_.size(); ++wire_i) {
+    auto& wire_o = outputs_[wire_i];
+    wire_o->get_public_share() = std::move(public_shares[first_output_wire + wire_i]);
+    wire_o->set_online_ready();
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYCircuitGate::evaluate_online end", gate_id_));
+    }
+  }
+}
+
 template <typename T>
 ArithmeticBEAVYInputGateSender<T>::ArithmeticBEAVYInputGateSender(
     std::size_t gate_id, BEAVYProvider& beavy_provider, std::size_t num_simd,
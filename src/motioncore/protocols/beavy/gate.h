@@ -30,6 +30,11 @@
 #include "utility/type_traits.hpp"
 #include "wire.h"
 
+namespace ENCRYPTO {
+struct AlgorithmDescription;
+struct CircuitLayers;
+}  // namespace ENCRYPTO
+
 namespace ENCRYPTO::ObliviousTransfer {
 class XCOTBitSender;
 class XCOTBitReceiver;
@@ -184,6 +189,39 @@ class BooleanBEAVYANDGate : public detail::BasicBooleanBEAVYBinaryGate {
   std::unique_ptr<ENCRYPTO::ObliviousTransfer::XCOTBitReceiver> ot_receiver_;
 };
 
+// Evaluates a whole Boolean circuit of XOR, INV and AND gates.  The setup of
+// all AND gates is done with one batch of OTs, and the online phase processes
+// the AND gates layer by layer (see ENCRYPTO::CircuitLayers), so that the
+// circuit needs one message per layer instead of one per AND gate.
+class BooleanBEAVYCircuitGate : public NewGate {
+ public:
+  BooleanBEAVYCircuitGate(std::size_t gate_id, BEAVYProvider&,
+                          const ENCRYPTO::AlgorithmDescription&, const ENCRYPTO::CircuitLayers&,
+                          BooleanBEAVYWireVector&&);
+  ~BooleanBEAVYCircuitGate();
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override;
+  void evaluate_online() override;
+  BooleanBEAVYWireVector& get_output_wires() noexcept { return outputs_; }
+
+ private:
+  BEAVYProvider& beavy_provider_;
+  const ENCRYPTO::AlgorithmDescription& algo_;
+  const ENCRYPTO::CircuitLayers& circuit_layers_;
+  std::size_t num_simd_;
+  const BooleanBEAVYWireVector inputs_;
+  BooleanBEAVYWireVector outputs_;
+  // secret shares of all wires of the circuit
+  std::vector<ENCRYPTO::BitVector<>> secret_shares_;
+  // shares of Delta_y for all AND gates in the order of the layers
+  ENCRYPTO::BitVector<> Delta_y_share_;
+  // one future per layer, invalid for layers without AND gates
+  std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>> share_futures_;
+  std::unique_ptr<ENCRYPTO::ObliviousTransfer::XCOTBitSender> ot_sender_;
+  std::unique_ptr<ENCRYPTO::ObliviousTransfer::XCOTBitReceiver> ot_receiver_;
+};
+
 template <typename T>
 class ArithmeticBEAVYInputGateSender : public NewGate {
  public:
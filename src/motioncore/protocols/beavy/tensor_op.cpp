@@ -23,13 +23,13 @@
 #include "tensor_op.h"
 
 #include <stdlib.h>
+#include <cassert>
 #include <fstream>
 #include <iostream>
 #include <parallel/algorithm>
 #include <stdexcept>
 
 #include "algorithm/circuit_loader.h"
-#include "algorithm/make_circuit.h"
 #include "beavy_provider.h"
 #include "crypto/arithmetic_provider.h"
 #include "crypto/motion_base_provider.h"
@@ -49,6 +49,56 @@
 
 namespace MOTION::proto::beavy {
 
+namespace {
+
+// Computes [delta_a * delta_b]_i from a precomputed triple (a, b, c) like the
+// GMW tensor gates do: d = delta_a - a and e = delta_b - b are opened, then
+//   [delta_a * delta_b]_i = [c]_i - d * e + [delta_a]_i * e + d * [delta_b]_i,
+// where d * e is only added by one party.
+template <typename T, typename ProductF>
+void compute_product_share_from_triple(BEAVYProvider& beavy_provider, std::size_t gate_id,
+                                       LinAlgTripleProvider::LinAlgTriple<T>&& triple,
+                                       const std::vector<T>& delta_a_share,
+                                       const std::vector<T>& delta_b_share,
+                                       ENCRYPTO::ReusableFiberFuture<std::vector<T>>& de_future,
+                                       ProductF product, std::vector<T>& result) {
+  const auto size_a = delta_a_share.size();
+  assert(triple.a_.size() == size_a);
+  assert(triple.b_.size() == delta_b_share.size());
+
+  // mask [delta_a]_i and [delta_b]_i
+  std::vector<T> de(size_a + delta_b_share.size());
+  auto it = __gnu_parallel::transform(std::begin(delta_a_share), std::end(delta_a_share),
+                                      std::begin(triple.a_), std::begin(de), std::minus{});
+  __gnu_parallel::transform(std::begin(delta_b_share), std::end(delta_b_share),
+                            std::begin(triple.b_), it, std::minus{});
+  beavy_provider.send_ints_message(1 - beavy_provider.get_my_id(), gate_id, de, 1);
+
+  // compute d, e
+  const auto other_share = de_future.get();
+  __gnu_parallel::transform(std::begin(de), std::end(de), std::begin(other_share), std::begin(de),
+                            std::plus{});
+
+  // result = c ...
+  result = std::move(triple.c_);
+  std::vector<T> tmp(result.size());
+  // ... - d * e ...
+  if (beavy_provider.is_my_job(gate_id)) {
+    product(de.data(), de.data() + size_a, tmp.data());
+    __gnu_parallel::transform(std::begin(result), std::end(result), std::begin(tmp),
+                              std::begin(result), std::minus{});
+  }
+  // ... + [delta_a]_i * e + d * [delta_b]_i
+  product(delta_a_share.data(), de.data() + size_a, tmp.data());
+  __gnu_parallel::transform(std::begin(result), std::end(result), std::begin(tmp),
+                            std::begin(result), std::plus{});
+  product(de.data(), delta_b_share.data(), tmp.data());
+  __gnu_parallel::transform(std::begin(result), std::end(result), std::begin(tmp),
+                            std::begin(result), std::plus{});
+}
+
+}  // namespace
+
 template <typename T>
 ArithmeticBEAVYTensorInputSender<T>::ArithmeticBEAVYTensorInputSender(
     std::size_t gate_id, BEAVYProvider& beavy_provider, const tensor::TensorDimensions& dimensions,
@@ -607,9 +657,15 @@ ArithmeticBEAVYTensorConv2D<T>::ArithmeticBEAVYTensorConv2D(
       output_(std::make_shared<ArithmeticBEAVYTensor<T>>(conv_op.get_output_tensor_dims())) {
   const auto my_id = beavy_provider_.get_my_id();
   const auto output_size = conv_op_.compute_output_size();
-  share_future_ = beavy_provider_.register_for_ints_message<T>(1 - my_id, gate_id_, output_size);
+  share_future_ =
+      beavy_provider_.register_for_ints_message_view<T>(1 - my_id, gate_id_, output_size);
   auto& ap = beavy_provider_.get_arith_manager().get_provider(1 - my_id);
-  if (!beavy_provider_.get_fake_setup()) {
+  linalg_triple_provider_ = beavy_provider_.get_linalg_triple_provider();
+  if (linalg_triple_provider_ != nullptr) {
+    triple_index_ = linalg_triple_provider_->register_for_conv2d_triple<T>(conv_op);
+    de_future_ = beavy_provider_.register_for_ints_message<T>(
+        1 - my_id, gate_id_, conv_op.compute_input_size() + conv_op.compute_kernel_size(), 1);
+  } else if (!beavy_provider_.get_fake_setup()) {
     conv_input_side_ = ap.template register_convolution_input_side<T>(conv_op);
     conv_kernel_side_ = ap.template register_convolution_kernel_side<T>(conv_op);
   }
@@ -648,14 +704,22 @@ void ArithmeticBEAVYTensorConv2D<T>::evaluate_setup() {
   const auto& delta_b_share = kernel_->get_secret_share();
   const auto& delta_y_share = output_->get_secret_share();
 
-  if (!beavy_provider_.get_fake_setup()) {
-    conv_input_side_->set_input(delta_a_share);
-    conv_kernel_side_->set_input(delta_b_share);
+  if (linalg_triple_provider_ != nullptr) {
+    // [Delta_y]_i = [delta_a * delta_b]_i
+    auto triple = linalg_triple_provider_->get_conv2d_triple<T>(conv_op_, triple_index_);
+    compute_product_share_from_triple(
+        beavy_provider_, gate_id_, std::move(triple), delta_a_share, delta_b_share, de_future_,
+        [this](const T* x, const T* y, T* out) { convolution(conv_op_, x, y, out); },
+        Delta_y_share_);
+  } else {
+    if (!beavy_provider_.get_fake_setup()) {
+      conv_input_side_->set_input(delta_a_share);
+      conv_kernel_side_->set_input(delta_b_share);
+    }
+    // [Delta_y]_i = [delta_a]_i * [delta_b]_i
+    convolution(conv_op_, delta_a_share.data(), delta_b_share.data(), Delta_y_share_.data());
   }
 
-  // [Delta_y]_i = [delta_a]_i * [delta_b]_i
-  convolution(conv_op_, delta_a_share.data(), delta_b_share.data(), Delta_y_share_.data());
-
   if (fractional_bits_ == 0) {
     // [Delta_y]_i += [delta_y]_i
     __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
@@ -663,27 +727,29 @@ void ArithmeticBEAVYTensorConv2D<T>::evaluate_setup() {
     // NB: happens after truncation if that is requested
   }
 
-  if (!beavy_provider_.get_fake_setup()) {
-    conv_input_side_->compute_output();
-    conv_kernel_side_->compute_output();
-  }
-  std::vector<T> delta_ab_share1;
-  std::vector<T> delta_ab_share2;
-  if (beavy_provider_.get_fake_setup()) {
-    delta_ab_share1 = Helpers::RandomVector<T>(conv_op_.compute_output_size());
-    delta_ab_share2 = Helpers::RandomVector<T>(conv_op_.compute_output_size());
-  } else {
-    // [[delta_a]_i * [delta_b]_(1-i)]_i
-    delta_ab_share1 = conv_input_side_->get_output();
-    // [[delta_b]_i * [delta_a]_(1-i)]_i
-    delta_ab_share2 = conv_kernel_side_->get_output();
+  if (linalg_triple_provider_ == nullptr) {
+    if (!beavy_provider_.get_fake_setup()) {
+      conv_input_side_->compute_output();
+      conv_kernel_side_->compute_output();
+    }
+    std::vector<T> delta_ab_share1;
+    std::vector<T> delta_ab_share2;
+    if (beavy_provider_.get_fake_setup()) {
+      delta_ab_share1 = Helpers::RandomVector<T>(conv_op_.compute_output_size());
+      delta_ab_share2 = Helpers::RandomVector<T>(conv_op_.compute_output_size());
+    } else {
+      // [[delta_a]_i * [delta_b]_(1-i)]_i
+      delta_ab_share1 = conv_input_side_->get_output();
+      // [[delta_b]_i * [delta_a]_(1-i)]_i
+      delta_ab_share2 = conv_kernel_side_->get_output();
+    }
+    // [Delta_y]_i += [[delta_a]_i * [delta_b]_(1-i)]_i
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(delta_ab_share1), std::begin(Delta_y_share_), std::plus{});
+    // [Delta_y]_i += [[delta_b]_i * [delta_a]_(1-i)]_i
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(delta_ab_share2), std::begin(Delta_y_share_), std::plus{});
   }
-  // [Delta_y]_i += [[delta_a]_i * [delta_b]_(1-i)]_i
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(delta_ab_share1), std::begin(Delta_y_share_), std::plus{});
-  // [Delta_y]_i += [[delta_b]_i * [delta_a]_(1-i)]_i
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(delta_ab_share2), std::begin(Delta_y_share_), std::plus{});
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
     auto logger = beavy_provider_.get_logger();
@@ -745,9 +811,12 @@ void ArithmeticBEAVYTensorConv2D<T>::evaluate_online() {
   // broadcast [Delta_y]_i
   beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
   // Delta_y = [Delta_y]_i + [Delta_y]_(1-i)
+  const auto other_share = share_future_.get();
+  assert(other_share.template size_as<T>() == Delta_y_share_.size());
+  std::vector<T> other_share_buffer;
   __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(share_future_.get()), std::begin(Delta_y_share_),
-                            std::plus{});
+                            other_share.data_as(other_share_buffer),
+                            std::begin(Delta_y_share_), std::plus{});
   output_->get_public_share() = std::move(Delta_y_share_);
   output_->set_online_ready();
 
@@ -779,12 +848,18 @@ ArithmeticBEAVYTensorGemm<T>::ArithmeticBEAVYTensorGemm(std::size_t gate_id,
       output_(std::make_shared<ArithmeticBEAVYTensor<T>>(gemm_op.get_output_tensor_dims())) {
   const auto my_id = beavy_provider_.get_my_id();
   const auto output_size = gemm_op_.compute_output_size();
-  share_future_ = beavy_provider_.register_for_ints_message<T>(1 - my_id, gate_id_, output_size);
+  share_future_ =
+      beavy_provider_.register_for_ints_message_view<T>(1 - my_id, gate_id_, output_size);
   auto& ap = beavy_provider_.get_arith_manager().get_provider(1 - my_id);
   const auto dim_l = gemm_op_.input_A_shape_[0];
   const auto dim_m = gemm_op_.input_A_shape_[1];
   const auto dim_n = gemm_op_.input_B_shape_[1];
-  if (!beavy_provider_.get_fake_setup()) {
+  linalg_triple_provider_ = beavy_provider_.get_linalg_triple_provider();
+  if (linalg_triple_provider_ != nullptr) {
+    triple_index_ = linalg_triple_provider_->register_for_gemm_triple<T>(gemm_op);
+    de_future_ = beavy_provider_.register_for_ints_message<T>(
+        1 - my_id, gate_id_, gemm_op.compute_input_A_size() + gemm_op.compute_input_B_size(), 1);
+  } else if (!beavy_provider_.get_fake_setup()) {
     mm_lhs_side_ = ap.template register_matrix_multiplication_lhs<T>(dim_l, dim_m, dim_n);
     mm_rhs_side_ = ap.template register_matrix_multiplication_rhs<T>(dim_l, dim_m, dim_n);
   }
@@ -823,14 +898,22 @@ void ArithmeticBEAVYTensorGemm<T>::evaluate_setup() {
   const auto& delta_b_share = input_B_->get_secret_share();
   const auto& delta_y_share = output_->get_secret_share();
 
-  if (!beavy_provider_.get_fake_setup()) {
-    mm_lhs_side_->set_input(delta_a_share);
-    mm_rhs_side_->set_input(delta_b_share);
+  if (linalg_triple_provider_ != nullptr) {
+    // [Delta_y]_i = [delta_a * delta_b]_i
+    auto triple = linalg_triple_provider_->get_gemm_triple<T>(gemm_op_, triple_index_);
+    compute_product_share_from_triple(
+        beavy_provider_, gate_id_, std::move(triple), delta_a_share, delta_b_share, de_future_,
+        [this](const T* x, const T* y, T* out) { matrix_multiply(gemm_op_, x, y, out); },
+        Delta_y_share_);
+  } else {
+    if (!beavy_provider_.get_fake_setup()) {
+      mm_lhs_side_->set_input(delta_a_share);
+      mm_rhs_side_->set_input(delta_b_share);
+    }
+    // [Delta_y]_i = [delta_a]_i * [delta_b]_i
+    matrix_multiply(gemm_op_, delta_a_share.data(), delta_b_share.data(), Delta_y_share_.data());
   }
 
-  // [Delta_y]_i = [delta_a]_i * [delta_b]_i
-  matrix_multiply(gemm_op_, delta_a_share.data(), delta_b_share.data(), Delta_y_share_.data());
-
   if (fractional_bits_ == 0) {
     // [Delta_y]_i += [delta_y]_i
     __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
@@ -838,27 +921,29 @@ void ArithmeticBEAVYTensorGemm<T>::evaluate_setup() {
     // NB: happens after truncation if that is requested
   }
 
-  if (!beavy_provider_.get_fake_setup()) {
-    mm_lhs_side_->compute_output();
-    mm_rhs_side_->compute_output();
-  }
-  std::vector<T> delta_ab_share1;
-  std::vector<T> delta_ab_share2;
-  if (beavy_provider_.get_fake_setup()) {
-    delta_ab_share1 = Helpers::RandomVector<T>(gemm_op_.compute_output_size());
-    delta_ab_share2 = Helpers::RandomVector<T>(gemm_op_.compute_output_size());
-  } else {
-    // [[delta_a]_i * [delta_b]_(1-i)]_i
-    delta_ab_share1 = mm_lhs_side_->get_output();
-    // [[delta_b]_i * [delta_a]_(1-i)]_i
-    delta_ab_share2 = mm_rhs_side_->get_output();
+  if (linalg_triple_provider_ == nullptr) {
+    if (!beavy_provider_.get_fake_setup()) {
+      mm_lhs_side_->compute_output();
+      mm_rhs_side_->compute_output();
+    }
+    std::vector<T> delta_ab_share1;
+    std::vector<T> delta_ab_share2;
+    if (beavy_provider_.get_fake_setup()) {
+      delta_ab_share1 = Helpers::RandomVector<T>(gemm_op_.compute_output_size());
+      delta_ab_share2 = Helpers::RandomVector<T>(gemm_op_.compute_output_size());
+    } else {
+      // [[delta_a]_i * [delta_b]_(1-i)]_i
+      delta_ab_share1 = mm_lhs_side_->get_output();
+      // [[delta_b]_i * [delta_a]_(1-i)]_i
+      delta_ab_share2 = mm_rhs_side_->get_output();
+    }
+    // [Delta_y]_i += [[delta_a]_i * [delta_b]_(1-i)]_i
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(delta_ab_share1), std::begin(Delta_y_share_), std::plus{});
+    // [Delta_y]_i += [[delta_b]_i * [delta_a]_(1-i)]_i
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(delta_ab_share2), std::begin(Delta_y_share_), std::plus{});
   }
-  // [Delta_y]_i += [[delta_a]_i * [delta_b]_(1-i)]_i
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(delta_ab_share1), std::begin(Delta_y_share_), std::plus{});
-  // [Delta_y]_i += [[delta_b]_i * [delta_a]_(1-i)]_i
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(delta_ab_share2), std::begin(Delta_y_share_), std::plus{});
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
     auto logger = beavy_provider_.get_logger();
@@ -920,9 +1005,12 @@ void ArithmeticBEAVYTensorGemm<T>::evaluate_online() {
   // broadcast [Delta_y]_i
   beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
   // Delta_y = [Delta_y]_i + [Delta_y]_(1-i)
+  const auto other_share = share_future_.get();
+  assert(other_share.template size_as<T>() == Delta_y_share_.size());
+  std::vector<T> other_share_buffer;
   __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(share_future_.get()), std::begin(Delta_y_share_),
-                            std::plus{});
+                            other_share.data_as(other_share_buffer),
+                            std::begin(Delta_y_share_), std::plus{});
   output_->get_public_share() = std::move(Delta_y_share_);
   output_->set_online_ready();
 
@@ -938,6 +1026,358 @@ void ArithmeticBEAVYTensorGemm<T>::evaluate_online() {
 template class ArithmeticBEAVYTensorGemm<std::uint32_t>;
 template class ArithmeticBEAVYTensorGemm<std::uint64_t>;
 
+template <typename T>
+ArithmeticBEAVYTensorPublicGemm<T>::ArithmeticBEAVYTensorPublicGemm(
+    std::size_t gate_id, BEAVYProvider& beavy_provider, tensor::GemmOp gemm_op,
+    std::vector<T>&& input_A, const ArithmeticBEAVYTensorCP<T> input_B,
+    std::size_t fractional_bits)
+    : NewGate(gate_id),
+      beavy_provider_(beavy_provider),
+      gemm_op_(gemm_op),
+      fractional_bits_(fractional_bits),
+      input_A_(std::move(input_A)),
+      input_B_(input_B),
+      output_(std::make_shared<ArithmeticBEAVYTensor<T>>(gemm_op.get_output_tensor_dims())) {
+  const auto my_id = beavy_provider_.get_my_id();
+  const auto output_size = gemm_op_.compute_output_size();
+  // without truncation the output is computed locally
+  if (fractional_bits_ > 0) {
+    share_future_ =
+        beavy_provider_.register_for_ints_message_view<T>(1 - my_id, gate_id_, output_size);
+  }
+  Delta_y_share_.resize(output_size);
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorPublicGemm<T> created", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+ArithmeticBEAVYTensorPublicGemm<T>::~ArithmeticBEAVYTensorPublicGemm() = default;
+
+template <typename T>
+void ArithmeticBEAVYTensorPublicGemm<T>::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: ArithmeticBEAVYTensorPublicGemm<T>::evaluate_setup start", gate_id_));
+    }
+  }
+
+  const auto output_size = gemm_op_.compute_output_size();
+
+  input_B_->wait_setup();
+  const auto& delta_b_share = input_B_->get_secret_share();
+
+  if (fractional_bits_ == 0) {
+    // [delta_y]_i = A * [delta_b]_i
+    output_->get_secret_share().resize(output_size);
+    matrix_multiply(gemm_op_, input_A_.data(), delta_b_share.data(),
+                    output_->get_secret_share().data());
+    output_->set_setup_ready();
+  } else {
+    output_->get_secret_share() = Helpers::RandomVector<T>(output_size);
+    output_->set_setup_ready();
+    // [Delta_y]_i = -A * [delta_b]_i
+    matrix_multiply(gemm_op_, input_A_.data(), delta_b_share.data(), Delta_y_share_.data());
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(Delta_y_share_), std::negate{});
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: ArithmeticBEAVYTensorPublicGemm<T>::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+void ArithmeticBEAVYTensorPublicGemm<T>::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: ArithmeticBEAVYTensorPublicGemm<T>::evaluate_online start", gate_id_));
+    }
+  }
+
+  input_B_->wait_online();
+  const auto& Delta_b = input_B_->get_public_share();
+
+  if (fractional_bits_ == 0) {
+    // Delta_y = A * Delta_b
+    matrix_multiply(gemm_op_, input_A_.data(), Delta_b.data(), Delta_y_share_.data());
+  } else {
+    // after setup phase, `Delta_y_share_` contains -A * [delta_b]_i
+    if (beavy_provider_.is_my_job(gate_id_)) {
+      // [Delta_y]_i += A * Delta_b
+      std::vector<T> tmp(Delta_y_share_.size());
+      matrix_multiply(gemm_op_, input_A_.data(), Delta_b.data(), tmp.data());
+      __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                                std::begin(tmp), std::begin(Delta_y_share_), std::plus{});
+    }
+    fixed_point::truncate_shared<T>(Delta_y_share_.data(), fractional_bits_, Delta_y_share_.size(),
+                                    beavy_provider_.is_my_job(gate_id_));
+    // [Delta_y]_i += [delta_y]_i
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(output_->get_secret_share()), std::begin(Delta_y_share_),
+                              std::plus{});
+    // broadcast [Delta_y]_i
+    beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
+    // Delta_y = [Delta_y]_i + [Delta_y]_(1-i)
+    const auto other_share = share_future_.get();
+    assert(other_share.template size_as<T>() == Delta_y_share_.size());
+    std::vector<T> other_share_buffer;
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              other_share.data_as(other_share_buffer),
+                              std::begin(Delta_y_share_), std::plus{});
+  }
+  output_->get_public_share() = std::move(Delta_y_share_);
+  output_->set_online_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: ArithmeticBEAVYTensorPublicGemm<T>::evaluate_online end", gate_id_));
+    }
+  }
+}
+
+template class ArithmeticBEAVYTensorPublicGemm<std::uint32_t>;
+template class ArithmeticBEAVYTensorPublicGemm<std::uint64_t>;
+
+template <typename T>
+ArithmeticBEAVYTensorDense<T>::ArithmeticBEAVYTensorDense(
+    std::size_t gate_id, BEAVYProvider& beavy_provider, tensor::GemmOp gemm_op,
+    const ArithmeticBEAVYTensorCP<T> input_A, const ArithmeticBEAVYTensorCP<T> input_B,
+    const ArithmeticBEAVYTensorCP<T> bias, std::size_t fractional_bits, bool negate_output)
+    : NewGate(gate_id),
+      beavy_provider_(beavy_provider),
+      gemm_op_(gemm_op),
+      fractional_bits_(fractional_bits),
+      negate_output_(negate_output),
+      bias_broadcast_(bias->get_dimensions() != gemm_op.get_output_tensor_dims()),
+      input_A_(input_A),
+      input_B_(input_B),
+      bias_(bias),
+      output_(std::make_shared<ArithmeticBEAVYTensor<T>>(gemm_op.get_output_tensor_dims())) {
+  const auto my_id = beavy_provider_.get_my_id();
+  const auto output_size = gemm_op_.compute_output_size();
+  share_future_ =
+      beavy_provider_.register_for_ints_message_view<T>(1 - my_id, gate_id_, output_size);
+  auto& ap = beavy_provider_.get_arith_manager().get_provider(1 - my_id);
+  const auto dim_l = gemm_op_.input_A_shape_[0];
+  const auto dim_m = gemm_op_.input_A_shape_[1];
+  const auto dim_n = gemm_op_.input_B_shape_[1];
+  linalg_triple_provider_ = beavy_provider_.get_linalg_triple_provider();
+  if (linalg_triple_provider_ != nullptr) {
+    triple_index_ = linalg_triple_provider_->register_for_gemm_triple<T>(gemm_op);
+    de_future_ = beavy_provider_.register_for_ints_message<T>(
+        1 - my_id, gate_id_, gemm_op.compute_input_A_size() + gemm_op.compute_input_B_size(), 1);
+  } else if (!beavy_provider_.get_fake_setup()) {
+    mm_lhs_side_ = ap.template register_matrix_multiplication_lhs<T>(dim_l, dim_m, dim_n);
+    mm_rhs_side_ = ap.template register_matrix_multiplication_rhs<T>(dim_l, dim_m, dim_n);
+  }
+  Delta_y_share_.resize(output_size);
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: ArithmeticBEAVYTensorDense<T> created", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+ArithmeticBEAVYTensorDense<T>::~ArithmeticBEAVYTensorDense() = default;
+
+template <typename T>
+void ArithmeticBEAVYTensorDense<T>::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorDense<T>::evaluate_setup start", gate_id_));
+    }
+  }
+
+  const auto output_size = gemm_op_.compute_output_size();
+
+  output_->get_secret_share() = Helpers::RandomVector<T>(output_size);
+  output_->set_setup_ready();
+
+  input_A_->wait_setup();
+  input_B_->wait_setup();
+  bias_->wait_setup();
+
+  const auto& delta_a_share = input_A_->get_secret_share();
+  const auto& delta_b_share = input_B_->get_secret_share();
+  const auto& delta_bias_share = bias_->get_secret_share();
+  const auto& delta_y_share = output_->get_secret_share();
+
+  if (linalg_triple_provider_ != nullptr) {
+    // [Delta_y]_i = [delta_a * delta_b]_i
+    auto triple = linalg_triple_provider_->get_gemm_triple<T>(gemm_op_, triple_index_);
+    compute_product_share_from_triple(
+        beavy_provider_, gate_id_, std::move(triple), delta_a_share, delta_b_share, de_future_,
+        [this](const T* x, const T* y, T* out) { matrix_multiply(gemm_op_, x, y, out); },
+        Delta_y_share_);
+  } else {
+    if (!beavy_provider_.get_fake_setup()) {
+      mm_lhs_side_->set_input(delta_a_share);
+      mm_rhs_side_->set_input(delta_b_share);
+    }
+    // [Delta_y]_i = [delta_a]_i * [delta_b]_i
+    matrix_multiply(gemm_op_, delta_a_share.data(), delta_b_share.data(), Delta_y_share_.data());
+  }
+
+  // the cross terms, unless they are already contained in [Delta_y]_i
+  const bool add_cross_terms = linalg_triple_provider_ == nullptr;
+  std::vector<T> delta_ab_share1;
+  std::vector<T> delta_ab_share2;
+  if (add_cross_terms) {
+    if (!beavy_provider_.get_fake_setup()) {
+      mm_lhs_side_->compute_output();
+      mm_rhs_side_->compute_output();
+    }
+    if (beavy_provider_.get_fake_setup()) {
+      delta_ab_share1 = Helpers::RandomVector<T>(output_size);
+      delta_ab_share2 = Helpers::RandomVector<T>(output_size);
+    } else {
+      // [[delta_a]_i * [delta_b]_(1-i)]_i
+      delta_ab_share1 = mm_lhs_side_->get_output();
+      // [[delta_b]_i * [delta_a]_(1-i)]_i
+      delta_ab_share2 = mm_rhs_side_->get_output();
+    }
+  }
+
+  // Single pass over the output:
+  //   [Delta_y]_i = +/- ([delta_ab]_i - [delta_bias]_i * 2^f)  (+ [delta_y]_i if f == 0)
+  // The bias is scaled to the 2f fractional bits of the product, s.t. it is
+  // truncated together with it.
+  const auto fractional_bits = fractional_bits_;
+  const bool negate = negate_output_;
+#pragma omp parallel for
+  for (std::size_t i = 0; i < output_size; ++i) {
+    T v = Delta_y_share_[i] - T(delta_bias_share[bias_index(i)] << fractional_bits);
+    if (add_cross_terms) {
+      v += delta_ab_share1[i] + delta_ab_share2[i];
+    }
+    if (negate) {
+      v = -v;
+    }
+    if (fractional_bits == 0) {
+      // NB: happens after truncation if that is requested
+      v += delta_y_share[i];
+    }
+    Delta_y_share_[i] = v;
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorDense<T>::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+void ArithmeticBEAVYTensorDense<T>::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorDense<T>::evaluate_online start", gate_id_));
+    }
+  }
+
+  const auto output_size = gemm_op_.compute_output_size();
+  const auto input_B_size = gemm_op_.compute_input_B_size();
+  input_A_->wait_online();
+  input_B_->wait_online();
+  bias_->wait_online();
+  const auto& Delta_a = input_A_->get_public_share();
+  const auto& Delta_b = input_B_->get_public_share();
+  const auto& Delta_bias = bias_->get_public_share();
+  const auto& delta_a_share = input_A_->get_secret_share();
+  const auto& delta_b_share = input_B_->get_secret_share();
+  const bool my_job = beavy_provider_.is_my_job(gate_id_);
+
+  // after setup phase, `Delta_y_share_` contains +/- ([delta_ab]_i - [delta_bias]_i * 2^f)
+  // (+ [delta_y]_i if f == 0)
+
+  // Delta_a * Delta_b - Delta_a * [delta_b]_i == Delta_a * (Delta_b - [delta_b]_i), so two
+  // products suffice instead of three
+  std::vector<T> b_share(input_B_size);
+  if (my_job) {
+    __gnu_parallel::transform(std::begin(Delta_b), std::end(Delta_b), std::begin(delta_b_share),
+                              std::begin(b_share), std::minus{});
+  } else {
+    __gnu_parallel::transform(std::begin(delta_b_share), std::end(delta_b_share),
+                              std::begin(b_share), std::negate{});
+  }
+  std::vector<T> tmp1(output_size);
+  std::vector<T> tmp2(output_size);
+  // Delta_a * (Delta_b - [delta_b]_i)
+  matrix_multiply(gemm_op_, Delta_a.data(), b_share.data(), tmp1.data());
+  // [delta_a]_i * Delta_b
+  matrix_multiply(gemm_op_, delta_a_share.data(), Delta_b.data(), tmp2.data());
+
+  // [Delta_y]_i +/-= tmp1 - tmp2 (+ Delta_bias * 2^f)
+  const auto fractional_bits = fractional_bits_;
+  const bool negate = negate_output_;
+#pragma omp parallel for
+  for (std::size_t i = 0; i < output_size; ++i) {
+    T v = tmp1[i] - tmp2[i];
+    if (my_job) {
+      v += T(Delta_bias[bias_index(i)] << fractional_bits);
+    }
+    Delta_y_share_[i] = negate ? Delta_y_share_[i] - v : Delta_y_share_[i] + v;
+  }
+
+  if (fractional_bits_ > 0) {
+    fixed_point::truncate_shared<T>(Delta_y_share_.data(), fractional_bits_, Delta_y_share_.size(),
+                                    my_job);
+    // [Delta_y]_i += [delta_y]_i
+    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                              std::begin(output_->get_secret_share()), std::begin(Delta_y_share_),
+                              std::plus{});
+    // NB: happens in setup phase if no truncation is requested
+  }
+
+  // broadcast [Delta_y]_i
+  beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
+  // Delta_y = [Delta_y]_i + [Delta_y]_(1-i)
+  const auto other_share = share_future_.get();
+  assert(other_share.template size_as<T>() == Delta_y_share_.size());
+  std::vector<T> other_share_buffer;
+  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
+                            other_share.data_as(other_share_buffer),
+                            std::begin(Delta_y_share_), std::plus{});
+  output_->get_public_share() = std::move(Delta_y_share_);
+  output_->set_online_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorDense<T>::evaluate_online end", gate_id_));
+    }
+  }
+}
+
+template class ArithmeticBEAVYTensorDense<std::uint32_t>;
+template class ArithmeticBEAVYTensorDense<std::uint64_t>;
+
 // Implementation of tensor Join operation (addnl)
 template <typename T>
 ArithmeticBEAVYTensorJoin<T>::ArithmeticBEAVYTensorJoin(std::size_t gate_id,
@@ -1138,7 +1578,8 @@ ArithmeticBEAVYTensorMul<T>::ArithmeticBEAVYTensorMul(std::size_t gate_id,
   }
   const auto my_id = beavy_provider_.get_my_id();
   const auto data_size = input_A_->get_dimensions().get_data_size();
-  share_future_ = beavy_provider_.register_for_ints_message<T>(1 - my_id, gate_id_, data_size);
+  share_future_ =
+      beavy_provider_.register_for_ints_message_view<T>(1 - my_id, gate_id_, data_size);
   auto& ap = beavy_provider_.get_arith_manager().get_provider(1 - my_id);
   mult_sender_ = ap.template register_integer_multiplication_send<T>(data_size);
   mult_receiver_ = ap.template register_integer_multiplication_receive<T>(data_size);
@@ -1265,9 +1706,12 @@ void ArithmeticBEAVYTensorMul<T>::evaluate_online() {
   // broadcast [Delta_y]_i
   beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
   // Delta_y = [Delta_y]_i + [Delta_y]_(1-i)
+  const auto other_share = share_future_.get();
+  assert(other_share.template size_as<T>() == Delta_y_share_.size());
+  std::vector<T> other_share_buffer;
   __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                            std::begin(share_future_.get()), std::begin(Delta_y_share_),
-                            std::plus{});
+                            other_share.data_as(other_share_buffer),
+                            std::begin(Delta_y_share_), std::plus{});
   output_->get_public_share() = std::move(Delta_y_share_);
   output_->set_online_ready();
 
@@ -2370,8 +2814,8 @@ BooleanBEAVYTensorMaxPool::BooleanBEAVYTensorMaxPool(std::size_t gate_id,
     WireVector in(bit_size_ * kernel_size);
     std::transform(std::begin(input_wires_), std::end(input_wires_), std::begin(in),
                    [](auto w) { return std::dynamic_pointer_cast<BooleanBEAVYWire>(w); });
-    auto [gates, out] = construct_circuit(beavy_provider_, maxpool_algo_, in);
-    gates_ = std::move(gates);
+    auto [gate, out] = beavy_provider_.construct_circuit_gate(maxpool_algo_, in);
+    gates_.push_back(std::move(gate));
     assert(out.size() == bit_size_);
     output_wires_.resize(bit_size_);
     std::transform(std::begin(out), std::end(out), std::begin(output_wires_),
@@ -2469,7 +2913,7 @@ void BooleanBEAVYTensorMaxPool::evaluate_setup() {
   prepare_wires<true>(bit_size_, maxpool_op_, input_wires_, input_->get_secret_share());
 
   for (auto& gate : gates_) {
-    // should work since its a Boolean circuit consisting of AND, XOR, INV gates
+    // a single gate evaluating the circuit layer by layer
     gate->evaluate_setup();
   }
 
@@ -2538,7 +2982,7 @@ void BooleanBEAVYTensorMaxPool::evaluate_online() {
   prepare_wires<false>(bit_size_, maxpool_op_, input_wires_, input_->get_public_share());
 
   for (auto& gate : gates_) {
-    // should work since its a Boolean circuit consisting of AND, XOR, INV gates
+    // a single gate evaluating the circuit layer by layer
     gate->evaluate_online();
   }
 
@@ -2593,4 +3037,209 @@ void BooleanBEAVYTensorMaxPool::evaluate_online_with_context(ExecutionContext& e
   }
 }
 
+BooleanBEAVYTensorArgMax::BooleanBEAVYTensorArgMax(std::size_t gate_id,
+                                                   BEAVYProvider& beavy_provider,
+                                                   tensor::ArgMaxOp argmax_op,
+                                                   const BooleanBEAVYTensorCP input, bool with_max)
+    : NewGate(gate_id),
+      beavy_provider_(beavy_provider),
+      argmax_op_(argmax_op),
+      bit_size_(input->get_bit_size()),
+      input_(input),
+      index_(std::make_shared<BooleanBEAVYTensor>(argmax_op_.get_output_tensor_dims(), bit_size_)),
+      max_(with_max ? std::make_shared<BooleanBEAVYTensor>(argmax_op_.get_output_tensor_dims(),
+                                                           bit_size_)
+                    : nullptr),
+      // the depth of the tournament determines the number of rounds
+      argmax_algo_(beavy_provider_.get_circuit_loader().load_argmax_circuit(
+          bit_size_, argmax_op_.compute_num_candidates(), with_max, true)) {
+  if (!argmax_op_.verify()) {
+    throw std::invalid_argument("invalid ArgMaxOp");
+  }
+  if (input_->get_dimensions() != argmax_op_.get_input_tensor_dims()) {
+    throw std::invalid_argument("ArgMaxOp does not fit to the input dimensions");
+  }
+  const auto num_candidates = argmax_op_.compute_num_candidates();
+  const auto output_size = argmax_op_.compute_output_size();
+  input_wires_.resize(bit_size_ * num_candidates);
+  std::generate(std::begin(input_wires_), std::end(input_wires_), [output_size] {
+    auto w = std::make_shared<BooleanBEAVYWire>(output_size);
+    w->get_secret_share().Resize(output_size);
+    w->get_public_share().Resize(output_size);
+    return w;
+  });
+  {
+    WireVector in(bit_size_ * num_candidates);
+    std::transform(std::begin(input_wires_), std::end(input_wires_), std::begin(in),
+                   [](auto w) { return std::dynamic_pointer_cast<BooleanBEAVYWire>(w); });
+    auto [gate, out] = beavy_provider_.construct_circuit_gate(argmax_algo_, in);
+    gates_.push_back(std::move(gate));
+    assert(out.size() == (with_max ? 2 : 1) * bit_size_);
+    output_wires_.resize(out.size());
+    std::transform(std::begin(out), std::end(out), std::begin(output_wires_),
+                   [](auto w) { return std::dynamic_pointer_cast<BooleanBEAVYWire>(w); });
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: BooleanBEAVYTensorArgMax created", gate_id_));
+    }
+  }
+}
+
+// Candidate i of every output becomes the i-th input of the circuit, the
+// outputs are used as SIMD dimension.
+template <bool setup>
+void BooleanBEAVYTensorArgMax::prepare_input_wires() {
+  const auto num_candidates = argmax_op_.compute_num_candidates();
+  const auto output_size = argmax_op_.compute_output_size();
+  const auto& input_shares = setup ? input_->get_secret_share() : input_->get_public_share();
+#pragma omp parallel for
+  for (std::size_t bit_j = 0; bit_j < bit_size_; ++bit_j) {
+    const auto& in_share = input_shares[bit_j];
+    for (std::size_t candidate_i = 0; candidate_i < num_candidates; ++candidate_i) {
+      auto& wire = input_wires_[candidate_i * bit_size_ + bit_j];
+      auto& bv = setup ? wire->get_secret_share() : wire->get_public_share();
+      for (std::size_t output_k = 0; output_k < output_size; ++output_k) {
+        bv.Set(in_share.Get(argmax_op_.compute_input_index(output_k, candidate_i)), output_k);
+      }
+    }
+  }
+  for (auto& wire : input_wires_) {
+    if constexpr (setup) {
+      wire->set_setup_ready();
+    } else {
+      wire->set_online_ready();
+    }
+  }
+}
+
+// The circuit outputs the bits of the index followed by the bits of the max.
+template <bool setup>
+void BooleanBEAVYTensorArgMax::collect_output_shares() {
+  for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
+    auto& wire = output_wires_[wire_i];
+    auto& tensor = wire_i < bit_size_ ? index_ : max_;
+    const auto bit_j = wire_i % bit_size_;
+    if constexpr (setup) {
+      wire->wait_setup();
+      tensor->get_secret_share()[bit_j] = std::move(wire->get_secret_share());
+    } else {
+      wire->wait_online();
+      tensor->get_public_share()[bit_j] = std::move(wire->get_public_share());
+    }
+  }
+  for (auto& tensor : {index_, max_}) {
+    if (!tensor) {
+      continue;
+    }
+    if constexpr (setup) {
+      tensor->set_setup_ready();
+    } else {
+      tensor->set_online_ready();
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup start", gate_id_));
+    }
+  }
+
+  input_->wait_setup();
+  prepare_input_wires<true>();
+  for (auto& gate : gates_) {
+    gate->evaluate_setup();
+  }
+  collect_output_shares<true>();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_setup_with_context(ExecutionContext& exec_ctx) {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup_with_context start", gate_id_));
+    }
+  }
+
+  input_->wait_setup();
+  prepare_input_wires<true>();
+  for (auto& gate : gates_) {
+    exec_ctx.fpool_->post([&] { gate->evaluate_setup(); });
+  }
+  collect_output_shares<true>();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup_with_context end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_online start", gate_id_));
+    }
+  }
+
+  input_->wait_online();
+  prepare_input_wires<false>();
+  for (auto& gate : gates_) {
+    gate->evaluate_online();
+  }
+  collect_output_shares<false>();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_online end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_online_with_context(ExecutionContext& exec_ctx) {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_online_with_context start", gate_id_));
+    }
+  }
+
+  input_->wait_online();
+  prepare_input_wires<false>();
+  for (auto& gate : gates_) {
+    exec_ctx.fpool_->post([&] { gate->evaluate_online(); });
+  }
+  collect_output_shares<false>();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_online_with_context end", gate_id_));
+    }
+  }
+}
+
 }  // namespace MOTION::proto::beavy
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "communication/buffer_pool.h"
 #include "gate/new_gate.h"
 #include "tensor.h"
 #include "tensor/tensor_op.h"
@@ -61,6 +62,7 @@ template <typename T>
 class MatrixMultiplicationLHS;
 template <typename T>
 class MatrixMultiplicationRHS;
+class LinAlgTripleProvider;
 }  // namespace MOTION
 
 namespace MOTION::proto::beavy {
@@ -199,10 +201,14 @@ class ArithmeticBEAVYTensorConv2D : public NewGate {
   const ArithmeticBEAVYTensorCP<T> kernel_;
   const ArithmeticBEAVYTensorCP<T> bias_;
   std::shared_ptr<ArithmeticBEAVYTensor<T>> output_;
-  ENCRYPTO::ReusableFiberFuture<std::vector<T>> share_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> share_future_;
   std::vector<T> Delta_y_share_;
   std::unique_ptr<MOTION::ConvolutionInputSide<T>> conv_input_side_;
   std::unique_ptr<MOTION::ConvolutionKernelSide<T>> conv_kernel_side_;
+  // set if [delta_a * delta_b] is computed from a precomputed triple
+  LinAlgTripleProvider* linalg_triple_provider_ = nullptr;
+  std::size_t triple_index_ = 0;
+  ENCRYPTO::ReusableFiberFuture<std::vector<T>> de_future_;
 };
 
 template <typename T>
@@ -225,10 +231,88 @@ class ArithmeticBEAVYTensorGemm : public NewGate {
   const ArithmeticBEAVYTensorCP<T> input_A_;
   const ArithmeticBEAVYTensorCP<T> input_B_;
   std::shared_ptr<ArithmeticBEAVYTensor<T>> output_;
-  ENCRYPTO::ReusableFiberFuture<std::vector<T>> share_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> share_future_;
   std::vector<T> Delta_y_share_;
   std::unique_ptr<MOTION::MatrixMultiplicationRHS<T>> mm_rhs_side_;
   std::unique_ptr<MOTION::MatrixMultiplicationLHS<T>> mm_lhs_side_;
+  // set if [delta_a * delta_b] is computed from a precomputed triple
+  LinAlgTripleProvider* linalg_triple_provider_ = nullptr;
+  std::size_t triple_index_ = 0;
+  ENCRYPTO::ReusableFiberFuture<std::vector<T>> de_future_;
+};
+
+// Gemm with a public left operand A (e.g., a model known to both parties).  The
+// product is computed locally without multiplication triples; only the
+// truncation requires a broadcast of the new public share.
+template <typename T>
+class ArithmeticBEAVYTensorPublicGemm : public NewGate {
+ public:
+  ArithmeticBEAVYTensorPublicGemm(std::size_t gate_id, BEAVYProvider&, tensor::GemmOp,
+                                  std::vector<T>&& input_A,
+                                  const ArithmeticBEAVYTensorCP<T> input_B,
+                                  std::size_t fractional_bits);
+  ~ArithmeticBEAVYTensorPublicGemm();
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override;
+  void evaluate_online() override;
+  const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
+
+ private:
+  BEAVYProvider& beavy_provider_;
+  tensor::GemmOp gemm_op_;
+  std::size_t fractional_bits_;
+  const std::vector<T> input_A_;
+  const ArithmeticBEAVYTensorCP<T> input_B_;
+  std::shared_ptr<ArithmeticBEAVYTensor<T>> output_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> share_future_;
+  std::vector<T> Delta_y_share_;
+};
+
+// Dense layer y = A * B + bias (optionally negated) in a single gate.  The bias
+// is folded into [Delta_y]_i before the truncation, and the negation the ReLU
+// conversion expects is applied to the shares, s.t. the output can be fed to
+// the conversion without separate Add and Negate gates.  The bias has either
+// the output shape or one entry per row of the output, which is then added to
+// every column.
+template <typename T>
+class ArithmeticBEAVYTensorDense : public NewGate {
+ public:
+  ArithmeticBEAVYTensorDense(std::size_t gate_id, BEAVYProvider&, tensor::GemmOp,
+                             const ArithmeticBEAVYTensorCP<T> input_A,
+                             const ArithmeticBEAVYTensorCP<T> input_B,
+                             const ArithmeticBEAVYTensorCP<T> bias, std::size_t fractional_bits,
+                             bool negate_output);
+  ~ArithmeticBEAVYTensorDense();
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override;
+  void evaluate_online() override;
+  const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
+
+ private:
+  // returns the index into the bias for output element i
+  std::size_t bias_index(std::size_t i) const noexcept {
+    return bias_broadcast_ ? i / gemm_op_.output_shape_[1] : i;
+  }
+
+  BEAVYProvider& beavy_provider_;
+  tensor::GemmOp gemm_op_;
+  std::size_t fractional_bits_;
+  bool negate_output_;
+  bool bias_broadcast_;
+  const ArithmeticBEAVYTensorCP<T> input_A_;
+  const ArithmeticBEAVYTensorCP<T> input_B_;
+  const ArithmeticBEAVYTensorCP<T> bias_;
+  std::shared_ptr<ArithmeticBEAVYTensor<T>> output_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> share_future_;
+  std::vector<T> Delta_y_share_;
+  std::unique_ptr<MOTION::MatrixMultiplicationRHS<T>> mm_rhs_side_;
+  std::unique_ptr<MOTION::MatrixMultiplicationLHS<T>> mm_lhs_side_;
+  // set if [delta_a * delta_b] is computed from a precomputed triple
+  LinAlgTripleProvider* linalg_triple_provider_ = nullptr;
+  std::size_t triple_index_ = 0;
+  ENCRYPTO::ReusableFiberFuture<std::vector<T>> de_future_;
 };
 
 //Implementation of Tensor Join (addnl)
@@ -277,7 +361,7 @@ class ArithmeticBEAVYTensorMul : public NewGate {
   const ArithmeticBEAVYTensorCP<T> input_A_;
   const ArithmeticBEAVYTensorCP<T> input_B_;
   std::shared_ptr<ArithmeticBEAVYTensor<T>> output_;
-  ENCRYPTO::ReusableFiberFuture<std::vector<T>> share_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> share_future_;
   std::vector<T> Delta_y_share_;
   std::unique_ptr<MOTION::IntegerMultiplicationSender<T>> mult_sender_;
   std::unique_ptr<MOTION::IntegerMultiplicationReceiver<T>> mult_receiver_;
@@ -526,4 +610,36 @@ class BooleanBEAVYTensorMaxPool : public NewGate {
   std::vector<std::unique_ptr<NewGate>> gates_;
 };
 
+class BooleanBEAVYTensorArgMax : public NewGate {
+ public:
+  BooleanBEAVYTensorArgMax(std::size_t gate_id, BEAVYProvider&, tensor::ArgMaxOp argmax_op,
+                           const BooleanBEAVYTensorCP input, bool with_max);
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override;
+  void evaluate_setup_with_context(ExecutionContext&) override;
+  void evaluate_online() override;
+  void evaluate_online_with_context(ExecutionContext&) override;
+  const BooleanBEAVYTensorP& get_index_tensor() const { return index_; }
+  // nullptr if the maximum is not computed
+  const BooleanBEAVYTensorP& get_max_tensor() const { return max_; }
+
+ private:
+  template <bool setup>
+  void prepare_input_wires();
+  template <bool setup>
+  void collect_output_shares();
+
+  BEAVYProvider& beavy_provider_;
+  const tensor::ArgMaxOp argmax_op_;
+  const std::size_t bit_size_;
+  const BooleanBEAVYTensorCP input_;
+  const BooleanBEAVYTensorP index_;
+  const BooleanBEAVYTensorP max_;
+  const ENCRYPTO::AlgorithmDescription& argmax_algo_;
+  BooleanBEAVYWireVector input_wires_;
+  BooleanBEAVYWireVector output_wires_;
+  std::vector<std::unique_ptr<NewGate>> gates_;
+};
+
 }  // namespace MOTION::proto::beavy
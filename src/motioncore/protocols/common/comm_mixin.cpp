@@ -22,10 +22,15 @@
 
 #include "comm_mixin.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
-#include <unordered_map>
-
-#include <boost/functional/hash.hpp>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <variant>
 
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/comm_mixin_gate_message_generated.h"
@@ -34,64 +39,90 @@
 #include "utility/constants.h"
 #include "utility/logger.h"
 
-namespace {
-
-struct SizeTPairHash {
-  std::size_t operator()(const std::pair<std::size_t, std::size_t>& p) const {
-    std::size_t seed = 0;
-    boost::hash_combine(seed, p.first);
-    boost::hash_combine(seed, p.second);
-    return seed;
-  }
-};
-
-}  // namespace
-
 namespace MOTION::proto {
 
 struct CommMixin::GateMessageHandler : public Communication::MessageHandler {
   GateMessageHandler(std::size_t num_parties, Communication::MessageType gate_message_type,
+                     std::shared_ptr<Communication::BufferPool> buffer_pool,
                      std::shared_ptr<Logger> logger);
   void received_message(std::size_t, std::vector<std::uint8_t>&& raw_message) override;
+  // Fulfill the promise for a single gate message.  Returns true if the raw
+  // message has been moved into the promised value.  raw_message is null for
+  // messages which are part of a batch.
+  bool deliver_gate_message(std::size_t party_id,
+                            const Communication::CommMixinGateMessage& gate_message,
+                            std::vector<std::uint8_t>* raw_message);
 
-  enum class MsgValueType { bit, block, uint8, uint16, uint32, uint64 };
+  enum class MsgValueType { bit, block, uint8, uint16, uint32, uint64, payload };
 
   template <typename T>
   constexpr static CommMixin::GateMessageHandler::MsgValueType get_msg_value_type();
 
-  // KeyType = (gate_id, msg_num)
-  using KeyType = std::pair<std::size_t, std::size_t>;
-
-  // KeyType -> (size, type)
-  std::unordered_map<KeyType, std::pair<std::size_t, MsgValueType>, SizeTPairHash>
-      expected_messages_;
-
-  // [KeyType -> promise]
-  std::vector<std::unordered_map<KeyType, ENCRYPTO::ReusableFiberPromise<ENCRYPTO::BitVector<>>,
-                                 SizeTPairHash>>
-      bits_promises_;
-  std::vector<std::unordered_map<KeyType, ENCRYPTO::ReusableFiberPromise<ENCRYPTO::block128_vector>,
-                                 SizeTPairHash>>
-      blocks_promises_;
-  std::vector<std::unordered_map<KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<std::uint8_t>>,
-                                 SizeTPairHash>>
-      uint8_promises_;
-  std::vector<std::unordered_map<
-      KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<std::uint16_t>>, SizeTPairHash>>
-      uint16_promises_;
-  std::vector<std::unordered_map<
-      KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<std::uint32_t>>, SizeTPairHash>>
-      uint32_promises_;
-  std::vector<std::unordered_map<
-      KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<std::uint64_t>>, SizeTPairHash>>
-      uint64_promises_;
+  using PromiseType =
+      std::variant<std::monostate, ENCRYPTO::ReusableFiberPromise<ENCRYPTO::BitVector<>>,
+                   ENCRYPTO::ReusableFiberPromise<ENCRYPTO::block128_vector>,
+                   ENCRYPTO::ReusableFiberPromise<std::vector<std::uint8_t>>,
+                   ENCRYPTO::ReusableFiberPromise<std::vector<std::uint16_t>>,
+                   ENCRYPTO::ReusableFiberPromise<std::vector<std::uint32_t>>,
+                   ENCRYPTO::ReusableFiberPromise<std::vector<std::uint64_t>>,
+                   ENCRYPTO::ReusableFiberPromise<Communication::ReceivedPayload>>;
+
+  // A message expected for a gate with a promise for each party sending it.
+  // The messages of a gate with different msg_num form a list.
+  struct ExpectedMessage {
+    std::size_t msg_num_;
+    std::size_t size_;
+    MsgValueType type_;
+    std::vector<PromiseType> promises_;
+    ExpectedMessage* next_;
+  };
 
-  template <typename T>
-  std::vector<
-      std::unordered_map<KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<T>>, SizeTPairHash>>&
-  get_promise_map();
+  // Register the message (gate_id, msg_num).  Throws if it is already registered.
+  void expect_message(std::size_t gate_id, std::size_t msg_num, std::size_t size,
+                      MsgValueType type, std::vector<PromiseType>&& promises);
+  // Returns nullptr if the message has not been registered.
+  ExpectedMessage* find_expected_message(std::size_t gate_id, std::size_t msg_num) const;
+
+  // The expected messages are indexed by gate id in a table of fixed-size
+  // chunks, which is reached through a directory of chunks.  They are
+  // registered when the circuit is built, possibly while the receive thread is
+  // already delivering messages for other gates, so directories, chunks and
+  // list entries are published by atomic stores once they are initialized and
+  // the receive thread looks them up without locking.  The directory covers
+  // the range of registered gate ids, which starts after those of the previous
+  // circuits of a session, and it is replaced by a larger copy when a gate id
+  // outside of it is registered.  Replaced directories are kept until the
+  // handler is destroyed, s.t. concurrent lookups never see freed memory.
+  constexpr static std::size_t chunk_bits = 12;
+  constexpr static std::size_t chunk_size = std::size_t(1) << chunk_bits;
+  constexpr static std::size_t initial_num_chunks = 64;
+  using Chunk = std::array<std::atomic<ExpectedMessage*>, chunk_size>;
+  struct Directory {
+    Directory(std::size_t first_chunk, std::size_t num_chunks)
+        : first_chunk_(first_chunk),
+          num_chunks_(num_chunks),
+          chunks_(std::make_unique<std::atomic<Chunk*>[]>(num_chunks)) {}
+    bool contains(std::size_t chunk_index) const {
+      return chunk_index >= first_chunk_ && chunk_index - first_chunk_ < num_chunks_;
+    }
+    std::atomic<Chunk*>& get(std::size_t chunk_index) const {
+      return chunks_[chunk_index - first_chunk_];
+    }
+    std::size_t first_chunk_;
+    std::size_t num_chunks_;
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks_;
+  };
+  std::atomic<Directory*> directory_ = nullptr;
 
+  // storage of the table, only used when registering
+  std::mutex registration_mutex_;
+  std::vector<std::unique_ptr<Directory>> directory_storage_;
+  std::vector<std::unique_ptr<Chunk>> chunk_storage_;
+  std::deque<ExpectedMessage> expected_message_storage_;
+
+  std::size_t num_parties_;
   Communication::MessageType gate_message_type_;
+  std::shared_ptr<Communication::BufferPool> buffer_pool_;
   std::shared_ptr<Logger> logger_;
 };
 
@@ -109,47 +140,80 @@ CommMixin::GateMessageHandler::get_msg_value_type() {
   }
 }
 
-template <>
-std::vector<
-    std::unordered_map<CommMixin::GateMessageHandler::KeyType,
-                       ENCRYPTO::ReusableFiberPromise<std::vector<std::uint8_t>>, SizeTPairHash>>&
-CommMixin::GateMessageHandler::get_promise_map() {
-  return uint8_promises_;
-}
-template <>
-std::vector<
-    std::unordered_map<CommMixin::GateMessageHandler::KeyType,
-                       ENCRYPTO::ReusableFiberPromise<std::vector<std::uint16_t>>, SizeTPairHash>>&
-CommMixin::GateMessageHandler::get_promise_map() {
-  return uint16_promises_;
-}
-template <>
-std::vector<
-    std::unordered_map<CommMixin::GateMessageHandler::KeyType,
-                       ENCRYPTO::ReusableFiberPromise<std::vector<std::uint32_t>>, SizeTPairHash>>&
-CommMixin::GateMessageHandler::get_promise_map() {
-  return uint32_promises_;
-}
-template <>
-std::vector<
-    std::unordered_map<CommMixin::GateMessageHandler::KeyType,
-                       ENCRYPTO::ReusableFiberPromise<std::vector<std::uint64_t>>, SizeTPairHash>>&
-CommMixin::GateMessageHandler::get_promise_map() {
-  return uint64_promises_;
-}
-
-CommMixin::GateMessageHandler::GateMessageHandler(std::size_t num_parties,
-                                                  Communication::MessageType gate_message_type,
-                                                  std::shared_ptr<Logger> logger)
-    : bits_promises_(num_parties),
-      blocks_promises_(num_parties),
-      uint8_promises_(num_parties),
-      uint16_promises_(num_parties),
-      uint32_promises_(num_parties),
-      uint64_promises_(num_parties),
+CommMixin::GateMessageHandler::GateMessageHandler(
+    std::size_t num_parties, Communication::MessageType gate_message_type,
+    std::shared_ptr<Communication::BufferPool> buffer_pool, std::shared_ptr<Logger> logger)
+    : num_parties_(num_parties),
       gate_message_type_(gate_message_type),
+      buffer_pool_(std::move(buffer_pool)),
       logger_(logger) {}
 
+void CommMixin::GateMessageHandler::expect_message(std::size_t gate_id, std::size_t msg_num,
+                                                   std::size_t size, MsgValueType type,
+                                                   std::vector<PromiseType>&& promises) {
+  const auto chunk_index = gate_id >> chunk_bits;
+  std::scoped_lock lock(registration_mutex_);
+  auto* directory = directory_.load(std::memory_order_relaxed);
+  if (directory == nullptr || !directory->contains(chunk_index)) {
+    // copy the chunk pointers into a directory which also covers chunk_index
+    auto first_chunk = chunk_index;
+    auto num_chunks = initial_num_chunks;
+    if (directory != nullptr) {
+      first_chunk = std::min(chunk_index, directory->first_chunk_);
+      const auto end_chunk =
+          std::max(chunk_index + 1, directory->first_chunk_ + directory->num_chunks_);
+      num_chunks = std::max(end_chunk - first_chunk, 2 * directory->num_chunks_);
+    }
+    auto* new_directory = directory_storage_
+                              .emplace_back(std::make_unique<Directory>(first_chunk, num_chunks))
+                              .get();
+    if (directory != nullptr) {
+      for (std::size_t i = 0; i < directory->num_chunks_; ++i) {
+        const auto index = directory->first_chunk_ + i;
+        new_directory->get(index).store(directory->get(index).load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+      }
+    }
+    directory_.store(new_directory, std::memory_order_release);
+    directory = new_directory;
+  }
+  auto* chunk = directory->get(chunk_index).load(std::memory_order_relaxed);
+  if (chunk == nullptr) {
+    chunk = chunk_storage_.emplace_back(std::make_unique<Chunk>()).get();
+    directory->get(chunk_index).store(chunk, std::memory_order_release);
+  }
+  auto& head = (*chunk)[gate_id % chunk_size];
+  auto* first = head.load(std::memory_order_relaxed);
+  for (auto* msg = first; msg != nullptr; msg = msg->next_) {
+    if (msg->msg_num_ == msg_num) {
+      throw std::logic_error(
+          fmt::format("tried to register twice for message {} for gate {}", msg_num, gate_id));
+    }
+  }
+  auto& expected_message = expected_message_storage_.emplace_back(
+      ExpectedMessage{msg_num, size, type, std::move(promises), first});
+  head.store(&expected_message, std::memory_order_release);
+}
+
+CommMixin::GateMessageHandler::ExpectedMessage*
+CommMixin::GateMessageHandler::find_expected_message(std::size_t gate_id,
+                                                     std::size_t msg_num) const {
+  const auto chunk_index = gate_id >> chunk_bits;
+  const auto* directory = directory_.load(std::memory_order_acquire);
+  if (directory == nullptr || !directory->contains(chunk_index)) {
+    return nullptr;
+  }
+  const auto* chunk = directory->get(chunk_index).load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  auto* msg = (*chunk)[gate_id % chunk_size].load(std::memory_order_acquire);
+  while (msg != nullptr && msg->msg_num_ != msg_num) {
+    msg = msg->next_;
+  }
+  return msg;
+}
+
 void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
                                                      std::vector<std::uint8_t>&& raw_message) {
   assert(!raw_message.empty());
@@ -179,20 +243,46 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
       // TODO: log and drop instead
     }
   }
-  auto gate_id = gate_message->gate_id();
-  auto msg_num = gate_message->msg_num();
-  auto payload = gate_message->payload();
-  auto it = expected_messages_.find({gate_id, msg_num});
-  if (it == expected_messages_.end()) {
-    logger_->LogError(fmt::format("received unexpected {} for gate {}, dropping",
-                                  EnumNameMessageType(gate_message_type_), gate_id));
+  if (auto batch = gate_message->batch(); batch != nullptr) {
+    // coalesced messages, see CommMixin::MessageCoalescer
+    for (flatbuffers::uoffset_t i = 0; i < batch->size(); ++i) {
+      deliver_gate_message(party_id, *batch->Get(i), nullptr);
+    }
+  } else if (deliver_gate_message(party_id, *gate_message, &raw_message)) {
+    // the buffer has been handed over together with the payload
     return;
   }
-  auto expected_size = it->second.first;
-  auto type = it->second.second;
 
-  auto set_value_helper = [this, party_id, gate_id, msg_num, expected_size, payload](
-                              auto& map_vec, auto type_tag) {
+  // the payload has been copied, so the buffer can be reused for the next message
+  if (buffer_pool_) {
+    buffer_pool_->release(std::move(raw_message));
+  }
+}
+
+bool CommMixin::GateMessageHandler::deliver_gate_message(
+    std::size_t party_id, const Communication::CommMixinGateMessage& gate_message,
+    std::vector<std::uint8_t>* raw_message) {
+  auto gate_id = gate_message.gate_id();
+  auto msg_num = gate_message.msg_num();
+  auto payload = gate_message.payload();
+  if (payload == nullptr) {
+    logger_->LogError(fmt::format("received {} without payload for gate {}, dropping",
+                                  EnumNameMessageType(gate_message_type_), gate_id));
+    return false;
+  }
+  auto* expected_message = find_expected_message(gate_id, msg_num);
+  if (expected_message == nullptr ||
+      std::holds_alternative<std::monostate>(expected_message->promises_.at(party_id))) {
+    logger_->LogError(fmt::format("received unexpected {} for gate {} from party {}, dropping",
+                                  EnumNameMessageType(gate_message_type_), gate_id, party_id));
+    return false;
+  }
+  auto expected_size = expected_message->size_;
+  auto type = expected_message->type_;
+  auto& promise_variant = expected_message->promises_[party_id];
+
+  auto set_value_helper = [this, gate_id, msg_num, expected_size, payload,
+                           &promise_variant](auto type_tag) {
     auto byte_size = expected_size * sizeof(type_tag);
     if (byte_size != payload->size()) {
       logger_->LogError(fmt::format(
@@ -200,8 +290,8 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
           EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(), byte_size));
       return;
     }
-    auto& promise_map = map_vec[party_id];
-    auto& promise = promise_map.at({gate_id, msg_num});
+    auto& promise = std::get<ENCRYPTO::ReusableFiberPromise<std::vector<decltype(type_tag)>>>(
+        promise_variant);
     auto ptr = reinterpret_cast<const decltype(type_tag)*>(payload->data());
     try {
       promise.set_value(std::vector(ptr, ptr + expected_size));
@@ -219,9 +309,10 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
         logger_->LogError(fmt::format(
             "received {} for gate {} (msg_num {}) of size {} while expecting size {}, dropping",
             EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(), byte_size));
-        return;
+        return false;
       }
-      auto& promise = bits_promises_[party_id].at({gate_id, msg_num});
+      auto& promise =
+          std::get<ENCRYPTO::ReusableFiberPromise<ENCRYPTO::BitVector<>>>(promise_variant);
       try {
         promise.set_value(ENCRYPTO::BitVector(payload->data(), expected_size));
       } catch (std::future_error& e) {
@@ -237,9 +328,10 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
         logger_->LogError(fmt::format(
             "received {} for gate {} (msg_num {}) of size {} while expecting size {}, dropping",
             EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(), byte_size));
-        return;
+        return false;
       }
-      auto& promise = blocks_promises_[party_id].at({gate_id, msg_num});
+      auto& promise =
+          std::get<ENCRYPTO::ReusableFiberPromise<ENCRYPTO::block128_vector>>(promise_variant);
       try {
         promise.set_value(ENCRYPTO::block128_vector(expected_size, payload->data()));
       } catch (std::future_error& e) {
@@ -250,45 +342,242 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
       break;
     }
     case MsgValueType::uint8: {
-      set_value_helper(uint8_promises_, std::uint8_t{});
+      set_value_helper(std::uint8_t{});
       break;
     }
     case MsgValueType::uint16: {
-      set_value_helper(uint16_promises_, std::uint16_t{});
+      set_value_helper(std::uint16_t{});
       break;
     }
     case MsgValueType::uint32: {
-      set_value_helper(uint32_promises_, std::uint32_t{});
+      set_value_helper(std::uint32_t{});
       break;
     }
     case MsgValueType::uint64: {
-      set_value_helper(uint64_promises_, std::uint64_t{});
+      set_value_helper(std::uint64_t{});
       break;
     }
+    case MsgValueType::payload: {
+      if (expected_size != payload->size()) {
+        logger_->LogError(fmt::format(
+            "received {} for gate {} (msg_num {}) of size {} while expecting size {}, dropping",
+            EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(),
+            expected_size));
+        return false;
+      }
+      auto& promise =
+          std::get<ENCRYPTO::ReusableFiberPromise<Communication::ReceivedPayload>>(promise_variant);
+      try {
+        if (raw_message != nullptr) {
+          // the payload stays in the receive buffer, which is handed over as a whole
+          promise.set_value(Communication::ReceivedPayload(
+              std::move(*raw_message), payload->data(), payload->size(), buffer_pool_));
+          return true;
+        }
+        // the receive buffer holds further messages of a batch, so copy the payload
+        auto buffer = buffer_pool_ ? buffer_pool_->acquire(payload->size())
+                                   : std::vector<std::uint8_t>(payload->size());
+        std::copy_n(payload->data(), payload->size(), buffer.data());
+        const auto* data = buffer.data();
+        promise.set_value(
+            Communication::ReceivedPayload(std::move(buffer), data, payload->size(), buffer_pool_));
+      } catch (std::future_error& e) {
+        logger_->LogError(fmt::format(
+            "unable to fulfill promise ({}) for {} (payload) for gate {} (msg_num {}), dropping",
+            e.what(), EnumNameMessageType(gate_message_type_), gate_id, msg_num));
+      }
+      return false;
+    }
+  }
+
+  return false;
+}
+
+// Collects small gate messages per party and sends them as one batch message.
+// A batch is sent by a background thread once its first message has been
+// waiting for the coalescing window, or directly when it reaches the maximum
+// batch size.
+struct CommMixin::MessageCoalescer {
+  MessageCoalescer(const CommMixin& comm_mixin, std::chrono::microseconds window,
+                   std::size_t max_message_size, std::size_t max_batch_size);
+  // sends all pending messages
+  ~MessageCoalescer();
+  void enqueue(std::size_t party_id, std::size_t gate_id, std::size_t msg_num,
+               const std::uint8_t* message, std::size_t size);
+  void flush_task();
+
+  struct PendingMessage {
+    std::size_t gate_id_;
+    std::size_t msg_num_;
+    std::vector<std::uint8_t> payload_;
+  };
+  struct Batch {
+    std::vector<PendingMessage> messages_;
+    std::size_t num_bytes_ = 0;
+    std::chrono::steady_clock::time_point deadline_;
+  };
+  void send_batch(std::size_t party_id, std::vector<PendingMessage>&& messages) const;
+
+  const CommMixin& comm_mixin_;
+  const std::chrono::microseconds window_;
+  const std::size_t max_message_size_;
+  const std::size_t max_batch_size_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::vector<Batch> batches_;
+  std::thread flush_thread_;
+};
+
+CommMixin::MessageCoalescer::MessageCoalescer(const CommMixin& comm_mixin,
+                                              std::chrono::microseconds window,
+                                              std::size_t max_message_size,
+                                              std::size_t max_batch_size)
+    : comm_mixin_(comm_mixin),
+      window_(window),
+      max_message_size_(max_message_size),
+      max_batch_size_(max_batch_size),
+      batches_(comm_mixin.num_parties_),
+      flush_thread_([this] { flush_task(); }) {}
+
+CommMixin::MessageCoalescer::~MessageCoalescer() {
+  {
+    std::scoped_lock lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  flush_thread_.join();
+  for (std::size_t party_id = 0; party_id < batches_.size(); ++party_id) {
+    if (!batches_[party_id].messages_.empty()) {
+      send_batch(party_id, std::move(batches_[party_id].messages_));
+    }
+  }
+}
+
+void CommMixin::MessageCoalescer::enqueue(std::size_t party_id, std::size_t gate_id,
+                                          std::size_t msg_num, const std::uint8_t* message,
+                                          std::size_t size) {
+  std::vector<PendingMessage> full_batch;
+  bool first_message;
+  {
+    std::scoped_lock lock(mutex_);
+    auto& batch = batches_.at(party_id);
+    first_message = batch.messages_.empty();
+    if (first_message) {
+      batch.deadline_ = std::chrono::steady_clock::now() + window_;
+    }
+    batch.messages_.push_back({gate_id, msg_num, std::vector(message, message + size)});
+    batch.num_bytes_ += size;
+    if (batch.num_bytes_ >= max_batch_size_) {
+      full_batch = std::move(batch.messages_);
+      batch.messages_.clear();
+      batch.num_bytes_ = 0;
+    }
+  }
+  if (!full_batch.empty()) {
+    send_batch(party_id, std::move(full_batch));
+  } else if (first_message) {
+    // the flush thread needs to wait for a new deadline
+    cv_.notify_one();
+  }
+}
+
+void CommMixin::MessageCoalescer::flush_task() {
+  std::unique_lock lock(mutex_);
+  while (!stop_) {
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    for (const auto& batch : batches_) {
+      if (!batch.messages_.empty()) {
+        next_deadline = std::min(next_deadline, batch.deadline_);
+      }
+    }
+    if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+      cv_.wait(lock);
+      continue;
+    }
+    cv_.wait_until(lock, next_deadline);
+
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::size_t, std::vector<PendingMessage>>> expired_batches;
+    for (std::size_t party_id = 0; party_id < batches_.size(); ++party_id) {
+      auto& batch = batches_[party_id];
+      if (!batch.messages_.empty() && batch.deadline_ <= now) {
+        expired_batches.emplace_back(party_id, std::move(batch.messages_));
+        batch.messages_.clear();
+        batch.num_bytes_ = 0;
+      }
+    }
+    lock.unlock();
+    for (auto& [party_id, messages] : expired_batches) {
+      send_batch(party_id, std::move(messages));
+    }
+    lock.lock();
   }
 }
 
+void CommMixin::MessageCoalescer::send_batch(std::size_t party_id,
+                                             std::vector<PendingMessage>&& messages) const {
+  auto& communication_layer = comm_mixin_.communication_layer_;
+  if (messages.size() == 1) {
+    const auto& message = messages.front();
+    communication_layer.send_message(
+        party_id, comm_mixin_.build_gate_message(message.gate_id_, message.msg_num_,
+                                                 message.payload_.data(), message.payload_.size()));
+    return;
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Communication::CommMixinGateMessage>> gate_messages;
+  gate_messages.reserve(messages.size());
+  for (const auto& message : messages) {
+    auto payload = builder.CreateVector(message.payload_);
+    gate_messages.push_back(Communication::CreateCommMixinGateMessage(builder, message.gate_id_,
+                                                                      message.msg_num_, payload));
+  }
+  auto batch = builder.CreateVector(gate_messages);
+  auto root = Communication::CreateCommMixinGateMessage(builder, 0, 0, 0, batch);
+  builder.Finish(root);
+  communication_layer.send_message(
+      party_id, Communication::BuildMessage(comm_mixin_.gate_message_type_,
+                                            builder.GetBufferPointer(), builder.GetSize()));
+}
+
 CommMixin::CommMixin(Communication::CommunicationLayer& communication_layer,
                      Communication::MessageType gate_message_type, std::shared_ptr<Logger> logger)
     : communication_layer_(communication_layer),
       gate_message_type_(gate_message_type),
       my_id_(communication_layer.get_my_id()),
       num_parties_(communication_layer.get_num_parties()),
-      message_handler_(std::make_unique<GateMessageHandler>(communication_layer_.get_num_parties(),
-                                                            gate_message_type, logger)),
+      message_handler_(std::make_unique<GateMessageHandler>(
+          communication_layer_.get_num_parties(), gate_message_type,
+          communication_layer_.get_receive_buffer_pool(), logger)),
       logger_(std::move(logger)) {
   // TODO
   communication_layer_.register_message_handler([this](auto) { return message_handler_; },
                                                 {gate_message_type});
 }
 
-CommMixin::~CommMixin() { communication_layer_.deregister_message_handler({gate_message_type_}); }
+CommMixin::~CommMixin() {
+  // send the pending messages before the handler is gone
+  message_coalescer_.reset();
+  communication_layer_.deregister_message_handler({gate_message_type_});
+}
+
+void CommMixin::set_message_coalescing(std::chrono::microseconds window,
+                                       std::size_t max_message_size, std::size_t max_batch_size) {
+  message_coalescer_.reset();
+  if (window.count() > 0) {
+    message_coalescer_ =
+        std::make_unique<MessageCoalescer>(*this, window, max_message_size, max_batch_size);
+  }
+}
 
 flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(std::size_t gate_id,
                                                              std::size_t msg_num,
                                                              const std::uint8_t* message,
                                                              std::size_t size) const {
   flatbuffers::FlatBufferBuilder builder;
+  // see Communication::BuildMessage, the payload can then be used in place
+  builder.ForceVectorAlignment(size, sizeof(std::uint8_t), 16);
   auto vector = builder.CreateVector(message, size);
   auto root = Communication::CreateCommMixinGateMessage(builder, gate_id, msg_num, vector);
   builder.Finish(root);
@@ -296,36 +585,40 @@ flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(std::size_t gate_id
                                      builder.GetSize());
 }
 
-template <typename T>
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(std::size_t gate_id,
-                                                             std::size_t msg_num,
-                                                             const std::vector<T>& vector) const {
-  return build_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(vector.data()),
-                            sizeof(T) * vector.size());
-}
-
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(
-    std::size_t gate_id, std::size_t msg_num, const ENCRYPTO::BitVector<>& message) const {
-  auto vector = message.GetData();
-  return build_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(vector.data()),
-                            vector.size());
+void CommMixin::send_gate_message(std::size_t party_id, std::size_t gate_id, std::size_t msg_num,
+                                  const std::uint8_t* message, std::size_t size) const {
+  if (message_coalescer_ && size < message_coalescer_->max_message_size_) {
+    message_coalescer_->enqueue(party_id, gate_id, msg_num, message, size);
+    return;
+  }
+  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message, size));
 }
 
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(
-    std::size_t gate_id, std::size_t msg_num, const ENCRYPTO::block128_vector& message) const {
-  auto data = message.data();
-  return build_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(data),
-                            16 * message.size());
+void CommMixin::broadcast_gate_message(std::size_t gate_id, std::size_t msg_num,
+                                       const std::uint8_t* message, std::size_t size) const {
+  if (message_coalescer_ && size < message_coalescer_->max_message_size_) {
+    for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+      if (party_id != my_id_) {
+        message_coalescer_->enqueue(party_id, gate_id, msg_num, message, size);
+      }
+    }
+    return;
+  }
+  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message, size));
 }
 
 void CommMixin::broadcast_bits_message(std::size_t gate_id, const ENCRYPTO::BitVector<>& message,
                                        std::size_t msg_num) const {
-  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message));
+  const auto& data = message.GetData();
+  broadcast_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(data.data()),
+                         data.size());
 }
 
 void CommMixin::send_bits_message(std::size_t party_id, std::size_t gate_id,
                                   const ENCRYPTO::BitVector<>& message, std::size_t msg_num) const {
-  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message));
+  const auto& data = message.GetData();
+  send_gate_message(party_id, gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(data.data()),
+                    data.size());
 }
 
 [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>>
@@ -336,21 +629,14 @@ CommMixin::register_for_bits_messages(std::size_t gate_id, std::size_t num_bits,
   std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>> futures;
   std::transform(std::begin(promises), std::end(promises), std::back_inserter(futures),
                  [](auto& p) { return p.get_future(); });
-  auto [_, success] = mh.expected_messages_.insert(
-      {std::make_pair(gate_id, msg_num),
-       std::make_pair(num_bits, GateMessageHandler::MsgValueType::bit)});
-  if (!success) {
-    throw std::logic_error(fmt::format("tried to register twice for message for gate {}", gate_id));
-  }
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
   for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
-    if (party_id == my_id_) {
-      continue;
+    if (party_id != my_id_) {
+      expected_promises[party_id] = std::move(promises[party_id]);
     }
-    auto& promise_map = mh.bits_promises_.at(party_id);
-    auto [_, success] =
-        promise_map.insert({std::make_pair(gate_id, msg_num), std::move(promises.at(party_id))});
-    assert(success);
   }
+  mh.expect_message(gate_id, msg_num, num_bits, GateMessageHandler::MsgValueType::bit,
+                    std::move(expected_promises));
   if constexpr (MOTION_VERBOSE_DEBUG) {
     if (logger_) {
       logger_->LogTrace(
@@ -367,17 +653,10 @@ CommMixin::register_for_bits_message(std::size_t party_id, std::size_t gate_id,
   auto& mh = *message_handler_;
   ENCRYPTO::ReusableFiberPromise<ENCRYPTO::BitVector<>> promise;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> future = promise.get_future();
-  auto [_, success] = mh.expected_messages_.insert(
-      {std::make_pair(gate_id, msg_num),
-       std::make_pair(num_bits, GateMessageHandler::MsgValueType::bit)});
-  if (!success) {
-    throw std::logic_error(fmt::format("tried to register twice for message for gate {}", gate_id));
-  }
-  {
-    auto& promise_map = mh.bits_promises_.at(party_id);
-    auto [_, success] = promise_map.insert({std::make_pair(gate_id, msg_num), std::move(promise)});
-    assert(success);
-  }
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
+  expected_promises.at(party_id) = std::move(promise);
+  mh.expect_message(gate_id, msg_num, num_bits, GateMessageHandler::MsgValueType::bit,
+                    std::move(expected_promises));
   if constexpr (MOTION_VERBOSE_DEBUG) {
     if (logger_) {
       logger_->LogTrace(
@@ -390,13 +669,15 @@ CommMixin::register_for_bits_message(std::size_t party_id, std::size_t gate_id,
 void CommMixin::broadcast_blocks_message(std::size_t gate_id,
                                          const ENCRYPTO::block128_vector& message,
                                          std::size_t msg_num) const {
-  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message));
+  broadcast_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(message.data()),
+                         16 * message.size());
 }
 
 void CommMixin::send_blocks_message(std::size_t party_id, std::size_t gate_id,
                                     const ENCRYPTO::block128_vector& message,
                                     std::size_t msg_num) const {
-  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message));
+  send_gate_message(party_id, gate_id, msg_num,
+                    reinterpret_cast<const std::uint8_t*>(message.data()), 16 * message.size());
 }
 
 [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>>
@@ -407,21 +688,14 @@ CommMixin::register_for_blocks_messages(std::size_t gate_id, std::size_t num_blo
   std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>> futures;
   std::transform(std::begin(promises), std::end(promises), std::back_inserter(futures),
                  [](auto& p) { return p.get_future(); });
-  auto [_, success] = mh.expected_messages_.insert(
-      {std::make_pair(gate_id, msg_num),
-       std::make_pair(num_blocks, GateMessageHandler::MsgValueType::block)});
-  if (!success) {
-    throw std::logic_error(fmt::format("tried to register twice for message for gate {}", gate_id));
-  }
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
   for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
-    if (party_id == my_id_) {
-      continue;
+    if (party_id != my_id_) {
+      expected_promises[party_id] = std::move(promises[party_id]);
     }
-    auto& promise_map = mh.blocks_promises_.at(party_id);
-    auto [_, success] =
-        promise_map.insert({std::make_pair(gate_id, msg_num), std::move(promises.at(party_id))});
-    assert(success);
   }
+  mh.expect_message(gate_id, msg_num, num_blocks, GateMessageHandler::MsgValueType::block,
+                    std::move(expected_promises));
   if constexpr (MOTION_VERBOSE_DEBUG) {
     if (logger_) {
       logger_->LogTrace(
@@ -438,17 +712,10 @@ CommMixin::register_for_blocks_message(std::size_t party_id, std::size_t gate_id
   auto& mh = *message_handler_;
   ENCRYPTO::ReusableFiberPromise<ENCRYPTO::block128_vector> promise;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> future = promise.get_future();
-  auto [_, success] = mh.expected_messages_.insert(
-      {std::make_pair(gate_id, msg_num),
-       std::make_pair(num_blocks, GateMessageHandler::MsgValueType::block)});
-  if (!success) {
-    throw std::logic_error(fmt::format("tried to register twice for message for gate {}", gate_id));
-  }
-  {
-    auto& promise_map = mh.blocks_promises_.at(party_id);
-    auto [_, success] = promise_map.insert({std::make_pair(gate_id, msg_num), std::move(promise)});
-    assert(success);
-  }
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
+  expected_promises.at(party_id) = std::move(promise);
+  mh.expect_message(gate_id, msg_num, num_blocks, GateMessageHandler::MsgValueType::block,
+                    std::move(expected_promises));
   if constexpr (MOTION_VERBOSE_DEBUG) {
     if (logger_) {
       logger_->LogTrace(
@@ -458,10 +725,31 @@ CommMixin::register_for_blocks_message(std::size_t party_id, std::size_t gate_id
   return future;
 }
 
+[[nodiscard]] ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+CommMixin::register_for_blocks_message_view(std::size_t party_id, std::size_t gate_id,
+                                            std::size_t num_blocks, std::size_t msg_num) {
+  assert(party_id != my_id_);
+  auto& mh = *message_handler_;
+  ENCRYPTO::ReusableFiberPromise<Communication::ReceivedPayload> promise;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> future = promise.get_future();
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
+  expected_promises.at(party_id) = std::move(promise);
+  mh.expect_message(gate_id, msg_num, sizeof(ENCRYPTO::block128_t) * num_blocks,
+                    GateMessageHandler::MsgValueType::payload, std::move(expected_promises));
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    if (logger_) {
+      logger_->LogTrace(fmt::format("Gate {}: registered for blocks message view {} of size {}",
+                                    gate_id, msg_num, num_blocks));
+    }
+  }
+  return future;
+}
+
 template <typename T>
 void CommMixin::broadcast_ints_message(std::size_t gate_id, const std::vector<T>& message,
                                        std::size_t msg_num) const {
-  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message));
+  broadcast_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(message.data()),
+                         sizeof(T) * message.size());
 }
 
 template void CommMixin::broadcast_ints_message(std::size_t, const std::vector<std::uint8_t>&,
@@ -476,7 +764,9 @@ template void CommMixin::broadcast_ints_message(std::size_t, const std::vector<s
 template <typename T>
 void CommMixin::send_ints_message(std::size_t party_id, std::size_t gate_id,
                                   const std::vector<T>& message, std::size_t msg_num) const {
-  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message));
+  send_gate_message(party_id, gate_id, msg_num,
+                    reinterpret_cast<const std::uint8_t*>(message.data()),
+                    sizeof(T) * message.size());
 }
 
 template void CommMixin::send_ints_message(std::size_t, std::size_t,
@@ -498,21 +788,13 @@ CommMixin::register_for_ints_messages(std::size_t gate_id, std::size_t num_eleme
   std::transform(std::begin(promises), std::end(promises), std::back_inserter(futures),
                  [](auto& p) { return p.get_future(); });
   auto type = GateMessageHandler::get_msg_value_type<T>();
-  auto [_, success] = mh.expected_messages_.insert(
-      {std::make_pair(gate_id, msg_num), std::make_pair(num_elements, type)});
-  if (!success) {
-    throw std::logic_error(
-        fmt::format("tried to register twice for message {} for gate {}", msg_num, gate_id));
-  }
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
   for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
-    if (party_id == my_id_) {
-      continue;
+    if (party_id != my_id_) {
+      expected_promises[party_id] = std::move(promises[party_id]);
     }
-    auto& promise_map = mh.get_promise_map<T>().at(party_id);
-    auto [_, success] =
-        promise_map.insert({std::make_pair(gate_id, msg_num), std::move(promises.at(party_id))});
-    assert(success);
   }
+  mh.expect_message(gate_id, msg_num, num_elements, type, std::move(expected_promises));
   if constexpr (MOTION_VERBOSE_DEBUG) {
     if (logger_) {
       logger_->LogTrace(fmt::format("Gate {}: registered for int messages {} of size {}", gate_id,
@@ -539,17 +821,9 @@ template <typename T>
   ENCRYPTO::ReusableFiberPromise<std::vector<T>> promise;
   ENCRYPTO::ReusableFiberFuture<std::vector<T>> future = promise.get_future();
   auto type = GateMessageHandler::get_msg_value_type<T>();
-  auto [_, success] = mh.expected_messages_.insert(
-      {std::make_pair(gate_id, msg_num), std::make_pair(num_elements, type)});
-  if (!success) {
-    throw std::logic_error(
-        fmt::format("tried to register twice for message {} for gate {}", msg_num, gate_id));
-  }
-  {
-    auto& promise_map = mh.get_promise_map<T>().at(party_id);
-    auto [_, success] = promise_map.insert({std::make_pair(gate_id, msg_num), std::move(promise)});
-    assert(success);
-  }
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
+  expected_promises.at(party_id) = std::move(promise);
+  mh.expect_message(gate_id, msg_num, num_elements, type, std::move(expected_promises));
   if constexpr (MOTION_VERBOSE_DEBUG) {
     if (logger_) {
       logger_->LogTrace(fmt::format("Gate {}: registered for int message {} of size {}", gate_id,
@@ -568,4 +842,38 @@ template ENCRYPTO::ReusableFiberFuture<std::vector<std::uint32_t>>
 template ENCRYPTO::ReusableFiberFuture<std::vector<std::uint64_t>>
     CommMixin::register_for_ints_message(std::size_t, std::size_t, std::size_t, std::size_t);
 
+template <typename T>
+[[nodiscard]] ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+CommMixin::register_for_ints_message_view(std::size_t party_id, std::size_t gate_id,
+                                          std::size_t num_elements, std::size_t msg_num) {
+  assert(party_id != my_id_);
+  auto& mh = *message_handler_;
+  ENCRYPTO::ReusableFiberPromise<Communication::ReceivedPayload> promise;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> future = promise.get_future();
+  std::vector<GateMessageHandler::PromiseType> expected_promises(num_parties_);
+  expected_promises.at(party_id) = std::move(promise);
+  mh.expect_message(gate_id, msg_num, sizeof(T) * num_elements,
+                    GateMessageHandler::MsgValueType::payload, std::move(expected_promises));
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    if (logger_) {
+      logger_->LogTrace(fmt::format("Gate {}: registered for int message view {} of size {}",
+                                    gate_id, msg_num, num_elements));
+    }
+  }
+  return future;
+}
+
+template ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+    CommMixin::register_for_ints_message_view<std::uint8_t>(std::size_t, std::size_t, std::size_t,
+                                                            std::size_t);
+template ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+    CommMixin::register_for_ints_message_view<std::uint16_t>(std::size_t, std::size_t, std::size_t,
+                                                             std::size_t);
+template ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+    CommMixin::register_for_ints_message_view<std::uint32_t>(std::size_t, std::size_t, std::size_t,
+                                                             std::size_t);
+template ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+    CommMixin::register_for_ints_message_view<std::uint64_t>(std::size_t, std::size_t, std::size_t,
+                                                             std::size_t);
+
 }  // namespace MOTION::proto
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 
+#include "communication/buffer_pool.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/reusable_future.h"
@@ -45,6 +47,15 @@ class CommMixin {
             std::shared_ptr<Logger>);
   ~CommMixin();
 
+  // Coalesce gate messages of less than max_message_size bytes which are sent
+  // to the same party within the given window into a single message of at most
+  // about max_batch_size bytes.  This saves the per-message overhead when many
+  // gates send small messages in the same round.  A zero window (the default)
+  // sends every message on its own.
+  void set_message_coalescing(std::chrono::microseconds window,
+                              std::size_t max_message_size = 4096,
+                              std::size_t max_batch_size = 1 << 16);
+
   void broadcast_bits_message(std::size_t gate_id, const ENCRYPTO::BitVector<>& message,
                               std::size_t msg_num = 0) const;
   void send_bits_message(std::size_t party_id, std::size_t gate_id,
@@ -63,6 +74,13 @@ class CommMixin {
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>
   register_for_blocks_message(std::size_t party_id, std::size_t gate_id, std::size_t num_bits,
                               std::size_t msg_num = 0);
+  // Like register_for_blocks_message, but the future yields the received
+  // message itself (see register_for_ints_message_view).  Senders align the
+  // payload to 16 bytes, check ReceivedPayload::is_aligned_for before reading
+  // the blocks in place.
+  [[nodiscard]] ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+  register_for_blocks_message_view(std::size_t party_id, std::size_t gate_id,
+                                   std::size_t num_blocks, std::size_t msg_num = 0);
 
   template <typename T>
   void broadcast_ints_message(std::size_t gate_id, const std::vector<T>& message,
@@ -77,25 +95,31 @@ class CommMixin {
   template <typename T>
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<std::vector<T>> register_for_ints_message(
       std::size_t party_id, std::size_t gate_id, std::size_t num_elements, std::size_t msg_num = 0);
+  // Like register_for_ints_message, but the future yields the received message
+  // itself instead of a copy of its payload (use ReceivedPayload::data_as<T>).
+  template <typename T>
+  [[nodiscard]] ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+  register_for_ints_message_view(std::size_t party_id, std::size_t gate_id,
+                                 std::size_t num_elements, std::size_t msg_num = 0);
 
  private:
   flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
                                                     const std::uint8_t* message,
                                                     std::size_t size) const;
-  template <typename T>
-  flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const std::vector<T>& vector) const;
-  flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const ENCRYPTO::BitVector<>& message) const;
-  flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const ENCRYPTO::block128_vector& message) const;
+  // send the message on its own or pass it to the coalescer
+  void send_gate_message(std::size_t party_id, std::size_t gate_id, std::size_t msg_num,
+                         const std::uint8_t* message, std::size_t size) const;
+  void broadcast_gate_message(std::size_t gate_id, std::size_t msg_num,
+                              const std::uint8_t* message, std::size_t size) const;
 
   struct GateMessageHandler;
+  struct MessageCoalescer;
   Communication::CommunicationLayer& communication_layer_;
   Communication::MessageType gate_message_type_;
   std::size_t my_id_;
   std::size_t num_parties_;
   std::shared_ptr<GateMessageHandler> message_handler_;
+  std::unique_ptr<MessageCoalescer> message_coalescer_;
   std::shared_ptr<Logger> logger_;
 };
 
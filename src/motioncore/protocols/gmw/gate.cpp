@@ -24,6 +24,7 @@
 #include <openssl/bn.h>
 #include <stdexcept>
 
+#include "algorithm/algorithm_description.h"
 #include "base/gate_factory.h"
 #include "crypto/arithmetic_provider.h"
 #include "crypto/motion_base_provider.h"
@@ -389,6 +390,136 @@ void BooleanGMWANDGate::evaluate_online() {
   }
 }
 
+BooleanGMWCircuitGate::BooleanGMWCircuitGate(std::size_t gate_id, GMWProvider& gmw_provider,
+                                             const ENCRYPTO::AlgorithmDescription& algo,
+                                             const ENCRYPTO::CircuitLayers& circuit_layers,
+                                             BooleanGMWWireVector&& in)
+    : NewGate(gate_id),
+      gmw_provider_(gmw_provider),
+      algo_(algo),
+      circuit_layers_(circuit_layers),
+      num_simd_(in.at(0)->get_num_simd()),
+      inputs_(std::move(in)) {
+  const auto n_input_wires =
+      algo_.n_input_wires_parent_a_ + algo_.n_input_wires_parent_b_.value_or(0);
+  if (inputs_.size() != n_input_wires) {
+    throw std::invalid_argument(
+        fmt::format("BooleanGMWCircuitGate: circuit expects {} input wires, but {} are provided",
+                    n_input_wires, inputs_.size()));
+  }
+  outputs_.reserve(algo_.n_output_wires_);
+  std::generate_n(std::back_inserter(outputs_), algo_.n_output_wires_,
+                  [this] { return std::make_shared<BooleanGMWWire>(num_simd_); });
+  mt_offset_ =
+      gmw_provider_.get_mt_provider().RequestBinaryMTs(circuit_layers_.n_and_gates_ * num_simd_);
+  const auto num_layers = circuit_layers_.layers_.size();
+  share_futures_.resize(num_layers);
+  for (std::size_t layer_i = 0; layer_i < num_layers; ++layer_i) {
+    const auto num_and_gates = circuit_layers_.layers_[layer_i].and_gates_.size();
+    if (num_and_gates > 0) {
+      share_futures_[layer_i] = gmw_provider_.register_for_bits_messages(
+          gate_id_, 2 * num_and_gates * num_simd_, layer_i);
+    }
+  }
+}
+
+void BooleanGMWCircuitGate::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = gmw_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanGMWCircuitGate::evaluate_online start", gate_id_));
+    }
+  }
+
+  // shares of all wires of the circuit
+  std::vector<ENCRYPTO::BitVector<>> shares(algo_.n_wires_);
+  for (std::size_t wire_i = 0; wire_i < inputs_.size(); ++wire_i) {
+    const auto& wire = inputs_[wire_i];
+    wire->wait_online();
+    assert(wire->get_share().GetSize() == num_simd_);
+    shares[wire_i] = wire->get_share();
+  }
+
+  const auto& mtp = gmw_provider_.get_mt_provider();
+  const auto num_parties = gmw_provider_.get_num_parties();
+  const auto my_id = gmw_provider_.get_my_id();
+  const auto is_my_job = gmw_provider_.is_my_job(gate_id_);
+  auto mt_offset = mt_offset_;
+  for (std::size_t layer_i = 0; layer_i < circuit_layers_.layers_.size(); ++layer_i) {
+    const auto& layer = circuit_layers_.layers_[layer_i];
+    for (auto gate_i : layer.linear_gates_) {
+      const auto& op = algo_.gates_[gate_i];
+      if (op.type_ == ENCRYPTO::PrimitiveOperationType::XOR) {
+        shares[op.output_wire_] = shares[op.parent_a_] ^ shares[*op.parent_b_];
+      } else if (is_my_job) {
+        shares[op.output_wire_] = ~shares[op.parent_a_];
+      } else {
+        shares[op.output_wire_] = shares[op.parent_a_];
+      }
+    }
+    if (layer.and_gates_.empty()) {
+      continue;
+    }
+
+    // evaluate all AND gates of this layer at once
+    const auto num_bits = layer.and_gates_.size() * num_simd_;
+    auto mts = mtp.GetBinary(mt_offset, num_bits);
+    mt_offset += num_bits;
+    ENCRYPTO::BitVector<> x;
+    ENCRYPTO::BitVector<> y;
+    x.Reserve(Helpers::Convert::BitsToBytes(num_bits));
+    y.Reserve(Helpers::Convert::BitsToBytes(num_bits));
+    for (auto gate_i : layer.and_gates_) {
+      const auto& op = algo_.gates_[gate_i];
+      x.Append(shares[op.parent_a_]);
+      y.Append(shares[*op.parent_b_]);
+    }
+    auto de = x ^ mts.a;
+    de.Append(y ^ mts.b);
+    gmw_provider_.broadcast_bits_message(gate_id_, de, layer_i);
+    for (std::size_t party_id = 0; party_id < num_parties; ++party_id) {
+      if (party_id == my_id) {
+        continue;
+      }
+      de ^= share_futures_[layer_i][party_id].get();
+    }
+    auto e = de.Subset(num_bits, 2 * num_bits);
+    auto d = std::move(de);
+    d.Resize(num_bits);
+    x &= e;
+    y &= d;
+    d &= e;
+    auto result = std::move(mts.c);
+    result ^= x;
+    result ^= y;
+    if (is_my_job) {
+      result ^= d;
+    }
+    for (std::size_t and_i = 0; and_i < layer.and_gates_.size(); ++and_i) {
+      const auto& op = algo_.gates_[layer.and_gates_[and_i]];
+      shares[op.output_wire_] = result.Subset(and_i * num_simd_, (and_i + 1) * num_simd_);
+    }
+  }
+
+  // the output wires are the last wires of the circuit
+  const auto first_output_wire = algo_.n_wires_ - algo_.n_output_wires_;
+  for (std::size_t wire_i = 0; wire_i < outputs_.size(); ++wire_i) {
+    auto& wire_o = outputs_[wire_i];
+    wire_o->get_share() = std::move(shares[first_output_wire + wire_i]);
+    assert(wire_o->get_share().GetSize() == num_simd_);
+    wire_o->set_online_ready();
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = gmw_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanGMWCircuitGate::evaluate_online end", gate_id_));
+    }
+  }
+}
+
 namespace detail {
 
 template <typename T>
@@ -37,6 +37,11 @@ template <typename T>
 class BitIntegerMultiplicationIntSide;
 }  // namespace MOTION
 
+namespace ENCRYPTO {
+struct AlgorithmDescription;
+struct CircuitLayers;
+}  // namespace ENCRYPTO
+
 namespace MOTION::proto::gmw {
 
 namespace detail {
@@ -164,6 +169,31 @@ class BooleanGMWANDGate : public detail::BasicBooleanGMWBinaryGate {
   std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>> share_futures_;
 };
 
+// Evaluates a whole Boolean circuit of XOR, INV and AND gates.  The AND gates
+// are processed layer by layer (see ENCRYPTO::CircuitLayers), so that the
+// circuit needs one message per layer instead of one per AND gate.
+class BooleanGMWCircuitGate : public NewGate {
+ public:
+  BooleanGMWCircuitGate(std::size_t gate_id, GMWProvider&, const ENCRYPTO::AlgorithmDescription&,
+                        const ENCRYPTO::CircuitLayers&, BooleanGMWWireVector&&);
+  bool need_setup() const noexcept override { return false; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override {}
+  void evaluate_online() override;
+  BooleanGMWWireVector& get_output_wires() noexcept { return outputs_; }
+
+ private:
+  GMWProvider& gmw_provider_;
+  const ENCRYPTO::AlgorithmDescription& algo_;
+  const ENCRYPTO::CircuitLayers& circuit_layers_;
+  std::size_t num_simd_;
+  std::size_t mt_offset_;
+  const BooleanGMWWireVector inputs_;
+  BooleanGMWWireVector outputs_;
+  // one vector of futures per layer, empty for layers without AND gates
+  std::vector<std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>>> share_futures_;
+};
+
 namespace detail {
 
 template <typename T>
@@ -26,6 +26,7 @@
 #include <unordered_map>
 #include "gmw_provider.h"
 
+#include "algorithm/circuit_loader.h"
 #include "base/gate_register.h"
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/gmw_message_generated.h"
@@ -388,6 +389,23 @@ std::pair<NewGateP, WireVector> GMWProvider::construct_binary_gate(
   }
 }
 
+std::pair<NewGateP, WireVector> GMWProvider::construct_circuit_gate(
+    const ENCRYPTO::AlgorithmDescription& algo, const WireVector& in) {
+  const auto& circuit_layers = circuit_loader_.get_circuit_layers(algo);
+  auto gate_id = gate_register_.get_next_gate_id();
+  auto gate =
+      std::make_unique<BooleanGMWCircuitGate>(gate_id, *this, algo, circuit_layers, cast_wires(in));
+  auto output = gate->get_output_wires();
+  return {std::move(gate), cast_wires(std::move(output))};
+}
+
+WireVector GMWProvider::make_circuit_gate(const ENCRYPTO::AlgorithmDescription& algo,
+                                          const WireVector& in) {
+  auto [gate, output] = construct_circuit_gate(algo, in);
+  gate_register_.register_gate(std::move(gate));
+  return output;
+}
+
 WireVector GMWProvider::make_binary_gate(ENCRYPTO::PrimitiveOperationType op,
                                          const WireVector& in_a, const WireVector& in_b) {
   switch (op) {
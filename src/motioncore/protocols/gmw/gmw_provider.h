@@ -33,6 +33,10 @@
 #include "utility/enable_wait.h"
 #include "utility/type_traits.hpp"
 
+namespace ENCRYPTO {
+struct AlgorithmDescription;
+}
+
 namespace ENCRYPTO::ObliviousTransfer {
 class OTProviderManager;
 }
@@ -176,6 +180,12 @@ class GMWProvider : public GateFactory,
   std::pair<NewGateP, WireVector> construct_binary_gate(ENCRYPTO::PrimitiveOperationType op,
                                                         const WireVector&, const WireVector&);
 
+  // Boolean circuit evaluated as a single gate with one round per AND layer,
+  // the circuit needs to be owned by the CircuitLoader
+  std::pair<NewGateP, WireVector> construct_circuit_gate(const ENCRYPTO::AlgorithmDescription&,
+                                                         const WireVector&);
+  WireVector make_circuit_gate(const ENCRYPTO::AlgorithmDescription&, const WireVector&);
+
   WireVector convert(MPCProtocol dst_proto, const WireVector&) override;
 
   // other gates
@@ -214,6 +224,7 @@ class GMWProvider : public GateFactory,
                                        const tensor::TensorCP input_A,
                                        const tensor::TensorCP input_B,
                                        std::size_t fractional_bits = 0) override;
+  using tensor::TensorOpFactory::make_tensor_gemm_op;
   tensor::TensorCP make_tensor_sqr_op(const tensor::TensorCP input,
                                       std::size_t fractional_bits = 0) override;
   tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP) override;
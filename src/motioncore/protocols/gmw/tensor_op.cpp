@@ -29,7 +29,6 @@
 #include <stdexcept>
 
 #include "algorithm/circuit_loader.h"
-#include "algorithm/make_circuit.h"
 #include "crypto/motion_base_provider.h"
 #include "crypto/multiplication_triple/linalg_triple_provider.h"
 #include "crypto/multiplication_triple/sb_provider.h"
@@ -953,8 +952,8 @@ BooleanGMWTensorMaxPool::BooleanGMWTensorMaxPool(std::size_t gate_id, GMWProvide
     WireVector in(bit_size_ * kernel_size);
     std::transform(std::begin(input_wires_), std::end(input_wires_), std::begin(in),
                    [](auto w) { return std::dynamic_pointer_cast<BooleanGMWWire>(w); });
-    auto [gates, out] = construct_circuit(gmw_provider_, maxpool_algo_, in);
-    gates_ = std::move(gates);
+    auto [gate, out] = gmw_provider_.construct_circuit_gate(maxpool_algo_, in);
+    gates_.push_back(std::move(gate));
     assert(out.size() == bit_size_);
     output_wires_.resize(bit_size_);
     std::transform(std::begin(out), std::end(out), std::begin(output_wires_),
@@ -1042,7 +1041,7 @@ void BooleanGMWTensorMaxPool::evaluate_online() {
   prepare_wires(bit_size_, maxpool_op_, input_wires_, input_->get_share());
 
   for (auto& gate : gates_) {
-    // should work since its a Boolean circuit consisting of AND, XOR, INV gates
+    // a single gate evaluating the circuit layer by layer
     gate->evaluate_online();
   }
 
@@ -911,7 +911,7 @@ YaoANDGateEvaluator::YaoANDGateEvaluator(std::size_t gate_id, YaoProvider& yao_p
                                          YaoWireVector&& in_a, YaoWireVector&& in_b)
     : BasicYaoBinaryGate(gate_id, yao_provider, std::move(in_a), std::move(in_b)) {
   auto num_gates = detail::count_bits(inputs_a_);
-  garbled_tables_fut_ = yao_provider_.register_for_blocks_message(
+  garbled_tables_fut_ = yao_provider_.register_for_blocks_message_view(
       gate_id_, num_gates * YaoProvider::garbled_table_size);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -951,7 +951,9 @@ void YaoANDGateEvaluator::evaluate_online() {
   }
 
   auto num_wires = outputs_.size();
-  auto garbled_tables = garbled_tables_fut_.get();
+  auto garbled_tables_message = garbled_tables_fut_.get();
+  ENCRYPTO::block128_vector buffer;
+  const auto* garbled_tables = YaoProvider::get_blocks(garbled_tables_message, buffer);
 
   std::size_t table_offset = 0;
   for (std::size_t wire_i = 0; wire_i < num_wires; ++wire_i) {
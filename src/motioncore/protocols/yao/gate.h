@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <variant>
 
+#include "communication/buffer_pool.h"
 #include "gate/new_gate.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
@@ -233,7 +234,7 @@ class YaoANDGateEvaluator : public detail::BasicYaoBinaryGate {
   void evaluate_online() override;
 
  private:
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_fut_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_fut_;
 };
 
 }  // namespace MOTION::proto::yao
@@ -23,6 +23,7 @@
 #include <parallel/algorithm>
 
 #include "algorithm/circuit_loader.h"
+#include "crypto/garbling/half_gates.h"
 #include "crypto/motion_base_provider.h"
 #include "crypto/oblivious_transfer/ot_flavors.h"
 #include "crypto/oblivious_transfer/ot_provider.h"
@@ -177,7 +178,7 @@ ArithmeticGMWToYaoTensorConversionEvaluator<T>::ArithmeticGMWToYaoTensorConversi
   ot_receiver_ = ot_provider.RegisterReceiveGOT128(bit_size_ * data_size_);
   garbler_input_keys_future_ =
       yao_provider_.CommMixin::register_for_blocks_message(0, gate_id, bit_size_ * data_size_, 0);
-  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message(
+  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message_view(
       0, gate_id, 2 * (bit_size_ - 1) * data_size_, 1);
   output_->get_keys().resize(bit_size_ * data_size_);
 
@@ -247,10 +248,10 @@ void ArithmeticGMWToYaoTensorConversionEvaluator<T>::evaluate_online() {
   }
   // evaluate garbled circuit
   {
-    garbled_tables_ = garbled_tables_future_.get();
+    const auto garbled_tables = garbled_tables_future_.get();
     yao_provider_.evaluate_garbled_circuit(gate_id_, data_size_, addition_algo_,
                                            garbler_input_keys_, evaluator_input_keys_,
-                                           garbled_tables_, output_->get_keys(), true);
+                                           garbled_tables, output_->get_keys(), true);
     output_->set_online_ready();
   }
 
@@ -368,7 +369,7 @@ YaoToArithmeticGMWTensorConversionEvaluator<T>::YaoToArithmeticGMWTensorConversi
           fmt::format("int_add{}_size.bristol", ENCRYPTO::bit_size_v<T>), CircuitFormat::Bristol)) {
   garbler_input_keys_future_ =
       yao_provider_.CommMixin::register_for_blocks_message(0, gate_id, bit_size_ * data_size_, 0);
-  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message(
+  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message_view(
       0, gate_id, 2 * (bit_size_ - 1) * data_size_, 1);
   output_info_future_ =
       yao_provider_.CommMixin::register_for_bits_message(0, gate_id_, bit_size_ * data_size_, 2);
@@ -701,7 +702,7 @@ ArithmeticBEAVYToYaoTensorConversionEvaluator<T>::ArithmeticBEAVYToYaoTensorConv
   ot_receiver_ = ot_provider.RegisterReceiveFixedXCOT128(bit_size_ * data_size_);
   garbler_input_keys_future_ =
       yao_provider_.CommMixin::register_for_blocks_message(0, gate_id, bit_size_ * data_size_, 0);
-  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message(
+  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message_view(
       0, gate_id, 2 * (bit_size_ - 1) * data_size_, 1);
   output_->get_keys().resize(bit_size_ * data_size_);
 
@@ -794,10 +795,10 @@ void ArithmeticBEAVYToYaoTensorConversionEvaluator<T>::evaluate_online() {
   { garbler_input_keys_ = garbler_input_keys_future_.get(); }
   // evaluate garbled circuit
   {
-    garbled_tables_ = garbled_tables_future_.get();
+    const auto garbled_tables = garbled_tables_future_.get();
     yao_provider_.evaluate_garbled_circuit(gate_id_, data_size_, addition_algo_,
                                            garbler_input_keys_, evaluator_input_keys_,
-                                           garbled_tables_, output_->get_keys(), true);
+                                           garbled_tables, output_->get_keys(), true);
     output_->set_online_ready();
   }
 
@@ -957,7 +958,7 @@ YaoToArithmeticBEAVYTensorConversionEvaluator<T>::YaoToArithmeticBEAVYTensorConv
           fmt::format("int_add{}_size.bristol", ENCRYPTO::bit_size_v<T>), CircuitFormat::Bristol)) {
   garbler_input_keys_future_ =
       yao_provider_.CommMixin::register_for_blocks_message(0, gate_id, bit_size_ * data_size_, 0);
-  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message(
+  garbled_tables_future_ = yao_provider_.CommMixin::register_for_blocks_message_view(
       0, gate_id, 2 * (bit_size_ - 1) * data_size_, 1);
   output_info_future_ =
       yao_provider_.CommMixin::register_for_bits_message(0, gate_id_, bit_size_ * data_size_, 2);
@@ -1268,7 +1269,6 @@ YaoTensorReluGarbler::YaoTensorReluGarbler(std::size_t gate_id, YaoProvider& yao
       input_(input),
       output_(std::make_shared<YaoTensor>(input->get_dimensions(), bit_size_)),
       relu_algo_(yao_provider_.get_circuit_loader().load_relu_circuit(bit_size_)) {
-  garbled_tables_.resize(data_size_ * (bit_size_ - 1));
   output_->get_keys().resize(bit_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1288,10 +1288,9 @@ void YaoTensorReluGarbler::evaluate_setup() {
     }
   }
 
-  // garble ReLU circuit
-  yao_provider_.create_garbled_circuit(gate_id_, data_size_, relu_algo_, input_->get_keys(), {},
-                                       garbled_tables_, output_->get_keys(), true);
-  yao_provider_.send_blocks_message(gate_id_, std::move(garbled_tables_));
+  // garble ReLU circuit and send the tables while garbling
+  yao_provider_.create_garbled_circuit_streaming(gate_id_, data_size_, relu_algo_,
+                                                 input_->get_keys(), {}, output_->get_keys(), true);
   output_->set_setup_ready();
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1311,8 +1310,8 @@ YaoTensorReluEvaluator::YaoTensorReluEvaluator(std::size_t gate_id, YaoProvider&
       input_(input),
       output_(std::make_shared<YaoTensor>(input->get_dimensions(), bit_size_)),
       relu_algo_(yao_provider_.get_circuit_loader().load_relu_circuit(bit_size_)) {
-  garbled_tables_future_ =
-      yao_provider_.register_for_blocks_message(gate_id, 2 * (bit_size_ - 1) * data_size_);
+  garbled_tables_futures_ =
+      yao_provider_.register_for_garbled_circuit_chunks(gate_id, data_size_, relu_algo_);
   output_->get_keys().resize(bit_size_ * data_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1332,10 +1331,10 @@ void YaoTensorReluEvaluator::evaluate_online() {
     }
   }
 
-  // evaluate ReLU circuit
-  const auto garbled_tables = garbled_tables_future_.get();
-  yao_provider_.evaluate_garbled_circuit(gate_id_, data_size_, relu_algo_, input_->get_keys(), {},
-                                         garbled_tables, output_->get_keys(), true);
+  // evaluate ReLU circuit, chunks of the garbled tables are consumed as they arrive
+  yao_provider_.evaluate_garbled_circuit_streaming(gate_id_, data_size_, relu_algo_,
+                                                   input_->get_keys(), {}, garbled_tables_futures_,
+                                                   output_->get_keys(), true);
   output_->set_online_ready();
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1415,7 +1414,8 @@ YaoTensorMaxPoolEvaluator::YaoTensorMaxPoolEvaluator(std::size_t gate_id, YaoPro
           bit_size_, maxpool_op_.compute_kernel_size())) {
   const std::size_t num_and_gates =
       (2 * bit_size_) * (maxpool_op_.compute_kernel_size() - 1) * maxpool_op_.compute_output_size();
-  garbled_tables_future_ = yao_provider_.register_for_blocks_message(gate_id, 2 * num_and_gates);
+  garbled_tables_future_ =
+      yao_provider_.register_for_blocks_message_view(gate_id, 2 * num_and_gates);
   output_->get_keys().resize(bit_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1522,7 +1522,8 @@ YaoTensorGTEvaluator::YaoTensorGTEvaluator(std::size_t gate_id, YaoProvider& yao
           bit_size_, maxpool_op_.compute_kernel_size())) {
   const std::size_t num_and_gates =
       (2 * bit_size_) * (maxpool_op_.compute_kernel_size() - 1) * maxpool_op_.compute_output_size();
-  garbled_tables_future_ = yao_provider_.register_for_blocks_message(gate_id, 2 * num_and_gates);
+  garbled_tables_future_ =
+      yao_provider_.register_for_blocks_message_view(gate_id, 2 * num_and_gates);
   output_->get_keys().resize(bit_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1561,4 +1562,149 @@ void YaoTensorGTEvaluator::evaluate_online() {
   }
 }
 
+// ArgMax
+
+// Copy the output keys of the argmax circuit into the index and max tensors.
+// The circuit outputs the bits of the index followed by the bits of the max,
+// each bit as one SIMD wire over all outputs, which is already the layout of
+// the tensor keys.
+static void argmax_split_keys_out(const YaoTensorP& index, const YaoTensorP& max,
+                                  const ENCRYPTO::block128_vector& out_keys,
+                                  std::size_t bit_size, std::size_t output_size) {
+  const auto num_keys = bit_size * output_size;
+  assert(out_keys.size() == (max ? 2 : 1) * num_keys);
+  index->get_keys() = ENCRYPTO::block128_vector(num_keys, out_keys.data());
+  if (max) {
+    max->get_keys() = ENCRYPTO::block128_vector(num_keys, out_keys.data() + num_keys);
+  }
+}
+
+YaoTensorArgMaxGarbler::YaoTensorArgMaxGarbler(std::size_t gate_id, YaoProvider& yao_provider,
+                                               tensor::ArgMaxOp argmax_op, const YaoTensorCP input,
+                                               bool with_max)
+    : NewGate(gate_id),
+      yao_provider_(yao_provider),
+      argmax_op_(argmax_op),
+      bit_size_(input->get_bit_size()),
+      output_size_(argmax_op_.compute_output_size()),
+      input_(input),
+      index_(std::make_shared<YaoTensor>(argmax_op_.get_output_tensor_dims(), bit_size_)),
+      max_(with_max ? std::make_shared<YaoTensor>(argmax_op_.get_output_tensor_dims(), bit_size_)
+                    : nullptr),
+      argmax_algo_(yao_provider_.get_circuit_loader().load_argmax_circuit(
+          bit_size_, argmax_op_.compute_num_candidates(), with_max)) {
+  if (!argmax_op_.verify()) {
+    throw std::invalid_argument("invalid ArgMaxOp");
+  }
+  if (input_->get_dimensions() != argmax_op_.get_input_tensor_dims()) {
+    throw std::invalid_argument("ArgMaxOp does not fit to the input dimensions");
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: YaoTensorArgMaxGarbler created", gate_id_));
+    }
+  }
+}
+
+void YaoTensorArgMaxGarbler::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxGarbler::evaluate_setup start", gate_id_));
+    }
+  }
+
+  // garble the tournament circuit for all outputs at once
+  ENCRYPTO::block128_vector in_keys;
+  ENCRYPTO::block128_vector out_keys;
+  ENCRYPTO::block128_vector garbled_tables;
+  input_->wait_setup();
+  argmax_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, argmax_op_);
+  yao_provider_.create_garbled_circuit(gate_id_, output_size_, argmax_algo_, in_keys, {},
+                                       garbled_tables, out_keys, true);
+  yao_provider_.send_blocks_message(gate_id_, std::move(garbled_tables));
+  argmax_split_keys_out(index_, max_, out_keys, bit_size_, output_size_);
+
+  index_->set_setup_ready();
+  if (max_) {
+    max_->set_setup_ready();
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxGarbler::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+YaoTensorArgMaxEvaluator::YaoTensorArgMaxEvaluator(std::size_t gate_id,
+                                                   YaoProvider& yao_provider,
+                                                   tensor::ArgMaxOp argmax_op,
+                                                   const YaoTensorCP input, bool with_max)
+    : NewGate(gate_id),
+      yao_provider_(yao_provider),
+      argmax_op_(argmax_op),
+      bit_size_(input->get_bit_size()),
+      output_size_(argmax_op_.compute_output_size()),
+      input_(input),
+      index_(std::make_shared<YaoTensor>(argmax_op_.get_output_tensor_dims(), bit_size_)),
+      max_(with_max ? std::make_shared<YaoTensor>(argmax_op_.get_output_tensor_dims(), bit_size_)
+                    : nullptr),
+      argmax_algo_(yao_provider_.get_circuit_loader().load_argmax_circuit(
+          bit_size_, argmax_op_.compute_num_candidates(), with_max)) {
+  if (!argmax_op_.verify()) {
+    throw std::invalid_argument("invalid ArgMaxOp");
+  }
+  if (input_->get_dimensions() != argmax_op_.get_input_tensor_dims()) {
+    throw std::invalid_argument("ArgMaxOp does not fit to the input dimensions");
+  }
+  const auto num_and_gates = Crypto::garbling::get_num_and_gates(argmax_algo_) * output_size_;
+  garbled_tables_future_ =
+      yao_provider_.register_for_blocks_message_view(gate_id, 2 * num_and_gates);
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: YaoTensorArgMaxEvaluator created", gate_id_));
+    }
+  }
+}
+
+void YaoTensorArgMaxEvaluator::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxEvaluator::evaluate_online start", gate_id_));
+    }
+  }
+
+  const auto garbled_tables = garbled_tables_future_.get();
+  ENCRYPTO::block128_vector in_keys;
+  ENCRYPTO::block128_vector out_keys;
+  input_->wait_online();
+  argmax_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, argmax_op_);
+  yao_provider_.evaluate_garbled_circuit(gate_id_, output_size_, argmax_algo_, in_keys, {},
+                                         garbled_tables, out_keys, true);
+  argmax_split_keys_out(index_, max_, out_keys, bit_size_, output_size_);
+
+  index_->set_online_ready();
+  if (max_) {
+    max_->set_online_ready();
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxEvaluator::evaluate_online end", gate_id_));
+    }
+  }
+}
+
 }  // namespace MOTION::proto::yao
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "communication/buffer_pool.h"
 #include "gate/new_gate.h"
 #include "protocols/beavy/tensor.h"
 #include "protocols/gmw/tensor.h"
@@ -89,10 +90,9 @@ class ArithmeticGMWToYaoTensorConversionEvaluator : public NewGate {
   YaoTensorP output_;
   std::unique_ptr<ENCRYPTO::ObliviousTransfer::GOT128Receiver> ot_receiver_;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbler_input_keys_future_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
   ENCRYPTO::block128_vector garbler_input_keys_;
   ENCRYPTO::block128_vector evaluator_input_keys_;
-  ENCRYPTO::block128_vector garbled_tables_;
   const ENCRYPTO::AlgorithmDescription& addition_algo_;
 };
 
@@ -137,7 +137,7 @@ class YaoToArithmeticGMWTensorConversionEvaluator : public NewGate {
   const YaoTensorCP input_;
   gmw::ArithmeticGMWTensorP<T> output_;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbler_input_keys_future_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> output_info_future_;
   const ENCRYPTO::AlgorithmDescription& addition_algo_;
 };
@@ -223,10 +223,9 @@ class ArithmeticBEAVYToYaoTensorConversionEvaluator : public NewGate {
   YaoTensorP output_;
   std::unique_ptr<ENCRYPTO::ObliviousTransfer::FixedXCOT128Receiver> ot_receiver_;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbler_input_keys_future_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
   ENCRYPTO::block128_vector garbler_input_keys_;
   ENCRYPTO::block128_vector evaluator_input_keys_;
-  ENCRYPTO::block128_vector garbled_tables_;
   const ENCRYPTO::AlgorithmDescription& addition_algo_;
 };
 
@@ -272,7 +271,7 @@ class YaoToArithmeticBEAVYTensorConversionEvaluator : public NewGate {
   const YaoTensorCP input_;
   beavy::ArithmeticBEAVYTensorP<T> output_;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbler_input_keys_future_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
   ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> output_info_future_;
   std::vector<T> masked_value_secret_share_;
   std::vector<T> masked_value_public_share_;
@@ -331,7 +330,6 @@ class YaoTensorReluGarbler : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::block128_vector garbled_tables_;
   const ENCRYPTO::AlgorithmDescription& relu_algo_;
 };
 
@@ -350,8 +348,8 @@ class YaoTensorReluEvaluator : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
   const ENCRYPTO::AlgorithmDescription& relu_algo_;
+  std::vector<ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>> garbled_tables_futures_;
 };
 
 class YaoTensorMaxPoolGarbler : public NewGate {
@@ -392,7 +390,7 @@ class YaoTensorMaxPoolEvaluator : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
   const ENCRYPTO::AlgorithmDescription& maxpool_algo_;
 };
 
@@ -434,8 +432,55 @@ class YaoTensorGTEvaluator : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
   const ENCRYPTO::AlgorithmDescription& maxpool_algo_;
 };
 
+class YaoTensorArgMaxGarbler : public NewGate {
+ public:
+  YaoTensorArgMaxGarbler(std::size_t gate_id, YaoProvider&, tensor::ArgMaxOp,
+                         const YaoTensorCP input, bool with_max);
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return false; }
+  void evaluate_setup() override;
+  void evaluate_online() override {}
+  YaoTensorCP get_index_tensor() const noexcept { return index_; }
+  // nullptr if the maximum is not computed
+  YaoTensorCP get_max_tensor() const noexcept { return max_; }
+
+ private:
+  YaoProvider& yao_provider_;
+  const tensor::ArgMaxOp argmax_op_;
+  const std::size_t bit_size_;
+  const std::size_t output_size_;
+  const YaoTensorCP input_;
+  const YaoTensorP index_;
+  const YaoTensorP max_;
+  const ENCRYPTO::AlgorithmDescription& argmax_algo_;
+};
+
+class YaoTensorArgMaxEvaluator : public NewGate {
+ public:
+  YaoTensorArgMaxEvaluator(std::size_t gate_id, YaoProvider&, tensor::ArgMaxOp,
+                           const YaoTensorCP input, bool with_max);
+  bool need_setup() const noexcept override { return false; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override {}
+  void evaluate_online() override;
+  YaoTensorCP get_index_tensor() const noexcept { return index_; }
+  // nullptr if the maximum is not computed
+  YaoTensorCP get_max_tensor() const noexcept { return max_; }
+
+ private:
+  YaoProvider& yao_provider_;
+  const tensor::ArgMaxOp argmax_op_;
+  const std::size_t bit_size_;
+  const std::size_t output_size_;
+  const YaoTensorCP input_;
+  const YaoTensorP index_;
+  const YaoTensorP max_;
+  const ENCRYPTO::AlgorithmDescription& argmax_algo_;
+  ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload> garbled_tables_future_;
+};
+
 }  // namespace MOTION::proto::yao
@@ -104,4 +104,25 @@ void maxpool_rearrange_keys_out(ENCRYPTO::block128_vector& dst,
           .shuffle(Eigen::array<Eigen::Index, 4>{0, 3, 2, 1});
 }
 
+void argmax_rearrange_keys_in(ENCRYPTO::block128_vector& dst,
+                              const ENCRYPTO::block128_vector& src, std::size_t bit_size,
+                              const tensor::ArgMaxOp& argmax_op) {
+  const auto num_candidates = argmax_op.compute_num_candidates();
+  const auto input_size = argmax_op.compute_input_size();
+  const auto output_size = argmax_op.compute_output_size();
+  if (src.size() != bit_size * input_size) {
+    throw std::invalid_argument("vector size mismatch");
+  }
+  dst.resize(num_candidates * bit_size * output_size);
+  for (std::size_t candidate_i = 0; candidate_i < num_candidates; ++candidate_i) {
+    for (std::size_t bit_j = 0; bit_j < bit_size; ++bit_j) {
+      auto* dst_wire = &dst[(candidate_i * bit_size + bit_j) * output_size];
+      const auto* src_bit = &src[bit_j * input_size];
+      for (std::size_t output_k = 0; output_k < output_size; ++output_k) {
+        dst_wire[output_k] = src_bit[argmax_op.compute_input_index(output_k, candidate_i)];
+      }
+    }
+  }
+}
+
 }  // namespace MOTION::proto::yao
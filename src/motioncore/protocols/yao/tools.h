@@ -28,6 +28,7 @@
 #include "utility/block.h"
 
 namespace MOTION::tensor {
+struct ArgMaxOp;
 struct MaxPoolOp;
 }
 
@@ -47,4 +48,10 @@ void maxpool_rearrange_keys_out(ENCRYPTO::block128_vector& dst,
                                 const ENCRYPTO::block128_vector& keys, std::size_t bit_size,
                                 const tensor::MaxPoolOp&);
 
+// Arrange the keys s.t. candidate i of every output becomes the i-th input of
+// the argmax circuit, the outputs are used as SIMD dimension.
+void argmax_rearrange_keys_in(ENCRYPTO::block128_vector& dst,
+                              const ENCRYPTO::block128_vector& keys, std::size_t bit_size,
+                              const tensor::ArgMaxOp&);
+
 }  // namespace MOTION::proto::yao
@@ -23,7 +23,9 @@
 #include "yao_provider.h"
 
 #include <fmt/format.h>
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 
 #include "algorithm/circuit_loader.h"
@@ -430,6 +432,20 @@ ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> YaoProvider::register_f
   return CommMixin::register_for_blocks_message(1 - my_id_, gate_id, num_blocks);
 }
 
+ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+YaoProvider::register_for_blocks_message_view(std::size_t gate_id, std::size_t num_blocks) {
+  return CommMixin::register_for_blocks_message_view(1 - my_id_, gate_id, num_blocks);
+}
+
+const ENCRYPTO::block128_t* YaoProvider::get_blocks(const Communication::ReceivedPayload& payload,
+                                                    ENCRYPTO::block128_vector& buffer) {
+  if (payload.is_aligned_for<ENCRYPTO::block128_t>()) {
+    return payload.data_as<ENCRYPTO::block128_t>();
+  }
+  buffer = ENCRYPTO::block128_vector(payload.size_as<ENCRYPTO::block128_t>(), payload.data());
+  return buffer.data();
+}
+
 ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> YaoProvider::register_for_bits_message(
     std::size_t gate_id, std::size_t num_bits) {
   return CommMixin::register_for_bits_message(1 - my_id_, gate_id, num_bits);
@@ -462,7 +478,7 @@ void YaoProvider::create_garbled_circuit(std::size_t gate_id, std::size_t num_si
                                          bool parallel) const {
   assert(hg_garbler_);
   hg_garbler_->garble_circuit(output_keys, tables, gate_id, input_keys_a, input_keys_b, num_simd,
-                              algo, parallel);
+                              algo, parallel, &circuit_loader_.get_wire_slot_allocation(algo));
 }
 
 void YaoProvider::evaluate_garbled_circuit(std::size_t gate_id, std::size_t num_simd,
@@ -474,7 +490,79 @@ void YaoProvider::evaluate_garbled_circuit(std::size_t gate_id, std::size_t num_
                                            bool parallel) const {
   assert(hg_evaluator_);
   hg_evaluator_->evaluate_circuit(output_keys, tables, gate_id, input_keys_a, input_keys_b,
-                                  num_simd, algo, parallel);
+                                  num_simd, algo, parallel,
+                                  &circuit_loader_.get_wire_slot_allocation(algo));
+}
+
+void YaoProvider::evaluate_garbled_circuit(std::size_t gate_id, std::size_t num_simd,
+                                           const ENCRYPTO::AlgorithmDescription& algo,
+                                           const ENCRYPTO::block128_vector& input_keys_a,
+                                           const ENCRYPTO::block128_vector& input_keys_b,
+                                           const Communication::ReceivedPayload& tables,
+                                           ENCRYPTO::block128_vector& output_keys,
+                                           bool parallel) const {
+  assert(hg_evaluator_);
+  ENCRYPTO::block128_vector buffer;
+  hg_evaluator_->evaluate_circuit(output_keys, get_blocks(tables, buffer), gate_id, input_keys_a,
+                                  input_keys_b, num_simd, algo, parallel,
+                                  &circuit_loader_.get_wire_slot_allocation(algo));
+}
+
+std::size_t YaoProvider::get_num_and_gates_per_chunk(std::size_t num_simd) const noexcept {
+  return std::max(std::size_t(1), garbled_tables_chunk_size / (garbled_table_size * num_simd));
+}
+
+std::vector<ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>>
+YaoProvider::register_for_garbled_circuit_chunks(std::size_t gate_id, std::size_t num_simd,
+                                                 const ENCRYPTO::AlgorithmDescription& algo) {
+  const auto num_and_gates = Crypto::garbling::get_num_and_gates(algo);
+  const auto num_and_gates_per_chunk = get_num_and_gates_per_chunk(num_simd);
+  std::vector<ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>> futures;
+  for (std::size_t and_j = 0, chunk_i = 0; and_j < num_and_gates;
+       and_j += num_and_gates_per_chunk, ++chunk_i) {
+    const auto chunk_size = std::min(num_and_gates_per_chunk, num_and_gates - and_j);
+    futures.emplace_back(CommMixin::register_for_blocks_message_view(
+        1 - my_id_, gate_id, garbled_table_size * chunk_size * num_simd, chunk_i));
+  }
+  return futures;
+}
+
+void YaoProvider::create_garbled_circuit_streaming(std::size_t gate_id, std::size_t num_simd,
+                                                   const ENCRYPTO::AlgorithmDescription& algo,
+                                                   const ENCRYPTO::block128_vector& input_keys_a,
+                                                   const ENCRYPTO::block128_vector& input_keys_b,
+                                                   ENCRYPTO::block128_vector& output_keys,
+                                                   bool parallel) const {
+  assert(hg_garbler_);
+  hg_garbler_->garble_circuit_streaming(
+      output_keys, gate_id, input_keys_a, input_keys_b, num_simd, algo,
+      get_num_and_gates_per_chunk(num_simd),
+      [this, gate_id](auto chunk_i, auto&& chunk) {
+        CommMixin::send_blocks_message(1 - my_id_, gate_id, chunk, chunk_i);
+      },
+      parallel, &circuit_loader_.get_wire_slot_allocation(algo));
+}
+
+void YaoProvider::evaluate_garbled_circuit_streaming(
+    std::size_t gate_id, std::size_t num_simd, const ENCRYPTO::AlgorithmDescription& algo,
+    const ENCRYPTO::block128_vector& input_keys_a, const ENCRYPTO::block128_vector& input_keys_b,
+    std::vector<ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>>& chunk_futures,
+    ENCRYPTO::block128_vector& output_keys, bool parallel) const {
+  assert(hg_evaluator_);
+  // the current chunk is kept in its receive buffer until the next one is requested
+  Communication::ReceivedPayload chunk;
+  ENCRYPTO::block128_vector buffer;
+  hg_evaluator_->evaluate_circuit_streaming(
+      output_keys, gate_id, input_keys_a, input_keys_b, num_simd, algo,
+      get_num_and_gates_per_chunk(num_simd),
+      [&](auto chunk_i, auto num_blocks) {
+        chunk = chunk_futures.at(chunk_i).get();
+        if (chunk.size_as<ENCRYPTO::block128_t>() != num_blocks) {
+          throw std::runtime_error("garbled tables chunk has wrong size");
+        }
+        return get_blocks(chunk, buffer);
+      },
+      parallel, &circuit_loader_.get_wire_slot_allocation(algo));
 }
 
 static std::vector<std::shared_ptr<NewWire>> cast_wires(gmw::BooleanGMWWireVector&& wires) {
@@ -1132,4 +1220,24 @@ tensor::TensorCP YaoProvider::make_tensor_gt_op(const tensor::MaxPoolOp& maxpool
   return output;
 }
 
+std::pair<tensor::TensorCP, tensor::TensorCP> YaoProvider::make_tensor_argmax_op(
+    const tensor::ArgMaxOp& argmax_op, const tensor::TensorCP in, bool with_max) {
+  const auto input_tensor = std::dynamic_pointer_cast<const YaoTensor>(in);
+  assert(input_tensor != nullptr);
+  auto gate_id = gate_register_.get_next_gate_id();
+  std::pair<tensor::TensorCP, tensor::TensorCP> output;
+  if (role_ == Role::garbler) {
+    auto tensor_op = std::make_unique<YaoTensorArgMaxGarbler>(gate_id, *this, argmax_op,
+                                                              input_tensor, with_max);
+    output = {tensor_op->get_index_tensor(), tensor_op->get_max_tensor()};
+    gate_register_.register_gate(std::move(tensor_op));
+  } else {
+    auto tensor_op = std::make_unique<YaoTensorArgMaxEvaluator>(gate_id, *this, argmax_op,
+                                                                input_tensor, with_max);
+    output = {tensor_op->get_index_tensor(), tensor_op->get_max_tensor()};
+    gate_register_.register_gate(std::move(tensor_op));
+  }
+  return output;
+}
+
 }  // namespace MOTION::proto::yao
@@ -142,6 +142,14 @@ class YaoProvider : public GateFactory,
   void send_bits_message(std::size_t gate_id, const ENCRYPTO::BitVector<>& message) const;
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>
   register_for_blocks_message(std::size_t gate_id, std::size_t num_blocks);
+  // the garbled tables are evaluated straight from the receive buffer, see
+  // CommMixin::register_for_blocks_message_view
+  [[nodiscard]] ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>
+  register_for_blocks_message_view(std::size_t gate_id, std::size_t num_blocks);
+  // Pointer to the blocks of a received message.  If the payload is not
+  // aligned, the blocks are copied into buffer first.
+  static const ENCRYPTO::block128_t* get_blocks(const Communication::ReceivedPayload& payload,
+                                                ENCRYPTO::block128_vector& buffer);
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> register_for_bits_message(
       std::size_t gate_id, std::size_t num_bits);
   void create_garbled_tables(std::size_t gate_id, const ENCRYPTO::block128_vector& keys_a,
@@ -163,7 +171,32 @@ class YaoProvider : public GateFactory,
                                 const ENCRYPTO::block128_vector& input_keys_b,
                                 const ENCRYPTO::block128_vector& tables,
                                 ENCRYPTO::block128_vector& keys_out, bool parallel = false) const;
+  void evaluate_garbled_circuit(std::size_t gate_id, std::size_t num_simd,
+                                const ENCRYPTO::AlgorithmDescription&,
+                                const ENCRYPTO::block128_vector& input_keys_a,
+                                const ENCRYPTO::block128_vector& input_keys_b,
+                                const Communication::ReceivedPayload& tables,
+                                ENCRYPTO::block128_vector& keys_out, bool parallel = false) const;
+  // Streaming variants: the garbler sends the tables in chunks of roughly
+  // garbled_tables_chunk_size blocks while garbling, the evaluator consumes the
+  // chunks as they arrive.  Chunk i is sent as message i of the gate.
+  std::size_t get_num_and_gates_per_chunk(std::size_t num_simd) const noexcept;
+  [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>>
+  register_for_garbled_circuit_chunks(std::size_t gate_id, std::size_t num_simd,
+                                      const ENCRYPTO::AlgorithmDescription&);
+  void create_garbled_circuit_streaming(std::size_t gate_id, std::size_t num_simd,
+                                        const ENCRYPTO::AlgorithmDescription&,
+                                        const ENCRYPTO::block128_vector& input_keys_a,
+                                        const ENCRYPTO::block128_vector& input_keys_b,
+                                        ENCRYPTO::block128_vector& keys_out,
+                                        bool parallel = false) const;
+  void evaluate_garbled_circuit_streaming(
+      std::size_t gate_id, std::size_t num_simd, const ENCRYPTO::AlgorithmDescription&,
+      const ENCRYPTO::block128_vector& input_keys_a, const ENCRYPTO::block128_vector& input_keys_b,
+      std::vector<ENCRYPTO::ReusableFiberFuture<Communication::ReceivedPayload>>& chunk_futures,
+      ENCRYPTO::block128_vector& keys_out, bool parallel = false) const;
   constexpr static std::size_t garbled_table_size = 2;
+  constexpr static std::size_t garbled_tables_chunk_size = 1 << 14;
 
   Crypto::MotionBaseProvider& get_motion_base_provider() const noexcept {
     return motion_base_provider_;
@@ -216,6 +249,8 @@ class YaoProvider : public GateFactory,
                                           const tensor::TensorCP) override;
   tensor::TensorCP make_tensor_gt_op(const tensor::MaxPoolOp&,
                                           const tensor::TensorCP) override;
+  std::pair<tensor::TensorCP, tensor::TensorCP> make_tensor_argmax_op(
+      const tensor::ArgMaxOp&, const tensor::TensorCP, bool with_max = false) override;
 
  private:
   Communication::CommunicationLayer& communication_layer_;
@@ -49,6 +49,15 @@ void AccumulatedRunTimeStats::add(const RunTimeStats& stats) {
   for (std::size_t i = 0; i <= static_cast<std::size_t>(RunTimeStats::StatID::MAX); ++i) {
     accumulators_[i](compute_duration(stats.data_[i]));
   }
+  if (gate_accumulators_.size() < stats.gate_stats_.size()) {
+    gate_accumulators_.resize(stats.gate_stats_.size());
+    gate_ids_.resize(stats.gate_stats_.size());
+  }
+  for (std::size_t i = 0; i < stats.gate_stats_.size(); ++i) {
+    gate_ids_[i] = stats.gate_stats_[i].gate_id_;
+    gate_accumulators_[i][0](compute_duration(stats.gate_stats_[i].setup_));
+    gate_accumulators_[i][1](compute_duration(stats.gate_stats_[i].online_));
+  }
   ++count_;
 }
 
@@ -101,6 +110,15 @@ std::string AccumulatedRunTimeStats::print_human_readable() const {
      << format_line("Gates Online", unit, at(accumulators_, StatID::gates_online), field_width)
      << "---------------------------------------------------------------------------\n"
      << format_line("Circuit Evaluation", unit, at(accumulators_, StatID::evaluate), field_width);
+  if (!gate_accumulators_.empty()) {
+    ss << "---------------------------------------------------------------------------\n";
+    for (std::size_t i = 0; i < gate_accumulators_.size(); ++i) {
+      ss << format_line(fmt::format("Gate {:<6} Setup", gate_ids_[i]), unit,
+                        gate_accumulators_[i][0], field_width)
+         << format_line(fmt::format("Gate {:<6} Online", gate_ids_[i]), unit,
+                        gate_accumulators_[i][1], field_width);
+    }
+  }
 
   return ss.str();
 }
@@ -117,28 +135,42 @@ std::string AccumulatedRunTimeStats::print_human_readable_execution_time() const
 
 ///////////////////////////////////////////////////////////////////////
 
+static json::object to_json_triple(const AccumulatedRunTimeStats::accumulator_type& acc) {
+  return json::object({{"mean", boost::accumulators::mean(acc)},
+                       {"median", boost::accumulators::median(acc)},
+                       // uncorrected standard deviation
+                       {"stddev", std::sqrt(boost::accumulators::variance(acc))}});
+}
+
 json::object AccumulatedRunTimeStats::to_json() const {
   const auto mk_triple = [this](const auto& stat_id) {
     const auto& acc = at(accumulators_, stat_id);
     std::cout << "AccumulatedRunTimeStats"
               << "\n";
-    return json::object({{"mean", boost::accumulators::mean(acc)},
-                         {"median", boost::accumulators::median(acc)},
-                         // uncorrected standard deviation
-                         {"stddev", std::sqrt(boost::accumulators::variance(acc))}});
+    return to_json_triple(acc);
   };
   std::cout << "Print statistics:" << mk_triple(StatID::evaluate) << "\n";
-  return {{"repetitions", count_},
-          {"mt_setup", mk_triple(StatID::mt_setup)},
-          {"sp_setup", mk_triple(StatID::sp_setup)},
-          {"sb_setup", mk_triple(StatID::sb_setup)},
-          {"linalgtriple_setup", mk_triple(StatID::linalgtriple_setup)},
-          {"base_ots", mk_triple(StatID::base_ots)},
-          {"ot_extension_setup", mk_triple(StatID::ot_extension_setup)},
-          {"preprocessing", mk_triple(StatID::preprocessing)},
-          {"gates_setup", mk_triple(StatID::gates_setup)},
-          {"gates_online", mk_triple(StatID::gates_online)},
-          {"evaluate", mk_triple(StatID::evaluate)}};
+  json::object obj{{"repetitions", count_},
+                   {"mt_setup", mk_triple(StatID::mt_setup)},
+                   {"sp_setup", mk_triple(StatID::sp_setup)},
+                   {"sb_setup", mk_triple(StatID::sb_setup)},
+                   {"linalgtriple_setup", mk_triple(StatID::linalgtriple_setup)},
+                   {"base_ots", mk_triple(StatID::base_ots)},
+                   {"ot_extension_setup", mk_triple(StatID::ot_extension_setup)},
+                   {"preprocessing", mk_triple(StatID::preprocessing)},
+                   {"gates_setup", mk_triple(StatID::gates_setup)},
+                   {"gates_online", mk_triple(StatID::gates_online)},
+                   {"evaluate", mk_triple(StatID::evaluate)}};
+  if (!gate_accumulators_.empty()) {
+    json::array gates;
+    for (std::size_t i = 0; i < gate_accumulators_.size(); ++i) {
+      gates.push_back(json::object({{"gate_id", gate_ids_[i]},
+                                    {"setup", to_json_triple(gate_accumulators_[i][0])},
+                                    {"online", to_json_triple(gate_accumulators_[i][1])}}));
+    }
+    obj.emplace("gates", std::move(gates));
+  }
+  return obj;
 }
 
 void AccumulatedCommunicationStats::add(const Communication::TransportStatistics& stats) {
@@ -146,6 +178,10 @@ void AccumulatedCommunicationStats::add(const Communication::TransportStatistics
   accumulators_[idx_num_messages_received](stats.num_messages_received);
   accumulators_[idx_num_bytes_sent](stats.num_bytes_sent);
   accumulators_[idx_num_bytes_received](stats.num_bytes_received);
+  accumulators_[idx_num_bytes_before_compression](stats.num_bytes_before_compression);
+  accumulators_[idx_num_bytes_after_compression](stats.num_bytes_after_compression);
+  accumulators_[idx_compression_time_ns](stats.compression_time_ns);
+  accumulators_[idx_decompression_time_ns](stats.decompression_time_ns);
   ++count_;
 }
 
@@ -168,6 +204,14 @@ std::string AccumulatedCommunicationStats::print_human_readable() const {
                     boost::accumulators::mean(accumulators_[idx_num_bytes_received]) / 1048576,
                     static_cast<std::size_t>(
                         boost::accumulators::mean(accumulators_[idx_num_messages_received])));
+  if (boost::accumulators::mean(accumulators_[idx_num_bytes_before_compression]) > 0) {
+    ss << fmt::format(
+        "Compressed: {:0.3f} MiB to {:0.3f} MiB in {:0.3f} ms (decompressed in {:0.3f} ms)\n",
+        boost::accumulators::mean(accumulators_[idx_num_bytes_before_compression]) / 1048576,
+        boost::accumulators::mean(accumulators_[idx_num_bytes_after_compression]) / 1048576,
+        boost::accumulators::mean(accumulators_[idx_compression_time_ns]) / 1e6,
+        boost::accumulators::mean(accumulators_[idx_decompression_time_ns]) / 1e6);
+  }
   return ss.str();
 }
 
@@ -180,7 +224,15 @@ json::object AccumulatedCommunicationStats::to_json() const {
       {"bytes_received",
        static_cast<std::size_t>(boost::accumulators::mean(accumulators_[idx_num_bytes_received]))},
       {"num_messages_received", static_cast<std::size_t>(boost::accumulators::mean(
-                                    accumulators_[idx_num_messages_received]))}};
+                                    accumulators_[idx_num_messages_received]))},
+      {"bytes_before_compression", static_cast<std::size_t>(boost::accumulators::mean(
+                                       accumulators_[idx_num_bytes_before_compression]))},
+      {"bytes_after_compression", static_cast<std::size_t>(boost::accumulators::mean(
+                                      accumulators_[idx_num_bytes_after_compression]))},
+      {"compression_time_ms",
+       boost::accumulators::mean(accumulators_[idx_compression_time_ns]) / 1e6},
+      {"decompression_time_ms",
+       boost::accumulators::mean(accumulators_[idx_decompression_time_ns]) / 1e6}};
 }
 
 std::string print_motion_info() {
@@ -52,6 +52,10 @@ struct AccumulatedRunTimeStats {
   std::size_t count_ = 0;
   std::array<accumulator_type, static_cast<std::size_t>(RunTimeStats::StatID::MAX) + 1>
       accumulators_;
+  // setup and online phase of the i-th evaluated gate and its id (see
+  // RunTimeStats::gate_stats_)
+  std::vector<std::array<accumulator_type, 2>> gate_accumulators_;
+  std::vector<std::size_t> gate_ids_;
 
   void add(const RunTimeStats& stats);
   std::string print_human_readable() const;
@@ -69,9 +73,13 @@ struct AccumulatedCommunicationStats {
   static constexpr std::size_t idx_num_messages_received = 1;
   static constexpr std::size_t idx_num_bytes_sent = 2;
   static constexpr std::size_t idx_num_bytes_received = 3;
+  static constexpr std::size_t idx_num_bytes_before_compression = 4;
+  static constexpr std::size_t idx_num_bytes_after_compression = 5;
+  static constexpr std::size_t idx_compression_time_ns = 6;
+  static constexpr std::size_t idx_decompression_time_ns = 7;
 
   std::size_t count_ = 0;
-  std::array<accumulator_type, 4> accumulators_;
+  std::array<accumulator_type, 8> accumulators_;
 
   void add(const Communication::TransportStatistics& stats);
   void add(const std::vector<Communication::TransportStatistics>& stats);
@@ -63,6 +63,15 @@ std::string RunTimeStats::print_human_readable() const {
      << fmt::format("Gates Online        {:{}.3f} ms\n", at(ms, StatID::gates_online), width)
      << fmt::format("-------------------------\n")
      << fmt::format("Circuit Evaluation  {:{}.3f} ms\n", at(ms, StatID::evaluate), width);
+  if (!gate_stats_.empty()) {
+    ss << fmt::format("-------------------------\n");
+    for (const auto& gs : gate_stats_) {
+      ss << fmt::format("Gate {:<6} Setup   {:{}.3f} ms\n", gs.gate_id_, compute_ms(gs.setup_),
+                        width)
+         << fmt::format("Gate {:<6} Online  {:{}.3f} ms\n", gs.gate_id_, compute_ms(gs.online_),
+                        width);
+    }
+  }
   return ss.str();
 }
 
@@ -26,6 +26,7 @@
 #include <chrono>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace MOTION {
 namespace Statistics {
@@ -71,6 +72,16 @@ struct RunTimeStats {
   std::string print_human_readable() const;
 
   std::array<time_point_pair, static_cast<std::size_t>(StatID::MAX) + 1> data_;
+
+  // Setup and online phase of each evaluated gate in the order of the gate
+  // ids.  A layer of a tensor network may consist of several gates, e.g., a
+  // conversion followed by the actual operation.
+  struct GateStats {
+    std::size_t gate_id_;
+    time_point_pair setup_;
+    time_point_pair online_;
+  };
+  std::vector<GateStats> gate_stats_;
 };
 
 }  // namespace Statistics
@@ -401,6 +401,75 @@ TensorDimensions GTOp::get_output_tensor_dims() const noexcept {
           .width_ = output_shape_[2]};
 }
 
+bool ArgMaxOp::verify() const noexcept {
+  bool result = axis_ < 3;
+  result = result && input_shape_[axis_] >= 2;
+  result = result && (output_shape_ == compute_output_shape());
+  return result;
+}
+
+std::array<std::size_t, 3> ArgMaxOp::compute_output_shape() const noexcept {
+  auto output_shape = input_shape_;
+  if (axis_ < 3) {
+    output_shape[axis_] = 1;
+  }
+  return output_shape;
+}
+
+std::size_t ArgMaxOp::compute_num_candidates() const noexcept {
+  assert(verify());
+  return input_shape_[axis_];
+}
+
+std::size_t ArgMaxOp::compute_index_bits() const noexcept {
+  assert(verify());
+  std::size_t index_bits = 0;
+  while ((std::size_t(1) << index_bits) < input_shape_[axis_]) {
+    ++index_bits;
+  }
+  return index_bits;
+}
+
+std::size_t ArgMaxOp::compute_input_size() const noexcept {
+  assert(verify());
+  return input_shape_[0] * input_shape_[1] * input_shape_[2];
+}
+
+std::size_t ArgMaxOp::compute_output_size() const noexcept {
+  assert(verify());
+  return output_shape_[0] * output_shape_[1] * output_shape_[2];
+}
+
+std::size_t ArgMaxOp::compute_input_index(std::size_t output_i,
+                                          std::size_t candidate_i) const noexcept {
+  assert(output_i < compute_output_size());
+  assert(candidate_i < compute_num_candidates());
+  // number of elements between two consecutive positions along the axis
+  std::size_t stride = 1;
+  for (std::size_t i = axis_ + 1; i < 3; ++i) {
+    stride *= input_shape_[i];
+  }
+  const auto outer = output_i / stride;
+  const auto inner = output_i % stride;
+  return (outer * input_shape_[axis_] + candidate_i) * stride + inner;
+}
+
+TensorDimensions ArgMaxOp::get_input_tensor_dims() const noexcept {
+  assert(verify());
+  return {.batch_size_ = 1,
+          .num_channels_ = input_shape_[0],
+          .height_ = input_shape_[1],
+          .width_ = input_shape_[2]};
+}
+
+TensorDimensions ArgMaxOp::get_output_tensor_dims() const noexcept {
+  assert(verify());
+  return {.batch_size_ = 1,
+          .num_channels_ = output_shape_[0],
+          .height_ = output_shape_[1],
+          .width_ = output_shape_[2]};
+}
+
 }  // namespace MOTION::tensor
 
 namespace std {
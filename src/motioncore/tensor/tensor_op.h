@@ -140,6 +140,25 @@ struct GTOp {
   TensorDimensions get_output_tensor_dims() const noexcept;
 };
 
+// Reduces a tensor along one of the axes of input_shape_ (channels, rows,
+// columns) to the position and the value of the maximum.
+struct ArgMaxOp {
+  std::array<std::size_t, 3> input_shape_;
+  std::array<std::size_t, 3> output_shape_;
+  std::size_t axis_;
+
+  bool verify() const noexcept;
+  std::array<std::size_t, 3> compute_output_shape() const noexcept;
+  std::size_t compute_num_candidates() const noexcept;
+  std::size_t compute_index_bits() const noexcept;
+  std::size_t compute_input_size() const noexcept;
+  std::size_t compute_output_size() const noexcept;
+  // position in the input of the candidate `candidate_i` of output `output_i`
+  std::size_t compute_input_index(std::size_t output_i, std::size_t candidate_i) const noexcept;
+  TensorDimensions get_input_tensor_dims() const noexcept;
+  TensorDimensions get_output_tensor_dims() const noexcept;
+};
+
 }  // namespace MOTION::tensor
 
 namespace std {
@@ -113,6 +113,21 @@ tensor::TensorCP TensorOpFactory::make_tensor_gemm_op(const tensor::GemmOp&, con
       fmt::format("{} does not support the Gemm operation", get_provider_name()));
 }
 
+tensor::TensorCP TensorOpFactory::make_tensor_gemm_op(const tensor::GemmOp&,
+                                                      const std::vector<std::uint64_t>&,
+                                                      const tensor::TensorCP, std::size_t) {
+  throw std::logic_error(
+      fmt::format("{} does not support the Gemm operation with public input", get_provider_name()));
+}
+
+tensor::TensorCP TensorOpFactory::make_tensor_dense_op(const tensor::GemmOp&,
+                                                       const tensor::TensorCP,
+                                                       const tensor::TensorCP,
+                                                       const tensor::TensorCP, std::size_t, bool) {
+  throw std::logic_error(
+      fmt::format("{} does not support the Dense operation", get_provider_name()));
+}
+
 tensor::TensorCP TensorOpFactory::make_tensor_sqr_op(const tensor::TensorCP, std::size_t) {
   throw std::logic_error(fmt::format("{} does not support the Sqr operation", get_provider_name()));
 }
@@ -167,6 +182,12 @@ tensor::TensorCP TensorOpFactory::make_tensor_gt_op(const tensor::MaxPoolOp&,
       fmt::format("{} does not support the GT operation", get_provider_name()));
 }
 
+std::pair<tensor::TensorCP, tensor::TensorCP> TensorOpFactory::make_tensor_argmax_op(
+    const tensor::ArgMaxOp&, const tensor::TensorCP, bool) {
+  throw std::logic_error(
+      fmt::format("{} does not support the ArgMax operation", get_provider_name()));
+}
+
 tensor::TensorCP TensorOpFactory::make_tensor_join_op(const tensor::JoinOp&, const tensor::TensorCP,
                                                       const tensor::TensorCP, std::size_t) {
   throw std::logic_error(
@@ -86,6 +86,20 @@ class TensorOpFactory {
                                                const tensor::TensorCP input_A,
                                                const tensor::TensorCP input_B,
                                                std::size_t truncate_bits = 0);
+  // input_A is a public matrix known to both parties.  Its values are reduced to the bit size of
+  // input_B and need to be given as unsigned or sign-extended values of that bit size, otherwise
+  // std::invalid_argument is thrown.
+  virtual tensor::TensorCP make_tensor_gemm_op(const tensor::GemmOp& gemm_op,
+                                               const std::vector<std::uint64_t>& input_A,
+                                               const tensor::TensorCP input_B,
+                                               std::size_t truncate_bits = 0);
+  // computes input_A * input_B + bias (negated if negate_output is set) in one operation
+  virtual tensor::TensorCP make_tensor_dense_op(const tensor::GemmOp& gemm_op,
+                                                const tensor::TensorCP input_A,
+                                                const tensor::TensorCP input_B,
+                                                const tensor::TensorCP bias,
+                                                std::size_t truncate_bits = 0,
+                                                bool negate_output = false);
   virtual tensor::TensorCP make_tensor_sqr_op(const tensor::TensorCP input,
                                               std::size_t truncate_bits = 0);
   virtual tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP input);
@@ -102,6 +116,9 @@ class TensorOpFactory {
   virtual std::vector<tensor::TensorCP> make_tensor_split_op(const tensor::TensorCP);
   virtual tensor::TensorCP make_tensor_gt_op(const tensor::MaxPoolOp& maxpool_op,
                                                   const tensor::TensorCP input);
+  // returns the index of the maximum along the axis and, if with_max is set, the maximum
+  virtual std::pair<tensor::TensorCP, tensor::TensorCP> make_tensor_argmax_op(
+      const tensor::ArgMaxOp& argmax_op, const tensor::TensorCP input, bool with_max = false);
   virtual tensor::TensorCP make_tensor_join_op(const tensor::JoinOp& join_op,
                                                const tensor::TensorCP input_A,
                                                const tensor::TensorCP input_B,
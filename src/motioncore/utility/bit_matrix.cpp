@@ -26,9 +26,12 @@
 
 #include <immintrin.h>
 #include <omp.h>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
+#include "cpu_features.h"
 #include "crypto/pseudo_random_generator.h"
 #include "helpers.h"
 
@@ -248,16 +251,13 @@ std::string BitMatrix::AsString() const {
 void BitMatrix::Transpose128RowsInplace(std::array<std::byte*, 128>& matrix,
                                         std::size_t num_columns) {
   constexpr std::size_t blk_size = 128;
+  alignas(64) std::array<std::byte, blk_size * blk_size / 8> block;
   for (auto blk_offset = 0u; blk_offset < num_columns; blk_offset += blk_size) {
-    std::array<std::uint64_t*, blk_size> rows_64;
-    std::array<std::uint32_t*, blk_size> rows_32;
-
+    Transpose128x128Block(matrix.data(), blk_offset, block.data());
     for (auto i = 0u; i < blk_size; ++i) {
-      rows_64.at(i) = reinterpret_cast<std::uint64_t*>(matrix.at(i) + (blk_offset >> 3));
-      rows_32.at(i) = reinterpret_cast<std::uint32_t*>(matrix.at(i) + (blk_offset >> 3));
+      std::copy_n(block.data() + i * (blk_size / 8), blk_size / 8,
+                  matrix.at(i) + (blk_offset >> 3));
     }
-
-    Transpose128x128InPlace(rows_64, rows_32);
   }
 }
 
@@ -368,7 +368,7 @@ void BitMatrix::Transpose128x128InPlace(std::array<std::uint64_t*, 128>& rows_64
   }
 }
 
-// BitMatrix::TransposeUsingBitSlicing(...)
+// BitMatrix::Transpose128x128Block*(...) and BitMatrix::TransposeUsingBitSlicing(...)
 //
 // MIT License
 //
@@ -395,91 +395,138 @@ void BitMatrix::Transpose128x128InPlace(std::array<std::uint64_t*, 128>& rows_64
 // Enquiries about further applications and development opportunities are
 // welcome.
 
-void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix, std::size_t ncols) {
-#define INP(r, c)                                     \
-  reinterpret_cast<const std::uint8_t* __restrict__>( \
-      __builtin_assume_aligned(matrix.at(r), 16))[c / 8]
-#define OUT(r, c) out[(r)*nrows / 8 + (c) / 8]
+namespace {
+
+// Defines a function which transposes the 16 x 16 bytes in x[0], ..., x[15] (independently in
+// each 128 bit lane), s.t. byte k of x[j] is afterwards the byte j of x[k].
+#define MOTION_DEFINE_TRANSPOSE_16X16_BYTES(NAME, TARGET, VEC, PREFIX)                     \
+  __attribute__((target(TARGET))) inline void NAME(VEC* x) {                               \
+    VEC a[16], b[16];                                                                      \
+    for (std::size_t p = 0; p < 8; ++p) {                                                  \
+      a[2 * p] = PREFIX##_unpacklo_epi8(x[2 * p], x[2 * p + 1]);                           \
+      a[2 * p + 1] = PREFIX##_unpackhi_epi8(x[2 * p], x[2 * p + 1]);                       \
+    }                                                                                      \
+    for (std::size_t q = 0; q < 4; ++q) {                                                  \
+      b[4 * q] = PREFIX##_unpacklo_epi16(a[4 * q], a[4 * q + 2]);                          \
+      b[4 * q + 1] = PREFIX##_unpackhi_epi16(a[4 * q], a[4 * q + 2]);                      \
+      b[4 * q + 2] = PREFIX##_unpacklo_epi16(a[4 * q + 1], a[4 * q + 3]);                  \
+      b[4 * q + 3] = PREFIX##_unpackhi_epi16(a[4 * q + 1], a[4 * q + 3]);                  \
+    }                                                                                      \
+    for (std::size_t h = 0; h < 2; ++h) {                                                  \
+      for (std::size_t m = 0; m < 4; ++m) {                                                \
+        a[8 * h + 2 * m] = PREFIX##_unpacklo_epi32(b[8 * h + m], b[8 * h + 4 + m]);        \
+        a[8 * h + 2 * m + 1] = PREFIX##_unpackhi_epi32(b[8 * h + m], b[8 * h + 4 + m]);    \
+      }                                                                                    \
+    }                                                                                      \
+    for (std::size_t n = 0; n < 8; ++n) {                                                  \
+      x[2 * n] = PREFIX##_unpacklo_epi64(a[n], a[8 + n]);                                  \
+      x[2 * n + 1] = PREFIX##_unpackhi_epi64(a[n], a[8 + n]);                              \
+    }                                                                                      \
+  }
+
+MOTION_DEFINE_TRANSPOSE_16X16_BYTES(transpose_16x16_bytes_sse, "sse2", __m128i, _mm)
+MOTION_DEFINE_TRANSPOSE_16X16_BYTES(transpose_16x16_bytes_avx2, "avx2", __m256i, _mm256)
+MOTION_DEFINE_TRANSPOSE_16X16_BYTES(transpose_16x16_bytes_avx512, "avx512f,avx512bw", __m512i,
+                                    _mm512)
+
+#undef MOTION_DEFINE_TRANSPOSE_16X16_BYTES
+
+inline const __m128i* load_ptr(const std::byte* row, std::size_t column) {
+  return reinterpret_cast<const __m128i*>(row + column / 8);
+}
 
-  constexpr std::uint64_t nrows = 128;
-  std::vector<std::byte, boost::alignment::aligned_allocator<std::byte, 16>> out(
-      ((nrows * ncols) + 7) / 8, std::byte{0});
+}  // namespace
 
-  uint64_t rr, cc;
-  int i;
-
-  assert(nrows % 8 == 0 && ncols % 8 == 0);
-
-  // constexpr auto block_size = nrows * nrows;
-  // const auto num_blocks = nrows * ncols / block_size;
-
-//#define MOTION_AVX2
-#if defined(MOTION_AVX512)
-  // TODO: not tested yet
-  __m512i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 8) {
-    for (cc = 0; cc < ncols; cc += 64) {
-      vec = _mm512_set_epi8(
-          INP(rr + 56, cc), INP(rr + 57, cc), INP(rr + 58, cc), INP(rr + 59, cc), INP(rr + 60, cc),
-          INP(rr + 61, cc), INP(rr + 62, cc), INP(rr + 63, cc), INP(rr + 48, cc), INP(rr + 49, cc),
-          INP(rr + 50, cc), INP(rr + 51, cc), INP(rr + 52, cc), INP(rr + 53, cc), INP(rr + 54, cc),
-          INP(rr + 55, cc), INP(rr + 39, cc), INP(rr + 40, cc), INP(rr + 41, cc), INP(rr + 42, cc),
-          INP(rr + 43, cc), INP(rr + 44, cc), INP(rr + 45, cc), INP(rr + 46, cc), INP(rr + 32, cc),
-          INP(rr + 33, cc), INP(rr + 34, cc), INP(rr + 35, cc), INP(rr + 36, cc), INP(rr + 37, cc),
-          INP(rr + 38, cc), INP(rr + 39, cc), INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc),
-          INP(rr + 27, cc), INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-          INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc), INP(rr + 20, cc),
-          INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc), INP(rr + 8, cc), INP(rr + 9, cc),
-          INP(rr + 10, cc), INP(rr + 11, cc), INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc),
-          INP(rr + 15, cc), INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-          INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 64; vec = _mm512_slli_epi64(vec, 1), ++i) {
-        OUT(cc + i, rr) = _mm512_movepi64_mask(vec);
+// After transposing the bytes, byte k of x[j] contains the bits of the columns column + 8j, ...,
+// column + 8j + 7 in row r + k.  Then the movemask instructions collect the most significant bits
+// of all rows, i.e., the bits of column column + 8j + 7, and so on.
+
+void BitMatrix::Transpose128x128BlockSSE(const std::byte* const* rows, std::size_t column,
+                                         std::byte* out) {
+  assert(column % 128 == 0);
+  __m128i x[16];
+  for (std::size_t r = 0; r < 128; r += 16) {
+    for (std::size_t k = 0; k < 16; ++k) {
+      x[k] = _mm_loadu_si128(load_ptr(rows[r + k], column));
+    }
+    transpose_16x16_bytes_sse(x);
+    for (std::size_t j = 0; j < 16; ++j) {
+      for (std::size_t i = 8; i > 0; x[j] = _mm_slli_epi64(x[j], 1), --i) {
+        const auto mask = static_cast<std::uint16_t>(_mm_movemask_epi8(x[j]));
+        std::memcpy(out + 16 * (8 * j + i - 1) + r / 8, &mask, sizeof(mask));
       }
     }
   }
-#elif defined(MOTION_AVX2)
-  __m256i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 32) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      vec = _mm256_set_epi8(INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc), INP(rr + 27, cc),
-                            INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-                            INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc),
-                            INP(rr + 20, cc), INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc),
-                            INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-                            INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-                            INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-                            INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
-        *(uint32_t*)&OUT(cc + i, rr) = _mm256_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
+}
+
+__attribute__((target("avx2"))) void BitMatrix::Transpose128x128BlockAVX2(
+    const std::byte* const* rows, std::size_t column, std::byte* out) {
+  assert(column % 128 == 0);
+  __m256i x[16];
+  // the two lanes contain the rows r, ..., r + 15 and r + 16, ..., r + 31
+  for (std::size_t r = 0; r < 128; r += 32) {
+    for (std::size_t k = 0; k < 16; ++k) {
+      x[k] = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128(load_ptr(rows[r + k], column))),
+          _mm_loadu_si128(load_ptr(rows[r + 16 + k], column)), 1);
+    }
+    transpose_16x16_bytes_avx2(x);
+    for (std::size_t j = 0; j < 16; ++j) {
+      for (std::size_t i = 8; i > 0; x[j] = _mm256_slli_epi64(x[j], 1), --i) {
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(x[j]));
+        std::memcpy(out + 16 * (8 * j + i - 1) + r / 8, &mask, sizeof(mask));
       }
     }
   }
-#else
-  __m128i vec;
-  // Do the main body in 16x8 blocks:
-  for (rr = 0; rr <= nrows - 16; rr += 16) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      // vec = _mm_set_epi8(INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-      //                    INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-      //                    INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-      //                    INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      vec = _mm_set_epi8(INP(rr + 15, cc), INP(rr + 14, cc), INP(rr + 13, cc), INP(rr + 12, cc),
-                         INP(rr + 11, cc), INP(rr + 10, cc), INP(rr + 9, cc), INP(rr + 8, cc),
-                         INP(rr + 7, cc), INP(rr + 6, cc), INP(rr + 5, cc), INP(rr + 4, cc),
-                         INP(rr + 3, cc), INP(rr + 2, cc), INP(rr + 1, cc), INP(rr + 0, cc));
-      // for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-      for (i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
-        // *(uint16_t * __restrict__) & OUT(cc + i, rr) = _mm_movemask_epi8(vec);
-        *(uint16_t * __restrict__) & OUT(cc + i - 1, rr) = _mm_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
+}
+
+__attribute__((target("avx512f,avx512bw"))) void BitMatrix::Transpose128x128BlockAVX512(
+    const std::byte* const* rows, std::size_t column, std::byte* out) {
+  assert(column % 128 == 0);
+  __m512i x[16];
+  // the four lanes contain the rows r + 16l, ..., r + 16l + 15 for l = 0, ..., 3
+  for (std::size_t r = 0; r < 128; r += 64) {
+    for (std::size_t k = 0; k < 16; ++k) {
+      auto v = _mm512_castsi128_si512(_mm_loadu_si128(load_ptr(rows[r + k], column)));
+      v = _mm512_inserti32x4(v, _mm_loadu_si128(load_ptr(rows[r + 16 + k], column)), 1);
+      v = _mm512_inserti32x4(v, _mm_loadu_si128(load_ptr(rows[r + 32 + k], column)), 2);
+      x[k] = _mm512_inserti32x4(v, _mm_loadu_si128(load_ptr(rows[r + 48 + k], column)), 3);
+    }
+    transpose_16x16_bytes_avx512(x);
+    for (std::size_t j = 0; j < 16; ++j) {
+      for (std::size_t i = 8; i > 0; x[j] = _mm512_slli_epi64(x[j], 1), --i) {
+        const auto mask = static_cast<std::uint64_t>(_mm512_movepi8_mask(x[j]));
+        std::memcpy(out + 16 * (8 * j + i - 1) + r / 8, &mask, sizeof(mask));
       }
     }
   }
-#endif
+}
+
+void BitMatrix::Transpose128x128Block(const std::byte* const* rows, std::size_t column,
+                                      std::byte* out) {
+  switch (get_simd_level()) {
+    case SIMDLevel::AVX512:
+      Transpose128x128BlockAVX512(rows, column, out);
+      break;
+    case SIMDLevel::AVX2:
+      Transpose128x128BlockAVX2(rows, column, out);
+      break;
+    case SIMDLevel::SSE:
+      Transpose128x128BlockSSE(rows, column, out);
+      break;
+  }
+}
+
+void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix, std::size_t ncols) {
+  constexpr std::uint64_t nrows = 128;
+  std::vector<std::byte, boost::alignment::aligned_allocator<std::byte, 16>> out(
+      ((nrows * ncols) + 7) / 8, std::byte{0});
+
+  assert(ncols % nrows == 0);
+
+  for (std::size_t c = 0; c < ncols; c += nrows) {
+    Transpose128x128Block(matrix.data(), c, out.data() + c * nrows / 8);
+  }
 
   for (auto j = 0ull; j < ncols; ++j) {
     std::copy(reinterpret_cast<const std::byte* __restrict__>(out.data()) + j * 16,
@@ -488,246 +535,111 @@ void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix, st
                   __builtin_assume_aligned(matrix.at(j % nrows), 16)) +
                   (j / nrows) * 16);
   }
-
-  // for (auto j = 0ull; j < nrows; ++j) {
-  // std::copy(out.data() + j * 16 * num_blocks, out.data() + (j + 1) * 16 * num_blocks,
-  //          reinterpret_cast<std::uint8_t*>(matrix.at(j)));
-  // }
 }
 
 void BitMatrix::SenderTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                           std::vector<BitVector<>>& y0,
                                           std::vector<BitVector<>>& y1, const BitVector<> choices,
                                           PRG& prg_fixed_key, const std::size_t ncols,
-                                          const std::vector<std::size_t>& bitlengths) {
-  constexpr std::size_t kappa{128}, nrows{128};
-#define INP(r, c)                                     \
-  reinterpret_cast<const std::uint8_t* __restrict__>( \
-      __builtin_assume_aligned(matrix.at(r), 16))[c / 8]
+                                          const std::vector<std::size_t>& bitlengths,
+                                          const std::size_t column_offset) {
+  constexpr std::size_t kappa{128}, nrows{128}, block_bytes{kappa / 8};
   assert(y0.size() == y1.size());
+  assert(ncols % nrows == 0);
+  assert(choices.GetSize() == kappa);
 
-  const std::size_t original_size{y0.size()}, difference{ncols - original_size};
-  if (difference) {
-    y0.resize(ncols);
-    y1.resize(ncols);
-  }
-
-  for (auto& bv : y0) bv = BitVector(std::vector<std::byte>(kappa / 8), kappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
-  assert(nrows % 8 == 0 && ncols % 8 == 0);
-
-//#define MOTION_AVX2
-#if defined(MOTION_AVX512)
-  // TODO: not tested yet
-  __m512i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 8) {
-    for (cc = 0; cc < ncols; cc += 64) {
-      vec = _mm512_set_epi8(
-          INP(rr + 56, cc), INP(rr + 57, cc), INP(rr + 58, cc), INP(rr + 59, cc), INP(rr + 60, cc),
-          INP(rr + 61, cc), INP(rr + 62, cc), INP(rr + 63, cc), INP(rr + 48, cc), INP(rr + 49, cc),
-          INP(rr + 50, cc), INP(rr + 51, cc), INP(rr + 52, cc), INP(rr + 53, cc), INP(rr + 54, cc),
-          INP(rr + 55, cc), INP(rr + 39, cc), INP(rr + 40, cc), INP(rr + 41, cc), INP(rr + 42, cc),
-          INP(rr + 43, cc), INP(rr + 44, cc), INP(rr + 45, cc), INP(rr + 46, cc), INP(rr + 32, cc),
-          INP(rr + 33, cc), INP(rr + 34, cc), INP(rr + 35, cc), INP(rr + 36, cc), INP(rr + 37, cc),
-          INP(rr + 38, cc), INP(rr + 39, cc), INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc),
-          INP(rr + 27, cc), INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-          INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc), INP(rr + 20, cc),
-          INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc), INP(rr + 8, cc), INP(rr + 9, cc),
-          INP(rr + 10, cc), INP(rr + 11, cc), INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc),
-          INP(rr + 15, cc), INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-          INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 64; vec = _mm512_slli_epi64(vec, 1), ++i) {
-        OUT(cc + i, rr) = _mm512_movepi64_mask(vec);
-      }
-    }
+  const std::size_t original_size{y0.size()};
+  if (original_size < column_offset + ncols) {
+    y0.resize(column_offset + ncols);
+    y1.resize(column_offset + ncols);
   }
-#elif defined(MOTION_AVX2)
-  __m256i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 32) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      vec = _mm256_set_epi8(INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc), INP(rr + 27, cc),
-                            INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-                            INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc),
-                            INP(rr + 20, cc), INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc),
-                            INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-                            INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-                            INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-                            INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
-        *(uint32_t*)&OUT(cc + i, rr) = _mm256_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
-      }
-    }
-  }
-#else
-  __m128i vec;
+
   PRG prg_var_key;
+  // the transposed 128 x 128 block, and the same xored with the choices
+  alignas(64) std::array<std::byte, nrows * block_bytes> block0, block1;
+  const auto choices_ptr = choices.GetData().data();
+
   // process 128x128 blocks
-  while (c < ncols) {
-    auto c_old{c};
-    for (r = 0; r <= nrows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        // vec = _mm_set_epi8(INP(r + 8, c), INP(r + 9, c), INP(r + 10, c), INP(r + 11, c),
-        //                    INP(r + 12, c), INP(r + 13, c), INP(r + 14, c), INP(r + 15, c),
-        //                    INP(r + 0, c), INP(r + 1, c), INP(r + 2, c), INP(r + 3, c),
-        //                    INP(r + 4, c), INP(r + 5, c), INP(r + 6, c), INP(r + 7, c));
-        vec = _mm_set_epi8(INP(r + 15, c), INP(r + 14, c), INP(r + 13, c), INP(r + 12, c),
-                           INP(r + 11, c), INP(r + 10, c), INP(r + 9, c), INP(r + 8, c),
-                           INP(r + 7, c), INP(r + 6, c), INP(r + 5, c), INP(r + 4, c),
-                           INP(r + 3, c), INP(r + 2, c), INP(r + 1, c), INP(r + 0, c));
-        // for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-        for (i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
-          // *reinterpret_cast<std::uint16_t* __restrict__>(y0[c + i].GetMutableData().data() +
-          *reinterpret_cast<std::uint16_t* __restrict__>(y0[c + i - 1].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
-      }
+  for (std::size_t c = 0; c < ncols; c += nrows) {
+    Transpose128x128Block(matrix.data(), c, block0.data());
+    for (std::size_t i = 0; i < block0.size(); ++i) {
+      block1[i] = block0[i] ^ choices_ptr[i % block_bytes];
     }
-    // XXX
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      auto& out0 = y0[c_old];
-      auto& out1 = y1[c_old];
+
+    // columns beyond the original size are padding and are not hashed
+    const auto first_column = column_offset + c;
+    const auto num_hashed =
+        first_column < original_size ? std::min(nrows, original_size - first_column) : 0;
+    // compute the sender outputs
+    prg_fixed_key.MMO(block0.data(), num_hashed);
+    prg_fixed_key.MMO(block1.data(), num_hashed);
+
+    for (std::size_t j = 0; j < nrows; ++j) {
+      auto& out0 = y0[first_column + j];
+      auto& out1 = y1[first_column + j];
+      const auto ptr0 = block0.data() + j * block_bytes;
+      const auto ptr1 = block1.data() + j * block_bytes;
 
       // bit length of the OT
-      const auto bitlen = bitlengths[c_old];
+      const auto bitlen = j < num_hashed ? bitlengths[first_column + j] : kappa;
 
-      out1 = choices ^ out0;
-      assert(out0.GetSize() == 128);
-      assert(out1.GetSize() == 128);
-      // compute the sender outputs
       if (bitlen <= kappa) {
         // the bit length is smaller than 128 bit
-        prg_fixed_key.MMO(out0.GetMutableData().data());
-        prg_fixed_key.MMO(out1.GetMutableData().data());
-        out0.Resize(bitlen);
-        out1.Resize(bitlen);
+        out0 = BitVector<>(ptr0, bitlen);
+        out1 = BitVector<>(ptr1, bitlen);
       } else {
         // string OT with bit length > 128 bit
         // -> do seed compression and send later only 128 bit seeds
-        prg_fixed_key.MMO(out0.GetMutableData().data());
-        prg_fixed_key.MMO(out1.GetMutableData().data());
-        prg_var_key.SetKey(out0.GetData().data());
+        prg_var_key.SetKey(ptr0);
         out0 =
             BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
-        prg_var_key.SetKey(out1.GetData().data());
+        prg_var_key.SetKey(ptr1);
         out1 =
             BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
       }
     }
   }
-#endif
 }
 
 void BitMatrix::ReceiverTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                             std::vector<BitVector<>>& out, PRG& prg_fixed_key,
                                             const std::size_t ncols,
-                                            const std::vector<std::size_t>& bitlengths) {
-  constexpr std::size_t kappa{128}, nrows{128};
-#define INP(r, c)                                     \
-  reinterpret_cast<const std::uint8_t* __restrict__>( \
-      __builtin_assume_aligned(matrix.at(r), 16))[c / 8]
-
-  const std::size_t original_size{out.size()}, difference{ncols - original_size};
-  if (difference) {
-    out.resize(ncols);
-  }
-
-  for (auto& bv : out) bv = BitVector(std::vector<std::byte>(kappa / 8), kappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
-  assert(nrows % 8 == 0 && ncols % 8 == 0);
-
-//#define MOTION_AVX2
-#if defined(MOTION_AVX512)
-  // TODO: not tested yet
-  __m512i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 8) {
-    for (cc = 0; cc < ncols; cc += 64) {
-      vec = _mm512_set_epi8(
-          INP(rr + 56, cc), INP(rr + 57, cc), INP(rr + 58, cc), INP(rr + 59, cc), INP(rr + 60, cc),
-          INP(rr + 61, cc), INP(rr + 62, cc), INP(rr + 63, cc), INP(rr + 48, cc), INP(rr + 49, cc),
-          INP(rr + 50, cc), INP(rr + 51, cc), INP(rr + 52, cc), INP(rr + 53, cc), INP(rr + 54, cc),
-          INP(rr + 55, cc), INP(rr + 39, cc), INP(rr + 40, cc), INP(rr + 41, cc), INP(rr + 42, cc),
-          INP(rr + 43, cc), INP(rr + 44, cc), INP(rr + 45, cc), INP(rr + 46, cc), INP(rr + 32, cc),
-          INP(rr + 33, cc), INP(rr + 34, cc), INP(rr + 35, cc), INP(rr + 36, cc), INP(rr + 37, cc),
-          INP(rr + 38, cc), INP(rr + 39, cc), INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc),
-          INP(rr + 27, cc), INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-          INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc), INP(rr + 20, cc),
-          INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc), INP(rr + 8, cc), INP(rr + 9, cc),
-          INP(rr + 10, cc), INP(rr + 11, cc), INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc),
-          INP(rr + 15, cc), INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-          INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 64; vec = _mm512_slli_epi64(vec, 1), ++i) {
-        OUT(cc + i, rr) = _mm512_movepi64_mask(vec);
-      }
-    }
-  }
-#elif defined(MOTION_AVX2)
-  __m256i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 32) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      vec = _mm256_set_epi8(INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc), INP(rr + 27, cc),
-                            INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-                            INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc),
-                            INP(rr + 20, cc), INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc),
-                            INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-                            INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-                            INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-                            INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
-        *(uint32_t*)&OUT(cc + i, rr) = _mm256_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
-      }
-    }
+                                            const std::vector<std::size_t>& bitlengths,
+                                            const std::size_t column_offset) {
+  constexpr std::size_t kappa{128}, nrows{128}, block_bytes{kappa / 8};
+  assert(ncols % nrows == 0);
+
+  const std::size_t original_size{out.size()};
+  if (original_size < column_offset + ncols) {
+    out.resize(column_offset + ncols);
   }
-#else
-  __m128i vec;
+
   PRG prg_var_key;
+  alignas(64) std::array<std::byte, nrows * block_bytes> block;
+
   // process 128x128 blocks
-  while (c < ncols) {
-    auto c_old{c};
-    for (r = 0; r <= nrows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        // vec = _mm_set_epi8(INP(r + 8, c), INP(r + 9, c), INP(r + 10, c), INP(r + 11, c),
-        //                    INP(r + 12, c), INP(r + 13, c), INP(r + 14, c), INP(r + 15, c),
-        //                    INP(r + 0, c), INP(r + 1, c), INP(r + 2, c), INP(r + 3, c),
-        //                    INP(r + 4, c), INP(r + 5, c), INP(r + 6, c), INP(r + 7, c));
-        vec = _mm_set_epi8(INP(r + 15, c), INP(r + 14, c), INP(r + 13, c), INP(r + 12, c),
-                           INP(r + 11, c), INP(r + 10, c), INP(r + 9, c), INP(r + 8, c),
-                           INP(r + 7, c), INP(r + 6, c), INP(r + 5, c), INP(r + 4, c),
-                           INP(r + 3, c), INP(r + 2, c), INP(r + 1, c), INP(r + 0, c));
-        // for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-        for (i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
-          // *reinterpret_cast<std::uint16_t* __restrict__>(out[c + i].GetMutableData().data() +
-          *reinterpret_cast<std::uint16_t* __restrict__>(out[c + i - 1].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
+  for (std::size_t c = 0; c < ncols; c += nrows) {
+    Transpose128x128Block(matrix.data(), c, block.data());
+
+    // columns beyond the original size are padding and are not hashed
+    const auto first_column = column_offset + c;
+    const auto num_hashed =
+        first_column < original_size ? std::min(nrows, original_size - first_column) : 0;
+    prg_fixed_key.MMO(block.data(), num_hashed);
+
+    for (std::size_t j = 0; j < nrows; ++j) {
+      auto& o = out[first_column + j];
+      const auto ptr = block.data() + j * block_bytes;
+      const std::size_t bitlen = j < num_hashed ? bitlengths[first_column + j] : kappa;
+
+      if (bitlen <= kappa) {
+        o = BitVector<>(ptr, bitlen);
+      } else {
+        prg_var_key.SetKey(ptr);
+        o = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
       }
     }
-    // XXX
-    for (; c_old < c && c_old < original_size; ++c_old) {
-        auto &o = out[c_old];
-        assert(o.GetSize() == 128);
-        const std::size_t bitlen = bitlengths[c_old];
-
-        if (bitlen <= kappa) {
-          prg_fixed_key.MMO(o.GetMutableData().data());
-          o.Resize(bitlen);
-        } else {
-          prg_fixed_key.MMO(o.GetMutableData().data());
-          prg_var_key.SetKey(o.GetData().data());
-          o = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
-        }
-    }
   }
-#endif
 }
 
 bool BitMatrix::operator==(const BitMatrix& other) {
@@ -119,16 +119,32 @@ class BitMatrix {
   static void TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix,
                                        std::size_t num_columns);
 
+  // Transposes the 128 x 128 block of the 128 rows starting at bit `column` (a multiple of 128)
+  // into 128 x 16 B at `out`, i.e., out + 16 * j gets the column `column + j`.  Dispatches to the
+  // best kernel supported by the CPU (see utility/cpu_features.h), all kernels are bit-exact.
+  static void Transpose128x128Block(const std::byte* const* rows, std::size_t column,
+                                    std::byte* out);
+  static void Transpose128x128BlockSSE(const std::byte* const* rows, std::size_t column,
+                                       std::byte* out);
+  static void Transpose128x128BlockAVX2(const std::byte* const* rows, std::size_t column,
+                                        std::byte* out);
+  static void Transpose128x128BlockAVX512(const std::byte* const* rows, std::size_t column,
+                                          std::byte* out);
+
+  // The column j of the matrix belongs to the OT column_offset + j, i.e., the
+  // matrix may be a chunk of the whole OT extension matrix.
   static void SenderTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                         std::vector<BitVector<>>& y0, std::vector<BitVector<>>& y1,
                                         const BitVector<> choices, PRG& prg_fixed_key,
                                         const std::size_t ncols,
-                                        const std::vector<std::size_t>& bitlengths);
+                                        const std::vector<std::size_t>& bitlengths,
+                                        const std::size_t column_offset = 0);
 
   static void ReceiverTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                           std::vector<BitVector<>>& out, PRG& prg_fixed_key,
                                           const std::size_t ncols,
-                                          const std::vector<std::size_t>& bitlengths);
+                                          const std::vector<std::size_t>& bitlengths,
+                                          const std::size_t column_offset = 0);
 
   bool operator==(const BitMatrix& other);
 
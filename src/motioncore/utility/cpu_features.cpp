@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace ENCRYPTO {
+
+namespace {
+
+CPUFeatures detect_cpu_features() {
+  __builtin_cpu_init();
+  CPUFeatures features;
+  // these also check that the OS saves the extended register state
+  features.avx2_ = __builtin_cpu_supports("avx2");
+  features.avx512f_ = __builtin_cpu_supports("avx512f");
+  features.avx512bw_ = __builtin_cpu_supports("avx512bw");
+  features.vaes_ = __builtin_cpu_supports("vaes");
+  return features;
+}
+
+SIMDLevel get_initial_simd_level() {
+  auto level = get_supported_simd_level();
+  if (const char* max_level = std::getenv("MOTION_MAX_SIMD_LEVEL"); max_level != nullptr) {
+    try {
+      level = std::min(level, parse_simd_level(max_level));
+    } catch (const std::invalid_argument& e) {
+      // a misspelled level should not abort a run, so fall back to the detected one
+      std::cerr << fmt::format("ignoring MOTION_MAX_SIMD_LEVEL: {}, using {}\n", e.what(),
+                               to_string(level));
+    }
+  }
+  return level;
+}
+
+std::atomic<SIMDLevel>& get_simd_level_ref() {
+  static std::atomic<SIMDLevel> simd_level{get_initial_simd_level()};
+  return simd_level;
+}
+
+}  // namespace
+
+const CPUFeatures& get_cpu_features() {
+  static const CPUFeatures features = detect_cpu_features();
+  return features;
+}
+
+SIMDLevel get_supported_simd_level() {
+  const auto& features = get_cpu_features();
+  if (features.avx512f_ && features.avx512bw_) {
+    return SIMDLevel::AVX512;
+  } else if (features.avx2_) {
+    return SIMDLevel::AVX2;
+  }
+  return SIMDLevel::SSE;
+}
+
+SIMDLevel get_simd_level() { return get_simd_level_ref().load(std::memory_order_relaxed); }
+
+void set_max_simd_level(SIMDLevel level) {
+  get_simd_level_ref().store(std::min(level, get_supported_simd_level()),
+                             std::memory_order_relaxed);
+}
+
+std::string_view to_string(SIMDLevel level) {
+  switch (level) {
+    case SIMDLevel::SSE:
+      return "sse";
+    case SIMDLevel::AVX2:
+      return "avx2";
+    case SIMDLevel::AVX512:
+      return "avx512";
+  }
+  return "invalid";
+}
+
+SIMDLevel parse_simd_level(std::string_view str) {
+  for (auto level : {SIMDLevel::SSE, SIMDLevel::AVX2, SIMDLevel::AVX512}) {
+    if (str == to_string(level)) {
+      return level;
+    }
+  }
+  throw std::invalid_argument(fmt::format("unknown SIMD level: {}", str));
+}
+
+}  // namespace ENCRYPTO
@@ -0,0 +1,63 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <string_view>
+
+namespace ENCRYPTO {
+
+// Instruction set levels of the kernels that are selected at runtime, in increasing order.
+// SSE (with SSE4.1 and AES-NI) is the baseline which the library requires anyway.
+enum class SIMDLevel : unsigned int { SSE, AVX2, AVX512 };
+
+struct CPUFeatures {
+  bool avx2_;
+  bool avx512f_;
+  bool avx512bw_;
+  bool vaes_;
+};
+
+// Detect the features of the CPU we are running on (done once).
+const CPUFeatures& get_cpu_features();
+
+// Best level supported by the CPU, AVX512 requires AVX-512F and AVX-512BW.
+SIMDLevel get_supported_simd_level();
+
+// Level used by the dispatched kernels.
+//
+// This is the supported level unless it is lowered by set_max_simd_level or by the environment
+// variable MOTION_MAX_SIMD_LEVEL (one of sse, avx2, avx512).  An invalid value of the variable is
+// reported on std::cerr and ignored.
+SIMDLevel get_simd_level();
+
+// Lower the level used by the dispatched kernels, e.g., to compare them.  Levels above the
+// supported one are clamped.
+void set_max_simd_level(SIMDLevel level);
+
+std::string_view to_string(SIMDLevel level);
+
+// Parse one of sse, avx2, avx512 and throw std::invalid_argument otherwise.
+SIMDLevel parse_simd_level(std::string_view str);
+
+}  // namespace ENCRYPTO
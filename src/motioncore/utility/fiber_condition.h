@@ -50,6 +50,14 @@ class FiberCondition {
     condition_variable_.wait(lock, condition_function_);
   }
 
+  // waits for another condition on the same variables, e.g., if waiters wait for different
+  // values of a counter
+  template <typename Predicate>
+  void Wait(Predicate predicate) const {
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    condition_variable_.wait(lock, predicate);
+  }
+
   template <typename Tick, typename Period>
   bool WaitFor(std::chrono::duration<Tick, Period> duration) const {
     std::unique_lock<decltype(mutex_)> lock(mutex_);
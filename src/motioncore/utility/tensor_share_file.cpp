@@ -0,0 +1,378 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "tensor_share_file.h"
+
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+namespace MOTION {
+
+namespace {
+
+constexpr char tensor_share_file_magic[4] = {'M', 'T', 'S', 'F'};
+
+template <typename T>
+T to_little_endian(T value) {
+  if constexpr (std::endian::native == std::endian::little) {
+    return value;
+  } else if constexpr (sizeof(T) == 4) {
+    return __builtin_bswap32(value);
+  } else {
+    static_assert(sizeof(T) == 8);
+    return __builtin_bswap64(value);
+  }
+}
+
+// read-only mapping of a whole file, unmapped on destruction
+class MappedFile {
+ public:
+  MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::runtime_error(fmt::format("could not open share file {}", path));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+      ::close(fd);
+      throw std::runtime_error(fmt::format("could not stat share file {}", path));
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+      throw std::runtime_error(fmt::format("could not map share file {}", path));
+    }
+    if (size_ > 0) {
+      ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+  }
+  ~MappedFile() {
+    if (size_ > 0) {
+      ::munmap(data_, size_);
+    }
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  const std::byte* data() const noexcept { return reinterpret_cast<const std::byte*>(data_); }
+  std::size_t size() const noexcept { return size_; }
+
+ private:
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+template <typename T>
+void copy_array(std::vector<T>& dst, const std::byte* src, std::size_t num_elements) {
+  dst.resize(num_elements);
+  std::memcpy(dst.data(), src, num_elements * sizeof(T));
+  if constexpr (std::endian::native != std::endian::little) {
+    for (auto& v : dst) {
+      v = to_little_endian(v);
+    }
+  }
+}
+
+// rows * cols, throws if the product does not fit into std::size_t
+std::size_t checked_num_elements(std::uint64_t rows, std::uint64_t cols,
+                                 const std::string& path) {
+  std::size_t num_elements;
+  if (__builtin_mul_overflow(rows, cols, &num_elements)) {
+    throw std::runtime_error(
+        fmt::format("share file {} has too many elements ({}x{})", path, rows, cols));
+  }
+  return num_elements;
+}
+
+// size of a binary share file with the given number of elements, throws on overflow
+std::size_t checked_file_size(std::size_t num_elements, std::size_t element_size,
+                              const std::string& path) {
+  std::size_t array_size;
+  std::size_t file_size;
+  if (__builtin_mul_overflow(num_elements, 2 * element_size, &array_size) ||
+      __builtin_add_overflow(array_size, sizeof(TensorShareFileHeader), &file_size)) {
+    throw std::runtime_error(fmt::format("share file {} has too many elements", path));
+  }
+  return file_size;
+}
+
+struct ParsedHeader {
+  std::size_t bit_size_;
+  std::size_t rows_;
+  std::size_t cols_;
+  std::size_t fractional_bits_;
+  std::size_t num_elements_;
+};
+
+// Validate the header of a mapped binary share file against the size of the file.
+ParsedHeader parse_header(const MappedFile& file, const std::string& path) {
+  if (file.size() < sizeof(TensorShareFileHeader)) {
+    throw std::runtime_error(fmt::format("share file {} is too small", path));
+  }
+  TensorShareFileHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic_, tensor_share_file_magic, sizeof(header.magic_)) != 0) {
+    throw std::runtime_error(fmt::format("{} is not a binary share file", path));
+  }
+  if (to_little_endian(header.version_) != tensor_share_file_version) {
+    throw std::runtime_error(fmt::format("share file {} has unsupported version {}", path,
+                                         to_little_endian(header.version_)));
+  }
+  ParsedHeader parsed;
+  parsed.bit_size_ = to_little_endian(header.bit_size_);
+  if (parsed.bit_size_ != 32 && parsed.bit_size_ != 64) {
+    throw std::runtime_error(
+        fmt::format("share file {} has unsupported bit size {}", path, parsed.bit_size_));
+  }
+  const auto rows = to_little_endian(header.rows_);
+  const auto cols = to_little_endian(header.cols_);
+  parsed.num_elements_ = checked_num_elements(rows, cols, path);
+  parsed.rows_ = rows;
+  parsed.cols_ = cols;
+  parsed.fractional_bits_ = to_little_endian(header.fractional_bits_);
+  const auto expected_size = checked_file_size(parsed.num_elements_, parsed.bit_size_ / 8, path);
+  if (file.size() != expected_size) {
+    throw std::runtime_error(fmt::format("share file {} has size {}, expected {}", path,
+                                         file.size(), expected_size));
+  }
+  return parsed;
+}
+
+template <typename T>
+TensorShares<T> read_text_share_file(const std::string& path) {
+  // the text format is written by the 64-bit data providers
+  if constexpr (sizeof(T) != sizeof(std::uint64_t)) {
+    throw std::runtime_error(fmt::format(
+        "share file {} is in the text format, which contains 64-bit shares, expected {}", path,
+        8 * sizeof(T)));
+  }
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error(fmt::format("could not open share file {}", path));
+  }
+  TensorShares<T> shares;
+  shares.fractional_bits_ = 0;
+  in >> shares.rows_ >> shares.cols_;
+  if (!in) {
+    throw std::runtime_error(fmt::format("share file {} is truncated", path));
+  }
+  const auto num_elements = checked_num_elements(shares.rows_, shares.cols_, path);
+  shares.Delta_.resize(num_elements);
+  shares.delta_.resize(num_elements);
+  for (std::size_t i = 0; i < num_elements; ++i) {
+    in >> shares.Delta_[i] >> shares.delta_[i];
+  }
+  if (!in) {
+    throw std::runtime_error(fmt::format("share file {} is truncated", path));
+  }
+  return shares;
+}
+
+}  // namespace
+
+bool is_tensor_share_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[sizeof(tensor_share_file_magic)];
+  if (!in.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return std::memcmp(magic, tensor_share_file_magic, sizeof(magic)) == 0;
+}
+
+template <typename T>
+TensorSharesView<T>::TensorSharesView(TensorShares<T>&& shares)
+    : rows_(shares.rows_), cols_(shares.cols_), fractional_bits_(shares.fractional_bits_) {
+  auto storage = std::make_shared<const TensorShares<T>>(std::move(shares));
+  Delta_ = storage->Delta_;
+  delta_ = storage->delta_;
+  storage_ = std::move(storage);
+}
+
+template <typename T>
+TensorSharesView<T>::TensorSharesView(std::shared_ptr<const void> storage, std::size_t rows,
+                                      std::size_t cols, std::size_t fractional_bits,
+                                      std::span<const T> Delta, std::span<const T> delta)
+    : storage_(std::move(storage)),
+      rows_(rows),
+      cols_(cols),
+      fractional_bits_(fractional_bits),
+      Delta_(Delta),
+      delta_(delta) {}
+
+namespace {
+
+template <typename T>
+TensorSharesView<T> make_mapped_view(std::shared_ptr<const MappedFile> file,
+                                     const ParsedHeader& header) {
+  assert(header.bit_size_ == 8 * sizeof(T));
+  // the header has a size of 32 bytes and the mapping is page-aligned, so the
+  // arrays are suitably aligned for T
+  const auto* data = reinterpret_cast<const T*>(file->data() + sizeof(TensorShareFileHeader));
+  std::span<const T> Delta(data, header.num_elements_);
+  std::span<const T> delta(data + header.num_elements_, header.num_elements_);
+  return {std::move(file), header.rows_, header.cols_, header.fractional_bits_, Delta, delta};
+}
+
+}  // namespace
+
+template <typename T>
+TensorSharesView<T> map_tensor_share_file(const std::string& path) {
+  static_assert(std::is_unsigned_v<T>);
+  if constexpr (std::endian::native != std::endian::little) {
+    throw std::runtime_error(
+        fmt::format("share file {} cannot be mapped in place on a big-endian host", path));
+  } else {
+    auto file = std::make_shared<const MappedFile>(path);
+    const auto header = parse_header(*file, path);
+    if (header.bit_size_ != 8 * sizeof(T)) {
+      throw std::runtime_error(fmt::format("share file {} contains {}-bit shares, expected {}",
+                                           path, header.bit_size_, 8 * sizeof(T)));
+    }
+    return make_mapped_view<T>(std::move(file), header);
+  }
+}
+
+template <typename T>
+TensorShares<T> read_tensor_share_file(const std::string& path) {
+  static_assert(std::is_unsigned_v<T>);
+  MappedFile file(path);
+  const auto header = parse_header(file, path);
+  if (header.bit_size_ != 8 * sizeof(T)) {
+    throw std::runtime_error(fmt::format("share file {} contains {}-bit shares, expected {}",
+                                         path, header.bit_size_, 8 * sizeof(T)));
+  }
+
+  TensorShares<T> shares;
+  shares.rows_ = header.rows_;
+  shares.cols_ = header.cols_;
+  shares.fractional_bits_ = header.fractional_bits_;
+  const auto num_elements = header.num_elements_;
+  const auto* data = file.data() + sizeof(TensorShareFileHeader);
+  copy_array(shares.Delta_, data, num_elements);
+  copy_array(shares.delta_, data + num_elements * sizeof(T), num_elements);
+  return shares;
+}
+
+template <typename T, typename U>
+TensorShares<T> reduce_tensor_shares(const TensorShares<U>& shares) {
+  static_assert(std::is_unsigned_v<T> && std::is_unsigned_v<U> && sizeof(T) < sizeof(U));
+  TensorShares<T> reduced;
+  reduced.rows_ = shares.rows_;
+  reduced.cols_ = shares.cols_;
+  reduced.fractional_bits_ = shares.fractional_bits_;
+  const auto reduce = [](const std::vector<U>& values) {
+    return std::vector<T>(std::begin(values), std::end(values));
+  };
+  reduced.Delta_ = reduce(shares.Delta_);
+  reduced.delta_ = reduce(shares.delta_);
+  return reduced;
+}
+
+template <typename T>
+void write_tensor_share_file(const std::string& path, const TensorShares<T>& shares) {
+  static_assert(std::is_unsigned_v<T>);
+  const auto num_elements = checked_num_elements(shares.rows_, shares.cols_, path);
+  if (shares.Delta_.size() != num_elements || shares.delta_.size() != num_elements) {
+    throw std::invalid_argument("number of shares does not match the dimensions");
+  }
+  TensorShareFileHeader header;
+  std::memcpy(header.magic_, tensor_share_file_magic, sizeof(header.magic_));
+  header.version_ = to_little_endian(tensor_share_file_version);
+  header.bit_size_ = to_little_endian(static_cast<std::uint32_t>(8 * sizeof(T)));
+  header.fractional_bits_ = to_little_endian(static_cast<std::uint32_t>(shares.fractional_bits_));
+  header.rows_ = to_little_endian(static_cast<std::uint64_t>(shares.rows_));
+  header.cols_ = to_little_endian(static_cast<std::uint64_t>(shares.cols_));
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error(fmt::format("could not open share file {} for writing", path));
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  const auto write_array = [&out](const std::vector<T>& values) {
+    if constexpr (std::endian::native == std::endian::little) {
+      out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    } else {
+      for (auto v : values) {
+        v = to_little_endian(v);
+        out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+      }
+    }
+  };
+  write_array(shares.Delta_);
+  write_array(shares.delta_);
+  if (!out) {
+    throw std::runtime_error(fmt::format("could not write share file {}", path));
+  }
+}
+
+template <typename T>
+TensorShares<T> read_tensor_shares(const std::string& path) {
+  if (is_tensor_share_file(path)) {
+    return read_tensor_share_file<T>(path);
+  }
+  return read_text_share_file<T>(path);
+}
+
+template <typename T>
+TensorSharesView<T> load_tensor_shares(const std::string& path) {
+  if constexpr (std::endian::native == std::endian::little) {
+    if (is_tensor_share_file(path)) {
+      auto file = std::make_shared<const MappedFile>(path);
+      const auto header = parse_header(*file, path);
+      if (header.bit_size_ == 8 * sizeof(T)) {
+        return make_mapped_view<T>(std::move(file), header);
+      }
+    }
+  }
+  return read_tensor_shares<T>(path);
+}
+
+template class TensorSharesView<std::uint32_t>;
+template class TensorSharesView<std::uint64_t>;
+template TensorSharesView<std::uint32_t> map_tensor_share_file(const std::string&);
+template TensorSharesView<std::uint64_t> map_tensor_share_file(const std::string&);
+template TensorShares<std::uint32_t> read_tensor_share_file(const std::string&);
+template TensorShares<std::uint64_t> read_tensor_share_file(const std::string&);
+template TensorShares<std::uint32_t> reduce_tensor_shares(const TensorShares<std::uint64_t>&);
+template void write_tensor_share_file(const std::string&, const TensorShares<std::uint32_t>&);
+template void write_tensor_share_file(const std::string&, const TensorShares<std::uint64_t>&);
+template TensorShares<std::uint32_t> read_tensor_shares(const std::string&);
+template TensorShares<std::uint64_t> read_tensor_shares(const std::string&);
+template TensorSharesView<std::uint32_t> load_tensor_shares(const std::string&);
+template TensorSharesView<std::uint64_t> load_tensor_shares(const std::string&);
+
+}  // namespace MOTION
@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MOTION {
+
+// Binary container for the two shares (Delta, delta) of an arithmetic BEAVY
+// tensor.  The file starts with a fixed header followed by the raw
+// little-endian Delta array and the raw little-endian delta array:
+//
+//   offset  size  field
+//   0       4     magic "MTSF"
+//   4       4     version
+//   8       4     bit size of an element (32 or 64)
+//   12      4     number of fractional bits
+//   16      8     number of rows
+//   24      8     number of columns
+//   32      ...   Delta[rows * cols], delta[rows * cols]
+struct TensorShareFileHeader {
+  char magic_[4];
+  std::uint32_t version_;
+  std::uint32_t bit_size_;
+  std::uint32_t fractional_bits_;
+  std::uint64_t rows_;
+  std::uint64_t cols_;
+};
+static_assert(sizeof(TensorShareFileHeader) == 32);
+
+constexpr std::uint32_t tensor_share_file_version = 1;
+
+template <typename T>
+struct TensorShares {
+  std::size_t rows_;
+  std::size_t cols_;
+  std::size_t fractional_bits_;
+  std::vector<T> Delta_;
+  std::vector<T> delta_;
+};
+
+// Read-only view of the shares of a tensor.  The arrays either point directly
+// into a mapping of a binary share file or into shares adopted from a
+// TensorShares object; the view keeps its backing storage alive and can be
+// copied cheaply.
+template <typename T>
+class TensorSharesView {
+ public:
+  TensorSharesView() = default;
+  TensorSharesView(TensorShares<T>&& shares);
+  TensorSharesView(std::shared_ptr<const void> storage, std::size_t rows, std::size_t cols,
+                   std::size_t fractional_bits, std::span<const T> Delta,
+                   std::span<const T> delta);
+
+  std::size_t get_rows() const noexcept { return rows_; }
+  std::size_t get_cols() const noexcept { return cols_; }
+  std::size_t get_fractional_bits() const noexcept { return fractional_bits_; }
+  std::span<const T> get_Delta() const noexcept { return Delta_; }
+  std::span<const T> get_delta() const noexcept { return delta_; }
+
+ private:
+  std::shared_ptr<const void> storage_;
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t fractional_bits_ = 0;
+  std::span<const T> Delta_;
+  std::span<const T> delta_;
+};
+
+// Check whether the file starts with the magic of the binary format.
+bool is_tensor_share_file(const std::string& path);
+
+// Map the binary file into memory and return a view of the shares in place,
+// i.e., without copying them.  The file needs to contain shares of exactly the
+// bit size of T, and the host needs to be little-endian.  Throws
+// std::runtime_error if the file is malformed or cannot be mapped in place.
+template <typename T>
+TensorSharesView<T> map_tensor_share_file(const std::string& path);
+
+// Map the binary file into memory and copy the shares out of it.  Throws
+// std::runtime_error if the file is malformed or does not contain shares of
+// exactly the bit size of T.
+template <typename T>
+TensorShares<T> read_tensor_share_file(const std::string& path);
+
+// Reduce shares modulo 2^(8 * sizeof(T)), e.g., to evaluate a model shared in
+// the 64-bit ring in the 32-bit ring.  The result is only meaningful if the
+// shared values fit into the smaller ring, which the caller needs to ensure.
+template <typename T, typename U>
+TensorShares<T> reduce_tensor_shares(const TensorShares<U>&);
+
+template <typename T>
+void write_tensor_share_file(const std::string& path, const TensorShares<T>&);
+
+// Read shares from either the binary format or the legacy text format
+// ("rows cols" followed by one "Delta delta" pair per line).  Text files
+// contain 64-bit shares, so they can only be read with 64-bit T.  Throws
+// std::runtime_error if the bit size of the file does not match T.
+template <typename T>
+TensorShares<T> read_tensor_shares(const std::string& path);
+
+// Like read_tensor_shares, but binary files are mapped in place instead of
+// being copied where the host allows it.
+template <typename T>
+TensorSharesView<T> load_tensor_shares(const std::string& path);
+
+}  // namespace MOTION
@@ -20,11 +20,16 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "test_constants.h"
 
 #include "crypto/aes/aesni_primitives.h"
+#include "utility/cpu_features.h"
 
 // Test vectors from NIST FIPS 197, Appendix A
 
@@ -172,3 +177,37 @@ TEST(aesni128, mmo_single) {
   aesni_mmo_single(round_keys.data(), output.data());
   EXPECT_EQ(output, expected_output);
 }
+
+TEST(aesni128, mmo_batch) {
+  std::array<std::uint8_t, aes_key_size_128> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(aes_block_size) std::array<std::uint8_t, aes_round_keys_size_128> round_keys;
+  std::copy(std::begin(key), std::end(key), std::begin(round_keys));
+  aesni_key_expansion_128(round_keys.data());
+
+  const auto& features = ENCRYPTO::get_cpu_features();
+  std::mt19937 gen(42);
+  // cover the main loops and the remainders of all variants
+  for (std::size_t num_blocks : {0, 1, 7, 8, 9, 16, 37}) {
+    std::vector<std::uint8_t> input(num_blocks * aes_block_size);
+    std::generate(std::begin(input), std::end(input), [&gen] { return gen(); });
+    auto expected_output = input;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+      aesni_mmo_single(round_keys.data(), expected_output.data() + i * aes_block_size);
+    }
+
+    auto output = input;
+    aesni_mmo_batch(round_keys.data(), output.data(), num_blocks);
+    EXPECT_EQ(output, expected_output);
+    if (features.vaes_ && features.avx2_) {
+      output = input;
+      vaes_mmo_batch_256(round_keys.data(), output.data(), num_blocks);
+      EXPECT_EQ(output, expected_output);
+    }
+    if (features.vaes_ && features.avx512f_) {
+      output = input;
+      vaes_mmo_batch_512(round_keys.data(), output.data(), num_blocks);
+      EXPECT_EQ(output, expected_output);
+    }
+  }
+}
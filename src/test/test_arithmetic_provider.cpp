@@ -281,6 +281,70 @@ TYPED_TEST(ArithmeticProviderTest, MatrixMultiplication) {
   }
 }
 
+// The matrix multiplication uses l * m * bit_size OTs if n >= l, and computes the transposed
+// product with m * n * bit_size OTs in the other direction if n < l.
+TYPED_TEST(ArithmeticProviderTest, MatrixMultiplicationOTCount) {
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<TypeParam>;
+  const std::size_t dim_m = 13;
+  const std::array<std::pair<std::size_t, std::size_t>, 2> outer_dims = {{{3, 11}, {11, 3}}};
+
+  auto& rhs_ot_provider =
+      this->ot_provider_managers_[this->sender_i_]->get_provider(this->receiver_i_);
+  auto& lhs_ot_provider =
+      this->ot_provider_managers_[this->receiver_i_]->get_provider(this->sender_i_);
+
+  std::vector<std::unique_ptr<MOTION::MatrixMultiplicationRHS<TypeParam>>> mm_rhs;
+  std::vector<std::unique_ptr<MOTION::MatrixMultiplicationLHS<TypeParam>>> mm_lhs;
+  for (const auto& [dim_l, dim_n] : outer_dims) {
+    const auto rhs_num_sent = rhs_ot_provider.GetNumOTsSender();
+    const auto rhs_num_received = rhs_ot_provider.GetNumOTsReceiver();
+    const auto lhs_num_sent = lhs_ot_provider.GetNumOTsSender();
+    const auto lhs_num_received = lhs_ot_provider.GetNumOTsReceiver();
+
+    mm_rhs.push_back(
+        this->get_sender_provider().template register_matrix_multiplication_rhs<TypeParam>(
+            dim_l, dim_m, dim_n));
+    mm_lhs.push_back(
+        this->get_receiver_provider().template register_matrix_multiplication_lhs<TypeParam>(
+            dim_l, dim_m, dim_n));
+
+    // the number of OTs only depends on the smaller one of the outer dimensions
+    const bool transposed = dim_n < dim_l;
+    const std::size_t expected_num_ots = std::min(dim_l, dim_n) * dim_m * bit_size;
+    EXPECT_EQ(rhs_ot_provider.GetNumOTsSender() - rhs_num_sent,
+              transposed ? 0 : expected_num_ots);
+    EXPECT_EQ(rhs_ot_provider.GetNumOTsReceiver() - rhs_num_received,
+              transposed ? expected_num_ots : 0);
+    EXPECT_EQ(lhs_ot_provider.GetNumOTsSender() - lhs_num_sent,
+              transposed ? expected_num_ots : 0);
+    EXPECT_EQ(lhs_ot_provider.GetNumOTsReceiver() - lhs_num_received,
+              transposed ? 0 : expected_num_ots);
+  }
+
+  this->run_setup();
+
+  for (std::size_t mm_i = 0; mm_i < outer_dims.size(); ++mm_i) {
+    const auto [dim_l, dim_n] = outer_dims[mm_i];
+    const auto input_rhs = MOTION::Helpers::RandomVector<TypeParam>(dim_m * dim_n);
+    const auto input_lhs = MOTION::Helpers::RandomVector<TypeParam>(dim_l * dim_m);
+    const auto expected_output =
+        MOTION::matrix_multiply(dim_l, dim_m, dim_n, input_lhs, input_rhs);
+
+    mm_rhs[mm_i]->set_input(input_rhs);
+    mm_lhs[mm_i]->set_input(input_lhs);
+    mm_rhs[mm_i]->compute_output();
+    mm_lhs[mm_i]->compute_output();
+    const auto output_sender = mm_rhs[mm_i]->get_output();
+    const auto output_receiver = mm_lhs[mm_i]->get_output();
+
+    ASSERT_EQ(output_sender.size(), dim_l * dim_n);
+    ASSERT_EQ(output_receiver.size(), dim_l * dim_n);
+    for (std::size_t i = 0; i < dim_l * dim_n; ++i) {
+      ASSERT_EQ(TypeParam(output_sender[i] + output_receiver[i]), expected_output[i]);
+    }
+  }
+}
+
 TYPED_TEST(ArithmeticProviderTest, Convolution) {
   // Convolution from CryptoNets
   const MOTION::tensor::Conv2DOp conv_op = {.kernel_shape_ = {5, 1, 5, 5},
@@ -20,12 +20,20 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <filesystem>
+#include <future>
+
+#include <fmt/format.h>
+#include <unistd.h>
+
 #include "gtest/gtest.h"
 
 #include "test_constants.h"
 
 #include "base/backend.h"
 #include "base/party.h"
+#include "communication/communication_layer.h"
+#include "crypto/base_ots/base_ot_cache.h"
 #include "crypto/base_ots/base_ot_provider.h"
 #include "data_storage/base_ot_data.h"
 
@@ -115,3 +123,78 @@ TEST(ObliviousTransfer, BaseOT) {
     }
   }
 }
+
+TEST(ObliviousTransfer, BaseOTCache) {
+  namespace fs = std::filesystem;
+  const auto cache_dir = fs::temp_directory_path() / fmt::format("motion_base_ots_{}", ::getpid());
+  fs::remove_all(cache_dir);
+  const BaseOTCache cache(cache_dir);
+
+  // run the base OTs between two parties and return the exported base OTs of both
+  const auto run_base_ots = [&cache](const std::vector<std::uint8_t> &session_id) {
+    auto comm_layers = Communication::make_dummy_communication_layers(2);
+    std::vector<std::unique_ptr<BaseOTProvider>> base_ot_providers;
+    for (std::size_t i = 0; i < 2; ++i) {
+      base_ot_providers.emplace_back(
+          std::make_unique<BaseOTProvider>(*comm_layers[i], nullptr, nullptr));
+    }
+    std::vector<std::future<void>> futs;
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [&, i] {
+        comm_layers[i]->start();
+        base_ot_providers[i]->ComputeBaseOTs(cache, session_id);
+      }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto &f) { f.get(); });
+    std::vector<std::pair<ReceiverMsgs, SenderMsgs>> base_ots;
+    for (std::size_t i = 0; i < 2; ++i) {
+      base_ots.push_back(base_ot_providers[i]->ExportBaseOTs(1 - i));
+    }
+    futs.clear();
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [&, i] { comm_layers[i]->shutdown(); }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto &f) { f.get(); });
+    return base_ots;
+  };
+
+  const auto check_correlation = [](const auto &base_ots) {
+    for (std::size_t i = 0; i < 2; ++i) {
+      const auto &[receiver_msgs, _] = base_ots.at(i);
+      const auto &sender_msgs = base_ots.at(1 - i).second;
+      for (std::size_t k = 0; k < kappa; ++k) {
+        if (receiver_msgs.c_.Get(k)) {
+          EXPECT_EQ(receiver_msgs.messages_c_.at(k), sender_msgs.messages_1_.at(k));
+        } else {
+          EXPECT_EQ(receiver_msgs.messages_c_.at(k), sender_msgs.messages_0_.at(k));
+        }
+      }
+    }
+  };
+
+  const auto first_run = run_base_ots({1, 2, 3, 4});
+  check_correlation(first_run);
+  for (std::size_t i = 0; i < 2; ++i) {
+    const auto path = cache.get_path(i, 1 - i);
+    ASSERT_TRUE(fs::exists(path));
+    EXPECT_EQ(fs::status(path).permissions() & (fs::perms::group_all | fs::perms::others_all),
+              fs::perms::none);
+  }
+
+  // the second run reuses the choice bits, but derives fresh messages
+  const auto second_run = run_base_ots({5, 6, 7, 8});
+  check_correlation(second_run);
+  for (std::size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(first_run.at(i).first.c_, second_run.at(i).first.c_);
+    EXPECT_NE(first_run.at(i).first.messages_c_, second_run.at(i).first.messages_c_);
+    EXPECT_NE(first_run.at(i).second.messages_0_, second_run.at(i).second.messages_0_);
+  }
+
+  // without a matching entry on the other side, the base OTs are computed again
+  cache.remove(1, 0);
+  const auto third_run = run_base_ots({5, 6, 7, 8});
+  check_correlation(third_run);
+  EXPECT_NE(second_run.at(0).second.messages_0_, third_run.at(0).second.messages_0_);
+
+  fs::remove_all(cache_dir);
+}
@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <array>
 #include <iterator>
 #include <memory>
@@ -548,6 +549,68 @@ TEST_F(BooleanBEAVYTest, ConstantAND) {
   }
 }
 
+TEST_F(BooleanBEAVYTest, Circuit) {
+  // max of two 8 bit integers: one layer for the comparison and one for the selection
+  const auto& algo = circuit_loader_.load_gtmux_circuit(8, true);
+  std::size_t num_wires = 8;
+  std::size_t num_simd = 10;
+  // keep the values small, such that X - Y does not overflow
+  std::vector<std::uint8_t> values_a(num_simd);
+  std::vector<std::uint8_t> values_b(num_simd);
+  std::generate(std::begin(values_a), std::end(values_a), [] { return std::rand() % 64; });
+  std::generate(std::begin(values_b), std::end(values_b), [] { return std::rand() % 64; });
+  const auto to_bits = [num_wires, num_simd](const auto& values) {
+    MOTION::BitValues bits(num_wires, ENCRYPTO::BitVector<>(num_simd));
+    for (std::size_t wire_i = 0; wire_i < num_wires; ++wire_i) {
+      for (std::size_t simd_j = 0; simd_j < num_simd; ++simd_j) {
+        bits.at(wire_i).Set((values.at(simd_j) >> wire_i) & 1, simd_j);
+      }
+    }
+    return bits;
+  };
+  const auto inputs_a = to_bits(values_a);
+  const auto inputs_b = to_bits(values_b);
+  std::vector<std::uint8_t> max_values(num_simd);
+  std::transform(std::begin(values_a), std::end(values_a), std::begin(values_b),
+                 std::begin(max_values), [](auto a, auto b) { return std::max(a, b); });
+  const auto expected_output = to_bits(max_values);
+
+  auto [input_a_promise, wires_0_in_a] =
+      beavy_providers_[0]->make_boolean_input_gate_my(0, num_wires, num_simd);
+  auto wires_1_in_a = beavy_providers_[1]->make_boolean_input_gate_other(0, num_wires, num_simd);
+  auto wires_0_in_b = beavy_providers_[0]->make_boolean_input_gate_other(1, num_wires, num_simd);
+  auto [input_b_promise, wires_1_in_b] =
+      beavy_providers_[1]->make_boolean_input_gate_my(1, num_wires, num_simd);
+  wires_0_in_a.insert(std::end(wires_0_in_a), std::begin(wires_0_in_b), std::end(wires_0_in_b));
+  wires_1_in_a.insert(std::end(wires_1_in_a), std::begin(wires_1_in_b), std::end(wires_1_in_b));
+  auto wires_0_out = beavy_providers_[0]->make_circuit_gate(algo, wires_0_in_a);
+  auto wires_1_out = beavy_providers_[1]->make_circuit_gate(algo, wires_1_in_a);
+  ASSERT_EQ(wires_0_out.size(), num_wires);
+  ASSERT_EQ(wires_1_out.size(), num_wires);
+
+  run_setup();
+  run_gates_setup();
+  input_a_promise.set_value(inputs_a);
+  input_b_promise.set_value(inputs_b);
+  run_gates_online();
+
+  for (std::size_t wire_i = 0; wire_i < num_wires; ++wire_i) {
+    const auto& expected_output_bits = expected_output.at(wire_i);
+    const auto wire_0 = std::dynamic_pointer_cast<BooleanBEAVYWire>(wires_0_out.at(wire_i));
+    const auto wire_1 = std::dynamic_pointer_cast<BooleanBEAVYWire>(wires_1_out.at(wire_i));
+    wire_0->wait_online();
+    wire_1->wait_online();
+    const auto& pshare_0 = wire_0->get_public_share();
+    const auto& pshare_1 = wire_1->get_public_share();
+    const auto& sshare_0 = wire_0->get_secret_share();
+    const auto& sshare_1 = wire_1->get_secret_share();
+    ASSERT_EQ(pshare_0.GetSize(), num_simd);
+    ASSERT_EQ(sshare_0.GetSize(), num_simd);
+    ASSERT_EQ(pshare_0, pshare_1);
+    ASSERT_EQ(expected_output_bits, pshare_0 ^ sshare_0 ^ sshare_1);
+  }
+}
+
 TEST_F(BooleanBEAVYTest, BooleanBEAVYToGMW) {
   std::size_t num_wires = 8;
   std::size_t num_simd = 10;
@@ -20,9 +20,15 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 #include <gtest/gtest.h>
 
@@ -148,6 +154,34 @@ class ArithmeticBEAVYTensorTest : public BEAVYTensorTest {
   static std::vector<T> generate_inputs(const MOTION::tensor::TensorDimensions dims) {
     return MOTION::Helpers::RandomVector<T>(dims.get_data_size());
   }
+  // random signed values in [-2^(bits - 1), 2^(bits - 1)), s.t. fixed-point products and their
+  // sums stay far below the ring size and the probabilistic truncation does not fail
+  static std::vector<T> generate_small_inputs(const MOTION::tensor::TensorDimensions dims,
+                                              std::size_t bits) {
+    auto inputs = generate_inputs(dims);
+    std::transform(std::begin(inputs), std::end(inputs), std::begin(inputs),
+                   [bits](auto x) { return T(x >> (ENCRYPTO::bit_size_v<T> - bits)) -
+                                           (T(1) << (bits - 1)); });
+    return inputs;
+  }
+  // plaintext reference of the truncation: arithmetic shift of the signed value
+  static std::vector<T> truncate(std::vector<T> values, std::size_t fractional_bits) {
+    std::transform(std::begin(values), std::end(values), std::begin(values),
+                   [fractional_bits](auto x) {
+                     return T(static_cast<std::make_signed_t<T>>(x) >> fractional_bits);
+                   });
+    return values;
+  }
+  // the truncation of shares is off by at most one
+  static void expect_truncated_eq(const std::vector<T>& values,
+                                  const std::vector<T>& expected_values) {
+    ASSERT_EQ(values.size(), expected_values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      const T diff = values[i] - expected_values[i];
+      EXPECT_TRUE(diff == 0 || diff == 1 || diff == T(-1))
+          << "at " << i << ": " << values[i] << " vs. " << expected_values[i];
+    }
+  }
   std::pair<ENCRYPTO::ReusableFiberPromise<MOTION::IntegerValues<T>>, MOTION::tensor::TensorCP>
   make_arithmetic_T_tensor_input_my(std::size_t party_id,
                                     const MOTION::tensor::TensorDimensions& dims) {
@@ -252,6 +286,53 @@ TYPED_TEST(ArithmeticBEAVYTensorTest, Input) {
   }
 }
 
+TYPED_TEST(ArithmeticBEAVYTensorTest, InputWithMessageCoalescing) {
+  MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 2, .width_ = 3};
+  constexpr std::size_t num_inputs = 8;
+  for (std::size_t i = 0; i < 2; ++i) {
+    this->beavy_providers_[i]->set_message_coalescing(std::chrono::microseconds(200));
+  }
+
+  // many small input tensors whose messages are sent together
+  std::vector<std::vector<TypeParam>> inputs;
+  std::vector<ENCRYPTO::ReusableFiberPromise<MOTION::IntegerValues<TypeParam>>> promises;
+  std::vector<std::array<MOTION::tensor::TensorCP, 2>> tensors;
+  for (std::size_t j = 0; j < num_inputs; ++j) {
+    inputs.push_back(this->generate_inputs(dims));
+    auto [promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+    auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+    promises.push_back(std::move(promise));
+    tensors.push_back({tensor_in_0, tensor_in_1});
+  }
+
+  this->run_setup();
+  this->run_gates_setup();
+  for (std::size_t j = 0; j < num_inputs; ++j) {
+    promises[j].set_value(inputs[j]);
+  }
+  this->run_gates_online();
+
+  for (std::size_t j = 0; j < num_inputs; ++j) {
+    const auto tensor_0 =
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensors[j][0]);
+    const auto tensor_1 =
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensors[j][1]);
+    ASSERT_NE(tensor_0, nullptr);
+    ASSERT_NE(tensor_1, nullptr);
+    tensor_0->wait_online();
+    tensor_1->wait_online();
+    const auto& pshare_0 = tensor_0->get_public_share();
+    const auto& pshare_1 = tensor_1->get_public_share();
+    const auto& sshare_0 = tensor_0->get_secret_share();
+    const auto& sshare_1 = tensor_1->get_secret_share();
+    ASSERT_EQ(pshare_0, pshare_1);
+    for (std::size_t i = 0; i < inputs[j].size(); ++i) {
+      ASSERT_EQ(inputs[j][i], TypeParam(pshare_0[i] - sshare_0[i] - sshare_1[i]));
+    }
+  }
+}
+
 TYPED_TEST(ArithmeticBEAVYTensorTest, OutputSingle) {
   MOTION::tensor::TensorDimensions dims = {
       .batch_size_ = 1, .num_channels_ = 1, .height_ = 28, .width_ = 28};
@@ -419,6 +500,263 @@ TYPED_TEST(ArithmeticBEAVYTensorTest, Gemm) {
   ASSERT_EQ(plain_output, expected_output);
 }
 
+TYPED_TEST(ArithmeticBEAVYTensorTest, PublicGemm) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {10, 100}, .input_B_shape_ = {100, 4}, .output_shape_ = {10, 4}};
+  ASSERT_TRUE(gemm_op.verify());
+  const auto input_A_dims = gemm_op.get_input_A_tensor_dims();
+  const auto input_B_dims = gemm_op.get_input_B_tensor_dims();
+  const auto output_dims = gemm_op.get_output_tensor_dims();
+  const auto input_A = this->generate_inputs(input_A_dims);
+  const auto input_B = this->generate_inputs(input_B_dims);
+  const std::vector<std::uint64_t> public_A(std::begin(input_A), std::end(input_A));
+
+  auto tensor_input_B_0 = this->make_arithmetic_T_tensor_input_other(0, input_B_dims);
+  auto [input_B_promise, tensor_input_B_1] =
+      this->make_arithmetic_T_tensor_input_my(1, input_B_dims);
+
+  auto tensor_output_0 =
+      this->beavy_providers_[0]->make_tensor_gemm_op(gemm_op, public_A, tensor_input_B_0);
+  auto tensor_output_1 =
+      this->beavy_providers_[1]->make_tensor_gemm_op(gemm_op, public_A, tensor_input_B_1);
+
+  ASSERT_EQ(tensor_output_0->get_dimensions(), output_dims);
+  ASSERT_EQ(tensor_output_1->get_dimensions(), output_dims);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_B_promise.set_value(input_B);
+  this->run_gates_online();
+
+  const auto output_beavy_tensor_0 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_0);
+  const auto output_beavy_tensor_1 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_1);
+
+  const auto& public_output_share_0 = output_beavy_tensor_0->get_public_share();
+  const auto& public_output_share_1 = output_beavy_tensor_1->get_public_share();
+  const auto& secret_output_share_0 = output_beavy_tensor_0->get_secret_share();
+  const auto& secret_output_share_1 = output_beavy_tensor_1->get_secret_share();
+
+  ASSERT_EQ(public_output_share_0.size(), output_dims.get_data_size());
+  ASSERT_EQ(secret_output_share_0.size(), output_dims.get_data_size());
+  ASSERT_EQ(secret_output_share_1.size(), output_dims.get_data_size());
+  ASSERT_EQ(public_output_share_0, public_output_share_1);
+
+  const auto expected_output =
+      MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                              gemm_op.input_B_shape_[1], input_A, input_B);
+  const auto plain_output = MOTION::Helpers::SubVectors(
+      public_output_share_0,
+      MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
+
+  ASSERT_EQ(plain_output, expected_output);
+}
+
+TYPED_TEST(ArithmeticBEAVYTensorTest, PublicGemmFixedPoint) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {10, 16}, .input_B_shape_ = {16, 4}, .output_shape_ = {10, 4}};
+  ASSERT_TRUE(gemm_op.verify());
+  const auto input_A_dims = gemm_op.get_input_A_tensor_dims();
+  const auto input_B_dims = gemm_op.get_input_B_tensor_dims();
+  // values in [-0.5, 0.5)
+  const std::size_t fractional_bits = ENCRYPTO::bit_size_v<TypeParam> == 32 ? 6 : 16;
+  const auto input_A = this->generate_small_inputs(input_A_dims, fractional_bits);
+  const auto input_B = this->generate_small_inputs(input_B_dims, fractional_bits);
+  // negative weights are given as sign-extended 64-bit values
+  std::vector<std::uint64_t> public_A(input_A.size());
+  std::transform(std::begin(input_A), std::end(input_A), std::begin(public_A), [](auto x) {
+    return std::uint64_t(std::int64_t(static_cast<std::make_signed_t<TypeParam>>(x)));
+  });
+
+  auto tensor_input_B_0 = this->make_arithmetic_T_tensor_input_other(0, input_B_dims);
+  auto [input_B_promise, tensor_input_B_1] =
+      this->make_arithmetic_T_tensor_input_my(1, input_B_dims);
+
+  auto tensor_output_0 = this->beavy_providers_[0]->make_tensor_gemm_op(
+      gemm_op, public_A, tensor_input_B_0, fractional_bits);
+  auto tensor_output_1 = this->beavy_providers_[1]->make_tensor_gemm_op(
+      gemm_op, public_A, tensor_input_B_1, fractional_bits);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_B_promise.set_value(input_B);
+  this->run_gates_online();
+
+  const auto output_beavy_tensor_0 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_0);
+  const auto output_beavy_tensor_1 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_1);
+  const auto& public_output_share_0 = output_beavy_tensor_0->get_public_share();
+  const auto& public_output_share_1 = output_beavy_tensor_1->get_public_share();
+  const auto& secret_output_share_0 = output_beavy_tensor_0->get_secret_share();
+  const auto& secret_output_share_1 = output_beavy_tensor_1->get_secret_share();
+  ASSERT_EQ(public_output_share_0, public_output_share_1);
+
+  const auto product =
+      MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                              gemm_op.input_B_shape_[1], input_A, input_B);
+  const auto plain_output = MOTION::Helpers::SubVectors(
+      public_output_share_0,
+      MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
+  this->expect_truncated_eq(plain_output, this->truncate(product, fractional_bits));
+}
+
+TYPED_TEST(ArithmeticBEAVYTensorTest, PublicGemmRejectsTooWideValues) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {2, 2}, .input_B_shape_ = {2, 1}, .output_shape_ = {2, 1}};
+  const auto input_B_dims = gemm_op.get_input_B_tensor_dims();
+  auto tensor_input_B = this->make_arithmetic_T_tensor_input_other(0, input_B_dims);
+  // unsigned and sign-extended values of the bit size are accepted
+  const std::vector<std::uint64_t> public_A = {
+      1, std::uint64_t(-1), std::uint64_t(std::numeric_limits<TypeParam>::max()), 0};
+  EXPECT_NO_THROW(this->beavy_providers_[0]->make_tensor_gemm_op(gemm_op, public_A,
+                                                                 tensor_input_B));
+  if constexpr (ENCRYPTO::bit_size_v<TypeParam> < 64) {
+    const std::vector<std::uint64_t> wide_A = {1, 2, std::uint64_t(1) << 40, 4};
+    EXPECT_THROW(this->beavy_providers_[0]->make_tensor_gemm_op(gemm_op, wide_A, tensor_input_B),
+                 std::invalid_argument);
+  }
+}
+
+TYPED_TEST(ArithmeticBEAVYTensorTest, Dense) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {10, 100}, .input_B_shape_ = {100, 4}, .output_shape_ = {10, 4}};
+  ASSERT_TRUE(gemm_op.verify());
+  const auto input_A_dims = gemm_op.get_input_A_tensor_dims();
+  const auto input_B_dims = gemm_op.get_input_B_tensor_dims();
+  const auto output_dims = gemm_op.get_output_tensor_dims();
+  const MOTION::tensor::TensorDimensions bias_dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 10, .width_ = 1};
+  const auto input_A = this->generate_inputs(input_A_dims);
+  const auto input_B = this->generate_inputs(input_B_dims);
+  const auto bias = this->generate_inputs(bias_dims);
+
+  auto [input_A_promise, tensor_input_A_0] =
+      this->make_arithmetic_T_tensor_input_my(0, input_A_dims);
+  auto tensor_input_A_1 = this->make_arithmetic_T_tensor_input_other(1, input_A_dims);
+  auto tensor_input_B_0 = this->make_arithmetic_T_tensor_input_other(0, input_B_dims);
+  auto [input_B_promise, tensor_input_B_1] =
+      this->make_arithmetic_T_tensor_input_my(1, input_B_dims);
+  auto [bias_promise, tensor_bias_0] = this->make_arithmetic_T_tensor_input_my(0, bias_dims);
+  auto tensor_bias_1 = this->make_arithmetic_T_tensor_input_other(1, bias_dims);
+
+  auto tensor_output_0 = this->beavy_providers_[0]->make_tensor_dense_op(
+      gemm_op, tensor_input_A_0, tensor_input_B_0, tensor_bias_0, 0, true);
+  auto tensor_output_1 = this->beavy_providers_[1]->make_tensor_dense_op(
+      gemm_op, tensor_input_A_1, tensor_input_B_1, tensor_bias_1, 0, true);
+
+  ASSERT_EQ(tensor_output_0->get_dimensions(), output_dims);
+  ASSERT_EQ(tensor_output_1->get_dimensions(), output_dims);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_A_promise.set_value(input_A);
+  input_B_promise.set_value(input_B);
+  bias_promise.set_value(bias);
+  this->run_gates_online();
+
+  const auto output_beavy_tensor_0 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_0);
+  const auto output_beavy_tensor_1 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_1);
+
+  const auto& public_output_share_0 = output_beavy_tensor_0->get_public_share();
+  const auto& public_output_share_1 = output_beavy_tensor_1->get_public_share();
+  const auto& secret_output_share_0 = output_beavy_tensor_0->get_secret_share();
+  const auto& secret_output_share_1 = output_beavy_tensor_1->get_secret_share();
+
+  ASSERT_EQ(public_output_share_0.size(), output_dims.get_data_size());
+  ASSERT_EQ(secret_output_share_0.size(), output_dims.get_data_size());
+  ASSERT_EQ(secret_output_share_1.size(), output_dims.get_data_size());
+  ASSERT_EQ(public_output_share_0, public_output_share_1);
+
+  auto expected_output =
+      MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                              gemm_op.input_B_shape_[1], input_A, input_B);
+  for (std::size_t i = 0; i < expected_output.size(); ++i) {
+    expected_output[i] = -(expected_output[i] + bias[i / gemm_op.output_shape_[1]]);
+  }
+  const auto plain_output = MOTION::Helpers::SubVectors(
+      public_output_share_0,
+      MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
+
+  ASSERT_EQ(plain_output, expected_output);
+}
+
+TYPED_TEST(ArithmeticBEAVYTensorTest, DenseFixedPoint) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {10, 16}, .input_B_shape_ = {16, 4}, .output_shape_ = {10, 4}};
+  ASSERT_TRUE(gemm_op.verify());
+  const auto input_A_dims = gemm_op.get_input_A_tensor_dims();
+  const auto input_B_dims = gemm_op.get_input_B_tensor_dims();
+  const auto output_dims = gemm_op.get_output_tensor_dims();
+  const MOTION::tensor::TensorDimensions bias_dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 10, .width_ = 1};
+  // values in [-0.5, 0.5), the bias in [-1, 1)
+  const std::size_t fractional_bits = ENCRYPTO::bit_size_v<TypeParam> == 32 ? 6 : 16;
+  const auto input_A = this->generate_small_inputs(input_A_dims, fractional_bits);
+  const auto input_B = this->generate_small_inputs(input_B_dims, fractional_bits);
+  const auto bias = this->generate_small_inputs(bias_dims, fractional_bits + 1);
+
+  auto [input_A_promise, tensor_input_A_0] =
+      this->make_arithmetic_T_tensor_input_my(0, input_A_dims);
+  auto tensor_input_A_1 = this->make_arithmetic_T_tensor_input_other(1, input_A_dims);
+  auto tensor_input_B_0 = this->make_arithmetic_T_tensor_input_other(0, input_B_dims);
+  auto [input_B_promise, tensor_input_B_1] =
+      this->make_arithmetic_T_tensor_input_my(1, input_B_dims);
+  auto [bias_promise, tensor_bias_0] = this->make_arithmetic_T_tensor_input_my(0, bias_dims);
+  auto tensor_bias_1 = this->make_arithmetic_T_tensor_input_other(1, bias_dims);
+
+  // the same layer with and without the negation the ReLU conversion expects
+  std::array<std::array<MOTION::tensor::TensorCP, 2>, 2> tensor_outputs;
+  for (const bool negate : {false, true}) {
+    tensor_outputs[negate][0] = this->beavy_providers_[0]->make_tensor_dense_op(
+        gemm_op, tensor_input_A_0, tensor_input_B_0, tensor_bias_0, fractional_bits, negate);
+    tensor_outputs[negate][1] = this->beavy_providers_[1]->make_tensor_dense_op(
+        gemm_op, tensor_input_A_1, tensor_input_B_1, tensor_bias_1, fractional_bits, negate);
+  }
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_A_promise.set_value(input_A);
+  input_B_promise.set_value(input_B);
+  bias_promise.set_value(bias);
+  this->run_gates_online();
+
+  // plaintext fixed-point reference: the product has 2f fractional bits, the bias is scaled to
+  // them before the result is truncated to f fractional bits
+  auto product = MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                                         gemm_op.input_B_shape_[1], input_A, input_B);
+  for (std::size_t i = 0; i < product.size(); ++i) {
+    product[i] += TypeParam(bias[i / gemm_op.output_shape_[1]] << fractional_bits);
+  }
+  std::vector<TypeParam> negated_product(product.size());
+  std::transform(std::begin(product), std::end(product), std::begin(negated_product),
+                 std::negate{});
+
+  for (const bool negate : {false, true}) {
+    const auto output_beavy_tensor_0 =
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(
+            tensor_outputs[negate][0]);
+    const auto output_beavy_tensor_1 =
+        std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(
+            tensor_outputs[negate][1]);
+    ASSERT_EQ(output_beavy_tensor_0->get_dimensions(), output_dims);
+    const auto& public_output_share_0 = output_beavy_tensor_0->get_public_share();
+    const auto& public_output_share_1 = output_beavy_tensor_1->get_public_share();
+    const auto& secret_output_share_0 = output_beavy_tensor_0->get_secret_share();
+    const auto& secret_output_share_1 = output_beavy_tensor_1->get_secret_share();
+    ASSERT_EQ(public_output_share_0, public_output_share_1);
+
+    const auto plain_output = MOTION::Helpers::SubVectors(
+        public_output_share_0,
+        MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
+    this->expect_truncated_eq(plain_output,
+                              this->truncate(negate ? negated_product : product, fractional_bits));
+  }
+}
+
 TYPED_TEST(ArithmeticBEAVYTensorTest, Sqr) {
   MOTION::tensor::TensorDimensions dims = {
       .batch_size_ = 1, .num_channels_ = 1, .height_ = 28, .width_ = 28};
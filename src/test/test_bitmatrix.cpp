@@ -27,6 +27,7 @@
 #include <gtest/gtest.h>
 
 #include "utility/bit_matrix.h"
+#include "utility/cpu_features.h"
 
 #include "test_constants.h"
 
@@ -89,6 +90,40 @@ TEST(BitMatrix, Transpose128) {
   }
 }
 
+TEST(BitMatrix, Transpose128x128BlockKernels) {
+  const std::size_t m = 128, n = 512;
+  std::vector<ENCRYPTO::AlignedBitVector> vectors(m);
+  std::array<const std::byte *, 128> ptrs;
+  for (auto j = 0ull; j < m; ++j) {
+    vectors.at(j) = ENCRYPTO::AlignedBitVector::Random(n);
+    ptrs.at(j) = vectors.at(j).GetData().data();
+  }
+
+  std::vector<decltype(&ENCRYPTO::BitMatrix::Transpose128x128Block)> kernels = {
+      &ENCRYPTO::BitMatrix::Transpose128x128Block,
+      &ENCRYPTO::BitMatrix::Transpose128x128BlockSSE};
+  const auto level = ENCRYPTO::get_supported_simd_level();
+  if (level >= ENCRYPTO::SIMDLevel::AVX2) {
+    kernels.push_back(&ENCRYPTO::BitMatrix::Transpose128x128BlockAVX2);
+  }
+  if (level >= ENCRYPTO::SIMDLevel::AVX512) {
+    kernels.push_back(&ENCRYPTO::BitMatrix::Transpose128x128BlockAVX512);
+  }
+
+  for (auto kernel : kernels) {
+    for (auto column = 0ull; column < n; column += m) {
+      alignas(16) std::array<std::byte, m * m / 8> out;
+      kernel(ptrs.data(), column, out.data());
+      for (auto column_i = 0ull; column_i < m; ++column_i) {
+        ENCRYPTO::BitVector<> transposed(out.data() + column_i * m / 8, m);
+        for (auto row_i = 0ull; row_i < m; ++row_i) {
+          ASSERT_EQ(vectors.at(row_i).Get(column + column_i), transposed.Get(row_i));
+        }
+      }
+    }
+  }
+}
+
 TEST(BitMatrix, Transpose128InPlaceOnRawPointers) {
   for (auto test_iterations = 0ull; test_iterations < TEST_ITERATIONS; ++test_iterations) {
     for (auto i = 7ull; i < 15u; ++i) {
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "communication/buffer_pool.h"
+
+using MOTION::Communication::BufferPool;
+
+TEST(BufferPool, ReuseReleasedBuffer) {
+  BufferPool pool;
+  auto buffer = pool.acquire(1000);
+  EXPECT_EQ(buffer.size(), 1000);
+  const auto* data = buffer.data();
+  pool.release(std::move(buffer));
+  EXPECT_EQ(pool.get_num_retained_bytes(), 1000);
+
+  // a smaller message still fits
+  auto reused_buffer = pool.acquire(600);
+  EXPECT_EQ(reused_buffer.size(), 600);
+  EXPECT_EQ(reused_buffer.data(), data);
+  EXPECT_EQ(pool.get_num_allocations(), 1);
+  EXPECT_EQ(pool.get_num_reuses(), 1);
+  EXPECT_EQ(pool.get_num_retained_bytes(), 0);
+}
+
+// small messages must not pin large buffers
+TEST(BufferPool, RefuseMuchLargerBuffer) {
+  BufferPool pool;
+  pool.release(pool.acquire(1 << 20));
+  auto buffer = pool.acquire(16);
+  EXPECT_LT(buffer.capacity(), 1 << 20);
+  EXPECT_EQ(pool.get_num_allocations(), 2);
+  EXPECT_EQ(pool.get_num_reuses(), 0);
+  EXPECT_EQ(pool.get_num_retained_bytes(), 1 << 20);
+}
+
+TEST(BufferPool, LimitRetainedBytes) {
+  const std::size_t max_retained_bytes = 4096;
+  const std::size_t max_buffer_size = 2048;
+  BufferPool pool(max_retained_bytes, max_buffer_size);
+
+  // too large to be kept at all
+  pool.release(pool.acquire(max_buffer_size + 1));
+  EXPECT_EQ(pool.get_num_retained_bytes(), 0);
+
+  std::vector<std::vector<std::uint8_t>> buffers;
+  for (std::size_t i = 0; i < 3; ++i) {
+    buffers.push_back(pool.acquire(max_buffer_size));
+  }
+  for (auto& buffer : buffers) {
+    pool.release(std::move(buffer));
+  }
+  EXPECT_EQ(pool.get_num_retained_bytes(), max_retained_bytes);
+}
+
+// a payload at an odd offset of the message is copied before it is read as integers
+TEST(ReceivedPayload, CopyUnalignedPayload) {
+  const std::vector<std::uint64_t> values = {1, 2, 3};
+  std::vector<std::uint8_t> message(1 + values.size() * sizeof(std::uint64_t) + 8);
+  // the vector storage is aligned, so find an offset which is not
+  auto offset = std::size_t(1);
+  while (reinterpret_cast<std::uintptr_t>(message.data() + offset) % alignof(std::uint64_t) == 0) {
+    ++offset;
+  }
+  std::memcpy(message.data() + offset, values.data(), values.size() * sizeof(std::uint64_t));
+  const auto* payload_data = message.data() + offset;
+  MOTION::Communication::ReceivedPayload payload(std::move(message), payload_data,
+                                                 values.size() * sizeof(std::uint64_t));
+  ASSERT_FALSE(payload.is_aligned_for<std::uint64_t>());
+  std::vector<std::uint64_t> buffer;
+  const auto* data = payload.data_as(buffer);
+  EXPECT_EQ(data, buffer.data());
+  EXPECT_EQ(std::vector<std::uint64_t>(data, data + values.size()), values);
+}
@@ -0,0 +1,63 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "protocols/common/comm_mixin.h"
+
+// gate ids keep growing over the circuits of a session, so they may exceed
+// any fixed size of the table of expected messages
+TEST(CommMixin, LargeGateIds) {
+  using MOTION::Communication::MessageType;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  MOTION::proto::CommMixin mixin_alice(*comm_layers[0], MessageType::GMWGate, nullptr);
+  MOTION::proto::CommMixin mixin_bob(*comm_layers[1], MessageType::GMWGate, nullptr);
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  // gate ids of a late circuit in a long session, registered out of order
+  const auto first_gate_id = std::size_t(1) << 40;
+  const std::vector<std::size_t> gate_ids = {first_gate_id + 7, first_gate_id + (1 << 26),
+                                             first_gate_id};
+  std::vector<ENCRYPTO::ReusableFiberFuture<std::vector<std::uint64_t>>> futures;
+  for (auto gate_id : gate_ids) {
+    futures.push_back(mixin_bob.register_for_ints_message<std::uint64_t>(0, gate_id, 2));
+  }
+  for (auto gate_id : gate_ids) {
+    mixin_alice.send_ints_message<std::uint64_t>(1, gate_id, {gate_id, gate_id + 1});
+  }
+  for (std::size_t i = 0; i < gate_ids.size(); ++i) {
+    EXPECT_EQ(futures[i].get(), (std::vector<std::uint64_t>{gate_ids[i], gate_ids[i] + 1}));
+  }
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
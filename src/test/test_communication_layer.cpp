@@ -20,11 +20,19 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+
 #include <gtest/gtest.h>
 #include <boost/log/trivial.hpp>
 
 #include "communication/communication_layer.h"
+#include "communication/lz_codec.h"
+#include "communication/message.h"
 #include "communication/message_handler.h"
+#include "communication/transport.h"
 #include "utility/logger.h"
 
 TEST(CommunicationLayer, Dummy) {
@@ -85,6 +93,221 @@ TEST(CommunicationLayer, Dummy) {
   std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
 }
 
+TEST(CommunicationLayer, HandlerRegistration) {
+  using MOTION::Communication::MessageType;
+  using MOTION::Communication::QueueHandler;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  auto& cl_alice = comm_layers.at(0);
+  auto& cl_bob = comm_layers.at(1);
+
+  cl_bob->register_fallback_message_handler(
+      [](auto party_id) { return std::make_shared<QueueHandler>(); });
+  cl_bob->register_message_handler([](auto party_id) { return std::make_shared<QueueHandler>(); },
+                                   {MessageType::OutputMessage});
+  auto& qh_fallback = dynamic_cast<QueueHandler&>(cl_bob->get_fallback_message_handler(0));
+  auto& qh_output =
+      dynamic_cast<QueueHandler&>(cl_bob->get_message_handler(0, MessageType::OutputMessage));
+
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  const std::vector<std::uint8_t> payload = {0xde, 0xad, 0xbe, 0xef};
+  auto build_message = [&payload] {
+    auto builder = MOTION::Communication::BuildMessage(MessageType::OutputMessage, payload.data(),
+                                                       payload.size());
+    return std::vector<std::uint8_t>(builder.GetBufferPointer(),
+                                     builder.GetBufferPointer() + builder.GetSize());
+  };
+  const auto message = build_message();
+
+  // dispatched to the registered handler
+  cl_alice->send_message(1, message);
+  EXPECT_EQ(qh_output.get_queue().dequeue(), message);
+
+  // dispatched to the fallback handler after deregistering
+  cl_bob->deregister_message_handler({MessageType::OutputMessage});
+  EXPECT_THROW(cl_bob->get_message_handler(0, MessageType::OutputMessage), std::logic_error);
+  cl_alice->send_message(1, message);
+  EXPECT_EQ(qh_fallback.get_queue().dequeue(), message);
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
+namespace {
+
+// handler which calls a function while dispatching and records its destruction
+class CallbackHandler : public MOTION::Communication::MessageHandler {
+ public:
+  CallbackHandler(std::function<void()> callback, std::atomic<bool>& destroyed)
+      : callback_(std::move(callback)), destroyed_(destroyed) {}
+  ~CallbackHandler() override { destroyed_ = true; }
+  void received_message(std::size_t, std::vector<std::uint8_t>&&) override {
+    callback_();
+    // touch the handler after the callback has returned
+    ++num_messages_;
+  }
+
+ private:
+  std::function<void()> callback_;
+  std::atomic<bool>& destroyed_;
+  std::atomic<std::size_t> num_messages_ = 0;
+};
+
+std::vector<std::uint8_t> build_output_message(const std::vector<std::uint8_t>& payload) {
+  auto builder = MOTION::Communication::BuildMessage(
+      MOTION::Communication::MessageType::OutputMessage, payload.data(), payload.size());
+  return std::vector<std::uint8_t>(builder.GetBufferPointer(),
+                                   builder.GetBufferPointer() + builder.GetSize());
+}
+
+}  // namespace
+
+TEST(CommunicationLayer, HandlerDeregistersItself) {
+  using MOTION::Communication::MessageType;
+  using MOTION::Communication::QueueHandler;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  auto& cl_alice = comm_layers.at(0);
+  auto& cl_bob = comm_layers.at(1);
+
+  std::atomic<bool> destroyed = false;
+  std::promise<bool> alive_after_deregistration;
+  cl_bob->register_fallback_message_handler(
+      [](auto party_id) { return std::make_shared<QueueHandler>(); });
+  cl_bob->register_message_handler(
+      [&](auto party_id) {
+        return std::make_shared<CallbackHandler>(
+            [&] {
+              cl_bob->deregister_message_handler({MessageType::OutputMessage});
+              alive_after_deregistration.set_value(!destroyed);
+            },
+            destroyed);
+      },
+      {MessageType::OutputMessage});
+  auto& qh_fallback = dynamic_cast<QueueHandler&>(cl_bob->get_fallback_message_handler(0));
+
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  const auto message = build_output_message({0xde, 0xad, 0xbe, 0xef});
+
+  // the handler is released only after its dispatch has returned
+  cl_alice->send_message(1, message);
+  EXPECT_TRUE(alive_after_deregistration.get_future().get());
+  EXPECT_THROW(cl_bob->get_message_handler(0, MessageType::OutputMessage), std::logic_error);
+
+  // the next message goes to the fallback handler
+  cl_alice->send_message(1, message);
+  EXPECT_EQ(qh_fallback.get_queue().dequeue(), message);
+  EXPECT_TRUE(destroyed);
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, ConcurrentHandlerDeregistration) {
+  using MOTION::Communication::MessageType;
+  using MOTION::Communication::QueueHandler;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  auto& cl_alice = comm_layers.at(0);
+  auto& cl_bob = comm_layers.at(1);
+
+  std::atomic<bool> destroyed = false;
+  std::promise<void> entered_promise;
+  std::promise<void> leave_promise;
+  auto leave_future = leave_promise.get_future();
+  cl_bob->register_fallback_message_handler(
+      [](auto party_id) { return std::make_shared<QueueHandler>(); });
+  cl_bob->register_message_handler(
+      [&](auto party_id) {
+        return std::make_shared<CallbackHandler>(
+            [&] {
+              entered_promise.set_value();
+              leave_future.wait();
+            },
+            destroyed);
+      },
+      {MessageType::OutputMessage});
+  auto& qh_fallback = dynamic_cast<QueueHandler&>(cl_bob->get_fallback_message_handler(0));
+
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  const auto message = build_output_message({0xde, 0xad, 0xbe, 0xef});
+
+  // deregister while the receive thread is inside the handler
+  cl_alice->send_message(1, message);
+  entered_promise.get_future().wait();
+  auto deregistration_future = std::async(std::launch::async, [&cl_bob] {
+    cl_bob->deregister_message_handler({MessageType::OutputMessage});
+  });
+  EXPECT_EQ(deregistration_future.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  EXPECT_FALSE(destroyed);
+
+  // deregistration completes and releases the handler once the dispatch returns
+  leave_promise.set_value();
+  deregistration_future.get();
+  EXPECT_TRUE(destroyed);
+  EXPECT_THROW(cl_bob->get_message_handler(0, MessageType::OutputMessage), std::logic_error);
+  cl_alice->send_message(1, message);
+  EXPECT_EQ(qh_fallback.get_queue().dequeue(), message);
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, Compression) {
+  using MOTION::Communication::MessageType;
+  using MOTION::Communication::QueueHandler;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  auto& cl_alice = comm_layers.at(0);
+  auto& cl_bob = comm_layers.at(1);
+
+  cl_alice->set_message_codec(MessageType::OutputMessage, MOTION::Communication::MessageCodec::lz);
+  cl_bob->register_message_handler([](auto party_id) { return std::make_shared<QueueHandler>(); },
+                                   {MessageType::OutputMessage});
+  auto& qh_bob =
+      dynamic_cast<QueueHandler&>(cl_bob->get_message_handler(0, MessageType::OutputMessage));
+
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  // a compressible message is received as it was sent
+  const std::vector<std::uint8_t> payload(1 << 16, 0x2a);
+  auto builder = MOTION::Communication::BuildMessage(MessageType::OutputMessage, payload.data(),
+                                                     payload.size());
+  const std::vector<std::uint8_t> message(builder.GetBufferPointer(),
+                                          builder.GetBufferPointer() + builder.GetSize());
+  cl_alice->send_message(1, message);
+  EXPECT_EQ(qh_bob.get_queue().dequeue(), message);
+
+  {
+    std::vector<std::future<void>> futs;
+    for (auto& cl : comm_layers) {
+      futs.emplace_back(std::async(std::launch::async, [&cl] { cl->sync(); }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  }
+
+  const auto stats = cl_alice->get_transport_statistics().at(0);
+  EXPECT_EQ(stats.num_messages_compressed, 1);
+  EXPECT_EQ(stats.num_bytes_before_compression, message.size());
+  EXPECT_LT(stats.num_bytes_after_compression, message.size() / 16);
+  EXPECT_LT(stats.num_bytes_sent, message.size() / 8);
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
 class CommunicationLayerTCP : public testing::TestWithParam<bool> {};
 
 TEST_P(CommunicationLayerTCP, TCP) {
@@ -0,0 +1,77 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <chrono>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "communication/dummy_transport.h"
+#include "communication/emulated_transport.h"
+
+using namespace MOTION::Communication;
+using namespace std::chrono_literals;
+
+TEST(EmulatedTransport, DelayAndOrder) {
+  auto [transport_alice, transport_bob] = DummyTransport::make_transport_pair();
+  const NetworkProfile profile{"test", 20'000us, 8'000'000, 5'000us};
+  EmulatedTransport emulated_alice(std::move(transport_alice), profile);
+
+  std::vector<std::vector<std::uint8_t>> messages;
+  for (std::uint8_t i = 0; i < 10; ++i) {
+    // 1000 bytes take 1 ms at 8 Mbit/s
+    messages.emplace_back(1000, i);
+  }
+  const auto start_time = std::chrono::steady_clock::now();
+  for (const auto& message : messages) {
+    emulated_alice.send_message(message);
+  }
+  EXPECT_FALSE(transport_bob->available());
+  for (const auto& message : messages) {
+    auto received_message = transport_bob->receive_message();
+    ASSERT_TRUE(received_message.has_value());
+    EXPECT_EQ(*received_message, message);
+  }
+  const auto elapsed_time = std::chrono::steady_clock::now() - start_time;
+  // latency + 10 * transmission time
+  EXPECT_GE(elapsed_time, 30ms);
+
+  EXPECT_EQ(emulated_alice.get_stats().num_messages_sent, 10);
+  EXPECT_EQ(emulated_alice.get_stats().num_bytes_sent, 10'000);
+  emulated_alice.shutdown();
+  EXPECT_FALSE(transport_bob->receive_message().has_value());
+}
+
+TEST(EmulatedTransport, ParseProfile) {
+  const auto wan = NetworkProfile::parse("wan");
+  EXPECT_EQ(wan.name, "wan");
+  EXPECT_EQ(wan.latency, 50ms);
+  const auto custom = NetworkProfile::parse("custom:10:50:0.5");
+  EXPECT_EQ(custom.name, "custom");
+  EXPECT_EQ(custom.latency, 10ms);
+  EXPECT_EQ(custom.bandwidth, 50'000'000);
+  EXPECT_EQ(custom.jitter, 500us);
+  EXPECT_THROW(NetworkProfile::parse("moon"), std::invalid_argument);
+  EXPECT_THROW(NetworkProfile::parse("custom:10:50"), std::invalid_argument);
+  EXPECT_THROW(NetworkProfile::parse("custom:x:50:0"), std::invalid_argument);
+}
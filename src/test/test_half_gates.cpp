@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <random>
 
 #include "gtest/gtest.h"
@@ -27,7 +28,9 @@
 #include "test_constants.h"
 
 #include "algorithm/circuit_loader.h"
+#include "communication/buffer_pool.h"
 #include "crypto/garbling/half_gates.h"
+#include "protocols/yao/yao_provider.h"
 
 using namespace MOTION::Crypto::garbling;
 
@@ -185,3 +188,162 @@ TEST(half_gates, circuit_garble_eval_batch) {
     }
   }
 }
+
+TEST(half_gates, circuit_garble_eval_streaming) {
+  HalfGateGarbler garbler;
+  HalfGateEvaluator evaluator(garbler.get_public_data());
+  MOTION::CircuitLoader circuit_loader;
+  const auto& algo =
+      circuit_loader.load_circuit("int_add8_size.bristol", MOTION::CircuitFormat::Bristol);
+  const std::size_t size = 8;
+  const std::size_t num_simd = 4;
+  const std::size_t num_and_gates_per_chunk = 3;
+  const auto offset = garbler.get_offset();
+  auto key_as = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  auto key_bs = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  const std::size_t index = 42;
+
+  ENCRYPTO::block128_vector key_cs_original;
+  ENCRYPTO::block128_vector garbled_tables;
+  garbler.garble_circuit(key_cs_original, garbled_tables, index, key_as, key_bs, num_simd, algo);
+
+  // the chunks need to contain the same tables as the non-streaming variant
+  std::vector<ENCRYPTO::block128_vector> chunks;
+  ENCRYPTO::block128_vector key_cs_streaming;
+  garbler.garble_circuit_streaming(key_cs_streaming, index, key_as, key_bs, num_simd, algo,
+                                   num_and_gates_per_chunk, [&chunks](auto chunk_i, auto&& chunk) {
+                                     EXPECT_EQ(chunk_i, chunks.size());
+                                     chunks.emplace_back(std::move(chunk));
+                                   });
+  EXPECT_EQ(chunks.size(), 3);
+  ASSERT_EQ(key_cs_streaming.size(), key_cs_original.size());
+  for (std::size_t i = 0; i < key_cs_original.size(); ++i) {
+    EXPECT_EQ(key_cs_streaming[i], key_cs_original[i]);
+  }
+  std::size_t table_i = 0;
+  for (const auto& chunk : chunks) {
+    for (std::size_t i = 0; i < chunk.size(); ++i, ++table_i) {
+      EXPECT_EQ(chunk[i], garbled_tables[table_i]);
+    }
+  }
+  EXPECT_EQ(table_i, garbled_tables.size());
+
+  const std::array<std::uint8_t, num_simd> xs = {0x42, 0x13, 0x37, 0x47};
+  const std::array<std::uint8_t, num_simd> ys = {0xd9, 0x6e, 0xcf, 0xf9};
+  std::array<std::uint8_t, num_simd> zs;
+  for (std::size_t simd_j = 0; simd_j < num_simd; ++simd_j) {
+    zs[simd_j] = xs[simd_j] + ys[simd_j];
+    for (std::size_t i = 0; i < size; ++i) {
+      if (xs[simd_j] & (1 << i)) key_as[i * num_simd + simd_j] ^= offset;
+      if (ys[simd_j] & (1 << i)) key_bs[i * num_simd + simd_j] ^= offset;
+    }
+  }
+
+  ENCRYPTO::block128_vector key_cs;
+  evaluator.evaluate_circuit_streaming(key_cs, index, key_as, key_bs, num_simd, algo,
+                                       num_and_gates_per_chunk,
+                                       [&chunks](auto chunk_i, auto num_blocks) {
+                                         EXPECT_EQ(chunks.at(chunk_i).size(), num_blocks);
+                                         return chunks.at(chunk_i).data();
+                                       });
+  EXPECT_EQ(key_cs.size(), size * num_simd);
+
+  for (std::size_t simd_j = 0; simd_j < num_simd; ++simd_j) {
+    for (std::size_t i = 0; i < size; ++i) {
+      auto idx = i * num_simd + simd_j;
+      if (zs[simd_j] & (1 << i))
+        EXPECT_EQ(key_cs[idx], key_cs_original[idx] ^ offset);
+      else
+        EXPECT_EQ(key_cs[idx], key_cs_original[idx]);
+    }
+  }
+}
+
+TEST(half_gates, circuit_garble_eval_wire_slots) {
+  HalfGateGarbler garbler;
+  HalfGateEvaluator evaluator(garbler.get_public_data());
+  MOTION::CircuitLoader circuit_loader;
+  const auto& algo = circuit_loader.load_gt_circuit(8);
+  const auto& slot_allocation = circuit_loader.get_wire_slot_allocation(algo);
+  EXPECT_LT(slot_allocation.n_slots_, algo.n_wires_);
+  EXPECT_EQ(&slot_allocation, &circuit_loader.get_wire_slot_allocation(algo));
+
+  const std::size_t size = 8;
+  const std::size_t num_simd = 4;
+  const auto offset = garbler.get_offset();
+  auto key_as = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  auto key_bs = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  const std::size_t index = 42;
+
+  ENCRYPTO::block128_vector key_cs_original;
+  ENCRYPTO::block128_vector garbled_tables;
+  garbler.garble_circuit(key_cs_original, garbled_tables, index, key_as, key_bs, num_simd, algo,
+                         false, &slot_allocation);
+  EXPECT_EQ(key_cs_original.size(), num_simd);
+
+  const std::array<std::uint8_t, num_simd> xs = {0x42, 0x13, 0x37, 0x47};
+  const std::array<std::uint8_t, num_simd> ys = {0xd9, 0x6e, 0x37, 0x09};
+  for (std::size_t simd_j = 0; simd_j < num_simd; ++simd_j) {
+    for (std::size_t i = 0; i < size; ++i) {
+      if (xs[simd_j] & (1 << i)) key_as[i * num_simd + simd_j] ^= offset;
+      if (ys[simd_j] & (1 << i)) key_bs[i * num_simd + simd_j] ^= offset;
+    }
+  }
+
+  // evaluation with and without slots needs to give the same keys
+  ENCRYPTO::block128_vector key_cs;
+  ENCRYPTO::block128_vector key_cs_all_wires;
+  evaluator.evaluate_circuit(key_cs, garbled_tables, index, key_as, key_bs, num_simd, algo, false,
+                             &slot_allocation);
+  evaluator.evaluate_circuit(key_cs_all_wires, garbled_tables, index, key_as, key_bs, num_simd,
+                             algo);
+  ASSERT_EQ(key_cs.size(), num_simd);
+  for (std::size_t simd_j = 0; simd_j < num_simd; ++simd_j) {
+    EXPECT_EQ(key_cs[simd_j], key_cs_all_wires[simd_j]);
+    // the inputs are compared as signed integers
+    if (static_cast<std::int8_t>(xs[simd_j]) > static_cast<std::int8_t>(ys[simd_j]))
+      EXPECT_EQ(key_cs[simd_j], key_cs_original[simd_j] ^ offset);
+    else
+      EXPECT_EQ(key_cs[simd_j], key_cs_original[simd_j]);
+  }
+}
+
+TEST(half_gates, garble_eval_circuit_from_received_payload) {
+  HalfGateGarbler garbler;
+  HalfGateEvaluator evaluator(garbler.get_public_data());
+  MOTION::CircuitLoader circuit_loader;
+  const auto& algo =
+      circuit_loader.load_circuit("int_add8_size.bristol", MOTION::CircuitFormat::Bristol);
+  const std::size_t size = 8;
+  const std::size_t num_simd = 3;
+  const auto key_as = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  const auto key_bs = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  const std::size_t index = 42;
+
+  ENCRYPTO::block128_vector key_cs_original;
+  ENCRYPTO::block128_vector garbled_tables;
+  garbler.garble_circuit(key_cs_original, garbled_tables, index, key_as, key_bs, num_simd, algo);
+  ENCRYPTO::block128_vector key_cs_expected;
+  evaluator.evaluate_circuit(key_cs_expected, garbled_tables, index, key_as, key_bs, num_simd,
+                             algo);
+
+  // the tables are read in place if they are aligned and copied otherwise
+  for (std::size_t payload_offset : {0, 16, 1, 7}) {
+    const auto num_bytes = garbled_tables.byte_size();
+    std::vector<std::uint8_t> message(payload_offset + num_bytes);
+    std::copy_n(reinterpret_cast<const std::uint8_t*>(garbled_tables.data()), num_bytes,
+                message.data() + payload_offset);
+    const auto* payload_ptr = message.data() + payload_offset;
+    MOTION::Communication::ReceivedPayload payload(std::move(message), payload_ptr, num_bytes);
+    ENCRYPTO::block128_vector buffer;
+    const auto* tables = MOTION::proto::yao::YaoProvider::get_blocks(payload, buffer);
+    EXPECT_EQ(tables == payload.data_as<ENCRYPTO::block128_t>(),
+              payload.is_aligned_for<ENCRYPTO::block128_t>());
+    ENCRYPTO::block128_vector key_cs;
+    evaluator.evaluate_circuit(key_cs, tables, index, key_as, key_bs, num_simd, algo);
+    ASSERT_EQ(key_cs.size(), key_cs_expected.size());
+    for (std::size_t i = 0; i < key_cs.size(); ++i) {
+      EXPECT_EQ(key_cs[i], key_cs_expected[i]);
+    }
+  }
+}
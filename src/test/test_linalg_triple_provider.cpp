@@ -21,9 +21,14 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <future>
 #include <iterator>
 #include <memory>
 
+#include <fmt/format.h>
+#include <unistd.h>
+
 #include "communication/communication_layer.h"
 #include "crypto/arithmetic_provider.h"
 #include "crypto/base_ots/base_ot_provider.h"
@@ -230,3 +235,97 @@ TYPED_TEST(LinAlgTripleProviderTest, ReLU) {
   }
   ASSERT_EQ(plain_triple.c_, expected_c);
 }
+
+TYPED_TEST(LinAlgTripleProviderTest, FromFile) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {7, 11}, .input_B_shape_ = {11, 13}, .output_shape_ = {7, 13}};
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<TypeParam>;
+  const MOTION::LinAlgTripleRequirements requirements = {
+      .bit_size_ = bit_size, .gemm_ops_ = {gemm_op}, .relu_sizes_ = {20}, .num_runs_ = 2};
+
+  const auto tmp_dir = std::filesystem::temp_directory_path();
+  std::array<std::filesystem::path, 2> paths;
+  for (std::size_t i = 0; i < 2; ++i) {
+    paths[i] = tmp_dir / fmt::format("motion_triples_{}_{}_{}", ::getpid(), bit_size, i);
+    this->linalg_triple_providers_[i]->register_for_requirements(requirements);
+  }
+  this->run_setup();
+  for (std::size_t i = 0; i < 2; ++i) {
+    this->linalg_triple_providers_[i]->save_triples(
+        paths[i], this->motion_base_providers_[i]->get_aes_fixed_key());
+  }
+  const auto file_size = std::filesystem::file_size(paths[0]);
+
+  // each run consumes one set of triples from the files
+  for (std::size_t run_i = 0; run_i < 2; ++run_i) {
+    std::array<MOTION::LinAlgTripleProvider::LinAlgTriple<TypeParam>, 2> triples;
+    std::vector<std::future<void>> futs;
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [this, i, &paths, &gemm_op, &triples] {
+        MOTION::LinAlgTriplesFromFile provider(paths[i], *this->comm_layers_[i], nullptr);
+        const auto gemm_index = provider.register_for_gemm_triple<TypeParam>(gemm_op);
+        const auto relu_index = provider.register_for_relu_triple(20, bit_size);
+        provider.setup();
+        triples[i] = provider.get_gemm_triple<TypeParam>(gemm_op, gemm_index);
+        const auto relu_triple = provider.get_relu_triple(20, bit_size, relu_index);
+        EXPECT_EQ(relu_triple.a_.GetSize(), 20);
+        EXPECT_EQ(relu_triple.b_.size(), bit_size - 1);
+      }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+    const auto a = MOTION::Helpers::AddVectors(triples[0].a_, triples[1].a_);
+    const auto b = MOTION::Helpers::AddVectors(triples[0].b_, triples[1].b_);
+    const auto c = MOTION::Helpers::AddVectors(triples[0].c_, triples[1].c_);
+    EXPECT_EQ(c, MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                                         gemm_op.output_shape_[1], a, b));
+    // only the counters are updated
+    EXPECT_EQ(std::filesystem::file_size(paths[0]), file_size);
+  }
+
+  // all triples have been used
+  std::vector<std::future<void>> futs;
+  for (std::size_t i = 0; i < 2; ++i) {
+    futs.emplace_back(std::async(std::launch::async, [this, i, &paths, &gemm_op] {
+      MOTION::LinAlgTriplesFromFile provider(paths[i], *this->comm_layers_[i], nullptr);
+      provider.register_for_gemm_triple<TypeParam>(gemm_op);
+      EXPECT_THROW(provider.setup(), std::runtime_error);
+    }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  for (std::size_t i = 0; i < 2; ++i) {
+    std::filesystem::remove(paths[i]);
+  }
+}
+
+TYPED_TEST(LinAlgTripleProviderTest, FromFileOfOtherBatch) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {3, 5}, .input_B_shape_ = {5, 2}, .output_shape_ = {3, 2}};
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<TypeParam>;
+  const MOTION::LinAlgTripleRequirements requirements = {.bit_size_ = bit_size,
+                                                         .gemm_ops_ = {gemm_op}};
+
+  const auto tmp_dir = std::filesystem::temp_directory_path();
+  std::array<std::filesystem::path, 2> paths;
+  for (std::size_t i = 0; i < 2; ++i) {
+    paths[i] = tmp_dir / fmt::format("motion_triples_other_{}_{}_{}", ::getpid(), bit_size, i);
+    this->linalg_triple_providers_[i]->register_for_requirements(requirements);
+  }
+  this->run_setup();
+  // party 1 pretends its triples come from another session
+  this->linalg_triple_providers_[0]->save_triples(
+      paths[0], this->motion_base_providers_[0]->get_aes_fixed_key());
+  this->linalg_triple_providers_[1]->save_triples(paths[1], std::vector<std::uint8_t>(16, 0x42));
+
+  std::vector<std::future<void>> futs;
+  for (std::size_t i = 0; i < 2; ++i) {
+    futs.emplace_back(std::async(std::launch::async, [this, i, &paths, &gemm_op] {
+      MOTION::LinAlgTriplesFromFile provider(paths[i], *this->comm_layers_[i], nullptr);
+      provider.register_for_gemm_triple<TypeParam>(gemm_op);
+      EXPECT_THROW(provider.setup(), std::runtime_error);
+    }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  for (std::size_t i = 0; i < 2; ++i) {
+    std::filesystem::remove(paths[i]);
+  }
+}
@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "communication/lz_codec.h"
+
+namespace {
+
+std::vector<std::uint8_t> roundtrip(const std::vector<std::uint8_t>& data) {
+  const auto compressed = MOTION::Communication::lz_compress(data.data(), data.size());
+  std::vector<std::uint8_t> decompressed(data.size());
+  MOTION::Communication::lz_decompress(compressed.data(), compressed.size(), decompressed.data(),
+                                       decompressed.size());
+  return decompressed;
+}
+
+TEST(LZCodec, Empty) {
+  std::vector<std::uint8_t> data;
+  EXPECT_EQ(roundtrip(data), data);
+  data = {0x42, 0x43, 0x44};
+  EXPECT_EQ(roundtrip(data), data);
+}
+
+TEST(LZCodec, Structured) {
+  // small fixed-point values in 64 bit integers and long runs
+  std::vector<std::uint64_t> values(100000);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = (i % 1000) << 16;
+  }
+  std::vector<std::uint8_t> data(reinterpret_cast<const std::uint8_t*>(values.data()),
+                                 reinterpret_cast<const std::uint8_t*>(values.data()) +
+                                     sizeof(std::uint64_t) * values.size());
+  data.insert(data.end(), 100000, 0);
+  const auto compressed = MOTION::Communication::lz_compress(data.data(), data.size());
+  EXPECT_LT(compressed.size(), data.size() / 4);
+  EXPECT_EQ(roundtrip(data), data);
+}
+
+TEST(LZCodec, Random) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<unsigned> dist(0, 255);
+  std::vector<std::uint8_t> data(100000);
+  for (auto& byte : data) {
+    byte = static_cast<std::uint8_t>(dist(gen));
+  }
+  const auto compressed = MOTION::Communication::lz_compress(data.data(), data.size());
+  EXPECT_LE(compressed.size(), data.size() + data.size() / 255 + 16);
+  EXPECT_EQ(roundtrip(data), data);
+}
+
+TEST(LZCodec, Malformed) {
+  std::vector<std::uint8_t> data(1000, 7);
+  auto compressed = MOTION::Communication::lz_compress(data.data(), data.size());
+  std::vector<std::uint8_t> output(data.size());
+  // wrong size
+  EXPECT_THROW(MOTION::Communication::lz_decompress(compressed.data(), compressed.size(),
+                                                    output.data(), output.size() - 1),
+               std::runtime_error);
+  // truncated
+  EXPECT_THROW(MOTION::Communication::lz_decompress(compressed.data(), compressed.size() - 1,
+                                                    output.data(), output.size()),
+               std::runtime_error);
+  // offset pointing before the start
+  std::vector<std::uint8_t> bad = {0x10, 0x01, 0x05, 0x00};
+  EXPECT_THROW(MOTION::Communication::lz_decompress(bad.data(), bad.size(), output.data(), 5),
+               std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "base/gate_register.h"
+#include "executor/new_gate_executor.h"
+#include "gate/new_gate.h"
+#include "statistics/run_time_stats.h"
+
+namespace {
+
+// counters shared by all gates of a circuit
+struct CircuitState {
+  std::size_t num_gates = 0;
+  std::atomic<std::size_t> num_in_flight = 0;
+  std::atomic<std::size_t> max_in_flight = 0;
+  std::atomic<std::size_t> num_setups_done = 0;
+  std::atomic<std::size_t> num_onlines_done = 0;
+  std::atomic<bool> online_before_all_setups = false;
+};
+
+// Gate whose setup and online phase wait for the ones of its inputs, like the
+// tensor gates do.  The online phase computes 1 + the sum of the inputs.
+class TestGate : public MOTION::NewGate {
+ public:
+  TestGate(std::size_t gate_id, std::vector<const TestGate*> inputs, CircuitState& state)
+      : NewGate(gate_id), inputs_(std::move(inputs)), state_(state) {}
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override {
+    enter();
+    for (auto input : inputs_) {
+      input->wait_setup();
+    }
+    ++state_.num_setups_done;
+    set_setup_ready();
+    leave();
+  }
+  void evaluate_online() override {
+    enter();
+    if (state_.num_setups_done != state_.num_gates) {
+      state_.online_before_all_setups = true;
+    }
+    wait_setup();
+    value_ = 1;
+    for (auto input : inputs_) {
+      input->wait_online();
+      value_ += input->value_;
+    }
+    ++state_.num_onlines_done;
+    set_online_ready();
+    leave();
+  }
+  std::uint64_t get_value() const noexcept { return value_; }
+
+ private:
+  void enter() {
+    const auto n = ++state_.num_in_flight;
+    auto max = state_.max_in_flight.load();
+    while (n > max && !state_.max_in_flight.compare_exchange_weak(max, n)) {
+    }
+  }
+  void leave() { --state_.num_in_flight; }
+
+  std::vector<const TestGate*> inputs_;
+  CircuitState& state_;
+  std::uint64_t value_ = 0;
+};
+
+// Registers a circuit in which gate i depends on gates i - 1 and i / 2, and
+// returns the expected outputs of the gates.
+std::vector<std::uint64_t> make_circuit(MOTION::GateRegister& gate_register, CircuitState& state,
+                                        std::size_t num_gates) {
+  std::vector<const TestGate*> gates;
+  std::vector<std::uint64_t> expected;
+  for (std::size_t i = 0; i < num_gates; ++i) {
+    std::vector<const TestGate*> inputs;
+    std::uint64_t value = 1;
+    if (i > 0) {
+      inputs.push_back(gates[i - 1]);
+      value += expected[i - 1];
+    }
+    if (i > 1) {
+      inputs.push_back(gates[i / 2]);
+      value += expected[i / 2];
+    }
+    auto gate =
+        std::make_unique<TestGate>(gate_register.get_next_gate_id(), std::move(inputs), state);
+    gates.push_back(gate.get());
+    expected.push_back(value);
+    gate_register.register_gate(std::move(gate));
+  }
+  state.num_gates = num_gates;
+  return expected;
+}
+
+std::vector<std::uint64_t> get_values(const MOTION::GateRegister& gate_register) {
+  std::vector<std::uint64_t> values;
+  for (const auto& gate : gate_register.get_gates()) {
+    values.push_back(static_cast<const TestGate&>(*gate).get_value());
+  }
+  return values;
+}
+
+class NewGateExecutorTest : public ::testing::TestWithParam<std::size_t> {};
+
+// all setup phases are done before the first online phase starts, and no more
+// gates than the window allows run at the same time
+TEST_P(NewGateExecutorTest, SetupOnline) {
+  const auto max_gates_in_flight = GetParam();
+  constexpr std::size_t num_gates = 200;
+  MOTION::GateRegister gate_register;
+  CircuitState state;
+  const auto expected = make_circuit(gate_register, state, num_gates);
+
+  MOTION::NewGateExecutor executor(gate_register, [] {}, 4, nullptr);
+  executor.set_max_gates_in_flight(max_gates_in_flight);
+  MOTION::Statistics::RunTimeStats stats;
+  executor.evaluate_setup_online(stats);
+
+  EXPECT_EQ(get_values(gate_register), expected);
+  EXPECT_EQ(state.num_setups_done, num_gates);
+  EXPECT_EQ(state.num_onlines_done, num_gates);
+  EXPECT_FALSE(state.online_before_all_setups);
+  EXPECT_LE(state.max_in_flight, max_gates_in_flight);
+}
+
+// setup and online phase of a gate run in the same task
+TEST_P(NewGateExecutorTest, Interleaved) {
+  const auto max_gates_in_flight = GetParam();
+  constexpr std::size_t num_gates = 200;
+  MOTION::GateRegister gate_register;
+  CircuitState state;
+  const auto expected = make_circuit(gate_register, state, num_gates);
+
+  MOTION::NewGateExecutor executor(gate_register, [] {}, 4, nullptr);
+  executor.set_max_gates_in_flight(max_gates_in_flight);
+  MOTION::Statistics::RunTimeStats stats;
+  executor.evaluate(stats);
+
+  EXPECT_EQ(get_values(gate_register), expected);
+  EXPECT_EQ(state.num_setups_done, num_gates);
+  EXPECT_EQ(state.num_onlines_done, num_gates);
+  EXPECT_LE(state.max_in_flight, max_gates_in_flight);
+}
+
+// a window of a single gate still makes progress, since the gates are
+// dispatched in topological order
+INSTANTIATE_TEST_SUITE_P(MaxGatesInFlight, NewGateExecutorTest,
+                         ::testing::Values(std::size_t{1}, std::size_t{3}, std::size_t{1024}));
+
+}  // namespace
@@ -30,6 +30,7 @@
 #include "crypto/motion_base_provider.h"
 #include "crypto/oblivious_transfer/ot_flavors.h"
 #include "crypto/oblivious_transfer/ot_provider.h"
+#include "crypto/oblivious_transfer/silent_ot.h"
 #include "utility/block.h"
 
 class OTFlavorTest : public ::testing::Test {
@@ -45,7 +46,8 @@ class OTFlavorTest : public ::testing::Test {
       motion_base_providers_[i] =
           std::make_unique<MOTION::Crypto::MotionBaseProvider>(*comm_layers_[i], nullptr);
       ot_provider_wrappers_[i] = std::make_unique<ENCRYPTO::ObliviousTransfer::OTProviderManager>(
-          *comm_layers_[i], *base_ot_providers_[i], *motion_base_providers_[i], nullptr, nullptr);
+          *comm_layers_[i], *base_ot_providers_[i], *motion_base_providers_[i], nullptr, nullptr,
+          ot_extension_type_, ot_extension_chunk_size_, ot_extension_num_threads_);
     }
 
     std::vector<std::future<void>> futs;
@@ -89,6 +91,11 @@ class OTFlavorTest : public ::testing::Test {
     std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
   }
 
+  ENCRYPTO::ObliviousTransfer::OTExtensionType ot_extension_type_ =
+      ENCRYPTO::ObliviousTransfer::OTExtensionType::IKNP;
+  std::size_t ot_extension_chunk_size_ =
+      ENCRYPTO::ObliviousTransfer::default_ot_extension_chunk_size;
+  std::size_t ot_extension_num_threads_ = 1;
   std::vector<std::unique_ptr<MOTION::Communication::CommunicationLayer>> comm_layers_;
   std::vector<std::unique_ptr<MOTION::BaseOTProvider>> base_ot_providers_;
   std::vector<std::unique_ptr<MOTION::Crypto::MotionBaseProvider>> motion_base_providers_;
@@ -383,3 +390,369 @@ TEST_F(OTFlavorTest, VectorROT) {
     }
   }
 }
+
+// the same flavors on top of the silent OT extension
+class ChunkedOTFlavorTest : public OTFlavorTest {
+ protected:
+  ChunkedOTFlavorTest() { ot_extension_chunk_size_ = 256; }
+};
+
+// the OT batches span several chunks and are not aligned to them
+TEST_F(ChunkedOTFlavorTest, MultipleBatches) {
+  const std::size_t num_xcots = 1000;
+  const std::size_t num_rots = 300;
+  const auto correlation = ENCRYPTO::block128_t::make_random();
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_xcots);
+  auto xcot_sender = get_sender_provider().RegisterSendFixedXCOT128(num_xcots);
+  auto xcot_receiver = get_receiver_provider().RegisterReceiveFixedXCOT128(num_xcots);
+  auto rot_sender = get_sender_provider().RegisterSendROT(num_rots, 1, true);
+  auto rot_receiver = get_receiver_provider().RegisterReceiveROT(num_rots, 1, true);
+
+  run_ot_extension_setup();
+
+  xcot_sender->SetCorrelation(correlation);
+  xcot_sender->SendMessages();
+  xcot_receiver->SetChoices(choice_bits);
+  xcot_receiver->SendCorrections();
+  xcot_sender->ComputeOutputs();
+  xcot_receiver->ComputeOutputs();
+  const auto xcot_sender_output = xcot_sender->GetOutputs();
+  const auto xcot_receiver_output = xcot_receiver->GetOutputs();
+  for (std::size_t ot_i = 0; ot_i < num_xcots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(xcot_receiver_output[ot_i], xcot_sender_output[ot_i] ^ correlation);
+    } else {
+      ASSERT_EQ(xcot_receiver_output[ot_i], xcot_sender_output[ot_i]);
+    }
+  }
+
+  rot_receiver->ComputeOutputs();
+  rot_sender->ComputeOutputs();
+  const auto rot_receiver_output = rot_receiver->GetOutputs();
+  const auto rot_choice_bits = rot_receiver->GetChoices();
+  const auto [rot_sender_output_m0, rot_sender_output_m1] = rot_sender->GetOutputs();
+  for (std::size_t ot_i = 0; ot_i < num_rots; ++ot_i) {
+    if (rot_choice_bits.Get(ot_i)) {
+      ASSERT_EQ(rot_receiver_output.Get(ot_i), rot_sender_output_m1.Get(ot_i));
+    } else {
+      ASSERT_EQ(rot_receiver_output.Get(ot_i), rot_sender_output_m0.Get(ot_i));
+    }
+  }
+}
+
+class MultiThreadedOTFlavorTest : public OTFlavorTest {
+ protected:
+  MultiThreadedOTFlavorTest() {
+    ot_extension_chunk_size_ = 2048;
+    ot_extension_num_threads_ = 3;
+  }
+};
+
+// the chunks are not evenly split among the threads
+TEST_F(MultiThreadedOTFlavorTest, GOT128) {
+  const std::size_t num_ots = 5000;
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  const auto sender_input = ENCRYPTO::block128_vector::make_random(2 * num_ots);
+  auto ot_sender = get_sender_provider().RegisterSendGOT128(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveGOT128(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_sender->SetInputs(sender_input);
+  ot_sender->SendMessages();
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+  ot_receiver->ComputeOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    ASSERT_EQ(receiver_output[ot_i], sender_input[2 * ot_i + choice_bits.Get(ot_i)]);
+  }
+}
+
+class PooledOTFlavorTest : public OTFlavorTest {
+ protected:
+  void SetUp() override {
+    OTFlavorTest::SetUp();
+    for (auto& ot_provider_wrapper : ot_provider_wrappers_) {
+      ot_provider_wrapper->set_pool_size(pool_size_);
+    }
+  }
+
+  void reset_ot_providers() {
+    for (auto& ot_provider_wrapper : ot_provider_wrappers_) {
+      ot_provider_wrapper->reset();
+    }
+  }
+
+  void check_got128(std::size_t num_ots) {
+    const auto sender_input = ENCRYPTO::block128_vector::make_random(2 * num_ots);
+    const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+    auto ot_sender = get_sender_provider().RegisterSendGOT128(num_ots);
+    auto ot_receiver = get_receiver_provider().RegisterReceiveGOT128(num_ots);
+
+    run_ot_extension_setup();
+
+    ot_receiver->SetChoices(choice_bits);
+    ot_receiver->SendCorrections();
+    ot_sender->SetInputs(sender_input);
+    ot_sender->SendMessages();
+    ot_receiver->ComputeOutputs();
+    const auto receiver_output = ot_receiver->GetOutputs();
+    for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+      ASSERT_EQ(receiver_output[ot_i], sender_input[2 * ot_i + choice_bits.Get(ot_i)]);
+    }
+  }
+
+  // OTs of 1, 128 and more than 128 bit in the same setup
+  void check_mixed_bitlengths(std::size_t num_ots) {
+    const std::size_t long_bitlen = 200;
+    const auto bit_input = ENCRYPTO::BitVector<>::Random(2 * num_ots);
+    const auto correlation = ENCRYPTO::block128_t::make_random();
+    std::vector<ENCRYPTO::BitVector<>> long_input;
+    for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+      long_input.emplace_back(ENCRYPTO::BitVector<>::Random(2 * long_bitlen));
+    }
+    const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+
+    auto bit_sender = get_sender_provider().RegisterSendGOTBit(num_ots);
+    auto bit_receiver = get_receiver_provider().RegisterReceiveGOTBit(num_ots);
+    auto xcot_sender = get_sender_provider().RegisterSendFixedXCOT128(num_ots);
+    auto xcot_receiver = get_receiver_provider().RegisterReceiveFixedXCOT128(num_ots);
+    auto long_sender = get_sender_provider().RegisterSend(long_bitlen, num_ots);
+    auto long_receiver = get_receiver_provider().RegisterReceive(long_bitlen, num_ots);
+
+    run_ot_extension_setup();
+
+    bit_receiver->SetChoices(choice_bits);
+    bit_receiver->SendCorrections();
+    bit_sender->SetInputs(bit_input);
+    bit_sender->SendMessages();
+    xcot_sender->SetCorrelation(correlation);
+    xcot_sender->SendMessages();
+    xcot_receiver->SetChoices(choice_bits);
+    xcot_receiver->SendCorrections();
+    long_receiver->SetChoices(choice_bits);
+    long_receiver->SendCorrections();
+    long_sender->SetInputs(long_input);
+    long_sender->SendMessages();
+
+    bit_receiver->ComputeOutputs();
+    xcot_sender->ComputeOutputs();
+    xcot_receiver->ComputeOutputs();
+    const auto bit_output = bit_receiver->GetOutputs();
+    const auto xcot_sender_output = xcot_sender->GetOutputs();
+    const auto xcot_receiver_output = xcot_receiver->GetOutputs();
+    const auto long_output = long_receiver->GetOutputs();
+    for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+      const bool choice = choice_bits.Get(ot_i);
+      ASSERT_EQ(bit_output.Get(ot_i), bit_input.Get(2 * ot_i + choice));
+      if (choice) {
+        ASSERT_EQ(xcot_receiver_output[ot_i], xcot_sender_output[ot_i] ^ correlation);
+      } else {
+        ASSERT_EQ(xcot_receiver_output[ot_i], xcot_sender_output[ot_i]);
+      }
+      ASSERT_EQ(long_output.at(ot_i),
+                long_input.at(ot_i).Subset(choice * long_bitlen, (choice + 1) * long_bitlen));
+    }
+  }
+
+  // OTs are taken from the pool if they suffice and only the missing ones are extended
+  void check_pool() {
+    check_got128(1000);
+    ASSERT_EQ(get_sender_provider().GetNumExtensions(), 1);
+    ASSERT_EQ(get_receiver_provider().GetNumExtensions(), 1);
+
+    reset_ot_providers();
+    check_mixed_bitlengths(800);
+    ASSERT_EQ(get_sender_provider().GetNumExtensions(), 1);
+    ASSERT_EQ(get_receiver_provider().GetNumExtensions(), 1);
+
+    reset_ot_providers();
+    check_got128(1500);
+    ASSERT_EQ(get_sender_provider().GetNumExtensions(), 2);
+    ASSERT_EQ(get_receiver_provider().GetNumExtensions(), 2);
+  }
+
+  const std::size_t pool_size_ = 3000;
+};
+
+TEST_F(PooledOTFlavorTest, ReuseAfterReset) { check_pool(); }
+
+class PooledSilentOTFlavorTest : public PooledOTFlavorTest {
+ protected:
+  PooledSilentOTFlavorTest() {
+    ot_extension_type_ = ENCRYPTO::ObliviousTransfer::OTExtensionType::Silent;
+  }
+};
+
+TEST_F(PooledSilentOTFlavorTest, ReuseAfterReset) { check_pool(); }
+
+class SilentOTFlavorTest : public OTFlavorTest {
+ protected:
+  SilentOTFlavorTest() {
+    ot_extension_type_ = ENCRYPTO::ObliviousTransfer::OTExtensionType::Silent;
+  }
+};
+
+TEST_F(SilentOTFlavorTest, XCOTBit) {
+  const std::size_t num_ots = 1000;
+  const auto correlations = ENCRYPTO::BitVector<>::Random(num_ots);
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  auto ot_sender = get_sender_provider().RegisterSendXCOTBit(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveXCOTBit(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_sender->SetCorrelations(correlations);
+  ot_sender->SendMessages();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->ComputeOutputs();
+  ot_receiver->ComputeOutputs();
+  const auto sender_output = ot_sender->GetOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  ASSERT_EQ(sender_output.GetSize(), num_ots);
+  ASSERT_EQ(receiver_output.GetSize(), num_ots);
+  ASSERT_EQ(receiver_output, sender_output ^ (choice_bits & correlations));
+}
+
+TEST_F(SilentOTFlavorTest, GOT128) {
+  const std::size_t num_ots = 1000;
+  const auto sender_input = ENCRYPTO::block128_vector::make_random(2 * num_ots);
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  auto ot_sender = get_sender_provider().RegisterSendGOT128(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveGOT128(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->SetInputs(sender_input);
+  ot_sender->SendMessages();
+
+  ot_receiver->ComputeOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output[ot_i], sender_input[2 * ot_i + 1]);
+    } else {
+      ASSERT_EQ(receiver_output[ot_i], sender_input[2 * ot_i]);
+    }
+  }
+}
+
+TEST_F(SilentOTFlavorTest, ROT) {
+  const std::size_t num_ots = 1000;
+  const std::size_t vector_size = 1;
+  const bool random_choice = true;
+  auto ot_sender = get_sender_provider().RegisterSendROT(num_ots, vector_size, random_choice);
+  auto ot_receiver =
+      get_receiver_provider().RegisterReceiveROT(num_ots, vector_size, random_choice);
+
+  run_ot_extension_setup();
+
+  ot_receiver->ComputeOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+  const auto choice_bits = ot_receiver->GetChoices();
+  ot_sender->ComputeOutputs();
+  const auto [sender_output_m0, sender_output_m1] = ot_sender->GetOutputs();
+
+  ASSERT_EQ(receiver_output.GetSize(), num_ots * vector_size);
+  ASSERT_EQ(choice_bits.GetSize(), num_ots);
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output.Get(ot_i), sender_output_m1.Get(ot_i));
+    } else {
+      ASSERT_EQ(receiver_output.Get(ot_i), sender_output_m0.Get(ot_i));
+    }
+  }
+}
+
+// Enough OTs for a large LPN instance and a small successor, whose base COTs
+// are taken from the outputs of the first one.
+TEST_F(SilentOTFlavorTest, XCOTBitAcrossLPNInstances) {
+  using ENCRYPTO::ObliviousTransfer::lpn_parameters_large;
+  const std::size_t num_ots = lpn_parameters_large.n_;
+  ASSERT_EQ(ENCRYPTO::ObliviousTransfer::make_silent_ot_schedule(num_ots).size(), 2);
+  const auto correlations = ENCRYPTO::BitVector<>::Random(num_ots);
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  auto ot_sender = get_sender_provider().RegisterSendXCOTBit(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveXCOTBit(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_sender->SetCorrelations(correlations);
+  ot_sender->SendMessages();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->ComputeOutputs();
+  ot_receiver->ComputeOutputs();
+  const auto sender_output = ot_sender->GetOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  ASSERT_EQ(sender_output.GetSize(), num_ots);
+  ASSERT_EQ(receiver_output.GetSize(), num_ots);
+  ASSERT_EQ(receiver_output, sender_output ^ (choice_bits & correlations));
+}
+
+TEST(SilentOT, Schedule) {
+  using namespace ENCRYPTO::ObliviousTransfer;
+  for (std::size_t num_cots : {std::size_t(1), lpn_parameters_small.n_, lpn_parameters_large.n_,
+                               std::size_t(50'000'000)}) {
+    const auto schedule = make_silent_ot_schedule(num_cots);
+    // every instance but the last one keeps the base COTs of its successor
+    std::size_t num_outputs = 0;
+    for (std::size_t i = 0; i < schedule.size(); ++i) {
+      const auto& parameters = schedule.at(i);
+      ASSERT_EQ(parameters.n_, parameters.t_ * parameters.get_bin_size());
+      num_outputs += parameters.n_;
+      if (i + 1 < schedule.size()) {
+        num_outputs -= schedule.at(i + 1).get_num_base_cots();
+      }
+    }
+    ASSERT_GE(num_outputs, num_cots);
+  }
+  ASSERT_EQ(make_silent_ot_schedule(lpn_parameters_small.n_).size(), 1);
+  ASSERT_EQ(make_silent_ot_schedule(lpn_parameters_large.n_).size(), 2);
+}
+
+// The punctured tree agrees with the full one on all leaves but alpha if the
+// receiver gets the level sums of the sides not on the path to alpha.
+TEST(SilentOT, GGMTreePuncture) {
+  using namespace ENCRYPTO::ObliviousTransfer;
+  ENCRYPTO::PRG prg_fixed_key;
+  const auto key = ENCRYPTO::block128_t::make_random();
+  prg_fixed_key.SetKey(key.data());
+  for (std::size_t depth : {std::size_t(1), std::size_t(4), lpn_parameters_small.log_bin_size_}) {
+    const std::size_t num_leaves = std::size_t(1) << depth;
+    ENCRYPTO::block128_vector leaves(num_leaves);
+    ENCRYPTO::block128_vector level_sums(2 * depth);
+    ggm_tree_expand(prg_fixed_key, ENCRYPTO::block128_t::make_random(), depth, leaves.data(),
+                    level_sums.data());
+    for (std::size_t alpha : {std::size_t(0), num_leaves / 3, num_leaves - 1}) {
+      ENCRYPTO::block128_vector punctured_sums(depth);
+      for (std::size_t level = 0; level < depth; ++level) {
+        const std::size_t direction = (alpha >> (depth - level - 1)) & 1;
+        punctured_sums[level] = level_sums[2 * level + 1 - direction];
+      }
+      ENCRYPTO::block128_vector punctured_leaves(num_leaves);
+      ggm_tree_puncture(prg_fixed_key, depth, alpha, punctured_sums.data(),
+                        punctured_leaves.data());
+      for (std::size_t j = 0; j < num_leaves; ++j) {
+        if (j == alpha) {
+          ASSERT_EQ(punctured_leaves[j], ENCRYPTO::block128_t::make_zero());
+        } else {
+          ASSERT_EQ(punctured_leaves[j], leaves[j]) << "depth " << depth << ", alpha " << alpha;
+        }
+      }
+    }
+  }
+}
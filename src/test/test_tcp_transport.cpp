@@ -24,6 +24,7 @@
 
 #include <future>
 
+#include "communication/buffer_pool.h"
 #include "communication/tcp_transport.h"
 
 class TCPTransportTest : public testing::TestWithParam<std::string> {};
@@ -54,5 +55,92 @@ TEST_P(TCPTransportTest, dummy) {
   EXPECT_EQ(received_message, message);
 }
 
+TEST_P(TCPTransportTest, buffer_pool) {
+  auto localhost = GetParam();
+  auto transport_alice_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(0, {{localhost, 13339}, {localhost, 13340}});
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(1, {{localhost, 13339}, {localhost, 13340}});
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_fut.get();
+  auto transport_bob = transport_bob_fut.get();
+  auto pool = std::make_shared<MOTION::Communication::BufferPool>();
+  transport_bob->set_receive_buffer_pool(pool);
+
+  const std::vector<std::uint8_t> message_1 = {0xde, 0xad, 0xbe, 0xef};
+  const std::vector<std::uint8_t> message_2 = {0xca, 0xfe};
+
+  transport_alice->send_message(message_1);
+  auto received_message_1 = transport_bob->receive_message();
+  ASSERT_TRUE(received_message_1.has_value());
+  EXPECT_EQ(*received_message_1, message_1);
+  EXPECT_EQ(pool->get_num_allocations(), 1);
+  pool->release(std::move(*received_message_1));
+
+  // the second message fits into the buffer of the first one
+  transport_alice->send_message(message_2);
+  auto received_message_2 = transport_bob->receive_message();
+  ASSERT_TRUE(received_message_2.has_value());
+  EXPECT_EQ(*received_message_2, message_2);
+  EXPECT_EQ(pool->get_num_allocations(), 1);
+  EXPECT_EQ(pool->get_num_reuses(), 1);
+}
+
+TEST_P(TCPTransportTest, multiple_streams) {
+  auto localhost = GetParam();
+  constexpr std::size_t num_streams = 4;
+  auto transport_alice_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(0, {{localhost, 13341}, {localhost, 13342}},
+                                                 num_streams);
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(1, {{localhost, 13341}, {localhost, 13342}},
+                                                 num_streams);
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_fut.get();
+  auto transport_bob = transport_bob_fut.get();
+
+  // small messages go over single connections, the large one is striped
+  const std::vector<std::uint8_t> message_1 = {0xde, 0xad, 0xbe, 0xef};
+  std::vector<std::uint8_t> message_2(
+      3 * MOTION::Communication::MultiStreamTCPTransport::stripe_threshold + 5);
+  for (std::size_t i = 0; i < message_2.size(); ++i) {
+    message_2[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  const std::vector<std::uint8_t> message_3 = {0xca, 0xfe};
+  const std::vector<std::uint8_t> message_4;
+
+  auto send_fut = std::async(std::launch::async, [&] {
+    transport_alice->send_message(message_1);
+    transport_alice->send_message(message_2);
+    transport_alice->send_message(message_3);
+    transport_alice->send_message(message_4);
+    transport_alice->shutdown_send();
+  });
+
+  // the messages arrive in the order in which they were sent
+  EXPECT_EQ(transport_bob->receive_message(), message_1);
+  EXPECT_EQ(transport_bob->receive_message(), message_2);
+  EXPECT_EQ(transport_bob->receive_message(), message_3);
+  EXPECT_EQ(transport_bob->receive_message(), message_4);
+  send_fut.get();
+  EXPECT_EQ(transport_bob->receive_message(), std::nullopt);
+  EXPECT_EQ(transport_bob->get_stats().num_messages_received, 4);
+  EXPECT_EQ(transport_alice->get_stats().num_bytes_sent,
+            transport_bob->get_stats().num_bytes_received);
+
+  transport_alice->shutdown();
+  transport_bob->shutdown();
+}
+
 INSTANTIATE_TEST_SUITE_P(TCPTransportSuite, TCPTransportTest, testing::Values("127.0.0.1", "::1"),
                          [](auto& info) { return info.param == "::1" ? "ipv6" : "ipv4"; });
@@ -0,0 +1,167 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "utility/tensor_share_file.h"
+
+namespace {
+
+class TensorShareFileTest : public testing::Test {
+ protected:
+  void TearDown() override { std::filesystem::remove(path_); }
+  const std::string path_ =
+      (std::filesystem::temp_directory_path() / "motion_test_tensor_share_file").string();
+};
+
+TEST_F(TensorShareFileTest, BinaryRoundTrip) {
+  MOTION::TensorShares<std::uint64_t> shares;
+  shares.rows_ = 7;
+  shares.cols_ = 3;
+  shares.fractional_bits_ = 13;
+  shares.Delta_.resize(21);
+  shares.delta_.resize(21);
+  std::iota(std::begin(shares.Delta_), std::end(shares.Delta_), 0xfffffffffffffff0);
+  std::iota(std::begin(shares.delta_), std::end(shares.delta_), 42);
+  MOTION::write_tensor_share_file(path_, shares);
+
+  ASSERT_TRUE(MOTION::is_tensor_share_file(path_));
+  const auto read_shares = MOTION::read_tensor_shares<std::uint64_t>(path_);
+  EXPECT_EQ(read_shares.rows_, shares.rows_);
+  EXPECT_EQ(read_shares.cols_, shares.cols_);
+  EXPECT_EQ(read_shares.fractional_bits_, shares.fractional_bits_);
+  EXPECT_EQ(read_shares.Delta_, shares.Delta_);
+  EXPECT_EQ(read_shares.delta_, shares.delta_);
+
+  // the shares are only reduced to a smaller ring on request
+  EXPECT_THROW(MOTION::read_tensor_share_file<std::uint32_t>(path_), std::runtime_error);
+  EXPECT_THROW(MOTION::read_tensor_shares<std::uint32_t>(path_), std::runtime_error);
+  const auto reduced_shares = MOTION::reduce_tensor_shares<std::uint32_t>(read_shares);
+  EXPECT_EQ(reduced_shares.rows_, shares.rows_);
+  EXPECT_EQ(reduced_shares.cols_, shares.cols_);
+  EXPECT_EQ(reduced_shares.fractional_bits_, shares.fractional_bits_);
+  for (std::size_t i = 0; i < 21; ++i) {
+    EXPECT_EQ(reduced_shares.Delta_[i], static_cast<std::uint32_t>(shares.Delta_[i]));
+    EXPECT_EQ(reduced_shares.delta_[i], static_cast<std::uint32_t>(shares.delta_[i]));
+  }
+}
+
+TEST_F(TensorShareFileTest, NarrowFileIsNotWidened) {
+  MOTION::TensorShares<std::uint32_t> shares;
+  shares.rows_ = 2;
+  shares.cols_ = 2;
+  shares.fractional_bits_ = 8;
+  shares.Delta_ = {1, 2, 3, 0xffffffff};
+  shares.delta_ = {5, 6, 7, 8};
+  MOTION::write_tensor_share_file(path_, shares);
+
+  EXPECT_EQ(MOTION::read_tensor_shares<std::uint32_t>(path_).Delta_, shares.Delta_);
+  EXPECT_THROW(MOTION::read_tensor_share_file<std::uint64_t>(path_), std::runtime_error);
+}
+
+TEST_F(TensorShareFileTest, MapInPlace) {
+  MOTION::TensorShares<std::uint64_t> shares;
+  shares.rows_ = 3;
+  shares.cols_ = 5;
+  shares.fractional_bits_ = 16;
+  shares.Delta_.resize(15);
+  shares.delta_.resize(15);
+  std::iota(std::begin(shares.Delta_), std::end(shares.Delta_), 0xfffffffffffffff8);
+  std::iota(std::begin(shares.delta_), std::end(shares.delta_), 1000);
+  MOTION::write_tensor_share_file(path_, shares);
+
+  const auto view = MOTION::map_tensor_share_file<std::uint64_t>(path_);
+  EXPECT_EQ(view.get_rows(), shares.rows_);
+  EXPECT_EQ(view.get_cols(), shares.cols_);
+  EXPECT_EQ(view.get_fractional_bits(), shares.fractional_bits_);
+  EXPECT_TRUE(std::equal(std::begin(view.get_Delta()), std::end(view.get_Delta()),
+                         std::begin(shares.Delta_), std::end(shares.Delta_)));
+  EXPECT_TRUE(std::equal(std::begin(view.get_delta()), std::end(view.get_delta()),
+                         std::begin(shares.delta_), std::end(shares.delta_)));
+  // the view keeps the mapping alive after the file is gone
+  std::filesystem::remove(path_);
+  EXPECT_EQ(view.get_delta()[14], 1014);
+
+  // shares of a different bit size are rejected
+  MOTION::write_tensor_share_file(path_, shares);
+  EXPECT_THROW(MOTION::map_tensor_share_file<std::uint32_t>(path_), std::runtime_error);
+  EXPECT_THROW(MOTION::load_tensor_shares<std::uint32_t>(path_), std::runtime_error);
+  const auto loaded = MOTION::load_tensor_shares<std::uint64_t>(path_);
+  ASSERT_EQ(loaded.get_Delta().size(), 15);
+  EXPECT_EQ(loaded.get_Delta()[0], 0xfffffffffffffff8);
+}
+
+TEST_F(TensorShareFileTest, OverflowingDimensionsAreRejected) {
+  // write a header whose rows * cols and byte count overflow a 64-bit size
+  const auto write_header = [this](std::uint64_t rows, std::uint64_t cols) {
+    MOTION::TensorShareFileHeader header;
+    std::memcpy(header.magic_, "MTSF", sizeof(header.magic_));
+    header.version_ = MOTION::tensor_share_file_version;
+    header.bit_size_ = 64;
+    header.fractional_bits_ = 0;
+    header.rows_ = rows;
+    header.cols_ = cols;
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  };
+  // rows * cols overflows
+  write_header(std::uint64_t(1) << 32, std::uint64_t(1) << 32);
+  EXPECT_THROW(MOTION::read_tensor_share_file<std::uint64_t>(path_), std::runtime_error);
+  EXPECT_THROW(MOTION::map_tensor_share_file<std::uint64_t>(path_), std::runtime_error);
+  // rows * cols fits, but 2 * 8 * rows * cols wraps around to 0
+  write_header(std::uint64_t(1) << 30, std::uint64_t(1) << 30);
+  EXPECT_THROW(MOTION::read_tensor_share_file<std::uint64_t>(path_), std::runtime_error);
+  EXPECT_THROW(MOTION::map_tensor_share_file<std::uint64_t>(path_), std::runtime_error);
+
+  MOTION::TensorShares<std::uint64_t> shares;
+  shares.rows_ = std::size_t(1) << 40;
+  shares.cols_ = std::size_t(1) << 40;
+  EXPECT_THROW(MOTION::write_tensor_share_file(path_, shares), std::runtime_error);
+}
+
+TEST_F(TensorShareFileTest, TextFallback) {
+  {
+    std::ofstream out(path_);
+    out << "2 1\n1 2\n18446744073709551615 4\n";
+  }
+  ASSERT_FALSE(MOTION::is_tensor_share_file(path_));
+  const auto shares = MOTION::read_tensor_shares<std::uint64_t>(path_);
+  EXPECT_EQ(shares.rows_, 2);
+  EXPECT_EQ(shares.cols_, 1);
+  EXPECT_EQ(shares.Delta_, (std::vector<std::uint64_t>{1, 18446744073709551615u}));
+  EXPECT_EQ(shares.delta_, (std::vector<std::uint64_t>{2, 4}));
+
+  // the text format contains 64-bit shares
+  EXPECT_THROW(MOTION::read_tensor_shares<std::uint32_t>(path_), std::runtime_error);
+  EXPECT_THROW(MOTION::load_tensor_shares<std::uint32_t>(path_), std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,419 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "base/two_party_tensor_backend.h"
+#include "communication/communication_layer.h"
+#include "crypto/base_ots/base_ot_provider.h"
+#include "crypto/multiplication_triple/linalg_triple_provider.h"
+#include "crypto/oblivious_transfer/ot_provider.h"
+#include "tensor/tensor.h"
+#include "tensor/tensor_op_factory.h"
+#include "utility/helpers.h"
+#include "utility/linear_algebra.h"
+#include "utility/logger.h"
+#include "utility/typedefs.h"
+
+namespace {
+
+// gives the test access to the OT state of the backend
+class InspectableTensorBackend : public MOTION::TwoPartyTensorBackend {
+ public:
+  using MOTION::TwoPartyTensorBackend::TwoPartyTensorBackend;
+
+  std::size_t get_num_ot_extensions() const {
+    return ot_manager_->get_provider(1 - my_id_).GetNumExtensions();
+  }
+  std::size_t get_base_ot_offset() const {
+    return base_ot_provider_->get_base_ots_data(1 - my_id_).GetSenderData().consumed_offset_;
+  }
+  ENCRYPTO::BitVector<> get_base_ot_choices() const {
+    return base_ot_provider_->get_base_ots_data(1 - my_id_).GetReceiverData().c_;
+  }
+};
+
+class TwoPartyTensorBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    comm_layers_ = MOTION::Communication::make_dummy_communication_layers(2);
+    for (std::size_t i = 0; i < 2; ++i) {
+      loggers_[i] = std::make_shared<MOTION::Logger>(i, boost::log::trivial::severity_level::trace);
+      comm_layers_[i]->set_logger(loggers_[i]);
+      backends_[i] = std::make_unique<InspectableTensorBackend>(*comm_layers_[i], 1, false,
+                                                                loggers_[i]);
+    }
+  }
+
+  void TearDown() override {
+    std::vector<std::future<void>> futs;
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [this, i] { comm_layers_[i]->shutdown(); }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  }
+
+  // square a tensor of party 0 and return the output of party 0
+  std::vector<std::uint64_t> run_inference(const std::vector<std::uint64_t>& input) {
+    const MOTION::tensor::TensorDimensions dims = {
+        .batch_size_ = 1, .num_channels_ = 1, .height_ = 4, .width_ = 4};
+    auto run_party = [this, &dims, &input](std::size_t party_id) {
+      auto& backend = *backends_[party_id];
+      auto& factory = backend.get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+      ENCRYPTO::ReusableFiberFuture<std::vector<std::uint64_t>> output_future;
+      if (party_id == 0) {
+        auto [input_promise, tensor_in] = factory.make_arithmetic_64_tensor_input_my(dims);
+        auto tensor_out = factory.make_tensor_sqr_op(tensor_in);
+        output_future = factory.make_arithmetic_64_tensor_output_my(tensor_out);
+        input_promise.set_value(input);
+      } else {
+        auto tensor_in = factory.make_arithmetic_64_tensor_input_other(dims);
+        auto tensor_out = factory.make_tensor_sqr_op(tensor_in);
+        factory.make_arithmetic_tensor_output_other(tensor_out);
+      }
+      backend.run();
+      return party_id == 0 ? output_future.get() : std::vector<std::uint64_t>{};
+    };
+    auto f1 = std::async(std::launch::async, run_party, 1);
+    auto output = run_party(0);
+    f1.get();
+    return output;
+  }
+
+  void reset_backends() {
+    auto f1 = std::async(std::launch::async, [this] { backends_[1]->reset(); });
+    backends_[0]->reset();
+    f1.get();
+  }
+
+  std::vector<std::unique_ptr<MOTION::Communication::CommunicationLayer>> comm_layers_;
+  std::array<std::shared_ptr<MOTION::Logger>, 2> loggers_;
+  std::array<std::unique_ptr<InspectableTensorBackend>, 2> backends_;
+};
+
+// the second inference takes its OTs from the pool of the first one, so
+// neither base OTs nor the OT extension are run again
+TEST_F(TwoPartyTensorBackendTest, ReuseOTsAcrossReset) {
+  for (auto& backend : backends_) {
+    backend->set_ot_pool_size(std::size_t(1) << 14);
+  }
+  const auto input_1 = MOTION::Helpers::RandomVector<std::uint64_t>(16);
+  ASSERT_EQ(run_inference(input_1), MOTION::Helpers::MultiplyVectors(input_1, input_1));
+
+  std::array<std::size_t, 2> num_ot_extensions, base_ot_offsets;
+  std::array<ENCRYPTO::BitVector<>, 2> base_ot_choices;
+  for (std::size_t i = 0; i < 2; ++i) {
+    num_ot_extensions[i] = backends_[i]->get_num_ot_extensions();
+    base_ot_offsets[i] = backends_[i]->get_base_ot_offset();
+    base_ot_choices[i] = backends_[i]->get_base_ot_choices();
+    ASSERT_GT(num_ot_extensions[i], 0);
+  }
+
+  reset_backends();
+  const auto input_2 = MOTION::Helpers::RandomVector<std::uint64_t>(16);
+  ASSERT_EQ(run_inference(input_2), MOTION::Helpers::MultiplyVectors(input_2, input_2));
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(backends_[i]->get_num_ot_extensions(), num_ot_extensions[i]);
+    EXPECT_EQ(backends_[i]->get_base_ot_offset(), base_ot_offsets[i]);
+    EXPECT_EQ(backends_[i]->get_base_ot_choices(), base_ot_choices[i]);
+  }
+}
+
+// the BEAVY GEMM takes its setup from triples generated in advance
+TEST_F(TwoPartyTensorBackendTest, GemmWithTriplesFromFile) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {2, 3}, .input_B_shape_ = {3, 4}, .output_shape_ = {2, 4}};
+  const MOTION::LinAlgTripleRequirements requirements = {.bit_size_ = 64,
+                                                         .gemm_ops_ = {gemm_op}};
+  std::array<std::filesystem::path, 2> paths;
+  for (std::size_t i = 0; i < 2; ++i) {
+    paths[i] = std::filesystem::temp_directory_path() /
+               ("motion_backend_triples_" + std::to_string(::getpid()) + "_" + std::to_string(i));
+  }
+  auto f1 = std::async(std::launch::async, [this, &requirements, &paths] {
+    backends_[1]->generate_linalg_triples(requirements, paths[1]);
+  });
+  backends_[0]->generate_linalg_triples(requirements, paths[0]);
+  f1.get();
+
+  const auto input_A = MOTION::Helpers::RandomVector<std::uint64_t>(6);
+  const auto input_B = MOTION::Helpers::RandomVector<std::uint64_t>(12);
+  auto run_party = [this, &gemm_op, &paths, &input_A, &input_B](std::size_t party_id) {
+    auto& backend = *backends_[party_id];
+    backend.use_linalg_triples_from_file(paths[party_id]);
+    auto& factory = backend.get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+    ENCRYPTO::ReusableFiberFuture<std::vector<std::uint64_t>> output_future;
+    if (party_id == 0) {
+      auto [input_promise, tensor_A] =
+          factory.make_arithmetic_64_tensor_input_my(gemm_op.get_input_A_tensor_dims());
+      auto tensor_B =
+          factory.make_arithmetic_64_tensor_input_other(gemm_op.get_input_B_tensor_dims());
+      auto tensor_out = factory.make_tensor_gemm_op(gemm_op, tensor_A, tensor_B);
+      output_future = factory.make_arithmetic_64_tensor_output_my(tensor_out);
+      input_promise.set_value(input_A);
+    } else {
+      auto tensor_A =
+          factory.make_arithmetic_64_tensor_input_other(gemm_op.get_input_A_tensor_dims());
+      auto [input_promise, tensor_B] =
+          factory.make_arithmetic_64_tensor_input_my(gemm_op.get_input_B_tensor_dims());
+      auto tensor_out = factory.make_tensor_gemm_op(gemm_op, tensor_A, tensor_B);
+      factory.make_arithmetic_tensor_output_other(tensor_out);
+      input_promise.set_value(input_B);
+    }
+    backend.run();
+    return party_id == 0 ? output_future.get() : std::vector<std::uint64_t>{};
+  };
+  auto f2 = std::async(std::launch::async, run_party, 1);
+  const auto output = run_party(0);
+  f2.get();
+  EXPECT_EQ(output, MOTION::matrix_multiply(2, 3, 4, input_A, input_B));
+
+  for (const auto& path : paths) {
+    std::filesystem::remove(path);
+  }
+}
+
+// Two dense layers with a ReLU in between, evaluated in the 32-bit ring like
+// the inference example does with --ring-bits 32.  The result needs to match
+// the plaintext computation up to the error of the truncations.
+TEST_F(TwoPartyTensorBackendTest, DenseNetworkIn32BitRing) {
+  constexpr std::size_t fractional_bits = 8;
+  constexpr std::size_t num_inputs = 4, num_hidden = 3, num_outputs = 2, num_images = 2;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  const auto random_matrix = [&rng, &dist](std::size_t rows, std::size_t cols) {
+    std::vector<double> values(rows * cols);
+    std::generate(std::begin(values), std::end(values), [&] { return dist(rng); });
+    return values;
+  };
+  const auto encode = [](const std::vector<double>& values) {
+    std::vector<std::uint32_t> encoded(values.size());
+    std::transform(std::begin(values), std::end(values), std::begin(encoded), [](double v) {
+      return static_cast<std::uint32_t>(std::lround(v * (1 << fractional_bits)));
+    });
+    return encoded;
+  };
+  const auto X = random_matrix(num_inputs, num_images);
+  const auto W1 = random_matrix(num_hidden, num_inputs);
+  const auto B1 = random_matrix(num_hidden, 1);
+  const auto W2 = random_matrix(num_outputs, num_hidden);
+  const auto B2 = random_matrix(num_outputs, 1);
+
+  // plaintext: W2 * relu(W1 * X + B1) + B2
+  const auto dense = [](const std::vector<double>& W, const std::vector<double>& input,
+                        const std::vector<double>& B, std::size_t rows, std::size_t inner) {
+    std::vector<double> output(rows * num_images);
+    for (std::size_t i = 0; i < rows; ++i) {
+      for (std::size_t j = 0; j < num_images; ++j) {
+        output[i * num_images + j] = B[i];
+        for (std::size_t k = 0; k < inner; ++k) {
+          output[i * num_images + j] += W[i * inner + k] * input[k * num_images + j];
+        }
+      }
+    }
+    return output;
+  };
+  auto hidden = dense(W1, X, B1, num_hidden, num_inputs);
+  std::transform(std::begin(hidden), std::end(hidden), std::begin(hidden),
+                 [](double v) { return std::max(v, 0.0); });
+  const auto expected = dense(W2, hidden, B2, num_outputs, num_hidden);
+
+  const MOTION::tensor::GemmOp gemm_op_1 = {.input_A_shape_ = {num_hidden, num_inputs},
+                                            .input_B_shape_ = {num_inputs, num_images},
+                                            .output_shape_ = {num_hidden, num_images}};
+  const MOTION::tensor::GemmOp gemm_op_2 = {.input_A_shape_ = {num_outputs, num_hidden},
+                                            .input_B_shape_ = {num_hidden, num_images},
+                                            .output_shape_ = {num_outputs, num_images}};
+  const auto bias_dims = [](std::size_t rows) {
+    return MOTION::tensor::TensorDimensions{
+        .batch_size_ = 1, .num_channels_ = 1, .height_ = rows, .width_ = 1};
+  };
+
+  // party 0 holds the image, party 1 the model
+  auto run_party = [&, this](std::size_t party_id) {
+    auto& backend = *backends_[party_id];
+    auto& arithmetic_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+    auto& boolean_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::Yao);
+    std::vector<ENCRYPTO::ReusableFiberPromise<std::vector<std::uint32_t>>> promises;
+    std::vector<std::vector<std::uint32_t>> values;
+    const auto make_input = [&](std::size_t owner, const auto& dims, const auto& plain) {
+      if (owner != party_id) {
+        return arithmetic_tof.make_arithmetic_32_tensor_input_other(dims);
+      }
+      auto [promise, tensor] = arithmetic_tof.make_arithmetic_32_tensor_input_my(dims);
+      promises.push_back(std::move(promise));
+      values.push_back(encode(plain));
+      return tensor;
+    };
+    auto tensor_X = make_input(0, gemm_op_1.get_input_B_tensor_dims(), X);
+    auto tensor_W1 = make_input(1, gemm_op_1.get_input_A_tensor_dims(), W1);
+    auto tensor_B1 = make_input(1, bias_dims(num_hidden), B1);
+    auto tensor_W2 = make_input(1, gemm_op_2.get_input_A_tensor_dims(), W2);
+    auto tensor_B2 = make_input(1, bias_dims(num_outputs), B2);
+
+    auto tensor_H = arithmetic_tof.make_tensor_dense_op(gemm_op_1, tensor_W1, tensor_X, tensor_B1,
+                                                        fractional_bits, true);
+    tensor_H = boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::Yao, tensor_H);
+    tensor_H = boolean_tof.make_tensor_relu_op(tensor_H);
+    tensor_H = boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::ArithmeticBEAVY, tensor_H);
+    tensor_H = arithmetic_tof.make_tensor_negate(tensor_H);
+    const auto tensor_Y = arithmetic_tof.make_tensor_dense_op(gemm_op_2, tensor_W2, tensor_H,
+                                                              tensor_B2, fractional_bits, false);
+    ENCRYPTO::ReusableFiberFuture<std::vector<std::uint32_t>> output_future;
+    if (party_id == 0) {
+      output_future = arithmetic_tof.make_arithmetic_32_tensor_output_my(tensor_Y);
+    } else {
+      arithmetic_tof.make_arithmetic_tensor_output_other(tensor_Y);
+    }
+    for (std::size_t i = 0; i < promises.size(); ++i) {
+      promises[i].set_value(values[i]);
+    }
+    backend.run();
+    return party_id == 0 ? output_future.get() : std::vector<std::uint32_t>{};
+  };
+  auto f1 = std::async(std::launch::async, run_party, 1);
+  const auto output = run_party(0);
+  f1.get();
+
+  ASSERT_EQ(output.size(), expected.size());
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    const auto value = static_cast<std::int32_t>(output[i]) / double(1 << fractional_bits);
+    EXPECT_NEAR(value, expected[i], 0.05) << "output " << i;
+  }
+}
+
+// A network of several layers gives the same output whether the online phase
+// waits for the setup of all gates or is pipelined with it.  Without
+// truncations, both need to match the plaintext computation exactly.
+TEST_F(TwoPartyTensorBackendTest, PipelinedEvaluationMatchesSetupOnline) {
+  constexpr std::size_t num_inputs = 5, num_hidden = 4, num_outputs = 3, num_images = 2;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<std::int64_t> dist(-3, 3);
+  const auto random_matrix = [&rng, &dist](std::size_t rows, std::size_t cols) {
+    std::vector<std::int64_t> values(rows * cols);
+    std::generate(std::begin(values), std::end(values), [&] { return dist(rng); });
+    return values;
+  };
+  const auto X = random_matrix(num_inputs, num_images);
+  const auto W1 = random_matrix(num_hidden, num_inputs);
+  const auto W2 = random_matrix(num_outputs, num_hidden);
+
+  // plaintext: W2 * relu(W1 * X)^2
+  const auto gemm = [](const std::vector<std::int64_t>& W, const std::vector<std::int64_t>& input,
+                       std::size_t rows, std::size_t inner) {
+    std::vector<std::int64_t> output(rows * num_images, 0);
+    for (std::size_t i = 0; i < rows; ++i) {
+      for (std::size_t j = 0; j < num_images; ++j) {
+        for (std::size_t k = 0; k < inner; ++k) {
+          output[i * num_images + j] += W[i * inner + k] * input[k * num_images + j];
+        }
+      }
+    }
+    return output;
+  };
+  auto hidden = gemm(W1, X, num_hidden, num_inputs);
+  std::transform(std::begin(hidden), std::end(hidden), std::begin(hidden),
+                 [](std::int64_t v) { return v > 0 ? v * v : 0; });
+  const auto expected = gemm(W2, hidden, num_outputs, num_hidden);
+
+  const MOTION::tensor::GemmOp gemm_op_1 = {.input_A_shape_ = {num_hidden, num_inputs},
+                                            .input_B_shape_ = {num_inputs, num_images},
+                                            .output_shape_ = {num_hidden, num_images}};
+  const MOTION::tensor::GemmOp gemm_op_2 = {.input_A_shape_ = {num_outputs, num_hidden},
+                                            .input_B_shape_ = {num_hidden, num_images},
+                                            .output_shape_ = {num_outputs, num_images}};
+
+  // party 0 holds the image, party 1 the model
+  auto run_party = [&, this](std::size_t party_id, bool pipelined) {
+    auto& backend = *backends_[party_id];
+    auto& arithmetic_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+    auto& boolean_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::Yao);
+    std::vector<ENCRYPTO::ReusableFiberPromise<std::vector<std::uint64_t>>> promises;
+    std::vector<std::vector<std::uint64_t>> values;
+    const auto make_input = [&](std::size_t owner, const auto& dims, const auto& plain) {
+      if (owner != party_id) {
+        return arithmetic_tof.make_arithmetic_64_tensor_input_other(dims);
+      }
+      auto [promise, tensor] = arithmetic_tof.make_arithmetic_64_tensor_input_my(dims);
+      promises.push_back(std::move(promise));
+      values.emplace_back(std::begin(plain), std::end(plain));
+      return tensor;
+    };
+    auto tensor_X = make_input(0, gemm_op_1.get_input_B_tensor_dims(), X);
+    auto tensor_W1 = make_input(1, gemm_op_1.get_input_A_tensor_dims(), W1);
+    auto tensor_W2 = make_input(1, gemm_op_2.get_input_A_tensor_dims(), W2);
+
+    auto tensor_H = arithmetic_tof.make_tensor_gemm_op(gemm_op_1, tensor_W1, tensor_X);
+    tensor_H = boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::Yao, tensor_H);
+    tensor_H = boolean_tof.make_tensor_relu_op(tensor_H);
+    tensor_H = boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::ArithmeticBEAVY, tensor_H);
+    tensor_H = arithmetic_tof.make_tensor_negate(tensor_H);
+    tensor_H = arithmetic_tof.make_tensor_sqr_op(tensor_H);
+    const auto tensor_Y = arithmetic_tof.make_tensor_gemm_op(gemm_op_2, tensor_W2, tensor_H);
+    ENCRYPTO::ReusableFiberFuture<std::vector<std::uint64_t>> output_future;
+    if (party_id == 0) {
+      output_future = arithmetic_tof.make_arithmetic_64_tensor_output_my(tensor_Y);
+    } else {
+      arithmetic_tof.make_arithmetic_tensor_output_other(tensor_Y);
+    }
+    for (std::size_t i = 0; i < promises.size(); ++i) {
+      promises[i].set_value(values[i]);
+    }
+    if (pipelined) {
+      backend.run_pipelined();
+    } else {
+      backend.run();
+    }
+    return party_id == 0 ? output_future.get() : std::vector<std::uint64_t>{};
+  };
+  const auto run_network = [&run_party](bool pipelined) {
+    auto f1 = std::async(std::launch::async, run_party, 1, pipelined);
+    auto output = run_party(0, pipelined);
+    f1.get();
+    return output;
+  };
+
+  const auto output_setup_online = run_network(false);
+  reset_backends();
+  const auto output_pipelined = run_network(true);
+
+  EXPECT_EQ(output_pipelined, output_setup_online);
+  ASSERT_EQ(output_pipelined.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(static_cast<std::int64_t>(output_pipelined[i]), expected[i]) << "output " << i;
+  }
+}
+
+}  // namespace
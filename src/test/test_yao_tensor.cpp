@@ -23,6 +23,7 @@
 #include <array>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 
 #include <gtest/gtest.h>
@@ -708,6 +709,69 @@ TYPED_TEST(YaoArithmeticGMWTensorTest, MaxPool) {
   EXPECT_EQ(output, expected_output);
 }
 
+TYPED_TEST(YaoArithmeticGMWTensorTest, ArgMax) {
+  const MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 3, .width_ = 4};
+  const MOTION::tensor::TensorDimensions out_dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 1, .width_ = 4};
+  const MOTION::tensor::ArgMaxOp argmax_op = {
+      .input_shape_ = {1, 3, 4}, .output_shape_ = {1, 1, 4}, .axis_ = 1};
+  ASSERT_TRUE(argmax_op.verify());
+
+  // argmax over the rows of each column, ties go to the first row
+  const auto v = [](auto x) { return static_cast<TypeParam>(x); };
+  // clang-format off
+  const std::vector<TypeParam> input = {
+    v(5), v(-3), v(7), v(2),
+    v(9), v(-1), v(7), v(-8),
+    v(1), v(-2), v(3), v(2)};
+  // clang-format on
+  const std::vector<TypeParam> expected_index = {1, 1, 0, 0};
+  const std::vector<TypeParam> expected_max = {v(9), v(-1), v(7), v(2)};
+
+  auto [input_promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+
+  auto tensor_0 = this->yao_providers_[0]->make_convert_from_arithmetic_gmw_tensor(tensor_in_0);
+  auto tensor_1 = this->yao_providers_[1]->make_convert_from_arithmetic_gmw_tensor(tensor_in_1);
+  auto [index_tensor_0, max_tensor_0] =
+      this->yao_providers_[0]->make_tensor_argmax_op(argmax_op, tensor_0, true);
+  auto [index_tensor_1, max_tensor_1] =
+      this->yao_providers_[1]->make_tensor_argmax_op(argmax_op, tensor_1, true);
+  ASSERT_EQ(index_tensor_0->get_dimensions(), out_dims);
+  ASSERT_EQ(max_tensor_1->get_dimensions(), out_dims);
+
+  auto gmw_index_tensor_0 =
+      this->yao_providers_[0]->make_convert_to_arithmetic_gmw_tensor(index_tensor_0);
+  auto gmw_index_tensor_1 =
+      this->yao_providers_[1]->make_convert_to_arithmetic_gmw_tensor(index_tensor_1);
+  auto gmw_max_tensor_0 =
+      this->yao_providers_[0]->make_convert_to_arithmetic_gmw_tensor(max_tensor_0);
+  auto gmw_max_tensor_1 =
+      this->yao_providers_[1]->make_convert_to_arithmetic_gmw_tensor(max_tensor_1);
+  this->gmw_providers_[0]->make_arithmetic_tensor_output_other(gmw_index_tensor_0);
+  auto index_future = this->make_arithmetic_T_tensor_output_my(1, gmw_index_tensor_1);
+  this->gmw_providers_[0]->make_arithmetic_tensor_output_other(gmw_max_tensor_0);
+  auto max_future = this->make_arithmetic_T_tensor_output_my(1, gmw_max_tensor_1);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_promise.set_value(input);
+  this->run_gates_online();
+
+  EXPECT_EQ(index_future.get(), expected_index);
+  EXPECT_EQ(max_future.get(), expected_max);
+}
+
+TEST(CircuitLoader, ArgMaxIndexNeedsToFitIntoBitSize) {
+  MOTION::CircuitLoader circuit_loader;
+  // 256 candidates need an 8 bit index
+  const auto& algo = circuit_loader.load_argmax_circuit(8, 256, false, false);
+  EXPECT_EQ(algo.n_output_wires_, 8);
+  EXPECT_THROW(circuit_loader.load_argmax_circuit(8, 257, false, false), std::invalid_argument);
+  EXPECT_THROW(circuit_loader.load_argmax_circuit(8, 1000, true, true), std::invalid_argument);
+}
+
 TYPED_TEST(YaoArithmeticGMWTensorTest, MaxPoolInBooleanGMW) {
   const MOTION::tensor::TensorDimensions dims = {
       .batch_size_ = 1, .num_channels_ = 1, .height_ = 4, .width_ = 4};
@@ -1194,3 +1258,63 @@ TYPED_TEST(YaoArithmeticBEAVYTensorTest, MaxPoolInBooleanBEAVY) {
   const auto output = output_future.get();
   EXPECT_EQ(output, expected_output);
 }
+
+TYPED_TEST(YaoArithmeticBEAVYTensorTest, ArgMaxInBooleanBEAVY) {
+  const MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 3, .width_ = 4};
+  const MOTION::tensor::TensorDimensions out_dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 1, .width_ = 4};
+  const MOTION::tensor::ArgMaxOp argmax_op = {
+      .input_shape_ = {1, 3, 4}, .output_shape_ = {1, 1, 4}, .axis_ = 1};
+  ASSERT_TRUE(argmax_op.verify());
+
+  // argmax over the rows of each column, ties go to the first row
+  const auto v = [](auto x) { return static_cast<TypeParam>(x); };
+  // clang-format off
+  const std::vector<TypeParam> input = {
+    v(5), v(-3), v(7), v(2),
+    v(9), v(-1), v(7), v(-8),
+    v(1), v(-2), v(3), v(2)};
+  // clang-format on
+  const std::vector<TypeParam> expected_index = {1, 1, 0, 0};
+  const std::vector<TypeParam> expected_max = {v(9), v(-1), v(7), v(2)};
+
+  auto [input_promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+
+  auto tensor_yao_0 =
+      this->yao_providers_[0]->make_convert_from_arithmetic_beavy_tensor(tensor_in_0);
+  auto tensor_yao_1 =
+      this->yao_providers_[1]->make_convert_from_arithmetic_beavy_tensor(tensor_in_1);
+  auto tensor_bbeavy_0 =
+      this->yao_providers_[0]->make_convert_to_boolean_beavy_tensor(tensor_yao_0);
+  auto tensor_bbeavy_1 =
+      this->yao_providers_[1]->make_convert_to_boolean_beavy_tensor(tensor_yao_1);
+  auto [index_tensor_0, max_tensor_0] =
+      this->beavy_providers_[0]->make_tensor_argmax_op(argmax_op, tensor_bbeavy_0, true);
+  auto [index_tensor_1, max_tensor_1] =
+      this->beavy_providers_[1]->make_tensor_argmax_op(argmax_op, tensor_bbeavy_1, true);
+  ASSERT_EQ(index_tensor_0->get_dimensions(), out_dims);
+  ASSERT_EQ(max_tensor_1->get_dimensions(), out_dims);
+
+  auto beavy_index_tensor_0 =
+      this->beavy_providers_[0]->make_convert_boolean_to_arithmetic_beavy_tensor(index_tensor_0);
+  auto beavy_index_tensor_1 =
+      this->beavy_providers_[1]->make_convert_boolean_to_arithmetic_beavy_tensor(index_tensor_1);
+  auto beavy_max_tensor_0 =
+      this->beavy_providers_[0]->make_convert_boolean_to_arithmetic_beavy_tensor(max_tensor_0);
+  auto beavy_max_tensor_1 =
+      this->beavy_providers_[1]->make_convert_boolean_to_arithmetic_beavy_tensor(max_tensor_1);
+  this->beavy_providers_[0]->make_arithmetic_tensor_output_other(beavy_index_tensor_0);
+  auto index_future = this->make_arithmetic_T_tensor_output_my(1, beavy_index_tensor_1);
+  this->beavy_providers_[0]->make_arithmetic_tensor_output_other(beavy_max_tensor_0);
+  auto max_future = this->make_arithmetic_T_tensor_output_my(1, beavy_max_tensor_1);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_promise.set_value(input);
+  this->run_gates_online();
+
+  EXPECT_EQ(index_future.get(), expected_index);
+  EXPECT_EQ(max_future.get(), expected_max);
+}